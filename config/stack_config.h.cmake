@@ -26,6 +26,7 @@
 #cmakedefine01 DEBUG_IED_CLIENT
 #cmakedefine01 DEBUG_MMS_CLIENT
 #cmakedefine01 DEBUG_MMS_SERVER
+#cmakedefine01 DEBUG_GOOSE_SUBSCRIBER
 
 /* Maximum MMS PDU SIZE - default is 65000 */
 #cmakedefine CONFIG_MMS_MAXIMUM_PDU_SIZE @CONFIG_MMS_MAXIMUM_PDU_SIZE@
@@ -51,11 +52,32 @@
 /* timeout while reading from TCP stream in ms */
 #define CONFIG_TCP_READ_TIMEOUT_MS 1000
 
+/* number of outgoing messages (reports) that can be queued per client connection. Set to 0 to send synchronously */
+#define CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE 16
+
 /* Ethernet interface ID for GOOSE and SV */
 //#define CONFIG_ETHERNET_INTERFACE_ID "eth0"
 //#define CONFIG_ETHERNET_INTERFACE_ID "vboxnet0"
 #define CONFIG_ETHERNET_INTERFACE_ID "en0"  // OS X uses enX in place of ethX as ethernet NIC names.
 
+/* Linux: receive GOOSE messages with a memory mapped ring buffer (PACKET_MMAP). Set to 0 to use recvfrom */
+#define CONFIG_ETHERNET_USE_RX_RING 1
+
+/* Linux: number of 64 kByte blocks of the memory mapped receive ring */
+#define CONFIG_ETHERNET_RX_RING_BLOCKS 16
+
+/* Linux: time in ms until the kernel hands over a partially filled block of the receive ring. A received frame
+ * can be delayed by up to this time (1 is the minimum). Use CONFIG_ETHERNET_USE_RX_RING 0 if this latency is
+ * too high for the application (e.g. GOOSE trip messages) */
+#define CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT 1
+
+/* Linux: use receive time stamps of the network adapter (SO_TIMESTAMPING). Requires root privileges and an
+ * adapter clock synchronized with PTP. Set to 0 to use the time stamps taken by the kernel */
+#define CONFIG_ETHERNET_USE_HW_TIMESTAMPS 0
+
+/* Loopback ethernet HAL (build option CONFIG_ETHERNET_LOOPBACK): number of frames in the shared memory frame bus */
+#define CONFIG_ETHERNET_LOOPBACK_SLOTS 1024
+
 /* Set to 1 to include GOOSE support in the build. Otherwise set to 0 */
 #cmakedefine01 CONFIG_INCLUDE_GOOSE_SUPPORT
 
@@ -84,6 +106,22 @@
 /* The number of GOOSE retransmissions after an event */
 #define CONFIG_GOOSE_EVENT_RETRANSMISSION_COUNT 2
 
+/* Set to 1 to publish GOOSE messages by a dedicated thread. Set to 0 to publish by the event worker thread */
+#define CONFIG_GOOSE_PUBLISHER_THREAD 1
+
+/* Real-time (SCHED_FIFO) priority of the GOOSE publisher thread. Set to 0 to keep the default scheduling policy */
+#define CONFIG_GOOSE_PUBLISHER_THREAD_PRIORITY 0
+
+/* CPU core the GOOSE publisher thread is bound to. Set to -1 to not change the CPU affinity */
+#define CONFIG_GOOSE_PUBLISHER_THREAD_CPU -1
+
+/* Maximum number of GOOSE messages that are sent with a single system call when multiple GOOSE
+ * control blocks publish at the same time. Set to 0 to send each message separately */
+#define CONFIG_GOOSE_TRANSMIT_QUEUE_SIZE 32
+
+/* Maximum number of sampled values messages that are sent with a single system call by SVPublisher_flush */
+#define CONFIG_SV_TRANSMIT_QUEUE_SIZE 16
+
 /* The default value for the priority field of the 802.1Q header (allowed range 0-7) */
 #define CONFIG_GOOSE_DEFAULT_PRIORITY 4
 
@@ -108,6 +146,9 @@
 /* The default buffer size of buffered RCBs in bytes */
 #cmakedefine CONFIG_REPORTING_DEFAULT_REPORT_BUFFER_SIZE @CONFIG_REPORTING_DEFAULT_REPORT_BUFFER_SIZE@
 
+/* Send queue overflow policy for unbuffered reports: 1 -> drop the oldest queued unbuffered report, 0 -> block until space is available */
+#define CONFIG_REPORTING_URCB_DROP_OLDEST_ON_OVERFLOW 1
+
 /* default results for MMS identify service */
 #define CONFIG_DEFAULT_MMS_VENDOR_NAME "libiec61850.com"
 #define CONFIG_DEFAULT_MMS_MODEL_NAME "LIBIEC61850"
@@ -119,6 +160,19 @@
 /* Maximum number of open file per MMS connection (for MMS file read service) */
 #define CONFIG_MMS_MAX_NUMBER_OF_OPEN_FILES_PER_CONNECTION 5
 
+/* Serve MMS file read requests from a memory mapped file (only supported on Linux) */
+#define CONFIG_MMS_FILE_SERVICE_USE_MMAP 0
+
+/* Maximum number of MMS client requests waiting for a response (per connection) */
+#define CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS 32
+
+/* Number of outstanding FileRead requests used by IedConnection_getFile (1 -> one request per round trip) */
+#define CONFIG_MMS_CLIENT_FILE_READ_WINDOW_SIZE 4
+
+/* Number of receive buffers of a client connection. Messages are received into a free buffer while
+ * the previous message is processed (the buffers are allocated when required) */
+#define CONFIG_ISO_CLIENT_RECEIVE_BUFFERS 4
+
 /* Definition of supported services */
 #define MMS_DEFAULT_PROFILE 1
 
@@ -0,0 +1,237 @@
+/*
+ * goose_latency_benchmark.c
+ *
+ * Measures the end-to-end latency of GOOSE events (from GoosePublisher_publish until the
+ * listener of the subscriber is called) and the number of frames per second that are
+ * delivered from a publisher to a subscriber in the same process.
+ *
+ * Usage: goose_latency_benchmark <interface> [<receive interface> [<events> [<frames>]]]
+ *
+ * With the loopback ethernet HAL (build option CONFIG_ETHERNET_LOOPBACK or
+ * make ETHERNET_LOOPBACK=1) the interface is only the name of the shared memory frame bus
+ * and no privileges are required. With the raw socket HAL it has to be started as root and
+ * the frames have to be received on a different interface (e.g. the peer of a veth pair)
+ * because a raw socket does not receive the frames sent on the same interface.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "mms_value.h"
+#include "goose_publisher.h"
+#include "goose_receiver.h"
+#include "thread.h"
+#include "hal.h"
+
+#define NUMBER_OF_DATA_SET_ENTRIES 16
+#define NUMBER_OF_EVENTS 10000
+#define NUMBER_OF_FRAMES 200000
+
+#define EVENT_TIMEOUT_IN_NS 100000000LL
+
+/* maximum number of frames sent but not yet received in the throughput test */
+#define SEND_WINDOW 256
+
+#define GOCB_REF "Test1/LLN0$GO$gocb1"
+
+static volatile uint32_t receivedStNum = 0;
+static volatile uint32_t receivedMessages = 0;
+static volatile uint64_t receiveTime = 0;
+
+static void
+gooseListener(GooseSubscriber subscriber, void* parameter)
+{
+    receiveTime = Hal_getMonotonicTimeInNs();
+    receivedMessages++;
+    receivedStNum = GooseSubscriber_getStNum(subscriber);
+}
+
+static int
+compareLatencies(const void* a, const void* b)
+{
+    uint64_t latencyA = *((uint64_t*) a);
+    uint64_t latencyB = *((uint64_t*) b);
+
+    if (latencyA < latencyB)
+        return -1;
+    else if (latencyA > latencyB)
+        return 1;
+    else
+        return 0;
+}
+
+static void
+measureEventLatency(GoosePublisher publisher, LinkedList dataSetValues, int events)
+{
+    uint64_t* latencies = (uint64_t*) malloc(events * sizeof(uint64_t));
+
+    MmsValue* value = (MmsValue*) LinkedList_getNext(dataSetValues)->data;
+
+    int received = 0;
+    int lost = 0;
+    int i;
+
+    for (i = 0; i < events; i++) {
+        MmsValue_setInt32(value, i);
+
+        GoosePublisher_increaseStNum(publisher);
+
+        uint64_t sendTime = Hal_getMonotonicTimeInNs();
+
+        if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+            printf("Error sending message!\n");
+            break;
+        }
+
+        /* wait for the subscriber - stNum of the first event is 2 */
+        while (receivedStNum != (uint32_t) (i + 2)) {
+            if (Hal_getMonotonicTimeInNs() - sendTime > EVENT_TIMEOUT_IN_NS)
+                break;
+        }
+
+        if (receivedStNum == (uint32_t) (i + 2))
+            latencies[received++] = receiveTime - sendTime;
+        else
+            lost++;
+    }
+
+    if (received > 0) {
+        uint64_t sum = 0;
+
+        for (i = 0; i < received; i++)
+            sum += latencies[i];
+
+        qsort(latencies, received, sizeof(uint64_t), compareLatencies);
+
+        printf("event latency (us): min %.1f avg %.1f median %.1f 99%% %.1f max %.1f\n",
+                latencies[0] / 1000.0, (double) sum / received / 1000.0, latencies[received / 2] / 1000.0,
+                latencies[(received * 99) / 100] / 1000.0, latencies[received - 1] / 1000.0);
+    }
+
+    printf("events: %i received: %i lost: %i\n", events, received, lost);
+
+    free(latencies);
+}
+
+static void
+measureThroughput(GoosePublisher publisher, LinkedList dataSetValues, int frames)
+{
+    uint32_t messagesBefore = receivedMessages;
+
+    int lost = 0; /* frames given up by the flow control */
+
+    uint64_t startTime = Hal_getMonotonicTimeInNs();
+
+    int i;
+
+    for (i = 0; i < frames; i++) {
+
+        /* don't overrun the receiver - frames that are not received within the timeout are lost */
+        int outstanding = i - lost - (int) (receivedMessages - messagesBefore);
+
+        if (outstanding >= SEND_WINDOW) {
+            uint64_t waitStart = Hal_getMonotonicTimeInNs();
+
+            while (i - lost - (int) (receivedMessages - messagesBefore) >= SEND_WINDOW) {
+                if (Hal_getMonotonicTimeInNs() - waitStart > EVENT_TIMEOUT_IN_NS) {
+                    lost = i - (int) (receivedMessages - messagesBefore);
+                    break;
+                }
+
+                Thread_sleep(0); /* let the receiver run on single core systems */
+            }
+        }
+
+        if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+            printf("Error sending message!\n");
+            break;
+        }
+    }
+
+    /* wait until the subscriber has received the remaining frames */
+    uint32_t lastCount;
+
+    do {
+        lastCount = receivedMessages;
+        Thread_sleep(10);
+    } while (receivedMessages != lastCount);
+
+    uint64_t duration = receiveTime - startTime;
+
+    if (duration == 0)
+        duration = 1;
+
+    uint32_t received = receivedMessages - messagesBefore;
+
+    printf("frames: %i received: %u -> %.0f frames/s\n", frames, received,
+            (double) received * 1e9 / duration);
+}
+
+int
+main(int argc, char** argv)
+{
+    char* interface = "eth0";
+    char* receiveInterface = NULL;
+    int events = NUMBER_OF_EVENTS;
+    int frames = NUMBER_OF_FRAMES;
+
+    if (argc > 1)
+        interface = argv[1];
+
+    if (argc > 2)
+        receiveInterface = argv[2];
+    else
+        receiveInterface = interface;
+
+    if (argc > 3)
+        events = atoi(argv[3]);
+
+    if (argc > 4)
+        frames = atoi(argv[4]);
+
+    LinkedList dataSetValues = LinkedList_create();
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_DATA_SET_ENTRIES; i++) {
+        if (i % 2)
+            LinkedList_add(dataSetValues, MmsValue_newFloat((float) i * 0.5f));
+        else
+            LinkedList_add(dataSetValues, MmsValue_newIntegerFromInt32(i));
+    }
+
+    GooseReceiver receiver = GooseReceiver_create();
+    GooseReceiver_setInterfaceId(receiver, receiveInterface);
+
+    GooseSubscriber subscriber = GooseSubscriber_create(GOCB_REF, NULL);
+    GooseSubscriber_setListener(subscriber, gooseListener, NULL);
+
+    GooseReceiver_addSubscriber(receiver, subscriber);
+    GooseReceiver_start(receiver);
+
+    GoosePublisher publisher = GoosePublisher_create(NULL, interface);
+
+    GoosePublisher_setGoCbRef(publisher, GOCB_REF);
+    GoosePublisher_setConfRev(publisher, 1);
+    GoosePublisher_setDataSetRef(publisher, "Test1/LLN0$dataset1");
+    GoosePublisher_setTimeAllowedToLive(publisher, 500);
+
+    /* give the receiver thread time to start listening */
+    Thread_sleep(100);
+
+    measureEventLatency(publisher, dataSetValues, events);
+
+    measureThroughput(publisher, dataSetValues, frames);
+
+    GoosePublisher_destroy(publisher);
+
+    GooseReceiver_destroy(receiver);
+    GooseSubscriber_destroy(subscriber);
+
+    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction) MmsValue_delete);
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * goose_publisher_benchmark.c
+ *
+ * Measures the time GoosePublisher_publish needs per frame for retransmissions
+ * (only sqNum changes) and for state changes (stNum increased, data set re-encoded).
+ *
+ * Usage: goose_publisher_benchmark [<interface> [<frames> [<capture file>]]]
+ *
+ * If a capture file is given the frames are written to the pcap file instead of being
+ * sent (e.g. to create input files for goose_replay_benchmark). Otherwise it has to be
+ * started as root in Linux.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "mms_value.h"
+#include "goose_publisher.h"
+#include "hal.h"
+
+#define NUMBER_OF_DATA_SET_ENTRIES 32
+#define NUMBER_OF_FRAMES 100000
+
+static void
+printResult(char* name, uint64_t durationInMs, int frames)
+{
+    printf("%-16s %8i frames in %6i ms -> %8.3f us/frame\n", name, frames, (int) durationInMs,
+            ((double) durationInMs * 1000.0) / frames);
+}
+
+int
+main(int argc, char** argv)
+{
+    char* interface = "eth0";
+    int frames = NUMBER_OF_FRAMES;
+    PcapWriter captureFile = NULL;
+
+    if (argc > 1)
+        interface = argv[1];
+
+    if (argc > 2)
+        frames = atoi(argv[2]);
+
+    if (argc > 3) {
+        captureFile = PcapWriter_create(argv[3]);
+
+        if (captureFile == NULL) {
+            printf("Cannot create capture file %s\n", argv[3]);
+            return -1;
+        }
+    }
+
+    LinkedList dataSetValues = LinkedList_create();
+
+    int i;
+
+    for (i = 0; i < NUMBER_OF_DATA_SET_ENTRIES; i++) {
+        if (i % 2)
+            LinkedList_add(dataSetValues, MmsValue_newIntegerFromInt32(i));
+        else
+            LinkedList_add(dataSetValues, MmsValue_newFloat((float) i * 0.5f));
+    }
+
+    GoosePublisher publisher = GoosePublisher_create(NULL, interface);
+
+    GoosePublisher_setGoCbRef(publisher, "Test1/LLN0$GO$gocb1");
+    GoosePublisher_setConfRev(publisher, 1);
+    GoosePublisher_setDataSetRef(publisher, "Test1/LLN0$dataset1");
+    GoosePublisher_setTimeAllowedToLive(publisher, 500);
+
+    if (captureFile != NULL)
+        GoosePublisher_setCaptureFile(publisher, captureFile, true);
+
+    /* retransmissions - the encoded frame is reused */
+    uint64_t startTime = Hal_getTimeInMs();
+
+    for (i = 0; i < frames; i++) {
+        if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+            printf("Error sending message!\n");
+            break;
+        }
+    }
+
+    printResult("retransmission", Hal_getTimeInMs() - startTime, frames);
+
+    /* state changes - the complete frame is encoded */
+    startTime = Hal_getTimeInMs();
+
+    for (i = 0; i < frames; i++) {
+        GoosePublisher_increaseStNum(publisher);
+
+        if (GoosePublisher_publish(publisher, dataSetValues) == -1) {
+            printf("Error sending message!\n");
+            break;
+        }
+    }
+
+    printResult("state change", Hal_getTimeInMs() - startTime, frames);
+
+    GoosePublisher_destroy(publisher);
+
+    if (captureFile != NULL)
+        PcapWriter_close(captureFile);
+
+    LinkedList_destroyDeep(dataSetValues, (LinkedListValueDeleteFunction) MmsValue_delete);
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * goose_replay_benchmark.c
+ *
+ * Replays GOOSE messages from a pcap capture file into the receive path of a GOOSE
+ * receiver and measures the number of frames per second that are decoded and passed to
+ * the subscriber. Capture files can be created with goose_publisher_benchmark or any
+ * network capture tool (pcap format, not pcapng).
+ *
+ * Usage: goose_replay_benchmark <pcap file> <gocbRef> [<speed> [<repetitions>]]
+ *
+ * A speed of 1.0 replays the frames with the original timing, 0 (default) as fast as possible.
+ *
+ * No network interface is required.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "goose_receiver.h"
+#include "pcap_file.h"
+#include "hal.h"
+
+#define DEFAULT_REPETITIONS 10
+
+static uint32_t receivedMessages = 0;
+static uint32_t stateChanges = 0;
+static uint32_t lastStNum = 0;
+
+static void
+gooseListener(GooseSubscriber subscriber, void* parameter)
+{
+    receivedMessages++;
+
+    if (GooseSubscriber_getStNum(subscriber) != lastStNum) {
+        lastStNum = GooseSubscriber_getStNum(subscriber);
+        stateChanges++;
+    }
+}
+
+static void
+handleFrame(void* parameter, uint8_t* buffer, int frameSize, uint64_t timestamp)
+{
+    GooseReceiver_handleMessage((GooseReceiver) parameter, buffer, frameSize, timestamp);
+}
+
+int
+main(int argc, char** argv)
+{
+    double speed = 0;
+    int repetitions = DEFAULT_REPETITIONS;
+
+    if (argc < 3) {
+        printf("Usage: goose_replay_benchmark <pcap file> <gocbRef> [<speed> [<repetitions>]]\n");
+        return -1;
+    }
+
+    if (argc > 3)
+        speed = atof(argv[3]);
+
+    if (argc > 4)
+        repetitions = atoi(argv[4]);
+
+    PcapReader reader = PcapReader_open(argv[1]);
+
+    if (reader == NULL) {
+        printf("Cannot read pcap file %s\n", argv[1]);
+        return -1;
+    }
+
+    GooseReceiver receiver = GooseReceiver_create();
+
+    GooseSubscriber subscriber = GooseSubscriber_create(argv[2], NULL);
+    GooseSubscriber_setListener(subscriber, gooseListener, NULL);
+
+    GooseReceiver_addSubscriber(receiver, subscriber);
+
+    uint64_t totalFrames = 0;
+
+    uint64_t startTime = Hal_getMonotonicTimeInNs();
+
+    int i;
+
+    for (i = 0; i < repetitions; i++) {
+        PcapReader_rewind(reader);
+
+        int frames = PcapReader_replay(reader, handleFrame, receiver, speed);
+
+        if (frames == -1) {
+            printf("Corrupted pcap file!\n");
+            break;
+        }
+
+        totalFrames += frames;
+    }
+
+    uint64_t duration = Hal_getMonotonicTimeInNs() - startTime;
+
+    if (duration == 0)
+        duration = 1;
+
+    printf("%llu frames in %.1f ms -> %.0f frames/s\n", (unsigned long long) totalFrames,
+            duration / 1000000.0, (double) totalFrames * 1e9 / duration);
+
+    printf("received: %u state changes: %u\n", receivedMessages, stateChanges);
+
+    PcapReader_close(reader);
+
+    GooseReceiver_destroy(receiver);
+    GooseSubscriber_destroy(subscriber);
+
+    return 0;
+}
@@ -29,6 +29,7 @@ gooseListener(GooseSubscriber subscriber, void* parameter)
             GooseSubscriber_getSqNum(subscriber));
     printf("  timeToLive: %u\n", GooseSubscriber_getTimeAllowedToLive(subscriber));
     printf("  timestamp: %"PRIu64"\n", GooseSubscriber_getTimestamp(subscriber));
+    printf("  received: %"PRIu64" ns\n", GooseSubscriber_getReceiveTimestamp(subscriber));
 }
 
 int
@@ -0,0 +1,299 @@
+/*
+ * goose_subscriber_benchmark.c
+ *
+ * Measures the time a GOOSE subscriber needs to decode a message and to read all data set
+ * values with the data set values decoded into MmsValue instances and with the data set
+ * values decoded into pre-bound typed slots (GooseSubscriber_setSlotLayout).
+ *
+ * The messages are created in memory - no network interface is required.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "mms_value.h"
+#include "goose_subscriber.h"
+#include "hal.h"
+
+#define NUMBER_OF_DATA_SET_ENTRIES 30
+#define NUMBER_OF_MESSAGES 1000000
+
+#define GOCB_REF "Test1/LLN0$GO$gocb1"
+
+static GooseSlotType layout[NUMBER_OF_DATA_SET_ENTRIES];
+
+static int
+encodeTag(uint8_t* buffer, int bufPos, uint8_t tag, int length)
+{
+    buffer[bufPos++] = tag;
+
+    if (length < 128)
+        buffer[bufPos++] = (uint8_t) length;
+    else if (length < 256) {
+        buffer[bufPos++] = 0x81;
+        buffer[bufPos++] = (uint8_t) length;
+    }
+    else {
+        buffer[bufPos++] = 0x82;
+        buffer[bufPos++] = (uint8_t) (length / 256);
+        buffer[bufPos++] = (uint8_t) (length % 256);
+    }
+
+    return bufPos;
+}
+
+static int
+encodeElement(uint8_t* buffer, int bufPos, uint8_t tag, uint8_t* value, int length)
+{
+    bufPos = encodeTag(buffer, bufPos, tag, length);
+    memcpy(buffer + bufPos, value, length);
+
+    return bufPos + length;
+}
+
+static int
+encodeUInt32(uint8_t* buffer, int bufPos, uint8_t tag, uint32_t value)
+{
+    uint8_t octets[4] = { value >> 24, value >> 16, value >> 8, value };
+
+    return encodeElement(buffer, bufPos, tag, octets, 4);
+}
+
+static int
+encodeAllData(uint8_t* buffer, int bufPos, uint32_t stNum)
+{
+    int i;
+
+    for (i = 0; i < NUMBER_OF_DATA_SET_ENTRIES; i++) {
+        layout[i] = (GooseSlotType) (i % 6);
+
+        switch (layout[i]) {
+        case GOOSE_SLOT_BOOLEAN:
+            {
+                uint8_t value = (stNum + i) % 2;
+                bufPos = encodeElement(buffer, bufPos, 0x83, &value, 1);
+            }
+            break;
+        case GOOSE_SLOT_BIT_STRING:
+            {
+                /* 13 bit quality */
+                uint8_t value[3] = { 3, (uint8_t) i, 0x40 };
+                bufPos = encodeElement(buffer, bufPos, 0x84, value, 3);
+            }
+            break;
+        case GOOSE_SLOT_INTEGER:
+            {
+                uint8_t value[2] = { 0xff, (uint8_t) (0 - i) };
+                bufPos = encodeElement(buffer, bufPos, 0x85, value, 2);
+            }
+            break;
+        case GOOSE_SLOT_UNSIGNED:
+            bufPos = encodeUInt32(buffer, bufPos, 0x86, 1000 + stNum);
+            break;
+        case GOOSE_SLOT_FLOAT:
+            {
+                /* 1.5 in single precision */
+                uint8_t value[5] = { 8, 0x3f, 0xc0, 0x00, 0x00 };
+                bufPos = encodeElement(buffer, bufPos, 0x87, value, 5);
+            }
+            break;
+        case GOOSE_SLOT_TIMESTAMP:
+            {
+                uint8_t value[8] = { 0x54, 0x00, 0x00, (uint8_t) i, 0x80, 0x00, 0x00, 0x0a };
+                bufPos = encodeElement(buffer, bufPos, 0x91, value, 8);
+            }
+            break;
+        }
+    }
+
+    return bufPos;
+}
+
+static int
+createMessage(uint8_t* buffer, uint32_t stNum, uint32_t sqNum)
+{
+    uint8_t content[1500];
+    uint8_t allData[1000];
+    uint8_t timestamp[8] = { 0x54, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x0a };
+    uint8_t boolean = 0;
+    int bufPos = 0;
+
+    bufPos = encodeElement(content, bufPos, 0x80, (uint8_t*) GOCB_REF, strlen(GOCB_REF));
+    bufPos = encodeUInt32(content, bufPos, 0x81, 2000);
+    bufPos = encodeElement(content, bufPos, 0x82, (uint8_t*) "Test1/LLN0$dataset1", 19);
+    bufPos = encodeElement(content, bufPos, 0x83, (uint8_t*) GOCB_REF, strlen(GOCB_REF));
+    bufPos = encodeElement(content, bufPos, 0x84, timestamp, 8);
+    bufPos = encodeUInt32(content, bufPos, 0x85, stNum);
+    bufPos = encodeUInt32(content, bufPos, 0x86, sqNum);
+    bufPos = encodeElement(content, bufPos, 0x87, &boolean, 1);
+    bufPos = encodeUInt32(content, bufPos, 0x88, 1);
+    bufPos = encodeElement(content, bufPos, 0x89, &boolean, 1);
+    bufPos = encodeUInt32(content, bufPos, 0x8a, NUMBER_OF_DATA_SET_ENTRIES);
+
+    int allDataLength = encodeAllData(allData, 0, stNum);
+
+    bufPos = encodeElement(content, bufPos, 0xab, allData, allDataLength);
+
+    return encodeElement(buffer, 0, 0x61, content, bufPos);
+}
+
+static uint64_t
+readMmsValues(GooseSubscriber subscriber)
+{
+    MmsValue* dataSetValues = GooseSubscriber_getDataSetValues(subscriber);
+
+    uint64_t sum = 0;
+    int i;
+
+    for (i = 0; i < MmsValue_getArraySize(dataSetValues); i++) {
+        MmsValue* value = MmsValue_getElement(dataSetValues, i);
+
+        switch (MmsValue_getType(value)) {
+        case MMS_BOOLEAN:
+            sum += MmsValue_getBoolean(value);
+            break;
+        case MMS_BIT_STRING:
+            sum += MmsValue_getBitStringAsInteger(value);
+            break;
+        case MMS_INTEGER:
+            sum += MmsValue_toInt32(value);
+            break;
+        case MMS_UNSIGNED:
+            sum += MmsValue_toUint32(value);
+            break;
+        case MMS_FLOAT:
+            sum += (uint64_t) MmsValue_toFloat(value);
+            break;
+        case MMS_UTC_TIME:
+            sum += MmsValue_getUtcTimeInMs(value);
+            break;
+        default:
+            break;
+        }
+    }
+
+    return sum;
+}
+
+static uint64_t
+readSlotValues(GooseSubscriber subscriber)
+{
+    GooseSlotValue* values = GooseSubscriber_getSlotValues(subscriber);
+
+    uint64_t sum = 0;
+    int i;
+
+    for (i = 0; i < NUMBER_OF_DATA_SET_ENTRIES; i++) {
+        switch (layout[i]) {
+        case GOOSE_SLOT_BOOLEAN:
+            sum += values[i].boolean;
+            break;
+        case GOOSE_SLOT_BIT_STRING:
+            sum += values[i].bitString;
+            break;
+        case GOOSE_SLOT_INTEGER:
+            sum += values[i].intValue;
+            break;
+        case GOOSE_SLOT_UNSIGNED:
+            sum += values[i].uintValue;
+            break;
+        case GOOSE_SLOT_FLOAT:
+            sum += (uint64_t) values[i].floatValue;
+            break;
+        case GOOSE_SLOT_TIMESTAMP:
+            sum += values[i].timestamp;
+            break;
+        }
+    }
+
+    return sum;
+}
+
+static void
+printResult(char* name, uint64_t durationInMs, int messages)
+{
+    printf("%-16s %8i messages in %6i ms -> %8.3f us/message\n", name, messages, (int) durationInMs,
+            ((double) durationInMs * 1000.0) / messages);
+}
+
+static void
+runBenchmark(char* name, bool useSlots, uint8_t* buffers[2], int apduLengths[2], int messages)
+{
+    GooseSubscriber subscriber = GooseSubscriber_create(GOCB_REF, NULL);
+
+    if (useSlots)
+        GooseSubscriber_setSlotLayout(subscriber, layout, NUMBER_OF_DATA_SET_ENTRIES);
+
+    uint64_t sum = 0;
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < messages; i++) {
+        int index = i % 2;
+
+        if (!GooseSubscriber_handleMessage(subscriber, buffers[index], apduLengths[index])) {
+            printf("Message not accepted!\n");
+            break;
+        }
+
+        if (useSlots)
+            sum += readSlotValues(subscriber);
+        else
+            sum += readMmsValues(subscriber);
+    }
+
+    printResult(name, Hal_getTimeInMs() - startTime, messages);
+
+    printf("  sum of values: %llu\n", (unsigned long long) sum);
+
+    if (useSlots) {
+        if (GooseSubscriber_isSlotDataValid(subscriber)) {
+            GooseSlotValue* values = GooseSubscriber_getSlotValues(subscriber);
+
+            printf("  slot values: %i %08x %i %u %f %llu checksum: %08x\n", values[0].boolean,
+                    values[1].bitString, values[2].intValue, values[3].uintValue, values[4].floatValue,
+                    (unsigned long long) values[5].timestamp, GooseSubscriber_getSlotChecksum(subscriber));
+        }
+        else
+            printf("  message does not match slot layout!\n");
+    }
+
+    GooseSubscriber_destroy(subscriber);
+}
+
+int
+main(int argc, char** argv)
+{
+    int messages = NUMBER_OF_MESSAGES;
+
+    if (argc > 1)
+        messages = atoi(argv[1]);
+
+    uint8_t message1[1500];
+    uint8_t message2[1500];
+    uint8_t* buffers[2];
+    int apduLengths[2];
+
+    /* retransmissions - all messages contain the same values */
+    buffers[0] = message1;
+    buffers[1] = message1;
+    apduLengths[0] = createMessage(message1, 1, 0);
+    apduLengths[1] = apduLengths[0];
+
+    runBenchmark("MmsValue (rt)", false, buffers, apduLengths, messages);
+    runBenchmark("slots (rt)", true, buffers, apduLengths, messages);
+
+    /* state changes - values change with every message */
+    buffers[1] = message2;
+    apduLengths[1] = createMessage(message2, 2, 0);
+
+    runBenchmark("MmsValue (sc)", false, buffers, apduLengths, messages);
+    runBenchmark("slots (sc)", true, buffers, apduLengths, messages);
+
+    return 0;
+}
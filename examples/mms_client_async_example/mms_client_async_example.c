@@ -0,0 +1,194 @@
+/*
+ *  mms_client_async_example.c
+ *
+ *  This example shows how to use the asynchronous (non-blocking) MMS client functions.
+ *  The names of the domains and variables are requested with asynchronous get name list
+ *  requests, then a variable is read repeatedly with several read requests outstanding
+ *  at the same time. For comparison the same number of reads is done with the blocking
+ *  MmsConnection_readVariable function.
+ *
+ *  Usage: mms_client_async_example [<hostname> [<port> [<reads> [<outstanding requests>]]]]
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *	This file is part of libIEC61850.
+ *
+ *	libIEC61850 is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	libIEC61850 is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	See COPYING file for the complete license text.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "mms_client_connection.h"
+#include "thread.h"
+#include "hal.h"
+
+#define DEFAULT_READS 1000
+#define DEFAULT_OUTSTANDING_REQUESTS 16
+
+static volatile bool nameListReceived = false;
+static char* firstName = NULL;
+
+static volatile int completedReads = 0;
+static volatile int failedReads = 0;
+
+static void
+getNameListHandler(uint32_t invokeId, void* parameter, MmsError mmsError, LinkedList nameList, bool moreFollows)
+{
+    if (mmsError != MMS_ERROR_NONE)
+        printf("get name list request %u failed (error %i)\n", invokeId, mmsError);
+    else {
+        LinkedList element = LinkedList_getNext(nameList);
+
+        if (element != NULL)
+            firstName = strdup((char*) element->data);
+
+        printf("%s: %i names%s\n", (char*) parameter, LinkedList_size(nameList),
+                moreFollows ? " (more follow)" : "");
+
+        LinkedList_destroy(nameList);
+    }
+
+    nameListReceived = true;
+}
+
+static void
+readHandler(uint32_t invokeId, void* parameter, MmsError mmsError, MmsValue* value)
+{
+    if (value != NULL)
+        MmsValue_delete(value);
+    else
+        failedReads++;
+
+    completedReads++;
+}
+
+static char*
+getFirstName(MmsConnection con, char* domainId, MmsObjectClass objectClass, char* label)
+{
+    MmsError mmsError;
+
+    nameListReceived = false;
+    firstName = NULL;
+
+    if (MmsConnection_getNameListAsync(con, &mmsError, domainId, objectClass, false, NULL,
+            getNameListHandler, label) == 0)
+    {
+        printf("Failed to send get name list request (error %i)\n", mmsError);
+        return NULL;
+    }
+
+    /* the response is handled by the receive thread of the connection */
+    while (nameListReceived == false)
+        Thread_sleep(1);
+
+    return firstName;
+}
+
+static void
+readVariable(MmsConnection con, char* domainId, char* itemId, int reads, int window)
+{
+    MmsError mmsError;
+
+    printf("read %s/%s %i times with up to %i outstanding requests\n", domainId, itemId, reads, window);
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int sentReads = 0;
+
+    while (completedReads < reads) {
+        if ((sentReads < reads) && (sentReads - completedReads < window)) {
+            if (MmsConnection_readVariableAsync(con, &mmsError, domainId, itemId, readHandler, NULL) == 0) {
+                printf("Failed to send read request (error %i)\n", mmsError);
+                return;
+            }
+
+            sentReads++;
+        }
+        else
+            Thread_sleep(0);
+    }
+
+    uint64_t asyncDuration = Hal_getTimeInMs() - startTime;
+
+    startTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < reads; i++) {
+        MmsValue* value = MmsConnection_readVariable(con, &mmsError, domainId, itemId);
+
+        if (value == NULL)
+            break;
+
+        MmsValue_delete(value);
+    }
+
+    uint64_t syncDuration = Hal_getTimeInMs() - startTime;
+
+    printf("asynchronous: %i reads (%i failed) in %llu ms\n", completedReads, failedReads,
+            (unsigned long long) asyncDuration);
+    printf("blocking:     %i reads in %llu ms\n", i, (unsigned long long) syncDuration);
+}
+
+int main(int argc, char** argv) {
+
+    char* hostname = "localhost";
+    int tcpPort = 102;
+    int reads = DEFAULT_READS;
+    int window = DEFAULT_OUTSTANDING_REQUESTS;
+
+    if (argc > 1)
+        hostname = argv[1];
+
+    if (argc > 2)
+        tcpPort = atoi(argv[2]);
+
+    if (argc > 3)
+        reads = atoi(argv[3]);
+
+    if (argc > 4)
+        window = atoi(argv[4]);
+
+	MmsConnection con = MmsConnection_create();
+
+	MmsError mmsError;
+
+	if (MmsConnection_connect(con, &mmsError, hostname, tcpPort)) {
+
+	    char* domainId = getFirstName(con, NULL, MMS_DOMAIN_NAMES, "domains");
+
+	    if (domainId != NULL) {
+	        char* itemId = getFirstName(con, domainId, MMS_NAMED_VARIABLE, "variables");
+
+	        if (itemId != NULL) {
+	            readVariable(con, domainId, itemId, reads, window);
+
+	            free(itemId);
+	        }
+
+	        free(domainId);
+	    }
+
+	    MmsConnection_conclude(con, &mmsError);
+	}
+	else
+	    printf("Connect to server failed!\n");
+
+	MmsConnection_destroy(con);
+
+	return 0;
+}
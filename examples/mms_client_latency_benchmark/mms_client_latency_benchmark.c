@@ -0,0 +1,151 @@
+/*
+ *  mms_client_latency_benchmark.c
+ *
+ *  Measures the round-trip time of MMS read requests (from the call of MmsConnection_readVariable
+ *  until the function returns with the value) against a server running in the same process.
+ *
+ *  Usage: mms_client_latency_benchmark [<reads> [<tcp port>]]
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *	This file is part of libIEC61850.
+ *
+ *	libIEC61850 is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	libIEC61850 is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	See COPYING file for the complete license text.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "iec61850_server.h"
+#include "mms_client_connection.h"
+#include "hal.h"
+
+#define DEFAULT_READS 10000
+#define DEFAULT_TCP_PORT 10102
+
+static int
+compareLatencies(const void* a, const void* b)
+{
+    uint64_t latencyA = *((uint64_t*) a);
+    uint64_t latencyB = *((uint64_t*) b);
+
+    if (latencyA < latencyB)
+        return -1;
+    else if (latencyA > latencyB)
+        return 1;
+    else
+        return 0;
+}
+
+static void
+measureReadLatency(MmsConnection con, char* domainId, char* itemId, int reads)
+{
+    uint64_t* latencies = (uint64_t*) malloc(reads * sizeof(uint64_t));
+
+    MmsError mmsError;
+
+    int received = 0;
+    int i;
+
+    uint64_t startTime = Hal_getMonotonicTimeInNs();
+
+    for (i = 0; i < reads; i++) {
+        uint64_t sendTime = Hal_getMonotonicTimeInNs();
+
+        MmsValue* value = MmsConnection_readVariable(con, &mmsError, domainId, itemId);
+
+        if (value == NULL) {
+            printf("read failed (error %i)\n", mmsError);
+            break;
+        }
+
+        latencies[received++] = Hal_getMonotonicTimeInNs() - sendTime;
+
+        MmsValue_delete(value);
+    }
+
+    uint64_t duration = Hal_getMonotonicTimeInNs() - startTime;
+
+    if (received > 0) {
+        uint64_t sum = 0;
+
+        for (i = 0; i < received; i++)
+            sum += latencies[i];
+
+        qsort(latencies, received, sizeof(uint64_t), compareLatencies);
+
+        printf("read round-trip time (us): min %.1f avg %.1f median %.1f 99%% %.1f max %.1f\n",
+                latencies[0] / 1000.0, (double) sum / received / 1000.0, latencies[received / 2] / 1000.0,
+                latencies[(received * 99) / 100] / 1000.0, latencies[received - 1] / 1000.0);
+
+        printf("%i reads in %.1f ms -> %.0f reads/s\n", received, duration / 1000000.0,
+                (double) received * 1e9 / duration);
+    }
+
+    free(latencies);
+}
+
+int main(int argc, char** argv) {
+
+    int reads = DEFAULT_READS;
+    int tcpPort = DEFAULT_TCP_PORT;
+
+    if (argc > 1)
+        reads = atoi(argv[1]);
+
+    if (argc > 2)
+        tcpPort = atoi(argv[2]);
+
+    IedModel* model = IedModel_create("bench");
+
+    LogicalDevice* lDevice = LogicalDevice_create("LD0", model);
+
+    LogicalNode* lln0 = LogicalNode_create("LLN0", lDevice);
+    CDC_ENS_create("Mod", (ModelNode*) lln0, 0);
+
+    LogicalNode* mmxu = LogicalNode_create("MMXU1", lDevice);
+    CDC_SAV_create("TotW", (ModelNode*) mmxu, 0, false);
+
+    IedServer iedServer = IedServer_create(model);
+
+    IedServer_start(iedServer, tcpPort);
+
+    if (!IedServer_isRunning(iedServer)) {
+        printf("Starting server failed! Exit.\n");
+        IedServer_destroy(iedServer);
+        IedModel_destroy(model);
+        return -1;
+    }
+
+    MmsConnection con = MmsConnection_create();
+
+    MmsError mmsError;
+
+    if (MmsConnection_connect(con, &mmsError, "localhost", tcpPort)) {
+        measureReadLatency(con, "benchLD0", "MMXU1$MX$TotW$instMag$f", reads);
+
+        MmsConnection_conclude(con, &mmsError);
+    }
+    else
+        printf("Connect to server failed!\n");
+
+    MmsConnection_destroy(con);
+
+    IedServer_stop(iedServer);
+    IedServer_destroy(iedServer);
+    IedModel_destroy(model);
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * mms_client_polling_benchmark.c
+ *
+ * Polls a variable of a server repeatedly. First every poll creates a new value
+ * (MmsConnection_readVariable), then the same value created from the cached type of the
+ * variable is updated by every poll (MmsConnection_readVariableInto). Prints the time
+ * that is required for both methods.
+ *
+ * Usage: mms_client_polling_benchmark [<hostname> [<port> [<domain> <item> [<polls>]]]]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "mms_client_connection.h"
+#include "hal.h"
+
+#define DEFAULT_POLLS 10000
+
+int
+main(int argc, char** argv)
+{
+    char* hostname = "localhost";
+    int tcpPort = 102;
+    char* domainId = "simpleIOGenericIO";
+    char* itemId = "GGIO1$MX$AnIn1";
+    int polls = DEFAULT_POLLS;
+
+    if (argc > 1)
+        hostname = argv[1];
+
+    if (argc > 2)
+        tcpPort = atoi(argv[2]);
+
+    if (argc > 4) {
+        domainId = argv[3];
+        itemId = argv[4];
+    }
+
+    if (argc > 5)
+        polls = atoi(argv[5]);
+
+    MmsConnection con = MmsConnection_create();
+
+    MmsError error;
+
+    if (!MmsConnection_connect(con, &error, hostname, tcpPort)) {
+        printf("MMS connect failed!\n");
+        MmsConnection_destroy(con);
+        return -1;
+    }
+
+    int i;
+    int failedPolls = 0;
+
+    uint64_t startTime = Hal_getMonotonicTimeInNs();
+
+    for (i = 0; i < polls; i++) {
+        MmsValue* value = MmsConnection_readVariable(con, &error, domainId, itemId);
+
+        if (value != NULL)
+            MmsValue_delete(value);
+        else
+            failedPolls++;
+    }
+
+    uint64_t duration = Hal_getMonotonicTimeInNs() - startTime;
+
+    printf("readVariable: %i polls (%i failed) in %.2f ms\n", polls, failedPolls, duration / 1000000.0);
+
+    MmsValue* value = MmsConnection_createVariableValue(con, &error, domainId, itemId);
+
+    if (value == NULL) {
+        printf("failed to get the type of %s/%s (error %i)\n", domainId, itemId, error);
+        MmsConnection_destroy(con);
+        return -1;
+    }
+
+    failedPolls = 0;
+
+    startTime = Hal_getMonotonicTimeInNs();
+
+    for (i = 0; i < polls; i++) {
+        MmsConnection_readVariableInto(con, &error, domainId, itemId, value);
+
+        if (error != MMS_ERROR_NONE)
+            failedPolls++;
+    }
+
+    duration = Hal_getMonotonicTimeInNs() - startTime;
+
+    printf("readVariableInto: %i polls (%i failed) in %.2f ms\n", polls, failedPolls, duration / 1000000.0);
+
+    char buffer[1024];
+
+    printf("last value: %s\n", MmsValue_printToBuffer(value, buffer, sizeof(buffer)));
+
+    MmsValue_delete(value);
+
+    MmsConnection_destroy(con);
+
+    return 0;
+}
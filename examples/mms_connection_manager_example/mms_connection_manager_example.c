@@ -0,0 +1,259 @@
+/*
+ *  mms_connection_manager_example.c
+ *
+ *  This example shows how to handle many client connections with the MMS connection manager.
+ *  Several servers are started in the same process (each accepts CONFIG_MAXIMUM_TCP_CLIENT_CONNECTIONS
+ *  clients). The connections are established by the connection manager and each connection polls a
+ *  variable with asynchronous read requests. After half of the run time the first server is
+ *  restarted to show that the lost connections are reestablished automatically.
+ *
+ *  Usage: mms_connection_manager_example [<connections> [<seconds> [<I/O threads>]]]
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *	This file is part of libIEC61850.
+ *
+ *	libIEC61850 is free software: you can redistribute it and/or modify
+ *	it under the terms of the GNU General Public License as published by
+ *	the Free Software Foundation, either version 3 of the License, or
+ *	(at your option) any later version.
+ *
+ *	libIEC61850 is distributed in the hope that it will be useful,
+ *	but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *	GNU General Public License for more details.
+ *
+ *	You should have received a copy of the GNU General Public License
+ *	along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *	See COPYING file for the complete license text.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "iec61850_server.h"
+#include "mms_client_connection.h"
+#include "mms_connection_manager.h"
+#include "thread.h"
+#include "hal.h"
+
+#define DEFAULT_CONNECTIONS 100
+#define DEFAULT_SECONDS 10
+#define DEFAULT_IO_THREADS 2
+#define CONNECT_THREADS 4
+
+#define CONNECTIONS_PER_SERVER 4
+#define FIRST_TCP_PORT 10102
+
+/* read requests per connection that are sent before a response is received */
+#define OUTSTANDING_READS 4
+
+#define DOMAIN_ID "benchLD0"
+#define ITEM_ID "MMXU1$MX$TotW$instMag$f"
+
+static Semaphore counterLock;
+static int connectedCount = 0;
+static int establishedEvents = 0;
+static int lostEvents = 0;
+static uint64_t completedReads = 0;
+static uint64_t failedReads = 0;
+
+static void
+countReadResult(bool success)
+{
+    Semaphore_wait(counterLock);
+
+    if (success)
+        completedReads++;
+    else
+        failedReads++;
+
+    Semaphore_post(counterLock);
+}
+
+static void
+readHandler(uint32_t invokeId, void* parameter, MmsError mmsError, MmsValue* value);
+
+static void
+sendReadRequest(MmsConnection con)
+{
+    MmsError mmsError;
+
+    MmsConnection_readVariableAsync(con, &mmsError, DOMAIN_ID, ITEM_ID, readHandler, con);
+}
+
+static void
+readHandler(uint32_t invokeId, void* parameter, MmsError mmsError, MmsValue* value)
+{
+    MmsConnection con = (MmsConnection) parameter;
+
+    countReadResult(value != NULL);
+
+    if (value != NULL) {
+        MmsValue_delete(value);
+
+        /* poll again - sending from the handler doesn't block */
+        sendReadRequest(con);
+    }
+}
+
+static void
+connectionStateHandler(void* parameter, MmsConnection con, bool connected)
+{
+    Semaphore_wait(counterLock);
+
+    if (connected) {
+        connectedCount++;
+        establishedEvents++;
+    }
+    else {
+        connectedCount--;
+        lostEvents++;
+    }
+
+    Semaphore_post(counterLock);
+
+    if (connected) {
+        int i;
+
+        for (i = 0; i < OUTSTANDING_READS; i++)
+            sendReadRequest(con);
+    }
+}
+
+static IedServer
+startServer(IedModel* model, int tcpPort)
+{
+    IedServer iedServer = IedServer_create(model);
+
+    IedServer_start(iedServer, tcpPort);
+
+    if (!IedServer_isRunning(iedServer)) {
+        printf("Starting server on port %i failed!\n", tcpPort);
+        IedServer_destroy(iedServer);
+        return NULL;
+    }
+
+    return iedServer;
+}
+
+static IedModel*
+createModel(void)
+{
+    IedModel* model = IedModel_create("bench");
+
+    LogicalDevice* lDevice = LogicalDevice_create("LD0", model);
+
+    LogicalNode* lln0 = LogicalNode_create("LLN0", lDevice);
+    CDC_ENS_create("Mod", (ModelNode*) lln0, 0);
+
+    LogicalNode* mmxu = LogicalNode_create("MMXU1", lDevice);
+    CDC_SAV_create("TotW", (ModelNode*) mmxu, 0, false);
+
+    return model;
+}
+
+static void
+runConnections(MmsConnectionManager manager, IedServer* servers, int numberOfConnections, int seconds)
+{
+    MmsConnection* connections = (MmsConnection*) calloc(numberOfConnections, sizeof(MmsConnection));
+
+    int i;
+
+    MmsConnectionManager_setReconnectInterval(manager, 500, 5000);
+
+    for (i = 0; i < numberOfConnections; i++) {
+        connections[i] = MmsConnection_create();
+        MmsConnection_setRequestTimeout(connections[i], 1000);
+
+        MmsConnectionManager_addConnection(manager, connections[i], "localhost",
+                FIRST_TCP_PORT + (i / CONNECTIONS_PER_SERVER), connectionStateHandler, NULL);
+    }
+
+    uint64_t lastReads = 0;
+    int second;
+
+    for (second = 1; second <= seconds; second++) {
+        Thread_sleep(1000);
+
+        Semaphore_wait(counterLock);
+        uint64_t reads = completedReads;
+        printf("%2i s: connected %i/%i reads/s %llu failed %llu\n", second, connectedCount, numberOfConnections,
+                (unsigned long long) (reads - lastReads), (unsigned long long) failedReads);
+        Semaphore_post(counterLock);
+
+        lastReads = reads;
+
+        if ((second == seconds / 2) && (servers[0] != NULL)) {
+            printf("restart server on port %i\n", FIRST_TCP_PORT);
+            IedServer_stop(servers[0]);
+            IedServer_start(servers[0], FIRST_TCP_PORT);
+        }
+    }
+
+    printf("connections established: %i lost: %i\n", establishedEvents, lostEvents);
+
+    /* connections have to be removed from the manager before they are destroyed */
+    for (i = 0; i < numberOfConnections; i++) {
+        MmsConnectionManager_removeConnection(manager, connections[i]);
+        MmsConnection_destroy(connections[i]);
+    }
+
+    free(connections);
+}
+
+int main(int argc, char** argv) {
+
+    int numberOfConnections = DEFAULT_CONNECTIONS;
+    int seconds = DEFAULT_SECONDS;
+    int ioThreads = DEFAULT_IO_THREADS;
+
+    if (argc > 1)
+        numberOfConnections = atoi(argv[1]);
+
+    if (argc > 2)
+        seconds = atoi(argv[2]);
+
+    if (argc > 3)
+        ioThreads = atoi(argv[3]);
+
+    int numberOfServers = (numberOfConnections + CONNECTIONS_PER_SERVER - 1) / CONNECTIONS_PER_SERVER;
+
+    IedModel** models = (IedModel**) calloc(numberOfServers, sizeof(IedModel*));
+    IedServer* servers = (IedServer*) calloc(numberOfServers, sizeof(IedServer));
+
+    counterLock = Semaphore_create(1);
+
+    int i;
+
+    for (i = 0; i < numberOfServers; i++) {
+        models[i] = createModel();
+        servers[i] = startServer(models[i], FIRST_TCP_PORT + i);
+    }
+
+    MmsConnectionManager manager = MmsConnectionManager_create(ioThreads, CONNECT_THREADS);
+
+    if (manager != NULL) {
+        runConnections(manager, servers, numberOfConnections, seconds);
+
+        MmsConnectionManager_destroy(manager);
+    }
+    else
+        printf("The connection manager is not supported on this platform!\n");
+
+    for (i = 0; i < numberOfServers; i++) {
+        if (servers[i] != NULL) {
+            IedServer_stop(servers[i]);
+            IedServer_destroy(servers[i]);
+        }
+
+        IedModel_destroy(models[i]);
+    }
+
+    free(models);
+    free(servers);
+
+    Semaphore_destroy(counterLock);
+
+    return 0;
+}
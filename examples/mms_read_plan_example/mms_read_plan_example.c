@@ -0,0 +1,158 @@
+/*
+ * mms_read_plan_example.c
+ *
+ * Reads all variables of a server (the leaves of the variable names of all domains) twice:
+ * once with a read plan and once with a single read request per variable. Prints the
+ * number of requests and the time that is required for both methods.
+ *
+ * Usage: mms_read_plan_example [<hostname> [<port> [<repetitions>]]]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mms_client_connection.h"
+#include "mms_read_plan.h"
+#include "hal.h"
+
+#define DEFAULT_REPETITIONS 10
+
+/* a variable is a leaf if the next variable is not one of its components */
+static bool
+isLeaf(char* variableName, LinkedList next)
+{
+    if (next == NULL)
+        return true;
+
+    int length = strlen(variableName);
+    char* nextName = (char*) next->data;
+
+    if ((strncmp(variableName, nextName, length) == 0) && (nextName[length] == '$'))
+        return false;
+
+    return true;
+}
+
+static MmsReadPlan
+createReadPlan(MmsConnection con)
+{
+    MmsError error;
+
+    MmsReadPlan plan = MmsReadPlan_create();
+
+    LinkedList domains = MmsConnection_getDomainNames(con, &error);
+
+    LinkedList domain = LinkedList_getNext(domains);
+
+    while (domain != NULL) {
+        char* domainId = (char*) domain->data;
+
+        LinkedList variables = MmsConnection_getDomainVariableNames(con, &error, domainId);
+
+        LinkedList variable = LinkedList_getNext(variables);
+
+        while (variable != NULL) {
+            LinkedList next = LinkedList_getNext(variable);
+
+            if (isLeaf((char*) variable->data, next))
+                MmsReadPlan_addVariable(plan, domainId, (char*) variable->data);
+
+            variable = next;
+        }
+
+        LinkedList_destroy(variables);
+
+        domain = LinkedList_getNext(domain);
+    }
+
+    LinkedList_destroy(domains);
+
+    return plan;
+}
+
+static int
+countValidValues(MmsReadPlan plan)
+{
+    int count = 0;
+    int i;
+
+    for (i = 0; i < MmsReadPlan_getSize(plan); i++) {
+        MmsValue* value = MmsReadPlan_getValue(plan, i);
+
+        if ((value != NULL) && (MmsValue_getType(value) != MMS_DATA_ACCESS_ERROR))
+            count++;
+    }
+
+    return count;
+}
+
+int
+main(int argc, char** argv)
+{
+    char* hostname = "localhost";
+    int tcpPort = 102;
+    int repetitions = DEFAULT_REPETITIONS;
+
+    if (argc > 1)
+        hostname = argv[1];
+
+    if (argc > 2)
+        tcpPort = atoi(argv[2]);
+
+    if (argc > 3)
+        repetitions = atoi(argv[3]);
+
+    MmsConnection con = MmsConnection_create();
+
+    MmsError error;
+
+    if (!MmsConnection_connect(con, &error, hostname, tcpPort)) {
+        printf("MMS connect failed!\n");
+        MmsConnection_destroy(con);
+        return -1;
+    }
+
+    MmsReadPlan plan = createReadPlan(con);
+
+    int variables = MmsReadPlan_getSize(plan);
+
+    printf("%i variables, max PDU size %i\n", variables, MmsConnection_getLocalDetail(con));
+
+    int i;
+
+    for (i = 0; i < repetitions; i++) {
+        uint64_t startTime = Hal_getMonotonicTimeInNs();
+
+        int readValues = MmsReadPlan_execute(plan, con, &error);
+
+        uint64_t duration = Hal_getMonotonicTimeInNs() - startTime;
+
+        printf("read plan: %i values (%i valid) with %i requests in %.2f ms (error %i)\n", readValues,
+                countValidValues(plan), MmsReadPlan_getRequestCount(plan), duration / 1000000.0, error);
+    }
+
+    uint64_t startTime = Hal_getMonotonicTimeInNs();
+
+    int readValues = 0;
+
+    for (i = 0; i < variables; i++) {
+        MmsValue* value = MmsConnection_readVariable(con, &error, MmsReadPlan_getDomainId(plan, i),
+                MmsReadPlan_getItemId(plan, i));
+
+        if (value != NULL) {
+            readValues++;
+            MmsValue_delete(value);
+        }
+    }
+
+    uint64_t duration = Hal_getMonotonicTimeInNs() - startTime;
+
+    printf("single reads: %i values with %i requests in %.2f ms\n", readValues, variables, duration / 1000000.0);
+
+    MmsReadPlan_destroy(plan);
+
+    MmsConnection_destroy(con);
+
+    return 0;
+}
@@ -0,0 +1,313 @@
+/*
+ * mms_report_decoder_benchmark.c
+ *
+ * Compares the number of MMS information reports per second that can be decoded by the
+ * asn1c based decoder (ber_decode into the MmsPdu_t structure and conversion into MmsValue
+ * instances) and by the direct BER decoder that is used by the MMS client.
+ *
+ * Two kinds of reports are decoded:
+ *  - IEC 61850 report (named variable list "RPT" with RptID, OptFlds, SeqNum, DatSet,
+ *    inclusion bit string, data values and reason codes)
+ *  - ICCP report (list of domain specific variables with RealQ like values)
+ *
+ * Usage: mms_report_decoder_benchmark [<values per report> [<reports>]]
+ *
+ * The benchmark uses internal functions of the library and has to be linked statically.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mms_client_internal.h"
+#include "mms_access_result.h"
+#include "ber_encoder.h"
+#include "string_utilities.h"
+#include "hal.h"
+
+#define DEFAULT_VALUES_PER_REPORT 20
+#define DEFAULT_REPORTS 100000
+
+#define MAX_MESSAGE_SIZE 65000
+
+typedef MmsValue* (*ReportDecoder) (ByteBuffer* message);
+
+static int
+encodeTLV(uint8_t tag, uint8_t* content, int contentSize, uint8_t* buffer, int bufPos)
+{
+    bufPos = BerEncoder_encodeTL(tag, contentSize, buffer, bufPos);
+    memcpy(buffer + bufPos, content, contentSize);
+
+    return bufPos + contentSize;
+}
+
+static int
+encodeInformationReport(uint8_t* variableAccessSpecification, int variableAccessSpecificationSize,
+        MmsValue** values, int valueCount, uint8_t* buffer)
+{
+    uint8_t* accessResults = (uint8_t*) malloc(MAX_MESSAGE_SIZE);
+    uint8_t* report = (uint8_t*) malloc(MAX_MESSAGE_SIZE);
+
+    int accessResultsSize = 0;
+    int i;
+
+    for (i = 0; i < valueCount; i++)
+        accessResultsSize = mmsServer_encodeAccessResult(values[i], accessResults, accessResultsSize, true);
+
+    memcpy(report, variableAccessSpecification, variableAccessSpecificationSize);
+
+    int reportSize = encodeTLV(0xa0, accessResults, accessResultsSize, report, variableAccessSpecificationSize);
+
+    int unconfirmedServiceSize = encodeTLV(0xa0, report, reportSize, accessResults, 0);
+
+    int messageSize = encodeTLV(0xa3, accessResults, unconfirmedServiceSize, buffer, 0);
+
+    free(report);
+    free(accessResults);
+
+    return messageSize;
+}
+
+static MmsValue*
+createDataValue(int index)
+{
+    MmsValue* mag = MmsValue_createEmptyStructure(1);
+    MmsValue_setElement(mag, 0, MmsValue_newFloat(230.0f + index));
+
+    MmsValue* value = MmsValue_createEmptyStructure(3);
+    MmsValue_setElement(value, 0, mag);
+    MmsValue_setElement(value, 1, MmsValue_newBitString(13));
+    MmsValue_setElement(value, 2, MmsValue_newUtcTimeByMsTime(Hal_getTimeInMs()));
+
+    return value;
+}
+
+static int
+createIec61850Report(int dataValues, uint8_t* buffer)
+{
+    int valueCount = 5 + (2 * dataValues);
+
+    MmsValue** values = (MmsValue**) calloc(valueCount, sizeof(MmsValue*));
+
+    values[0] = MmsValue_newVisibleString("bench/LLN0$RP$Events01");
+    values[1] = MmsValue_newBitString(10);
+    values[2] = MmsValue_newUnsignedFromUint32(4711);
+    values[3] = MmsValue_newVisibleString("bench/LLN0$Measurements");
+    values[4] = MmsValue_newBitString(dataValues);
+
+    int i;
+
+    for (i = 0; i < dataValues; i++) {
+        MmsValue_setBitStringBit(values[4], i, true);
+        values[5 + i] = createDataValue(i);
+        values[5 + dataValues + i] = MmsValue_newBitString(7);
+    }
+
+    uint8_t variableListName[20];
+
+    int nameSize = BerEncoder_encodeStringWithTag(0x80, "RPT", variableListName, 0);
+    int specSize = encodeTLV(0xa1, variableListName, nameSize, variableListName + nameSize, 0);
+
+    int messageSize = encodeInformationReport(variableListName + nameSize, specSize, values, valueCount, buffer);
+
+    for (i = 0; i < valueCount; i++)
+        MmsValue_delete(values[i]);
+
+    free(values);
+
+    return messageSize;
+}
+
+static int
+createIccpReport(int dataValues, uint8_t* buffer)
+{
+    MmsValue** values = (MmsValue**) calloc(dataValues, sizeof(MmsValue*));
+
+    uint8_t* listOfVariables = (uint8_t*) malloc(MAX_MESSAGE_SIZE);
+    uint8_t* element = (uint8_t*) malloc(100);
+    uint8_t* variableSpec = (uint8_t*) malloc(100);
+
+    int listSize = 0;
+    int i;
+
+    for (i = 0; i < dataValues; i++) {
+        char itemId[65];
+
+        sprintf(itemId, "Point_%04i", i);
+
+        int elementSize = BerEncoder_encodeStringWithTag(0x1a, "ICC1", element, 0);
+        elementSize = BerEncoder_encodeStringWithTag(0x1a, itemId, element, elementSize);
+
+        int nameSize = encodeTLV(0xa1, element, elementSize, variableSpec, 0);
+        elementSize = encodeTLV(0xa0, variableSpec, nameSize, element, 0);
+
+        listSize = encodeTLV(0x30, element, elementSize, listOfVariables, listSize);
+
+        values[i] = MmsValue_createEmptyStructure(2);
+        MmsValue_setElement(values[i], 0, MmsValue_newFloat(50.0f + i));
+        MmsValue_setElement(values[i], 1, MmsValue_newBitString(8));
+    }
+
+    uint8_t* spec = (uint8_t*) malloc(MAX_MESSAGE_SIZE);
+
+    int specSize = encodeTLV(0xa0, listOfVariables, listSize, spec, 0);
+
+    int messageSize = encodeInformationReport(spec, specSize, values, dataValues, buffer);
+
+    for (i = 0; i < dataValues; i++)
+        MmsValue_delete(values[i]);
+
+    free(spec);
+    free(variableSpec);
+    free(element);
+    free(listOfVariables);
+    free(values);
+
+    return messageSize;
+}
+
+static MmsValue*
+decodeWithAsn1c(ByteBuffer* message)
+{
+    MmsPdu_t* mmsPdu = 0;
+    MmsValue* values = NULL;
+
+    asn_dec_rval_t rval = ber_decode(NULL, &asn_DEF_MmsPdu,
+            (void**) &mmsPdu, ByteBuffer_getBuffer(message), ByteBuffer_getSize(message));
+
+    if ((rval.code == RC_OK) && (mmsPdu->present == MmsPdu_PR_unconfirmedPDU)) {
+        InformationReport_t* report =
+                &(mmsPdu->choice.unconfirmedPDU.unconfirmedService.choice.informationReport);
+
+        /* create the names like the client did before */
+        if (report->variableAccessSpecification.present == VariableAccessSpecification_PR_variableListName) {
+            char* variableListName = createStringFromBuffer(
+                    report->variableAccessSpecification.choice.variableListName.choice.vmdspecific.buf,
+                    report->variableAccessSpecification.choice.variableListName.choice.vmdspecific.size);
+
+            free(variableListName);
+        }
+        else {
+            LinkedList attributes = LinkedList_create();
+
+            int i;
+
+            for (i = 0; i < report->variableAccessSpecification.choice.listOfVariable.list.count; i++) {
+                VariableSpecification_t* varSpec =
+                        &(report->variableAccessSpecification.choice.listOfVariable.list.array[i]->variableSpecification);
+
+                LinkedList_add(attributes, createStringFromBuffer(varSpec->choice.name.choice.domainspecific.itemId.buf,
+                        varSpec->choice.name.choice.domainspecific.itemId.size));
+            }
+
+            LinkedList_destroy(attributes);
+        }
+
+        values = mmsClient_parseListOfAccessResults(report->listOfAccessResult.list.array,
+                report->listOfAccessResult.list.count, true);
+    }
+
+    asn_DEF_MmsPdu.free_struct(&asn_DEF_MmsPdu, mmsPdu, 0);
+
+    return values;
+}
+
+static MmsValue*
+decodeDirect(ByteBuffer* message)
+{
+    char* domainName;
+    char* variableListName;
+    LinkedList attributes;
+    MmsValue* values;
+
+    if (mmsClient_parseInformationReport(message, &domainName, &variableListName, &attributes, &values)) {
+        if (domainName != NULL)
+            free(domainName);
+
+        if (variableListName != NULL)
+            free(variableListName);
+
+        if (attributes != NULL)
+            LinkedList_destroy(attributes);
+
+        return values;
+    }
+
+    return NULL;
+}
+
+static double
+runDecoder(ReportDecoder decoder, ByteBuffer* message, int reports)
+{
+    uint64_t startTime = Hal_getMonotonicTimeInNs();
+
+    int i;
+
+    for (i = 0; i < reports; i++) {
+        MmsValue* values = decoder(message);
+
+        if (values == NULL) {
+            printf("Failed to decode report!\n");
+            return 0;
+        }
+
+        MmsValue_delete(values);
+    }
+
+    uint64_t duration = Hal_getMonotonicTimeInNs() - startTime;
+
+    if (duration == 0)
+        duration = 1;
+
+    return (double) reports * 1e9 / duration;
+}
+
+static void
+runBenchmark(char* name, uint8_t* buffer, int messageSize, int reports)
+{
+    ByteBuffer message;
+
+    ByteBuffer_wrap(&message, buffer, messageSize, MAX_MESSAGE_SIZE);
+
+    MmsValue* asn1cValues = decodeWithAsn1c(&message);
+    MmsValue* directValues = decodeDirect(&message);
+
+    if ((asn1cValues == NULL) || (directValues == NULL) || !MmsValue_equals(asn1cValues, directValues))
+        printf("%s: decoders return different values!\n", name);
+
+    if (asn1cValues != NULL)
+        MmsValue_delete(asn1cValues);
+
+    if (directValues != NULL)
+        MmsValue_delete(directValues);
+
+    double asn1cRate = runDecoder(decodeWithAsn1c, &message, reports);
+    double directRate = runDecoder(decodeDirect, &message, reports);
+
+    printf("%-16s %6i bytes  asn1c: %9.0f reports/s  direct: %9.0f reports/s  (x%.1f)\n", name, messageSize,
+            asn1cRate, directRate, (asn1cRate > 0) ? directRate / asn1cRate : 0);
+}
+
+int
+main(int argc, char** argv)
+{
+    int dataValues = DEFAULT_VALUES_PER_REPORT;
+    int reports = DEFAULT_REPORTS;
+
+    if (argc > 1)
+        dataValues = atoi(argv[1]);
+
+    if (argc > 2)
+        reports = atoi(argv[2]);
+
+    uint8_t* buffer = (uint8_t*) malloc(MAX_MESSAGE_SIZE);
+
+    printf("%i values per report, %i reports\n", dataValues, reports);
+
+    runBenchmark("IEC 61850 report", buffer, createIec61850Report(dataValues, buffer), reports);
+    runBenchmark("ICCP report", buffer, createIccpReport(dataValues, buffer), reports);
+
+    free(buffer);
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * sv_publisher_example.c
+ *
+ * Simulates a merging unit that publishes 8 channels (4 currents, 4 voltages) with
+ * 4000 samples per second. With more than one ASDU per frame consecutive samples
+ * are sent in a single message. All frames that are due in a cycle are sent with
+ * a single system call (SVPublisher_enqueue/SVPublisher_flush).
+ *
+ * Usage: sv_publisher_example <interface> <ASDUs per frame> <duration in s>
+ *
+ * Has to be started as root in Linux.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sv_publisher.h"
+#include "hal.h"
+
+#define NUMBER_OF_CHANNELS 8
+#define SAMPLES_PER_SECOND 4000
+#define MAX_ASDUS 8
+
+/* triangle wave with 80 samples per period (50 Hz) */
+static int32_t
+getSampleValue(int channel, uint16_t smpCnt)
+{
+    int phase = (smpCnt + (channel % 4) * 27) % 80;
+
+    int32_t value = (phase < 40) ? (phase * 100) - 2000 : 2000 - ((phase - 40) * 100);
+
+    if (channel >= 4)
+        value *= 100; /* voltages */
+
+    return value;
+}
+
+int
+main(int argc, char** argv)
+{
+    char* interface = "eth0";
+    int asduCount = 1;
+    int duration = 1;
+
+    if (argc > 1)
+        interface = argv[1];
+
+    if (argc > 2)
+        asduCount = atoi(argv[2]);
+
+    if (argc > 3)
+        duration = atoi(argv[3]);
+
+    if ((asduCount < 1) || (asduCount > MAX_ASDUS)) {
+        printf("Number of ASDUs has to be between 1 and %i\n", MAX_ASDUS);
+        return -1;
+    }
+
+    SVPublisher publisher = SVPublisher_create(NULL, interface);
+
+    SVPublisher_ASDU asdus[MAX_ASDUS];
+
+    int i;
+
+    for (i = 0; i < asduCount; i++) {
+        asdus[i] = SVPublisher_addASDU(publisher, "MU01", NULL, 1, NUMBER_OF_CHANNELS);
+        SVPublisher_ASDU_setSmpCntWrap(asdus[i], SAMPLES_PER_SECOND);
+        SVPublisher_ASDU_setSmpSynch(asdus[i], 2);
+        SVPublisher_ASDU_setSmpCnt(asdus[i], (uint16_t) i);
+    }
+
+    if (!SVPublisher_setupComplete(publisher)) {
+        printf("Cannot prepare SV message!\n");
+        SVPublisher_destroy(publisher);
+        return -1;
+    }
+
+    int32_t values[NUMBER_OF_CHANNELS];
+
+    int frames = 0;
+    int samples = 0;
+
+    uint64_t startTime = Hal_getTimeInMs();
+    uint64_t currentTime = startTime;
+
+    while (currentTime < startTime + (duration * 1000)) {
+
+        /* send all samples that are due at the current time */
+        int samplesDue = (int) ((currentTime - startTime) * SAMPLES_PER_SECOND / 1000);
+
+        while (samples + asduCount <= samplesDue) {
+            for (i = 0; i < asduCount; i++) {
+                int channel;
+
+                uint16_t smpCnt = SVPublisher_ASDU_getSmpCnt(asdus[i]);
+
+                for (channel = 0; channel < NUMBER_OF_CHANNELS; channel++)
+                    values[channel] = getSampleValue(channel, smpCnt);
+
+                SVPublisher_ASDU_setSamples(asdus[i], values, NULL);
+            }
+
+            if (SVPublisher_enqueue(publisher) == -1) {
+                printf("Error sending message!\n");
+                break;
+            }
+
+            frames++;
+            samples += asduCount;
+
+            /* the next frame starts with the sample after the last ASDU */
+            for (i = 0; i < asduCount; i++) {
+                int step;
+
+                for (step = 0; step < asduCount; step++)
+                    SVPublisher_ASDU_increaseSmpCnt(asdus[i]);
+            }
+        }
+
+        SVPublisher_flush(publisher);
+
+        currentTime = Hal_getTimeInMs();
+    }
+
+    printf("Sent %i frames with %i samples\n", frames, frames * asduCount);
+
+    SVPublisher_destroy(publisher);
+
+    return 0;
+}
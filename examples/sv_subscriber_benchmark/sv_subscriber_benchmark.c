@@ -0,0 +1,253 @@
+/*
+ * sv_subscriber_benchmark.c
+ *
+ * Measures the throughput of the SV subscriber by replaying sampled values messages
+ * from a pcap capture file (or from generated IEC 61850-9-2 LE messages if no file
+ * is given). A second thread consumes the samples from the ring buffer in blocks.
+ *
+ * Usage: sv_subscriber_benchmark [<pcap file> <svID> [<repetitions>]]
+ *
+ * No network interface is required.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sv_subscriber.h"
+#include "pcap_file.h"
+#include "thread.h"
+#include "hal.h"
+
+#define NUMBER_OF_CHANNELS 8
+#define SAMPLES_PER_SECOND 4000
+#define RING_BUFFER_SIZE 4096
+#define BLOCK_SIZE 80
+#define DEFAULT_REPETITIONS 250
+
+#define MAX_FRAME_SIZE 1518
+#define MAX_FRAMES 100000
+
+static uint8_t* frames[MAX_FRAMES];
+static int frameLengths[MAX_FRAMES];
+static int frameCount = 0;
+
+static volatile bool running = true;
+static uint64_t samplesConsumed = 0;
+
+static bool
+readPcapFile(char* fileName)
+{
+    PcapReader reader = PcapReader_open(fileName);
+
+    if (reader == NULL)
+        return false;
+
+    uint8_t buffer[MAX_FRAME_SIZE];
+
+    while (frameCount < MAX_FRAMES) {
+        int frameSize = PcapReader_readFrame(reader, buffer, MAX_FRAME_SIZE, NULL);
+
+        if (frameSize == 0)
+            break;
+
+        if (frameSize == -1) {
+            PcapReader_close(reader);
+            return false;
+        }
+
+        frames[frameCount] = (uint8_t*) malloc(frameSize);
+        memcpy(frames[frameCount], buffer, frameSize);
+
+        frameLengths[frameCount] = frameSize;
+        frameCount++;
+    }
+
+    PcapReader_close(reader);
+
+    return true;
+}
+
+static int
+encodeTL(uint8_t* buffer, int bufPos, uint8_t tag, int length)
+{
+    buffer[bufPos++] = tag;
+
+    if (length > 127) {
+        buffer[bufPos++] = 0x81;
+    }
+
+    buffer[bufPos++] = (uint8_t) length;
+
+    return bufPos;
+}
+
+static int
+encodeUInt32(uint8_t* buffer, int bufPos, uint32_t value)
+{
+    buffer[bufPos++] = (uint8_t) (value >> 24);
+    buffer[bufPos++] = (uint8_t) (value >> 16);
+    buffer[bufPos++] = (uint8_t) (value >> 8);
+    buffer[bufPos++] = (uint8_t) value;
+
+    return bufPos;
+}
+
+/* one second of 9-2 LE messages with one ASDU each */
+static void
+createFrames(char* svID)
+{
+    uint8_t header[] = { 0x01, 0x0c, 0xcd, 0x04, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+                         0x81, 0x00, 0x80, 0x00, 0x88, 0xba, 0x40, 0x00 };
+
+    int svIDLength = strlen(svID);
+    int asduLength = 2 + svIDLength + 4 + 6 + 3 + 2 + (NUMBER_OF_CHANNELS * 8);
+    int seqLength = 2 + asduLength;
+    int pduLength = 3 + 2 + seqLength;
+
+    int smpCnt;
+
+    for (smpCnt = 0; smpCnt < SAMPLES_PER_SECOND; smpCnt++) {
+        uint8_t* frame = (uint8_t*) malloc(MAX_FRAME_SIZE);
+
+        memcpy(frame, header, sizeof(header));
+
+        int bufPos = sizeof(header);
+
+        frame[bufPos++] = 0;
+        frame[bufPos++] = 0; /* length - set below */
+        frame[bufPos++] = 0;
+        frame[bufPos++] = 0;
+        frame[bufPos++] = 0;
+        frame[bufPos++] = 0;
+
+        int payloadStart = bufPos;
+
+        bufPos = encodeTL(frame, bufPos, 0x60, pduLength);
+        bufPos = encodeTL(frame, bufPos, 0x80, 1);
+        frame[bufPos++] = 1;
+        bufPos = encodeTL(frame, bufPos, 0xa2, seqLength);
+        bufPos = encodeTL(frame, bufPos, 0x30, asduLength);
+        bufPos = encodeTL(frame, bufPos, 0x80, svIDLength);
+        memcpy(frame + bufPos, svID, svIDLength);
+        bufPos += svIDLength;
+        bufPos = encodeTL(frame, bufPos, 0x82, 2);
+        frame[bufPos++] = (uint8_t) (smpCnt >> 8);
+        frame[bufPos++] = (uint8_t) smpCnt;
+        bufPos = encodeTL(frame, bufPos, 0x83, 4);
+        bufPos = encodeUInt32(frame, bufPos, 1);
+        bufPos = encodeTL(frame, bufPos, 0x85, 1);
+        frame[bufPos++] = 2;
+        bufPos = encodeTL(frame, bufPos, 0x87, NUMBER_OF_CHANNELS * 8);
+
+        int channel;
+
+        for (channel = 0; channel < NUMBER_OF_CHANNELS; channel++) {
+            bufPos = encodeUInt32(frame, bufPos, (uint32_t) (smpCnt * (channel + 1)));
+            bufPos = encodeUInt32(frame, bufPos, 0);
+        }
+
+        int svLength = bufPos - payloadStart + 8;
+
+        frame[payloadStart - 6] = (uint8_t) (svLength >> 8);
+        frame[payloadStart - 5] = (uint8_t) svLength;
+
+        frames[frameCount] = frame;
+        frameLengths[frameCount] = bufPos;
+        frameCount++;
+    }
+}
+
+static void
+consumerThread(void* parameter)
+{
+    SVSubscriber subscriber = (SVSubscriber) parameter;
+
+    uint16_t smpCnt[BLOCK_SIZE];
+    int32_t values[BLOCK_SIZE * NUMBER_OF_CHANNELS];
+
+    while (true) {
+        int samples = SVSubscriber_readSamples(subscriber, BLOCK_SIZE, smpCnt, NULL, values, NULL);
+
+        if (samples == 0) {
+            if (running == false)
+                break;
+
+            Thread_sleep(0);
+        }
+
+        samplesConsumed += samples;
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    char* svID = "MU01";
+    int repetitions = DEFAULT_REPETITIONS;
+
+    if (argc > 2) {
+        svID = argv[2];
+
+        if (!readPcapFile(argv[1])) {
+            printf("Cannot read pcap file %s\n", argv[1]);
+            return -1;
+        }
+    }
+    else
+        createFrames(svID);
+
+    if (argc > 3)
+        repetitions = atoi(argv[3]);
+
+    printf("Replaying %i frames %i times\n", frameCount, repetitions);
+
+    SVReceiver receiver = SVReceiver_create();
+
+    SVSubscriber subscriber = SVSubscriber_create(svID, NUMBER_OF_CHANNELS, RING_BUFFER_SIZE);
+    SVSubscriber_setSmpCntWrap(subscriber, SAMPLES_PER_SECOND);
+
+    SVReceiver_addSubscriber(receiver, subscriber);
+
+    Thread consumer = Thread_create((ThreadExecutionFunction) consumerThread, subscriber, false);
+    Thread_start(consumer);
+
+    uint64_t startTime = Hal_getTimeInMs();
+
+    int i, j;
+
+    for (i = 0; i < repetitions; i++) {
+        for (j = 0; j < frameCount; j++)
+            SVReceiver_handleMessage(receiver, frames[j], frameLengths[j], 0);
+    }
+
+    uint64_t duration = Hal_getTimeInMs() - startTime;
+
+    running = false;
+    Thread_destroy(consumer);
+
+    SVSubscriberStatistics statistics;
+    SVSubscriber_getStatistics(subscriber, &statistics);
+
+    uint64_t totalFrames = (uint64_t) frameCount * repetitions;
+
+    if (duration == 0)
+        duration = 1;
+
+    printf("%llu frames in %i ms -> %.0f frames/s\n", (unsigned long long) totalFrames, (int) duration,
+            (double) totalFrames * 1000.0 / duration);
+
+    printf("received: %u consumed: %llu gaps: %u missing: %u overflows: %u errors: %u\n",
+            statistics.received, (unsigned long long) samplesConsumed, statistics.gaps,
+            statistics.missing, statistics.overflows, statistics.errors);
+
+    SVReceiver_destroy(receiver);
+    SVSubscriber_destroy(subscriber);
+
+    for (i = 0; i < frameCount; i++)
+        free(frames[i]);
+
+    return 0;
+}
@@ -18,6 +18,8 @@ INCLUDES += -I$(LIBIEC_HOME)/src/iedserver
 INCLUDES += -I$(LIBIEC_HOME)/src/iedclient
 INCLUDES += -I$(LIBIEC_HOME)/src/hal
 INCLUDES += -I$(LIBIEC_HOME)/src/hal/thread
+INCLUDES += -I$(LIBIEC_HOME)/src/hal/ethernet
 INCLUDES += -I$(LIBIEC_HOME)/src/hal/socket
 INCLUDES += -I$(LIBIEC_HOME)/src/hal/filesystem
 INCLUDES += -I$(LIBIEC_HOME)/src/goose
+INCLUDES += -I$(LIBIEC_HOME)/src/sampled_values
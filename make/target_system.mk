@@ -110,6 +110,13 @@ endif
 
 LDLIBS = -lpthread
 
+# shared memory frame bus of the loopback ethernet HAL (make ETHERNET_LOOPBACK=1)
+ifdef ETHERNET_LOOPBACK
+ifneq ($(TARGET), BSD)
+LDLIBS += -lrt
+endif
+endif
+
 ifeq ($(TARGET), LINUX-MIPSEL)
 LIB_OBJS_DIR = $(LIBIEC_HOME)/build-mipsel
 else ifeq ($(TARGET), LINUX-ARM)
@@ -57,6 +57,30 @@ struct sGoosePublisher {
     bool simulation;
 
     MmsValue* timestamp; /* time when stNum is increased */
+
+    /* encoded frame that is reused for retransmissions */
+    bool frameValid;
+    LinkedList frameDataSet;
+    int32_t payloadLength;
+    int32_t timeAllowedToLivePos; /* position of the encoded values inside the payload */
+    int32_t sqNumPos;
+
+    char* interfaceId;
+
+    PcapWriter captureFile;
+    bool captureOnly; /* write the frames to the capture file without sending them */
+};
+
+struct sGooseTransmitQueue {
+    EthernetSocket ethernetSocket;
+    char* interfaceId;
+
+    int maxMessages;
+    int messageCount;
+
+    uint8_t* frames; /* maxMessages frame buffers of GOOSE_MAX_MESSAGE_SIZE bytes */
+    uint8_t** frameBuffers;
+    int* frameSizes;
 };
 
 
@@ -77,7 +101,8 @@ GoosePublisher_create(CommParameters* parameters, char* interfaceID)
 void
 GoosePublisher_destroy(GoosePublisher self)
 {
-    Ethernet_destroySocket(self->ethernetSocket);
+    if (self->ethernetSocket != NULL)
+        Ethernet_destroySocket(self->ethernetSocket);
 
     MmsValue_delete(self->timestamp);
 
@@ -90,6 +115,7 @@ GoosePublisher_destroy(GoosePublisher self)
     if (self->dataSetRef != NULL)
         free(self->dataSetRef);
 
+    free(self->interfaceId);
     free(self->buffer);
     free(self);
 }
@@ -98,36 +124,42 @@ void
 GoosePublisher_setGoID(GoosePublisher self, char* goID)
 {
     self->goID = copyString(goID);
+    self->frameValid = false;
 }
 
 void
 GoosePublisher_setGoCbRef(GoosePublisher self, char* goCbRef)
 {
     self->goCBRef = copyString(goCbRef);
+    self->frameValid = false;
 }
 
 void
 GoosePublisher_setDataSetRef(GoosePublisher self, char* dataSetRef)
 {
     self->dataSetRef = copyString(dataSetRef);
+    self->frameValid = false;
 }
 
 void
 GoosePublisher_setConfRev(GoosePublisher self, uint32_t confRev)
 {
     self->confRev = confRev;
+    self->frameValid = false;
 }
 
 void
 GoosePublisher_setSimulation(GoosePublisher self, bool simulation)
 {
     self->simulation = simulation;
+    self->frameValid = false;
 }
 
 void
 GoosePublisher_setNeedsCommission(GoosePublisher self, bool ndsCom)
 {
     self->needsCommission = ndsCom;
+    self->frameValid = false;
 }
 
 uint64_t
@@ -139,6 +171,7 @@ GoosePublisher_increaseStNum(GoosePublisher self)
 
     self->stNum++;
     self->sqNum = 0;
+    self->frameValid = false;
 
     return currentTime;
 }
@@ -147,6 +180,7 @@ void
 GoosePublisher_reset(GoosePublisher self) {
     self->sqNum = 0;
     self->stNum = 1;
+    self->frameValid = false;
 }
 
 void
@@ -186,9 +220,11 @@ prepareGooseBuffer(GoosePublisher self, CommParameters* parameters, char* interf
     }
 
     if (interfaceID != NULL)
-        self->ethernetSocket = Ethernet_createSocket(interfaceID, dstAddr);
+        self->interfaceId = copyString(interfaceID);
     else
-        self->ethernetSocket = Ethernet_createSocket(CONFIG_ETHERNET_INTERFACE_ID, dstAddr);
+        self->interfaceId = copyString(CONFIG_ETHERNET_INTERFACE_ID);
+
+    self->ethernetSocket = Ethernet_createSocket(self->interfaceId, dstAddr);
 
     self->buffer = (uint8_t*) malloc(GOOSE_MAX_MESSAGE_SIZE);
 
@@ -295,6 +331,7 @@ createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffe
     bufPos = BerEncoder_encodeStringWithTag(0x80, self->goCBRef, buffer, bufPos);
 
     /* Encode timeAllowedToLive */
+    self->timeAllowedToLivePos = bufPos + 2;
     bufPos = BerEncoder_encodeUInt32WithTL(0x81, timeAllowedToLive, buffer, bufPos);
 
     /* Encode datSet reference */
@@ -311,6 +348,7 @@ createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffe
     bufPos = BerEncoder_encodeUInt32WithTL(0x85, self->stNum, buffer, bufPos);
 
     /* Encode sqNum */
+    self->sqNumPos = bufPos + 2;
     bufPos = BerEncoder_encodeUInt32WithTL(0x86, self->sqNum, buffer, bufPos);
 
     /* Encode simulation */
@@ -342,14 +380,47 @@ createGoosePayload(GoosePublisher self, LinkedList dataSetValues, uint8_t* buffe
     return bufPos;
 }
 
-int
-GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
+/* replace an encoded unsigned integer if the new value has the same encoded size */
+static bool
+patchUInt32(uint8_t* buffer, int32_t valuePos, uint32_t value)
+{
+    if (BerEncoder_UInt32determineEncodedSize(value) != buffer[valuePos - 1])
+        return false;
+
+    BerEncoder_encodeUInt32(value, buffer, valuePos);
+
+    return true;
+}
+
+/* encode the next message into the frame buffer - returns the frame size or -1 */
+static int
+encodeMessage(GoosePublisher self, LinkedList dataSet)
 {
     uint8_t* buffer = self->buffer + self->payloadStart;
 
     size_t maxPayloadSize = GOOSE_MAX_MESSAGE_SIZE - self->payloadStart;
 
-    int32_t payloadLength = createGoosePayload(self, dataSet, buffer, maxPayloadSize);
+    /* Retransmissions only differ in sqNum and timeAllowedToLive from the last sent
+     * message. Data set values are encoded again after the state number has changed. */
+    if (self->frameValid && (self->frameDataSet == dataSet)) {
+        if (!patchUInt32(buffer, self->sqNumPos, self->sqNum))
+            self->frameValid = false;
+        else if (!patchUInt32(buffer, self->timeAllowedToLivePos, self->timeAllowedToLive))
+            self->frameValid = false;
+    }
+    else
+        self->frameValid = false;
+
+    if (self->frameValid == false) {
+        self->payloadLength = createGoosePayload(self, dataSet, buffer, maxPayloadSize);
+
+        if (self->payloadLength != -1) {
+            self->frameValid = true;
+            self->frameDataSet = dataSet;
+        }
+    }
+
+    int32_t payloadLength = self->payloadLength;
 
     self->sqNum++;
 
@@ -363,7 +434,122 @@ GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
     self->buffer[lengthIndex] = gooseLength / 256;
     self->buffer[lengthIndex + 1] = gooseLength & 0xff;
 
-    Ethernet_sendPacket(self->ethernetSocket, self->buffer, self->payloadStart + payloadLength);
+    return self->payloadStart + payloadLength;
+}
+
+void
+GoosePublisher_setCaptureFile(GoosePublisher self, PcapWriter captureFile, bool captureOnly)
+{
+    self->captureFile = captureFile;
+    self->captureOnly = captureOnly;
+}
+
+int
+GoosePublisher_publish(GoosePublisher self, LinkedList dataSet)
+{
+    int frameSize = encodeMessage(self, dataSet);
+
+    if (frameSize == -1)
+        return -1;
+
+    if (self->captureFile != NULL) {
+        PcapWriter_writeFrame(self->captureFile, self->buffer, frameSize, Hal_getTimeInNs());
+
+        if (self->captureOnly)
+            return 0;
+    }
+
+    if (self->ethernetSocket == NULL)
+        return -1;
+
+    Ethernet_sendPacket(self->ethernetSocket, self->buffer, frameSize);
+
+    return 0;
+}
+
+int
+GoosePublisher_enqueue(GoosePublisher self, LinkedList dataSet, GooseTransmitQueue queue)
+{
+    /* messages for other interfaces cannot be sent with the socket of the queue */
+    if ((strcmp(self->interfaceId, queue->interfaceId) != 0) || (self->captureFile != NULL))
+        return GoosePublisher_publish(self, dataSet);
+
+    int frameSize = encodeMessage(self, dataSet);
+
+    if (frameSize == -1)
+        return -1;
+
+    if (queue->messageCount == queue->maxMessages)
+        GooseTransmitQueue_flush(queue);
+
+    uint8_t* frame = queue->frameBuffers[queue->messageCount];
+
+    memcpy(frame, self->buffer, frameSize);
+
+    queue->frameSizes[queue->messageCount] = frameSize;
+    queue->messageCount++;
 
     return 0;
 }
+
+GooseTransmitQueue
+GooseTransmitQueue_create(char* interfaceId, int maxMessages)
+{
+    uint8_t dstAddr[] = CONFIG_GOOSE_DEFAULT_DST_ADDRESS;
+
+    if (interfaceId == NULL)
+        interfaceId = CONFIG_ETHERNET_INTERFACE_ID;
+
+    EthernetSocket ethernetSocket = Ethernet_createSocket(interfaceId, dstAddr);
+
+    if (ethernetSocket == NULL)
+        return NULL;
+
+    if (maxMessages < 1)
+        maxMessages = 1;
+
+    GooseTransmitQueue self = (GooseTransmitQueue) calloc(1, sizeof(struct sGooseTransmitQueue));
+
+    self->ethernetSocket = ethernetSocket;
+    self->interfaceId = copyString(interfaceId);
+    self->maxMessages = maxMessages;
+
+    self->frames = (uint8_t*) malloc(maxMessages * GOOSE_MAX_MESSAGE_SIZE);
+    self->frameBuffers = (uint8_t**) malloc(maxMessages * sizeof(uint8_t*));
+    self->frameSizes = (int*) malloc(maxMessages * sizeof(int));
+
+    int i;
+
+    for (i = 0; i < maxMessages; i++)
+        self->frameBuffers[i] = self->frames + (i * GOOSE_MAX_MESSAGE_SIZE);
+
+    return self;
+}
+
+int
+GooseTransmitQueue_flush(GooseTransmitQueue self)
+{
+    if (self->messageCount == 0)
+        return 0;
+
+    int sent = Ethernet_sendPackets(self->ethernetSocket, self->frameBuffers, self->frameSizes,
+            self->messageCount);
+
+    self->messageCount = 0;
+
+    return sent;
+}
+
+void
+GooseTransmitQueue_destroy(GooseTransmitQueue self)
+{
+    GooseTransmitQueue_flush(self);
+
+    Ethernet_destroySocket(self->ethernetSocket);
+
+    free(self->interfaceId);
+    free(self->frames);
+    free(self->frameBuffers);
+    free(self->frameSizes);
+    free(self);
+}
@@ -26,6 +26,7 @@
 
 #include "linked_list.h"
 #include "mms_value.h"
+#include "pcap_file.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,15 +41,80 @@ typedef struct sCommParameters {
 
 typedef struct sGoosePublisher* GoosePublisher;
 
+typedef struct sGooseTransmitQueue* GooseTransmitQueue;
+
 GoosePublisher
 GoosePublisher_create(CommParameters* parameters, char* interfaceID);
 
 void
 GoosePublisher_destroy(GoosePublisher self);
 
+/**
+ * \brief send a GOOSE message with the values of the data set
+ *
+ * The encoded message is kept and only sqNum and timeAllowedToLive are updated for
+ * retransmissions. The data set values are encoded again after GoosePublisher_increaseStNum
+ * or GoosePublisher_reset have been called or when a different data set is passed.
+ *
+ * \return 0 on success, -1 if the message does not fit into an ethernet frame
+ */
 int
 GoosePublisher_publish(GoosePublisher self, LinkedList dataSet);
 
+/**
+ * \brief encode a GOOSE message like GoosePublisher_publish but add it to a transmit queue
+ *
+ * The message is sent together with the other queued messages by GooseTransmitQueue_flush.
+ * Messages of publishers of a different interface than the queue are sent immediately.
+ *
+ * \return 0 on success, -1 if the message does not fit into an ethernet frame
+ */
+int
+GoosePublisher_enqueue(GoosePublisher self, LinkedList dataSet, GooseTransmitQueue queue);
+
+/**
+ * \brief Create a queue to send the messages of multiple GOOSE publishers in a single batch.
+ *
+ * The queue uses its own ethernet socket and a copy of the queued frames. It has to be
+ * used by a single thread. When the queue is full the queued messages are sent before a
+ * new message is added.
+ *
+ * \param interfaceId the ethernet interface or NULL to use the default interface
+ * \param maxMessages maximum number of messages sent with a single flush
+ *
+ * \return the new queue or NULL if the ethernet socket cannot be created
+ */
+GooseTransmitQueue
+GooseTransmitQueue_create(char* interfaceId, int maxMessages);
+
+/**
+ * \brief send all queued messages
+ *
+ * \return the number of messages sent
+ */
+int
+GooseTransmitQueue_flush(GooseTransmitQueue self);
+
+/**
+ * \brief send the queued messages and release all resources of the queue
+ */
+void
+GooseTransmitQueue_destroy(GooseTransmitQueue self);
+
+/**
+ * \brief Write all messages of the publisher to a pcap capture file.
+ *
+ * Each message is written with the current time when it is published. Messages that are
+ * queued with GoosePublisher_enqueue are published directly while a capture file is set. In
+ * capture only mode the messages are not sent, so no privileges are required to create
+ * capture files for replay and benchmarks.
+ *
+ * \param captureFile the capture file or NULL to stop capturing
+ * \param captureOnly write the messages to the file without sending them
+ */
+void
+GoosePublisher_setCaptureFile(GoosePublisher self, PcapWriter captureFile, bool captureOnly);
+
 void
 GoosePublisher_setGoID(GoosePublisher self, char* goID);
 
@@ -0,0 +1,900 @@
+/*
+ *  goose_receiver.c
+ *
+ *  Copyright 2014 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+
+#include "stack_config.h"
+#include "goose_receiver.h"
+#include "goose_receiver_internal.h"
+#include "ethernet.h"
+#include "thread.h"
+#include "linked_list.h"
+
+#include "ber_decode.h"
+
+#define ETH_P_GOOSE 0x88b8
+
+/* number of hash buckets used to find the subscribers of a gocbRef */
+#define GOOSE_RECEIVER_HASH_TABLE_SIZE 64
+
+/* maximum time in ms the receiver thread waits for new frames before checking for a stop request */
+#define GOOSE_RECEIVER_WAIT_TIMEOUT 100
+
+/* maximum number of APPIDs and MAC addresses checked by the kernel frame filter */
+#define GOOSE_RECEIVER_MAX_FILTER_ENTRIES 256
+
+/* initial capacity of the deadline heap */
+#define GOOSE_RECEIVER_HEAP_SIZE 64
+
+/* maximum number of redundant interfaces (e.g. LAN A and LAN B) */
+#define GOOSE_RECEIVER_MAX_INTERFACES 4
+
+/* flags of the callbacks that are pending for a subscriber */
+#define GOOSE_CALLBACK_LISTENER 1
+#define GOOSE_CALLBACK_RECOVERED 2
+#define GOOSE_CALLBACK_TIMEOUT 4
+
+typedef struct {
+    GooseReceiver receiver;
+    char* interfaceId;
+    EthernetSocket ethSocket;
+    Thread thread;
+} GooseReceiverInterface;
+
+struct sGooseReceiver {
+    bool running;
+
+    /* each interface has its own socket and receiver thread */
+    GooseReceiverInterface interfaces[GOOSE_RECEIVER_MAX_INTERFACES];
+    int interfaceCount;
+
+    /* serializes the processing of messages and timeouts including the callbacks */
+    Semaphore dispatchMutex;
+
+    /* thread that is running a user callback - protected by the subscriber mutex */
+    bool callbackRunning;
+    ThreadId callbackThread;
+
+    /* protects the subscriber table and the heap - not held while user callbacks are running */
+    Semaphore subscriberMutex;
+    LinkedList subscriberTable[GOOSE_RECEIVER_HASH_TABLE_SIZE];
+
+    /* binary min-heap of the supervised subscribers ordered by deadline - protected by the subscriber mutex */
+    GooseSubscriber* supervisionHeap;
+    int supervisionHeapSize;
+    int supervisionHeapCapacity;
+
+    GooseSupervisionHandler supervisionHandler;
+    void* supervisionHandlerParameter;
+};
+
+/* FNV-1a hash of the gocbRef */
+static uint32_t
+getHashIndex(uint8_t* goCbRef, int length)
+{
+    uint32_t hash = 2166136261U;
+
+    int i;
+    for (i = 0; i < length; i++) {
+        hash ^= goCbRef[i];
+        hash *= 16777619U;
+    }
+
+    return hash % GOOSE_RECEIVER_HASH_TABLE_SIZE;
+}
+
+GooseReceiver
+GooseReceiver_create()
+{
+    GooseReceiver self = (GooseReceiver) calloc(1, sizeof(struct sGooseReceiver));
+
+    self->dispatchMutex = Semaphore_create(1);
+    self->subscriberMutex = Semaphore_create(1);
+
+    int i;
+    for (i = 0; i < GOOSE_RECEIVER_HASH_TABLE_SIZE; i++)
+        self->subscriberTable[i] = LinkedList_create();
+
+    return self;
+}
+
+static void
+freeInterfaceIds(GooseReceiver self)
+{
+    int i;
+
+    for (i = 0; i < self->interfaceCount; i++)
+        free(self->interfaces[i].interfaceId);
+
+    self->interfaceCount = 0;
+}
+
+void
+GooseReceiver_setInterfaceId(GooseReceiver self, char* interfaceId)
+{
+    freeInterfaceIds(self);
+
+    GooseReceiver_addInterfaceId(self, interfaceId);
+}
+
+bool
+GooseReceiver_addInterfaceId(GooseReceiver self, char* interfaceId)
+{
+    if (self->interfaceCount == GOOSE_RECEIVER_MAX_INTERFACES)
+        return false;
+
+    GooseReceiverInterface* receiverInterface = &(self->interfaces[self->interfaceCount++]);
+
+    receiverInterface->receiver = self;
+    receiverInterface->interfaceId = copyString(interfaceId);
+
+    return true;
+}
+
+/* Let the kernel drop frames with APPIDs and destination addresses no subscriber is interested in.
+ * Has to be called with the subscriber mutex locked. */
+static void
+updateFrameFilter(GooseReceiver self)
+{
+    uint16_t appIds[GOOSE_RECEIVER_MAX_FILTER_ENTRIES];
+    uint8_t dstAddresses[GOOSE_RECEIVER_MAX_FILTER_ENTRIES * 6];
+    int appIdCount = 0;
+    int dstAddressCount = 0;
+    bool filterAppIds = true;
+    bool filterDstAddresses = true;
+    int i, j;
+
+    for (i = 0; i < GOOSE_RECEIVER_HASH_TABLE_SIZE; i++) {
+        LinkedList element = LinkedList_getNext(self->subscriberTable[i]);
+
+        while (element != NULL) {
+            GooseSubscriber subscriber = (GooseSubscriber) element->data;
+
+            int32_t appId = private_GooseSubscriber_getAppId(subscriber);
+            uint8_t* dstMac = private_GooseSubscriber_getDstMac(subscriber);
+
+            if (filterAppIds) {
+                if (appId < 0)
+                    filterAppIds = false;
+                else {
+                    for (j = 0; j < appIdCount; j++)
+                        if (appIds[j] == (uint16_t) appId)
+                            break;
+
+                    if (j == appIdCount) {
+                        if (appIdCount < GOOSE_RECEIVER_MAX_FILTER_ENTRIES)
+                            appIds[appIdCount++] = (uint16_t) appId;
+                        else
+                            filterAppIds = false;
+                    }
+                }
+            }
+
+            if (filterDstAddresses) {
+                if (dstMac == NULL)
+                    filterDstAddresses = false;
+                else {
+                    for (j = 0; j < dstAddressCount; j++)
+                        if (memcmp(dstAddresses + (j * 6), dstMac, 6) == 0)
+                            break;
+
+                    if (j == dstAddressCount) {
+                        if (dstAddressCount < GOOSE_RECEIVER_MAX_FILTER_ENTRIES)
+                            memcpy(dstAddresses + (dstAddressCount++ * 6), dstMac, 6);
+                        else
+                            filterDstAddresses = false;
+                    }
+                }
+            }
+
+            element = LinkedList_getNext(element);
+        }
+    }
+
+    if (filterAppIds == false)
+        appIdCount = 0;
+
+    if (filterDstAddresses == false)
+        dstAddressCount = 0;
+
+    for (i = 0; i < self->interfaceCount; i++) {
+        EthernetSocket ethSocket = self->interfaces[i].ethSocket;
+
+        if (ethSocket == NULL)
+            continue;
+
+        if (!Ethernet_setFrameFilter(ethSocket, ETH_P_GOOSE, appIds, appIdCount, dstAddresses, dstAddressCount))
+            if (DEBUG_GOOSE_SUBSCRIBER)
+                printf("GOOSE_RECEIVER: frame filter not supported - filtering in user space\n");
+    }
+}
+
+static uint64_t
+getTimeInMs(void)
+{
+    return Hal_getMonotonicTimeInNs() / 1000000;
+}
+
+static void
+heapSet(GooseReceiver self, int index, GooseSubscriber subscriber)
+{
+    self->supervisionHeap[index] = subscriber;
+    private_GooseSubscriber_getSupervisionState(subscriber)->heapIndex = index;
+}
+
+static uint64_t
+heapDeadline(GooseReceiver self, int index)
+{
+    return private_GooseSubscriber_getSupervisionState(self->supervisionHeap[index])->deadline;
+}
+
+static void
+heapSiftUp(GooseReceiver self, int index)
+{
+    GooseSubscriber subscriber = self->supervisionHeap[index];
+    uint64_t deadline = private_GooseSubscriber_getSupervisionState(subscriber)->deadline;
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (heapDeadline(self, parent) <= deadline)
+            break;
+
+        heapSet(self, index, self->supervisionHeap[parent]);
+        index = parent;
+    }
+
+    heapSet(self, index, subscriber);
+}
+
+static void
+heapSiftDown(GooseReceiver self, int index)
+{
+    GooseSubscriber subscriber = self->supervisionHeap[index];
+    uint64_t deadline = private_GooseSubscriber_getSupervisionState(subscriber)->deadline;
+
+    while (true) {
+        int child = (2 * index) + 1;
+
+        if (child >= self->supervisionHeapSize)
+            break;
+
+        if ((child + 1 < self->supervisionHeapSize) && (heapDeadline(self, child + 1) < heapDeadline(self, child)))
+            child++;
+
+        if (deadline <= heapDeadline(self, child))
+            break;
+
+        heapSet(self, index, self->supervisionHeap[child]);
+        index = child;
+    }
+
+    heapSet(self, index, subscriber);
+}
+
+static void
+heapRemove(GooseReceiver self, GooseSubscriber subscriber)
+{
+    GooseSupervisionState* state = private_GooseSubscriber_getSupervisionState(subscriber);
+
+    int index = state->heapIndex;
+
+    state->heapIndex = -1;
+
+    self->supervisionHeapSize--;
+
+    if (index == self->supervisionHeapSize)
+        return;
+
+    /* move the last element to the free position and restore the heap order */
+    GooseSubscriber moved = self->supervisionHeap[self->supervisionHeapSize];
+
+    heapSet(self, index, moved);
+    heapSiftUp(self, index);
+    heapSiftDown(self, private_GooseSubscriber_getSupervisionState(moved)->heapIndex);
+}
+
+/* restart the supervision of a subscriber after a message has been accepted - called with the subscriber mutex locked */
+static void
+superviseSubscriber(GooseReceiver self, GooseSubscriber subscriber)
+{
+    GooseSupervisionState* state = private_GooseSubscriber_getSupervisionState(subscriber);
+
+    uint32_t timeAllowedToLive = GooseSubscriber_getTimeAllowedToLive(subscriber);
+
+    if (timeAllowedToLive == 0) {
+        if (state->heapIndex != -1)
+            heapRemove(self, subscriber);
+    }
+    else {
+        uint64_t oldDeadline = state->deadline;
+
+        state->deadline = getTimeInMs() + timeAllowedToLive;
+
+        if (state->heapIndex == -1) {
+            if (self->supervisionHeapSize == self->supervisionHeapCapacity) {
+                self->supervisionHeapCapacity = (self->supervisionHeapCapacity == 0) ?
+                        GOOSE_RECEIVER_HEAP_SIZE : self->supervisionHeapCapacity * 2;
+
+                self->supervisionHeap = (GooseSubscriber*) realloc(self->supervisionHeap,
+                        self->supervisionHeapCapacity * sizeof(GooseSubscriber));
+            }
+
+            self->supervisionHeap[self->supervisionHeapSize] = subscriber;
+            heapSiftUp(self, self->supervisionHeapSize++);
+        }
+        else if (state->deadline < oldDeadline)
+            heapSiftUp(self, state->heapIndex);
+        else
+            heapSiftDown(self, state->heapIndex);
+    }
+
+    if (state->timedOut) {
+        state->timedOut = false;
+        state->pendingCallbacks |= GOOSE_CALLBACK_RECOVERED;
+    }
+}
+
+/* call the pending callbacks of the subscribers of a hash table bucket - called with the dispatch mutex locked */
+static void
+invokePendingCallbacks(GooseReceiver self, int index)
+{
+    while (true) {
+        GooseSubscriber subscriber = NULL;
+        uint8_t callbacks = 0;
+
+        Semaphore_wait(self->subscriberMutex);
+
+        /* search again after each callback - the callbacks can add and remove subscribers */
+        LinkedList element = LinkedList_getNext(self->subscriberTable[index]);
+
+        while (element != NULL) {
+            GooseSupervisionState* state = private_GooseSubscriber_getSupervisionState((GooseSubscriber) element->data);
+
+            if (state->pendingCallbacks != 0) {
+                subscriber = (GooseSubscriber) element->data;
+                callbacks = state->pendingCallbacks;
+                state->pendingCallbacks = 0;
+                break;
+            }
+
+            element = LinkedList_getNext(element);
+        }
+
+        GooseSupervisionHandler handler = self->supervisionHandler;
+        void* handlerParameter = self->supervisionHandlerParameter;
+
+        self->callbackRunning = (subscriber != NULL);
+        self->callbackThread = Thread_getCurrentId();
+
+        Semaphore_post(self->subscriberMutex);
+
+        if (subscriber == NULL)
+            break;
+
+        if (callbacks & GOOSE_CALLBACK_LISTENER)
+            private_GooseSubscriber_notifyListener(subscriber);
+
+        if (handler != NULL) {
+            if (callbacks & GOOSE_CALLBACK_RECOVERED)
+                handler(subscriber, GOOSE_SUPERVISION_RECOVERED, handlerParameter);
+
+            if (callbacks & GOOSE_CALLBACK_TIMEOUT)
+                handler(subscriber, GOOSE_SUPERVISION_TIMEOUT, handlerParameter);
+        }
+    }
+}
+
+void
+GooseReceiver_setSupervisionHandler(GooseReceiver self, GooseSupervisionHandler handler, void* parameter)
+{
+    Semaphore_wait(self->subscriberMutex);
+
+    self->supervisionHandler = handler;
+    self->supervisionHandlerParameter = parameter;
+
+    Semaphore_post(self->subscriberMutex);
+}
+
+int
+GooseReceiver_checkTimeouts(GooseReceiver self)
+{
+    int timeToNextDeadline = -1;
+    bool timedOut = false;
+
+    Semaphore_wait(self->dispatchMutex);
+    Semaphore_wait(self->subscriberMutex);
+
+    if (self->supervisionHeapSize > 0) {
+        uint64_t currentTime = getTimeInMs();
+
+        while ((self->supervisionHeapSize > 0) && (heapDeadline(self, 0) <= currentTime)) {
+            GooseSubscriber subscriber = self->supervisionHeap[0];
+            GooseSupervisionState* state = private_GooseSubscriber_getSupervisionState(subscriber);
+
+            heapRemove(self, subscriber);
+
+            state->timedOut = true;
+            state->timeouts++;
+            state->pendingCallbacks |= GOOSE_CALLBACK_TIMEOUT;
+            timedOut = true;
+
+            /* a restarted publisher starts again with the same sequence numbers */
+            private_GooseSubscriber_getDuplicateWindow(subscriber)->valid = false;
+
+            if (DEBUG_GOOSE_SUBSCRIBER)
+                printf("GOOSE_RECEIVER: timeout of %s\n", private_GooseSubscriber_getGoCbRef(subscriber));
+        }
+
+        if (self->supervisionHeapSize > 0)
+            timeToNextDeadline = (int) (heapDeadline(self, 0) - currentTime);
+    }
+
+    Semaphore_post(self->subscriberMutex);
+
+    if (timedOut) {
+        int i;
+
+        for (i = 0; i < GOOSE_RECEIVER_HASH_TABLE_SIZE; i++)
+            invokePendingCallbacks(self, i);
+    }
+
+    Semaphore_post(self->dispatchMutex);
+
+    return timeToNextDeadline;
+}
+
+void
+GooseReceiver_addSubscriber(GooseReceiver self, GooseSubscriber subscriber)
+{
+    int index = getHashIndex((uint8_t*) private_GooseSubscriber_getGoCbRef(subscriber),
+            private_GooseSubscriber_getGoCbRefLength(subscriber));
+
+    Semaphore_wait(self->subscriberMutex);
+    LinkedList_add(self->subscriberTable[index], subscriber);
+
+    if (self->running) {
+        if (private_GooseSubscriber_getDstMac(subscriber) != NULL) {
+            int i;
+
+            for (i = 0; i < self->interfaceCount; i++) {
+                if (self->interfaces[i].ethSocket != NULL)
+                    Ethernet_addMulticastAddress(self->interfaces[i].ethSocket, private_GooseSubscriber_getDstMac(subscriber));
+            }
+        }
+
+        updateFrameFilter(self);
+    }
+
+    Semaphore_post(self->subscriberMutex);
+}
+
+void
+GooseReceiver_removeSubscriber(GooseReceiver self, GooseSubscriber subscriber)
+{
+    int index = getHashIndex((uint8_t*) private_GooseSubscriber_getGoCbRef(subscriber),
+            private_GooseSubscriber_getGoCbRefLength(subscriber));
+
+    Semaphore_wait(self->subscriberMutex);
+
+    bool calledFromCallback = self->callbackRunning && (self->callbackThread == Thread_getCurrentId());
+
+    LinkedList_remove(self->subscriberTable[index], subscriber);
+
+    GooseSupervisionState* state = private_GooseSubscriber_getSupervisionState(subscriber);
+
+    if (state->heapIndex != -1)
+        heapRemove(self, subscriber);
+
+    /* callbacks of a message that is currently dispatched are dropped */
+    state->pendingCallbacks = 0;
+
+    if (self->running)
+        updateFrameFilter(self);
+
+    Semaphore_post(self->subscriberMutex);
+
+    /* no new callbacks are called for the removed subscriber - wait until a callback that is running
+     * in another thread has returned */
+    if (calledFromCallback == false) {
+        Semaphore_wait(self->dispatchMutex);
+        Semaphore_post(self->dispatchMutex);
+    }
+}
+
+/* get stNum and sqNum without decoding the complete message */
+static bool
+getSequenceNumbers(uint8_t* apdu, int apduLength, uint32_t* stNum, uint32_t* sqNum)
+{
+    int gooseLength;
+    int bufPos = BerDecoder_decodeLength(apdu, &gooseLength, 1, apduLength);
+
+    if (bufPos == -1)
+        return false;
+
+    int gooseEnd = bufPos + gooseLength;
+
+    if (gooseEnd > apduLength)
+        return false;
+
+    bool stNumFound = false;
+
+    while (bufPos < gooseEnd) {
+        int elementLength;
+
+        uint8_t tag = apdu[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(apdu, &elementLength, bufPos, gooseEnd);
+
+        if ((bufPos == -1) || (bufPos + elementLength > gooseEnd))
+            return false;
+
+        if (tag == 0x85) {
+            *stNum = BerDecoder_decodeUint32(apdu, elementLength, bufPos);
+            stNumFound = true;
+        }
+        else if (tag == 0x86) { /* sqNum follows stNum */
+            *sqNum = BerDecoder_decodeUint32(apdu, elementLength, bufPos);
+            return stNumFound;
+        }
+
+        bufPos += elementLength;
+    }
+
+    return false;
+}
+
+/* check if the message has already been received on another interface - called with the subscriber mutex locked */
+static bool
+isDuplicate(GooseSubscriber subscriber, uint16_t appId, uint8_t* apdu, int apduLength, uint64_t timestamp)
+{
+    uint32_t stNum = 0;
+    uint32_t sqNum = 0;
+
+    if (getSequenceNumbers(apdu, apduLength, &stNum, &sqNum) == false)
+        return false; /* malformed messages are counted by the subscriber */
+
+    GooseDuplicateWindow* window = private_GooseSubscriber_getDuplicateWindow(subscriber);
+
+    /* stNum and sqNum only increase - a copy is not newer than the last message */
+    if (window->valid && (window->appId == appId)) {
+        int32_t stNumDistance = (int32_t) (stNum - window->stNum);
+        int32_t sqNumDistance = (int32_t) (sqNum - window->sqNum);
+
+        if (stNumDistance == 0)
+            stNumDistance = sqNumDistance;
+
+        if ((stNumDistance <= 0) && (stNumDistance > -GOOSE_DUPLICATE_WINDOW_SIZE)) {
+
+            /* a restarted publisher begins again with stNum 1 (or 0) and sqNum 0 (or 1). A late copy of the
+             * first messages can look the same - a restart is only accepted after a gap. A publisher that
+             * restarts with the last stNum is detected by the timeout of the subscriber (see
+             * GooseReceiver_checkTimeouts) */
+            bool restarted = (stNum <= 1) && (sqNum <= 1) && (stNum != window->stNum) &&
+                    (timestamp >= window->timestamp + (uint64_t) GOOSE_DUPLICATE_RESTART_MIN_GAP_MS * 1000000);
+
+            if (restarted == false) {
+                window->duplicates++;
+                return true;
+            }
+
+            if (DEBUG_GOOSE_SUBSCRIBER)
+                printf("GOOSE_RECEIVER: restart of publisher %s detected\n",
+                        private_GooseSubscriber_getGoCbRef(subscriber));
+        }
+    }
+
+    window->valid = true;
+    window->appId = appId;
+    window->stNum = stNum;
+    window->sqNum = sqNum;
+    window->timestamp = timestamp;
+
+    return false;
+}
+
+static void
+dispatchGooseMessage(void* parameter, uint8_t* buffer, int numbytes, uint64_t timestamp)
+{
+    GooseReceiver self = (GooseReceiver) parameter;
+
+    int bufPos;
+
+    if (numbytes < 22) return;
+
+    /* skip ethernet addresses */
+    bufPos = 12;
+    int headerLength = 14;
+
+    /* check for VLAN tag */
+    if ((buffer[bufPos] == 0x81) && (buffer[bufPos + 1] == 0x00)) {
+        bufPos += 4; /* skip VLAN tag */
+        headerLength += 4;
+    }
+
+    /* check for GOOSE Ethertype */
+    if (buffer[bufPos++] != 0x88)
+        return;
+    if (buffer[bufPos++] != 0xb8)
+        return;
+
+    uint16_t appId;
+
+    appId = buffer[bufPos++] * 0x100;
+    appId += buffer[bufPos++];
+
+    uint16_t length;
+
+    length = buffer[bufPos++] * 0x100;
+    length += buffer[bufPos++];
+
+    /* skip reserved fields */
+    bufPos += 4;
+
+    int apduLength = length - 8;
+
+    if (numbytes != length + headerLength) {
+        if (DEBUG_GOOSE_SUBSCRIBER)
+            printf("Invalid PDU size\n");
+        return;
+    }
+
+    uint8_t* apdu = buffer + bufPos;
+
+    /* gocbRef is the first element of the goosePdu */
+    int apduPos = 0;
+    int gooseLength;
+    int goCbRefLength;
+
+    if (apduLength < 4)
+        return;
+
+    if (apdu[apduPos++] != 0x61)
+        return;
+
+    apduPos = BerDecoder_decodeLength(apdu, &gooseLength, apduPos, apduLength);
+
+    if ((apduPos == -1) || (apduPos >= apduLength))
+        return;
+
+    if (apdu[apduPos++] != 0x80)
+        return;
+
+    apduPos = BerDecoder_decodeLength(apdu, &goCbRefLength, apduPos, apduLength);
+
+    if ((apduPos == -1) || (apduPos + goCbRefLength > apduLength))
+        return;
+
+    uint8_t* goCbRef = apdu + apduPos;
+
+    int index = getHashIndex(goCbRef, goCbRefLength);
+
+    bool callbacksPending = false;
+
+    Semaphore_wait(self->dispatchMutex);
+    Semaphore_wait(self->subscriberMutex);
+
+    LinkedList element = LinkedList_getNext(self->subscriberTable[index]);
+
+    while (element != NULL) {
+        GooseSubscriber subscriber = (GooseSubscriber) element->data;
+
+        if (private_GooseSubscriber_getGoCbRefLength(subscriber) == goCbRefLength) {
+
+            int32_t subscriberAppId = private_GooseSubscriber_getAppId(subscriber);
+
+            uint8_t* dstMac = private_GooseSubscriber_getDstMac(subscriber);
+
+            if ((subscriberAppId < 0) || (subscriberAppId == appId)) {
+                if ((dstMac == NULL) || (memcmp(dstMac, buffer, 6) == 0)) {
+                    if (memcmp(private_GooseSubscriber_getGoCbRef(subscriber), goCbRef, goCbRefLength) == 0) {
+
+                        /* with redundant interfaces only the first copy of a message is passed to the subscriber */
+                        if ((self->interfaceCount < 2) ||
+                                (isDuplicate(subscriber, appId, apdu, apduLength, timestamp) == false))
+                        {
+                            bool notifyListener;
+
+                            if (private_GooseSubscriber_handleMessage(subscriber, apdu, apduLength, timestamp, &notifyListener))
+                                superviseSubscriber(self, subscriber);
+
+                            GooseSupervisionState* state = private_GooseSubscriber_getSupervisionState(subscriber);
+
+                            if (notifyListener)
+                                state->pendingCallbacks |= GOOSE_CALLBACK_LISTENER;
+
+                            if (state->pendingCallbacks != 0)
+                                callbacksPending = true;
+                        }
+                    }
+                }
+            }
+            else if (DEBUG_GOOSE_SUBSCRIBER)
+                printf("GOOSE message ignored due to wrong APPID value\n");
+        }
+
+        element = LinkedList_getNext(element);
+    }
+
+    Semaphore_post(self->subscriberMutex);
+
+    /* the user callbacks are called without the subscriber mutex so they can add and remove subscribers */
+    if (callbacksPending)
+        invokePendingCallbacks(self, index);
+
+    Semaphore_post(self->dispatchMutex);
+}
+
+void
+GooseReceiver_handleMessage(GooseReceiver self, uint8_t* buffer, int length, uint64_t timestamp)
+{
+    if (timestamp == 0)
+        timestamp = Hal_getTimeInNs();
+
+    dispatchGooseMessage(self, buffer, length, timestamp);
+}
+
+static void
+gooseReceiverLoop(void* threadParameter)
+{
+    GooseReceiverInterface* receiverInterface = (GooseReceiverInterface*) threadParameter;
+    GooseReceiver self = receiverInterface->receiver;
+
+    while (self->running) {
+
+        /* wake up in time for the next timeout */
+        int waitTime = GooseReceiver_checkTimeouts(self);
+
+        if ((waitTime < 0) || (waitTime > GOOSE_RECEIVER_WAIT_TIMEOUT))
+            waitTime = GOOSE_RECEIVER_WAIT_TIMEOUT;
+
+        if (Ethernet_receivePackets(receiverInterface->ethSocket, dispatchGooseMessage, self, waitTime) < 0)
+            Thread_sleep(waitTime);
+    }
+}
+
+void
+GooseReceiver_start(GooseReceiver self)
+{
+    if (self->running == false) {
+
+        if (self->interfaceCount == 0)
+            GooseReceiver_addInterfaceId(self, CONFIG_ETHERNET_INTERFACE_ID);
+
+        int i;
+        int socketCount = 0;
+
+        for (i = 0; i < self->interfaceCount; i++) {
+            GooseReceiverInterface* receiverInterface = &(self->interfaces[i]);
+
+            receiverInterface->ethSocket = Ethernet_createSocket(receiverInterface->interfaceId, NULL);
+
+            /* continue with the remaining interfaces of a redundant receiver */
+            if (receiverInterface->ethSocket == NULL) {
+                if (DEBUG_GOOSE_SUBSCRIBER)
+                    printf("GOOSE_RECEIVER: Failed to open receiverInterface %s\n", receiverInterface->interfaceId);
+
+                continue;
+            }
+
+            Ethernet_setProtocolFilter(receiverInterface->ethSocket, ETH_P_GOOSE);
+
+            socketCount++;
+        }
+
+        if (socketCount == 0)
+            return;
+
+        Semaphore_wait(self->subscriberMutex);
+
+        for (i = 0; i < GOOSE_RECEIVER_HASH_TABLE_SIZE; i++) {
+            LinkedList element = LinkedList_getNext(self->subscriberTable[i]);
+
+            while (element != NULL) {
+                uint8_t* dstMac = private_GooseSubscriber_getDstMac((GooseSubscriber) element->data);
+
+                if (dstMac != NULL) {
+                    int j;
+
+                    for (j = 0; j < self->interfaceCount; j++) {
+                        if (self->interfaces[j].ethSocket != NULL)
+                            Ethernet_addMulticastAddress(self->interfaces[j].ethSocket, dstMac);
+                    }
+                }
+
+                element = LinkedList_getNext(element);
+            }
+        }
+
+        updateFrameFilter(self);
+
+        Semaphore_post(self->subscriberMutex);
+
+        self->running = true;
+
+        for (i = 0; i < self->interfaceCount; i++) {
+            GooseReceiverInterface* receiverInterface = &(self->interfaces[i]);
+
+            if (receiverInterface->ethSocket != NULL) {
+                receiverInterface->thread = Thread_create((ThreadExecutionFunction) gooseReceiverLoop, receiverInterface, false);
+                Thread_start(receiverInterface->thread);
+            }
+        }
+    }
+}
+
+void
+GooseReceiver_stop(GooseReceiver self)
+{
+    if (self->running) {
+        self->running = false;
+
+        int i;
+
+        for (i = 0; i < self->interfaceCount; i++) {
+            GooseReceiverInterface* receiverInterface = &(self->interfaces[i]);
+
+            if (receiverInterface->thread != NULL) {
+                Thread_destroy(receiverInterface->thread);
+                receiverInterface->thread = NULL;
+            }
+        }
+
+        Semaphore_wait(self->subscriberMutex);
+
+        for (i = 0; i < self->interfaceCount; i++) {
+            GooseReceiverInterface* receiverInterface = &(self->interfaces[i]);
+
+            if (receiverInterface->ethSocket != NULL) {
+                Ethernet_destroySocket(receiverInterface->ethSocket);
+                receiverInterface->ethSocket = NULL;
+            }
+        }
+
+        Semaphore_post(self->subscriberMutex);
+    }
+}
+
+void
+GooseReceiver_destroy(GooseReceiver self)
+{
+    GooseReceiver_stop(self);
+
+    int i;
+    for (i = 0; i < GOOSE_RECEIVER_HASH_TABLE_SIZE; i++)
+        LinkedList_destroyStatic(self->subscriberTable[i]);
+
+    /* the subscribers are not destroyed and can be added to another receiver */
+    for (i = 0; i < self->supervisionHeapSize; i++)
+        private_GooseSubscriber_getSupervisionState(self->supervisionHeap[i])->heapIndex = -1;
+
+    if (self->supervisionHeap != NULL)
+        free(self->supervisionHeap);
+
+    Semaphore_destroy(self->subscriberMutex);
+    Semaphore_destroy(self->dispatchMutex);
+
+    freeInterfaceIds(self);
+
+    free(self);
+}
@@ -0,0 +1,205 @@
+/*
+ *  goose_receiver.h
+ *
+ *  Copyright 2014 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef GOOSE_RECEIVER_H_
+#define GOOSE_RECEIVER_H_
+
+#include "libiec61850_common_api.h"
+#include "goose_subscriber.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \addtogroup goose_api_group
+ */
+/**@{*/
+
+typedef struct sGooseReceiver* GooseReceiver;
+
+typedef enum {
+    GOOSE_SUPERVISION_TIMEOUT,  /* no message received within timeAllowedToLive of the last message */
+    GOOSE_SUPERVISION_RECOVERED /* first message received after a timeout */
+} GooseSupervisionEvent;
+
+/**
+ * \brief user provided callback function that is invoked when a subscriber times out or recovers.
+ *
+ * \param subscriber the subscriber that changed its state
+ * \param event the new supervision state
+ * \param parameter a user provided parameter that will be passed to the callback function
+ */
+typedef void (*GooseSupervisionHandler)(GooseSubscriber subscriber, GooseSupervisionEvent event, void* parameter);
+
+/**
+ * \brief create a new GOOSE receiver instance.
+ *
+ * A GOOSE receiver uses a single ethernet socket and a single thread to receive the GOOSE messages
+ * of an interface and passes them to the registered subscribers. A message is dispatched by its
+ * gocbRef (and APPID if set for the subscriber) with a hash table lookup. Use one receiver per
+ * interface instead of calling GooseSubscriber_subscribe for each subscriber when many GOOSE
+ * control blocks are monitored.
+ */
+GooseReceiver
+GooseReceiver_create(void);
+
+/**
+ * \brief set the ethernet interface that should be used.
+ *
+ * Has to be called before GooseReceiver_start. The interface IDs of the subscribers are ignored.
+ * Replaces all interfaces added with GooseReceiver_addInterfaceId.
+ *
+ * \param self GooseReceiver instance to operate on.
+ * \param interfaceId the id of the interface (e.g. a network device name like eth0
+ *        for linux or a numerical index for windows)
+ */
+void
+GooseReceiver_setInterfaceId(GooseReceiver self, char* interfaceId);
+
+/**
+ * \brief add a redundant ethernet interface (e.g. LAN B of a PRP network).
+ *
+ * Has to be called before GooseReceiver_start. The receiver uses a socket and a thread for each
+ * interface. When more than one interface is used, the copies of a message that are received
+ * on the other interfaces are discarded before the message is decoded. Messages are identified
+ * by APPID, stNum and sqNum: a message that is not newer than the last message of the publisher
+ * is a copy. The subscribers get the first copy that arrives.
+ *
+ * The receiver continues with the remaining interfaces if an interface cannot be opened.
+ *
+ * \param self GooseReceiver instance to operate on.
+ * \param interfaceId the id of the interface
+ *
+ * \return false if the maximum number of interfaces (4) has been reached
+ */
+bool
+GooseReceiver_addInterfaceId(GooseReceiver self, char* interfaceId);
+
+/**
+ * \brief add a subscriber to the receiver.
+ *
+ * Subscribers can be added and removed while the receiver is running, also from inside a GooseListener
+ * or GooseSupervisionHandler callback. The subscriber must not be used with GooseSubscriber_subscribe
+ * at the same time.
+ *
+ * \param self GooseReceiver instance to operate on.
+ * \param subscriber the subscriber that will be informed about matching messages
+ */
+void
+GooseReceiver_addSubscriber(GooseReceiver self, GooseSubscriber subscriber);
+
+/**
+ * \brief remove a subscriber from the receiver.
+ *
+ * The subscriber is not destroyed. Callbacks of the subscriber that are pending for the message
+ * that is currently processed by the receiver thread are dropped. When called outside of a callback
+ * the function waits until a running GooseListener or GooseSupervisionHandler callback has returned.
+ * The subscriber can be destroyed with GooseSubscriber_destroy when the function has returned. The
+ * function must not be called while holding a lock that is also taken by the callbacks.
+ *
+ * \param self GooseReceiver instance to operate on.
+ * \param subscriber the subscriber to remove
+ */
+void
+GooseReceiver_removeSubscriber(GooseReceiver self, GooseSubscriber subscriber);
+
+/**
+ * \brief set a callback function that is invoked when a subscriber times out or recovers.
+ *
+ * The receiver supervises each subscriber that has received a message. When no further message
+ * arrives within the timeAllowedToLive of the last message the subscriber times out (see
+ * GooseSubscriber_isValid). The deadlines of all subscribers are kept in a heap so the receiver
+ * thread only has to check the next deadline, independent of the number of subscribers.
+ *
+ * The handler is called by the receiver thread. Subscribers can be added and removed from
+ * inside the handler.
+ *
+ * \param self GooseReceiver instance to operate on.
+ * \param handler user provided callback function or NULL
+ * \param parameter a user provided parameter that will be passed to the callback function
+ */
+void
+GooseReceiver_setSupervisionHandler(GooseReceiver self, GooseSupervisionHandler handler, void* parameter);
+
+/**
+ * \brief check the deadlines of the supervised subscribers and report the timeouts.
+ *
+ * This function is called by the receiver thread. It only has to be called by the application
+ * when messages are passed to the receiver with GooseReceiver_handleMessage.
+ *
+ * \param self GooseReceiver instance to operate on.
+ *
+ * \return the time in ms until the next deadline or -1 if no subscriber is supervised
+ */
+int
+GooseReceiver_checkTimeouts(GooseReceiver self);
+
+/**
+ * \brief Decode a GOOSE message and pass it to the matching subscribers.
+ *
+ * This function is called by the receiver thread. It can be used to feed messages from other
+ * sources (e.g. a capture file replayed with PcapReader_replay) to the subscribers when the
+ * receiver is not started.
+ *
+ * \param self GooseReceiver instance to operate on.
+ * \param buffer a complete ethernet frame (including the ethernet header)
+ * \param length the size of the frame in bytes
+ * \param timestamp the receive time in ns since epoch or 0 to use the current time
+ */
+void
+GooseReceiver_handleMessage(GooseReceiver self, uint8_t* buffer, int length, uint64_t timestamp);
+
+/**
+ * \brief Start listening to GOOSE messages
+ *
+ * \param self GooseReceiver instance to operate on.
+ */
+void
+GooseReceiver_start(GooseReceiver self);
+
+/**
+ * \brief Stop listening to GOOSE messages
+ *
+ * \param self GooseReceiver instance to operate on.
+ */
+void
+GooseReceiver_stop(GooseReceiver self);
+
+/**
+ * \brief Stop the receiver and release all resources.
+ *
+ * The registered subscribers are not destroyed.
+ *
+ * \param self GooseReceiver instance to operate on.
+ */
+void
+GooseReceiver_destroy(GooseReceiver self);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GOOSE_RECEIVER_H_ */
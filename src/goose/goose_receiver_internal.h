@@ -0,0 +1,87 @@
+/*
+ *  goose_receiver_internal.h
+ *
+ *  Copyright 2014 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef GOOSE_RECEIVER_INTERNAL_H_
+#define GOOSE_RECEIVER_INTERNAL_H_
+
+#include "goose_subscriber.h"
+
+/* functions of the GooseSubscriber that are used by the GooseReceiver */
+
+char*
+private_GooseSubscriber_getGoCbRef(GooseSubscriber self);
+
+int
+private_GooseSubscriber_getGoCbRefLength(GooseSubscriber self);
+
+int32_t
+private_GooseSubscriber_getAppId(GooseSubscriber self);
+
+/* returns NULL if no destination MAC address is set */
+uint8_t*
+private_GooseSubscriber_getDstMac(GooseSubscriber self);
+
+/* like GooseSubscriber_handleMessage with the receive time stamp of the frame. The listener is not called -
+ * notifyListener is set when private_GooseSubscriber_notifyListener has to be called for the message */
+bool
+private_GooseSubscriber_handleMessage(GooseSubscriber self, uint8_t* apdu, int apduLength, uint64_t receiveTimestamp,
+        bool* notifyListener);
+
+void
+private_GooseSubscriber_notifyListener(GooseSubscriber self);
+
+/* state of the timeAllowedToLive supervision - maintained by the GooseReceiver */
+typedef struct {
+    uint64_t deadline; /* time in ms (monotonic) when the subscriber times out */
+    int heapIndex;     /* position in the deadline heap of the receiver or -1 if not supervised */
+    bool timedOut;
+    uint32_t timeouts;
+    uint8_t pendingCallbacks; /* callbacks that are called by the receiver after releasing the subscriber mutex */
+} GooseSupervisionState;
+
+GooseSupervisionState*
+private_GooseSubscriber_getSupervisionState(GooseSubscriber self);
+
+/* messages up to this distance (stNum or sqNum) behind the last message are considered as copies received on
+ * a redundant interface. Messages further behind and messages that restart the sequence numbers are sent by a
+ * restarted publisher */
+#define GOOSE_DUPLICATE_WINDOW_SIZE 256
+
+/* a message that restarts the sequence numbers is only accepted this time after the last message. Copies
+ * received on the redundant interface arrive earlier */
+#define GOOSE_DUPLICATE_RESTART_MIN_GAP_MS 100
+
+/* last message of a subscriber that has been passed to the subscriber - maintained by the GooseReceiver */
+typedef struct {
+    bool valid;
+    uint16_t appId;
+    uint32_t stNum;
+    uint32_t sqNum;
+    uint64_t timestamp; /* receive time of the last message in ns */
+    uint32_t duplicates;
+} GooseDuplicateWindow;
+
+GooseDuplicateWindow*
+private_GooseSubscriber_getDuplicateWindow(GooseSubscriber self);
+
+#endif /* GOOSE_RECEIVER_INTERNAL_H_ */
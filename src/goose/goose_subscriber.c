@@ -25,18 +25,14 @@
 
 #include "stack_config.h"
 #include "goose_subscriber.h"
-#include "ethernet.h"
-#include "thread.h"
+#include "goose_receiver.h"
+#include "goose_receiver_internal.h"
 
 #include "ber_decode.h"
 
 #include "mms_value.h"
 #include "mms_value_internal.h"
 
-#define ETH_BUFFER_LENGTH 1518
-
-#define ETH_P_GOOSE 0x88b8
-
 struct sGooseSubscriber {
     char* goCBRef;
     int goCBRefLen;
@@ -50,13 +46,30 @@ struct sGooseSubscriber {
 
     int32_t appId; /* APPID or -1 if APPID should be ignored */
 
+    uint8_t dstMac[6];
+    bool dstMacSet;
+
     MmsValue* dataSetValues;
     bool dataSetValuesSelfAllocated;
 
+    GooseSlotType* slotLayout;   /* NULL if data set values are decoded into MmsValue instances */
+    GooseSlotValue* slotValues;
+    GooseSlotValue* slotBuffer;  /* message is decoded here first to not overwrite valid values */
+    int slotCount;
+    uint32_t slotChecksum;
+    bool slotValuesValid;
+
     GooseListener listener;
     void* listenerParameter;
-    bool running;
-    Thread receiver;
+    GooseListenerMode listenerMode;
+
+    GooseSubscriberStatistics statistics;
+    GooseSupervisionState supervision;
+    GooseDuplicateWindow duplicateWindow;
+
+    uint64_t receiveTimestamp; /* receive time of the last accepted message in ns since epoch */
+
+    GooseReceiver receiver; /* used by GooseSubscriber_subscribe */
     char* interfaceId;
 };
 
@@ -165,24 +178,17 @@ parseAllData(uint8_t* buffer, int allDataLength, MmsValue* dataSetValues)
         	break;
         case 0x8a: /* visible string */
         	if (MmsValue_getType(value) == MMS_VISIBLE_STRING) {
-        		if (value->value.visibleString != NULL) {
-        			if ((int32_t) strlen(value->value.visibleString) >= elementLength) {
-        				memcpy(value->value.visibleString, buffer + bufPos, elementLength);
-						value->value.visibleString[elementLength] = 0;
-        			}
-        			else {
-        				free(value->value.visibleString);
-        				value->value.visibleString = (char*) malloc(elementLength + 1);
-						memcpy(value->value.visibleString, buffer + bufPos, elementLength);
-						value->value.visibleString[elementLength] = 0;
-        			}
-        		}
-        		else {
-        			value->value.visibleString = (char*) malloc(elementLength + 1);
-        			memcpy(value->value.visibleString, buffer + bufPos, elementLength);
-        			value->value.visibleString[elementLength] = 0;
+        		if ((value->value.visibleString.buf == NULL) || (value->value.visibleString.size <= elementLength)) {
+        			if (value->value.visibleString.buf != NULL)
+        				free(value->value.visibleString.buf);
+
+        			value->value.visibleString.buf = (char*) malloc(elementLength + 1);
+        			value->value.visibleString.size = elementLength + 1;
         		}
 
+        		memcpy(value->value.visibleString.buf, buffer + bufPos, elementLength);
+        		value->value.visibleString.buf[elementLength] = 0;
+
         	}
         	break;
         case 0x8c: /* binary time */
@@ -216,6 +222,151 @@ parseAllData(uint8_t* buffer, int allDataLength, MmsValue* dataSetValues)
     return 1;
 }
 
+static uint64_t
+decodeUtcTimeInMs(uint8_t* buffer)
+{
+    uint32_t timeval32 = ((uint32_t) buffer[0] << 24) + ((uint32_t) buffer[1] << 16) +
+            ((uint32_t) buffer[2] << 8) + (uint32_t) buffer[3];
+
+    uint32_t fractionOfSecond = ((uint32_t) buffer[4] << 16) + ((uint32_t) buffer[5] << 8) +
+            (uint32_t) buffer[6];
+
+    return ((uint64_t) timeval32 * 1000LL) + (fractionOfSecond / 16777);
+}
+
+static bool
+parseAllDataToSlots(uint8_t* buffer, int allDataLength, GooseSlotType* layout, GooseSlotValue* slots,
+        int slotCount)
+{
+    int bufPos = 0;
+    int elementLength = 0;
+
+    int slotIndex = 0;
+
+    while (bufPos < allDataLength) {
+        uint8_t tag = buffer[bufPos++];
+
+        if (slotIndex == slotCount) {
+            if (DEBUG) printf("Malformed message: too much elements!\n");
+            return false;
+        }
+
+        bufPos = BerDecoder_decodeLength(buffer, &elementLength, bufPos, allDataLength);
+
+        if ((bufPos < 0) || (bufPos + elementLength > allDataLength)) {
+            if (DEBUG) printf("Malformed message: sub element is to large!\n");
+            return false;
+        }
+
+        uint8_t* value = buffer + bufPos;
+
+        /* clear unused bytes of the union to keep the checksum independent of old values */
+        GooseSlotValue slot;
+        slot.timestamp = 0;
+
+        switch (layout[slotIndex]) {
+        case GOOSE_SLOT_BOOLEAN:
+            if ((tag != 0x83) || (elementLength != 1))
+                goto wrong_type;
+
+            slot.boolean = (value[0] != 0);
+            break;
+
+        case GOOSE_SLOT_BIT_STRING:
+            if ((tag != 0x84) || (elementLength < 1) || (elementLength > 5))
+                goto wrong_type;
+            {
+                int bitCount = (8 * (elementLength - 1)) - value[0];
+                int bitPos;
+
+                for (bitPos = 0; bitPos < bitCount; bitPos++) {
+                    if (value[1 + (bitPos / 8)] & (0x80 >> (bitPos % 8)))
+                        slot.bitString |= (1U << bitPos);
+                }
+            }
+            break;
+
+        case GOOSE_SLOT_INTEGER:
+            if ((tag != 0x85) || (elementLength < 1) || (elementLength > 4))
+                goto wrong_type;
+            {
+                /* sign extension */
+                int32_t intValue = (value[0] & 0x80) ? -1 : 0;
+                int i;
+
+                for (i = 0; i < elementLength; i++)
+                    intValue = (int32_t) (((uint32_t) intValue << 8) | value[i]);
+
+                slot.intValue = intValue;
+            }
+            break;
+
+        case GOOSE_SLOT_UNSIGNED:
+            if ((tag != 0x86) || (elementLength < 1) || (elementLength > 5))
+                goto wrong_type;
+
+            if ((elementLength == 5) && (value[0] != 0))
+                goto wrong_type;
+
+            slot.uintValue = BerDecoder_decodeUint32(buffer, elementLength, bufPos);
+            break;
+
+        case GOOSE_SLOT_FLOAT:
+            if (tag != 0x87)
+                goto wrong_type;
+
+            if (elementLength == 5)
+                slot.floatValue = BerDecoder_decodeFloat(buffer, bufPos);
+            else if (elementLength == 9)
+                slot.floatValue = (float) BerDecoder_decodeDouble(buffer, bufPos);
+            else
+                goto wrong_type;
+            break;
+
+        case GOOSE_SLOT_TIMESTAMP:
+            if ((tag != 0x91) || (elementLength != 8))
+                goto wrong_type;
+
+            slot.timestamp = decodeUtcTimeInMs(value);
+            break;
+        }
+
+        slots[slotIndex] = slot;
+
+        bufPos += elementLength;
+
+        slotIndex++;
+    }
+
+    if (slotIndex != slotCount) {
+        if (DEBUG) printf("Malformed message: too few elements!\n");
+        return false;
+    }
+
+    return true;
+
+wrong_type:
+    if (DEBUG) printf("      message contains value of wrong type for slot %i!\n", slotIndex);
+    return false;
+}
+
+static void
+updateSlotValues(GooseSubscriber self, uint8_t* buffer, int allDataLength)
+{
+    if (parseAllDataToSlots(buffer, allDataLength, self->slotLayout, self->slotBuffer, self->slotCount)) {
+
+        /* retransmissions usually contain the same values - no need to update the checksum */
+        if (memcmp(self->slotValues, self->slotBuffer, self->slotCount * sizeof(GooseSlotValue)) != 0) {
+            memcpy(self->slotValues, self->slotBuffer, self->slotCount * sizeof(GooseSlotValue));
+            self->slotChecksum = GooseSubscriber_calculateSlotChecksum(self->slotValues, self->slotCount);
+        }
+
+        self->slotValuesValid = true;
+    }
+    else
+        self->slotValuesValid = false;
+}
+
 static MmsValue*
 parseAllDataUnknownValue(GooseSubscriber self, uint8_t* buffer, int allDataLength, bool isStructure)
 {
@@ -327,11 +478,17 @@ parseAllDataUnknownValue(GooseSubscriber self, uint8_t* buffer, int allDataLengt
             break;
         case 0x85: /* integer */
             value = MmsValue_newInteger(elementLength * 8);
-            memcpy(value->value.integer->octets, buffer + bufPos, elementLength);
+            if (elementLength <= value->value.integer->maxSize) {
+                value->value.integer->size = elementLength;
+                memcpy(value->value.integer->octets, buffer + bufPos, elementLength);
+            }
             break;
         case 0x86: /* unsigned integer */
             value = MmsValue_newUnsigned(elementLength * 8);
-            memcpy(value->value.integer->octets, buffer + bufPos, elementLength);
+            if (elementLength <= value->value.integer->maxSize) {
+                value->value.integer->size = elementLength;
+                memcpy(value->value.integer->octets, buffer + bufPos, elementLength);
+            }
             break;
         case 0x87: /* Float */
                 if (elementLength == 9)
@@ -495,7 +652,9 @@ parseGoosePayload(uint8_t* buffer, int apduLength, GooseSubscriber self)
             case 0xab:
                 if (DEBUG) printf("  Found all data with length: %i\n", elementLength);
 
-                if (self->dataSetValues == NULL)
+                if (self->slotLayout != NULL)
+                    updateSlotValues(self, buffer + bufPos, elementLength);
+                else if (self->dataSetValues == NULL)
                     self->dataSetValues = parseAllDataUnknownValue(self, buffer + bufPos, elementLength, false);
                 else
                     parseAllData(buffer + bufPos, elementLength, self->dataSetValues);
@@ -528,107 +687,113 @@ exit_with_fault:
     return -1;
 }
 
-static int
-parseGooseMessage(uint8_t* buffer, int numbytes, GooseSubscriber subscriber)
+char*
+private_GooseSubscriber_getGoCbRef(GooseSubscriber self)
 {
-    int bufPos;
-
-    if (numbytes < 22) return -1;
-
-    /* skip ethernet addresses */
-    bufPos = 12;
-    int headerLength = 14;
-
-    /* check for VLAN tag */
-    if ((buffer[bufPos] == 0x81) && (buffer[bufPos + 1] == 0x00)) {
-        bufPos += 4; /* skip VLAN tag */
-        headerLength += 4;
-    }
-
-    /* check for GOOSE Ethertype */
-    if (buffer[bufPos++] != 0x88)
-        return -1;
-    if (buffer[bufPos++] != 0xb8)
-        return -1;
-
-    uint16_t appId;
-
-    appId = buffer[bufPos++] * 0x100;
-    appId += buffer[bufPos++];
+    return self->goCBRef;
+}
 
-    uint16_t length;
+int
+private_GooseSubscriber_getGoCbRefLength(GooseSubscriber self)
+{
+    return self->goCBRefLen;
+}
 
-    length = buffer[bufPos++] * 0x100;
-    length += buffer[bufPos++];
+int32_t
+private_GooseSubscriber_getAppId(GooseSubscriber self)
+{
+    return self->appId;
+}
 
-    /* skip reserved fields */
-    bufPos += 4;
+uint8_t*
+private_GooseSubscriber_getDstMac(GooseSubscriber self)
+{
+    if (self->dstMacSet)
+        return self->dstMac;
+    else
+        return NULL;
+}
 
-    int apduLength = length - 8;
+GooseSupervisionState*
+private_GooseSubscriber_getSupervisionState(GooseSubscriber self)
+{
+    return &(self->supervision);
+}
 
-    if (numbytes != length + headerLength) {
-        if (DEBUG)
-        	printf("Invalid PDU size\n");
-        return -1;
-    }
+GooseDuplicateWindow*
+private_GooseSubscriber_getDuplicateWindow(GooseSubscriber self)
+{
+    return &(self->duplicateWindow);
+}
 
-    if (DEBUG) {
-        printf("GOOSE message:\n----------------\n");
-        printf("  APPID: %u\n", appId);
-        printf("  LENGTH: %u\n", length);
-        printf("  APDU length: %i\n", apduLength);
-    }
+bool
+GooseSubscriber_handleMessage(GooseSubscriber self, uint8_t* apdu, int apduLength)
+{
+    bool notifyListener;
 
-    if (subscriber->appId >= 0) {
-        if (appId != (uint16_t) subscriber->appId) {
-            if (DEBUG)
-                printf("GOOSE message ignored due to wrong APPID value\n");
+    bool accepted = private_GooseSubscriber_handleMessage(self, apdu, apduLength, Hal_getTimeInNs(), &notifyListener);
 
-            return 0;
-        }
-    }
+    if (notifyListener)
+        private_GooseSubscriber_notifyListener(self);
 
-    return parseGoosePayload(buffer + bufPos, apduLength, subscriber);
+    return accepted;
 }
 
-static void
-gooseSubscriberLoop(void* threadParameter)
+void
+private_GooseSubscriber_notifyListener(GooseSubscriber self)
 {
-    GooseSubscriber self = (GooseSubscriber) threadParameter;
+    if (self->listener != NULL)
+        self->listener(self, self->listenerParameter);
+}
 
-    uint8_t* buffer = (uint8_t*) malloc(ETH_BUFFER_LENGTH);
+bool
+private_GooseSubscriber_handleMessage(GooseSubscriber self, uint8_t* apdu, int apduLength, uint64_t receiveTimestamp,
+        bool* notifyListener)
+{
+    *notifyListener = false;
 
-    EthernetSocket socket;
+    uint32_t lastStNum = self->stNum;
+    uint32_t lastSqNum = self->sqNum;
 
-    if (self->interfaceId == NULL)
-    	socket = Ethernet_createSocket(CONFIG_ETHERNET_INTERFACE_ID, NULL);
-    else
-    	socket = Ethernet_createSocket(self->interfaceId, NULL);
+    int result = parseGoosePayload(apdu, apduLength, self);
 
-    Ethernet_setProtocolFilter(socket, ETH_P_GOOSE);
+    if (result == 1) {
+        bool stateChange;
 
-    int running = 1;
+        if (self->statistics.received == 0)
+            stateChange = true;
+        else if (self->stNum != lastStNum) {
+            stateChange = true;
 
-    while (running) {
+            if (self->stNum != lastStNum + 1)
+                self->statistics.sequenceErrors++;
+        }
+        else {
+            stateChange = false;
 
-        int packetSize = Ethernet_receivePacket(socket, buffer, ETH_BUFFER_LENGTH);
+            self->statistics.retransmissions++;
 
-        if (packetSize > 0) {
-            if (parseGooseMessage(buffer, packetSize, self) == 1) {
-                if (self->listener != NULL) {
-                    self->listener(self, self->listenerParameter);
-                }
-            }
+            if (self->sqNum != lastSqNum + 1)
+                self->statistics.sequenceErrors++;
         }
 
-        Thread_sleep(1);
+        self->statistics.received++;
+        self->receiveTimestamp = receiveTimestamp;
 
-        running = self->running;
-    }
+        if (stateChange)
+            self->statistics.stateChanges++;
 
-    free(buffer);
+        if (self->listener != NULL) {
+            if (stateChange || (self->listenerMode == GOOSE_LISTENER_ALL_MESSAGES))
+                *notifyListener = true;
+        }
 
-    Ethernet_destroySocket(socket);
+        return true;
+    }
+    else if (result == -1)
+        self->statistics.decodeErrors++;
+
+    return false;
 }
 
 GooseSubscriber
@@ -644,10 +809,10 @@ GooseSubscriber_create(char* goCbRef, MmsValue* dataSetValues)
     if (dataSetValues != NULL)
         self->dataSetValuesSelfAllocated = false;
 
-    self->running = false;
-
     self->appId = -1;
 
+    self->supervision.heapIndex = -1;
+
     return self;
 }
 
@@ -657,6 +822,13 @@ GooseSubscriber_setAppId(GooseSubscriber self, uint16_t appId)
     self->appId = (int32_t) appId;
 }
 
+void
+GooseSubscriber_setDstMac(GooseSubscriber self, uint8_t dstMac[6])
+{
+    memcpy(self->dstMac, dstMac, 6);
+    self->dstMacSet = true;
+}
+
 void
 GooseSubscriber_setInterfaceId(GooseSubscriber self, char* interfaceId)
 {
@@ -666,18 +838,23 @@ GooseSubscriber_setInterfaceId(GooseSubscriber self, char* interfaceId)
 void
 GooseSubscriber_subscribe(GooseSubscriber self)
 {
-    Thread thread = Thread_create((ThreadExecutionFunction) gooseSubscriberLoop, self, false);
-    self->receiver = thread;
-    self->running = true;
-    Thread_start(thread);
+    if (self->receiver == NULL) {
+        self->receiver = GooseReceiver_create();
+
+        if (self->interfaceId != NULL)
+            GooseReceiver_setInterfaceId(self->receiver, self->interfaceId);
+
+        GooseReceiver_addSubscriber(self->receiver, self);
+        GooseReceiver_start(self->receiver);
+    }
 }
 
 void
 GooseSubscriber_unsubscribe(GooseSubscriber self)
 {
-    if (self->running) {
-        self->running = false;
-        Thread_destroy(self->receiver);
+    if (self->receiver != NULL) {
+        GooseReceiver_destroy(self->receiver);
+        self->receiver = NULL;
     }
 }
 
@@ -696,6 +873,12 @@ GooseSubscriber_destroy(GooseSubscriber self)
     if (self->interfaceId != NULL)
     	free(self->interfaceId);
 
+    if (self->slotLayout != NULL) {
+        free(self->slotLayout);
+        free(self->slotValues);
+        free(self->slotBuffer);
+    }
+
     free(self);
 }
 
@@ -706,6 +889,86 @@ GooseSubscriber_setListener(GooseSubscriber self, GooseListener listener, void*
     self->listenerParameter = parameter;
 }
 
+void
+GooseSubscriber_setListenerMode(GooseSubscriber self, GooseListenerMode mode)
+{
+    self->listenerMode = mode;
+}
+
+void
+GooseSubscriber_getStatistics(GooseSubscriber self, GooseSubscriberStatistics* statistics)
+{
+    *statistics = self->statistics;
+    statistics->timeouts = self->supervision.timeouts;
+    statistics->duplicates = self->duplicateWindow.duplicates;
+}
+
+uint64_t
+GooseSubscriber_getReceiveTimestamp(GooseSubscriber self)
+{
+    return self->receiveTimestamp;
+}
+
+bool
+GooseSubscriber_isValid(GooseSubscriber self)
+{
+    return (self->statistics.received > 0) && (self->supervision.timedOut == false);
+}
+
+void
+GooseSubscriber_setSlotLayout(GooseSubscriber self, GooseSlotType* layout, int slotCount)
+{
+    if (self->slotLayout != NULL) {
+        free(self->slotLayout);
+        free(self->slotValues);
+        free(self->slotBuffer);
+    }
+
+    self->slotLayout = (GooseSlotType*) malloc(slotCount * sizeof(GooseSlotType));
+    memcpy(self->slotLayout, layout, slotCount * sizeof(GooseSlotType));
+
+    self->slotValues = (GooseSlotValue*) calloc(slotCount, sizeof(GooseSlotValue));
+    self->slotBuffer = (GooseSlotValue*) calloc(slotCount, sizeof(GooseSlotValue));
+    self->slotCount = slotCount;
+    self->slotValuesValid = false;
+    self->slotChecksum = GooseSubscriber_calculateSlotChecksum(self->slotValues, slotCount);
+}
+
+GooseSlotValue*
+GooseSubscriber_getSlotValues(GooseSubscriber self)
+{
+    return self->slotValues;
+}
+
+bool
+GooseSubscriber_isSlotDataValid(GooseSubscriber self)
+{
+    return self->slotValuesValid;
+}
+
+uint32_t
+GooseSubscriber_getSlotChecksum(GooseSubscriber self)
+{
+    return self->slotChecksum;
+}
+
+uint32_t
+GooseSubscriber_calculateSlotChecksum(GooseSlotValue* slotValues, int slotCount)
+{
+    /* FNV-1a applied to 32 bit words instead of bytes */
+    uint32_t checksum = 2166136261U;
+    uint32_t* words = (uint32_t*) slotValues;
+    int wordCount = slotCount * (sizeof(GooseSlotValue) / sizeof(uint32_t));
+    int i;
+
+    for (i = 0; i < wordCount; i++) {
+        checksum ^= words[i];
+        checksum *= 16777619U;
+    }
+
+    return checksum;
+}
+
 uint32_t
 GooseSubscriber_getStNum(GooseSubscriber self)
 {
@@ -47,6 +47,48 @@ typedef struct sGooseSubscriber* GooseSubscriber;
  */
 typedef void (*GooseListener)(GooseSubscriber subscriber, void* parameter);
 
+/**
+ * \brief selects the messages the listener is called for (see GooseSubscriber_setListenerMode)
+ */
+typedef enum {
+    GOOSE_LISTENER_ALL_MESSAGES,  /* listener is called for each received message (default) */
+    GOOSE_LISTENER_STATE_CHANGES  /* listener is called for the first message and when stNum changes */
+} GooseListenerMode;
+
+typedef struct {
+    uint32_t received;        /* number of accepted messages */
+    uint32_t stateChanges;    /* messages with a new stNum (including the first message) */
+    uint32_t retransmissions; /* messages with the same stNum as the previous message */
+    uint32_t sequenceErrors;  /* stNum or sqNum not increased by one (lost or reordered messages) */
+    uint32_t decodeErrors;    /* malformed messages */
+    uint32_t timeouts;        /* number of times no message was received within timeAllowedToLive */
+    uint32_t duplicates;      /* messages discarded because they have been received on another interface */
+} GooseSubscriberStatistics;
+
+/**
+ * \brief type of a data set element that is decoded into a slot (see GooseSubscriber_setSlotLayout)
+ */
+typedef enum {
+    GOOSE_SLOT_BOOLEAN,    /* BOOLEAN -> boolean */
+    GOOSE_SLOT_BIT_STRING, /* BIT STRING with up to 32 bits -> bitString (first bit is bit 0) */
+    GOOSE_SLOT_INTEGER,    /* INTEGER with up to 32 bits -> intValue */
+    GOOSE_SLOT_UNSIGNED,   /* UNSIGNED with up to 32 bits -> uintValue */
+    GOOSE_SLOT_FLOAT,      /* FLOAT (single or double precision) -> floatValue */
+    GOOSE_SLOT_TIMESTAMP   /* UTC time -> timestamp in ms since epoch */
+} GooseSlotType;
+
+/**
+ * \brief decoded value of a single data set element
+ */
+typedef union {
+    bool boolean;
+    uint32_t bitString;
+    int32_t intValue;
+    uint32_t uintValue;
+    float floatValue;
+    uint64_t timestamp;
+} GooseSlotValue;
+
 /**
  * \brief create a new GOOSE subscriber instance.
  *
@@ -81,6 +123,18 @@ GooseSubscriber_create(char* goCbRef, MmsValue* dataSetValues);
 void
 GooseSubscriber_setAppId(GooseSubscriber self, uint16_t appId);
 
+/**
+ * \brief set the destination MAC address used by the subscriber to filter relevant messages.
+ *
+ * If set the subscriber will ignore all messages with other destination addresses and the
+ * receiver joins the multicast group of the address.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param dstMac the multicast MAC address the publisher is sending to (6 bytes)
+ */
+void
+GooseSubscriber_setDstMac(GooseSubscriber self, uint8_t dstMac[6]);
+
 /**
  * \brief set the ethernet interface that should be used.
  *
@@ -120,6 +174,99 @@ GooseSubscriber_destroy(GooseSubscriber self);
 void
 GooseSubscriber_setListener(GooseSubscriber self, GooseListener listener, void* parameter);
 
+/**
+ * \brief select if the listener is called for each message or only for state changes.
+ *
+ * With GOOSE_LISTENER_STATE_CHANGES retransmissions (same stNum, increased sqNum) are only counted
+ * and the data set values are updated without calling the listener.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param mode the listener mode
+ */
+void
+GooseSubscriber_setListenerMode(GooseSubscriber self, GooseListenerMode mode);
+
+/**
+ * \brief get the message counters of the subscriber
+ *
+ * The counters are updated by the receiving thread without locking. The values can be
+ * slightly outdated when read by another thread.
+ */
+void
+GooseSubscriber_getStatistics(GooseSubscriber self, GooseSubscriberStatistics* statistics);
+
+/**
+ * \brief check if the publisher is alive
+ *
+ * \return true if a message has been received and the subscriber is not timed out (the
+ *         timeout is only detected when the subscriber is supervised by a GooseReceiver)
+ */
+bool
+GooseSubscriber_isValid(GooseSubscriber self);
+
+/**
+ * \brief decode the data set values into a flat array of typed slots instead of a MmsValue tree.
+ *
+ * The layout describes the type of each data set element. Messages are decoded directly into the
+ * slots without allocating memory. A message that does not match the layout (number of elements,
+ * types or sizes) leaves the slot values untouched and marks them as invalid
+ * (see GooseSubscriber_isSlotDataValid). Nested elements (arrays and structures) are not supported.
+ *
+ * If a layout is set GooseSubscriber_getDataSetValues will not be updated.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param layout the types of the data set elements. The array is copied.
+ * \param slotCount the number of data set elements
+ */
+void
+GooseSubscriber_setSlotLayout(GooseSubscriber self, GooseSlotType* layout, int slotCount);
+
+/**
+ * \brief get the slot values decoded from the last valid message
+ *
+ * The returned array has as many elements as the slot layout and remains valid until the subscriber
+ * is destroyed. It is updated by the receiving thread before the listener is called.
+ *
+ * \return the slot values or NULL if no slot layout is set
+ */
+GooseSlotValue*
+GooseSubscriber_getSlotValues(GooseSubscriber self);
+
+/**
+ * \brief check if the last received message could be decoded with the slot layout
+ */
+bool
+GooseSubscriber_isSlotDataValid(GooseSubscriber self);
+
+/**
+ * \brief get the checksum of the current slot values
+ *
+ * The checksum is calculated over the decoded slot values. It can be used to check if the values
+ * changed with a single comparison or to validate a copy of the slot values.
+ */
+uint32_t
+GooseSubscriber_getSlotChecksum(GooseSubscriber self);
+
+/**
+ * \brief calculate the checksum of slot values (e.g. of a copy made by the application)
+ */
+uint32_t
+GooseSubscriber_calculateSlotChecksum(GooseSlotValue* slotValues, int slotCount);
+
+/**
+ * \brief process a GOOSE APDU that has been received by other means than the subscriber itself
+ *
+ * The message is decoded and the listener is called when the gocbRef is matching.
+ *
+ * \param self GooseSubscriber instance to operate on.
+ * \param apdu buffer containing the GOOSE APDU (the message without ethernet and GOOSE header)
+ * \param apduLength the length of the APDU in bytes
+ *
+ * \return true if the message has been accepted by the subscriber
+ */
+bool
+GooseSubscriber_handleMessage(GooseSubscriber self, uint8_t* apdu, int apduLength);
+
 uint32_t
 GooseSubscriber_getStNum(GooseSubscriber self);
 
@@ -138,6 +285,18 @@ GooseSubscriber_getTimeAllowedToLive(GooseSubscriber self);
 uint64_t
 GooseSubscriber_getTimestamp(GooseSubscriber self);
 
+/**
+ * \brief get the receive time of the last message
+ *
+ * The time stamp is taken when the frame is received by the kernel or the network adapter (see
+ * EthernetFrameHandler) and can be compared with GooseSubscriber_getTimestamp to measure the
+ * transmission latency. The value is updated before the listener is called.
+ *
+ * \return the receive time in ns since epoch
+ */
+uint64_t
+GooseSubscriber_getReceiveTimestamp(GooseSubscriber self);
+
 MmsValue*
 GooseSubscriber_getDataSetValues(GooseSubscriber self);
 
@@ -35,6 +35,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <fcntl.h>
+#include <poll.h>
 
 #include "ethernet.h"
 
@@ -334,12 +335,84 @@ int Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
         return 0;
 }
 
+bool Ethernet_setFrameFilter(EthernetSocket self, uint16_t etherType, uint16_t* appIds, int appIdCount,
+        uint8_t* dstAddresses, int dstAddressCount)
+{
+    // Not supported - the BPF program of the socket only filters by EtherType and a single destination address.
+    return false;
+}
+
+bool Ethernet_addMulticastAddress(EthernetSocket self, uint8_t* macAddress)
+{
+    // Not required - the interface is set into promiscuous mode when the socket is created.
+    return true;
+}
+
+int Ethernet_receivePackets(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int timeoutInMs)
+{
+    int frames = 0;
+
+    // If the actual buffer is empty, wait for new data and read it from the BPF device.
+    if (self->bpfEnd - self->bpfPositon < 4)
+    {
+        struct pollfd pollFd;
+
+        pollFd.fd = self->bpf;
+        pollFd.events = POLLIN;
+        pollFd.revents = 0;
+
+        if (poll(&pollFd, 1, timeoutInMs) < 1)
+            return 0;
+
+        self->bpfPositon = self->bpfBuffer;
+
+        int size = read(self->bpf, self->bpfBuffer, self->bpfBufferSize);
+
+        if (size >= 0)
+            self->bpfEnd = self->bpfBuffer + size;
+        else
+            self->bpfEnd = NULL;
+    }
+
+    // Pass all frames of the buffer to the handler without copying them.
+    while (self->bpfPositon < self->bpfEnd)
+    {
+        struct bpf_hdr *header = (struct bpf_hdr *)(self->bpfPositon);
+
+        uint64_t timestamp = ((uint64_t) header->bh_tstamp.tv_sec * 1000000000ULL) +
+                ((uint64_t) header->bh_tstamp.tv_usec * 1000);
+
+        handler(parameter, self->bpfPositon + header->bh_hdrlen, header->bh_caplen, timestamp);
+
+        self->bpfPositon += BPF_WORDALIGN(header->bh_hdrlen + header->bh_caplen);
+
+        frames++;
+    }
+
+    return frames;
+}
+
 void Ethernet_sendPacket(EthernetSocket self, uint8_t* buffer, int packetSize)
 {
     // Just send the packet as it is.
     write(self->bpf, buffer, packetSize);
 }
 
+int Ethernet_sendPackets(EthernetSocket self, uint8_t** buffers, int* packetSizes, int packetCount)
+{
+    int sent = 0;
+
+    // BPF has no batch transmission - write the frames one by one.
+    while (sent < packetCount) {
+        if (write(self->bpf, buffers[sent], packetSizes[sent]) == -1)
+            break;
+
+        sent++;
+    }
+
+    return sent;
+}
+
 void Ethernet_destroySocket(EthernetSocket self)
 {
     // Close the BPF device.
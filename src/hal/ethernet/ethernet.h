@@ -25,6 +25,7 @@
 #define ETHERNET_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -74,12 +75,91 @@ Ethernet_destroySocket(EthernetSocket ethSocket);
 void
 Ethernet_sendPacket(EthernetSocket ethSocket, uint8_t* buffer, int packetSize);
 
+/**
+ * Send multiple complete ethernet frames with as few system calls as possible.
+ *
+ * On Linux the frames are passed to the kernel with sendmmsg. Other platforms send the
+ * frames one by one if no batch transmission is available. The frames are sent in the
+ * order of the array.
+ *
+ * \param buffers array of frame buffers
+ * \param packetSizes array with the size of each frame in bytes
+ * \param packetCount number of frames
+ *
+ * \return the number of frames that have been sent
+ */
+int
+Ethernet_sendPackets(EthernetSocket ethSocket, uint8_t** buffers, int* packetSizes, int packetCount);
+
 void
 Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType);
 
 int
 Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize);
 
+/**
+ * Install a frame filter in the kernel that drops irrelevant GOOSE or SV frames.
+ *
+ * Only frames with the given EtherType (with or without VLAN tag) are accepted. If appIdCount is
+ * greater than zero the APPID of the frame has to be one of the given values. If dstAddressCount is
+ * greater than zero the destination MAC address has to be one of the given addresses.
+ * Calling the function again replaces the filter.
+ *
+ * \param etherType the EtherType of the accepted frames
+ * \param appIds array of accepted APPID values
+ * \param appIdCount number of APPID values or 0 to accept all APPIDs
+ * \param dstAddresses accepted destination MAC addresses (6 bytes per address)
+ * \param dstAddressCount number of MAC addresses or 0 to accept all destinations
+ *
+ * \return true if the filter has been installed, false if not supported by the platform
+ */
+bool
+Ethernet_setFrameFilter(EthernetSocket self, uint16_t etherType, uint16_t* appIds, int appIdCount,
+        uint8_t* dstAddresses, int dstAddressCount);
+
+/**
+ * Join an ethernet multicast group on the interface of the socket.
+ *
+ * \param macAddress the multicast MAC address (6 bytes)
+ *
+ * \return true on success, false otherwise
+ */
+bool
+Ethernet_addMulticastAddress(EthernetSocket self, uint8_t* macAddress);
+
+/**
+ * Callback that is invoked by Ethernet_receivePackets for each received frame.
+ *
+ * The frame buffer is only valid until the callback returns.
+ *
+ * The receive time stamp is taken by the kernel (Linux: SO_TIMESTAMPING or SO_TIMESTAMPNS) or by
+ * the network adapter if CONFIG_ETHERNET_USE_HW_TIMESTAMPS is set and supported by the adapter.
+ * Hardware time stamps are in the time base of the adapter clock that is usually synchronized
+ * with PTP.
+ *
+ * \param parameter user provided parameter
+ * \param buffer the received ethernet frame (starting with the destination MAC address)
+ * \param packetSize the size of the frame in bytes
+ * \param timestamp the receive time in ns since epoch
+ */
+typedef void (*EthernetFrameHandler) (void* parameter, uint8_t* buffer, int packetSize, uint64_t timestamp);
+
+/**
+ * Wait for received frames and pass all pending frames to the handler.
+ *
+ * On Linux the frames are taken from a memory mapped receive ring (TPACKET_V3) without copying
+ * if CONFIG_ETHERNET_USE_RX_RING is set. If the ring cannot be created the frames are read with
+ * recvfrom. Don't mix this function with Ethernet_receivePacket on the same socket.
+ *
+ * \param handler the callback function that is invoked for each frame
+ * \param parameter user provided parameter that is passed to the callback function
+ * \param timeoutInMs maximum time to wait for new frames
+ *
+ * \return the number of handled frames or -1 in case of an error
+ */
+int
+Ethernet_receivePackets(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int timeoutInMs);
+
 /*! @} */
 
 /*! @} */
@@ -21,6 +21,10 @@
  *  See COPYING file for the complete license text.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for sendmmsg */
+#endif
+
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <linux/if_packet.h>
@@ -28,6 +32,13 @@
 #include <linux/if_arp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <time.h>
 
 #include <stdint.h>
 #include <stdlib.h>
@@ -35,12 +46,46 @@
 #include <stdbool.h>
 #include <stdio.h>
 
+#include "stack_config.h"
 #include "ethernet.h"
 
+#if (CONFIG_ETHERNET_USE_RX_RING == 1) && defined(TPACKET3_HDRLEN)
+#define ETHERNET_HAS_RX_RING 1
+#endif
+
+#define RX_RING_BLOCK_SIZE (1 << 16)
+#define RX_RING_FRAME_SIZE 2048
+
+#ifndef CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT
+#define CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT 1
+#endif
+
+#define RX_BUFFER_SIZE 2048
+
+#define TX_BATCH_SIZE 64 /* maximum number of frames passed to a single sendmmsg call */
+
+#ifndef SO_TIMESTAMPING
+#define SO_TIMESTAMPING 37
+#define SCM_TIMESTAMPING SO_TIMESTAMPING
+#endif
+
+/* source of the receive time stamps used by receiveWithRecvfrom */
+#define TIMESTAMPS_NONE 0
+#define TIMESTAMPS_TIMESTAMPING 1 /* SO_TIMESTAMPING - software or hardware */
+#define TIMESTAMPS_TIMESTAMPNS 2  /* SO_TIMESTAMPNS - software only */
+
 struct sEthernetSocket {
     int rawSocket;
     bool isBind;
     struct sockaddr_ll socketAddress;
+
+    int rxRingState; /* 0 - not initialized, 1 - receive ring is used, -1 - recvfrom is used */
+    uint8_t* rxRing;
+    size_t rxRingSize;
+    int rxRingBlock; /* next block to read */
+    uint8_t* rxBuffer;
+
+    int timestampMode;
 };
 
 static int
@@ -137,21 +182,394 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType)
     ethSocket->socketAddress.sll_protocol = htons(etherType);
 }
 
+#define FRAME_FILTER_ACCEPT 0x40000
+#define ETHERTYPE_VLAN 0x8100
 
-/* non-blocking receive */
-int
-Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
+bool
+Ethernet_setFrameFilter(EthernetSocket self, uint16_t etherType, uint16_t* appIds, int appIdCount,
+        uint8_t* dstAddresses, int dstAddressCount)
+{
+    struct sock_fprog program;
+    struct sock_filter* code;
+    int pc = 0;
+    int i;
+
+    code = (struct sock_filter*) calloc(12 + (appIdCount * 2) + (dstAddressCount * 5), sizeof(struct sock_filter));
+
+    /* X := offset of the EtherType relative to an untagged frame (4 if VLAN tag is present) */
+    code[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12);
+    code[pc++] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETHERTYPE_VLAN, 0, 2);
+    code[pc++] = (struct sock_filter) BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 4);
+    code[pc++] = (struct sock_filter) BPF_STMT(BPF_JMP | BPF_JA, 1);
+    code[pc++] = (struct sock_filter) BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 0);
+
+    code[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_IND, 12);
+    code[pc++] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, etherType, 1, 0);
+    code[pc++] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0);
+
+    if (appIdCount > 0) {
+        int appIdCheckEnd = pc + 1 + (appIdCount * 2) + 1;
+
+        code[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_IND, 14);
+
+        for (i = 0; i < appIdCount; i++) {
+            code[pc++] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, appIds[i], 0, 1);
+            code[pc] = (struct sock_filter) BPF_STMT(BPF_JMP | BPF_JA, appIdCheckEnd - (pc + 1));
+            pc++;
+        }
+
+        code[pc++] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0);
+    }
+
+    if (dstAddressCount > 0) {
+        for (i = 0; i < dstAddressCount; i++) {
+            uint8_t* addr = dstAddresses + (i * 6);
+
+            uint32_t addrHigh = (addr[0] << 24) + (addr[1] << 16) + (addr[2] << 8) + addr[3];
+            uint32_t addrLow = (addr[4] << 8) + addr[5];
+
+            code[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 0);
+            code[pc++] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, addrHigh, 0, 3);
+            code[pc++] = (struct sock_filter) BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 4);
+            code[pc++] = (struct sock_filter) BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, addrLow, 0, 1);
+            code[pc++] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, FRAME_FILTER_ACCEPT);
+        }
+
+        code[pc++] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, 0);
+    }
+    else
+        code[pc++] = (struct sock_filter) BPF_STMT(BPF_RET | BPF_K, FRAME_FILTER_ACCEPT);
+
+    program.len = pc;
+    program.filter = code;
+
+    int result = setsockopt(self->rawSocket, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program));
+
+    free(code);
+
+    if (result == -1) {
+        perror("ETHERNET_LINUX: Failed to attach frame filter");
+        return false;
+    }
+
+    return true;
+}
+
+bool
+Ethernet_addMulticastAddress(EthernetSocket self, uint8_t* macAddress)
+{
+    struct packet_mreq mreq;
+
+    memset(&mreq, 0, sizeof(mreq));
+
+    mreq.mr_ifindex = self->socketAddress.sll_ifindex;
+    mreq.mr_type = PACKET_MR_MULTICAST;
+    mreq.mr_alen = ETH_ALEN;
+    memcpy(mreq.mr_address, macAddress, ETH_ALEN);
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == -1) {
+        perror("ETHERNET_LINUX: Failed to add multicast membership");
+        return false;
+    }
+
+    return true;
+}
+
+
+static bool
+bindSocket(EthernetSocket self)
 {
     if (self->isBind == false) {
         if (bind(self->rawSocket, (struct sockaddr*) &self->socketAddress, sizeof(self->socketAddress)) == 0)
             self->isBind = true;
-        else
-            return 0;
     }
 
+    return self->isBind;
+}
+
+/* non-blocking receive */
+int
+Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
+{
+    if (bindSocket(self) == false)
+        return 0;
+
     return recvfrom(self->rawSocket, buffer, bufferSize, MSG_DONTWAIT, 0, 0);
 }
 
+static bool
+waitForFrames(EthernetSocket self, int timeoutInMs)
+{
+    struct pollfd pollFd;
+
+    pollFd.fd = self->rawSocket;
+    pollFd.events = POLLIN | POLLERR;
+    pollFd.revents = 0;
+
+    if (poll(&pollFd, 1, timeoutInMs) == -1)
+        return (errno == EINTR);
+
+    return true;
+}
+
+static uint64_t
+getCurrentTimeInNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    return ((uint64_t) now.tv_sec * 1000000000ULL) + now.tv_nsec;
+}
+
+#if (CONFIG_ETHERNET_USE_HW_TIMESTAMPS == 1)
+/* let the network adapter time stamp all received frames */
+static bool
+enableHardwareTimestamps(EthernetSocket self)
+{
+    struct ifreq ifr;
+    struct hwtstamp_config config;
+
+    memset(&ifr, 0, sizeof(ifr));
+    memset(&config, 0, sizeof(config));
+
+    config.tx_type = HWTSTAMP_TX_OFF;
+    config.rx_filter = HWTSTAMP_FILTER_ALL;
+
+    ifr.ifr_ifindex = self->socketAddress.sll_ifindex;
+
+    if (ioctl(self->rawSocket, SIOCGIFNAME, &ifr) == -1)
+        return false;
+
+    ifr.ifr_data = (char*) &config;
+
+    if (ioctl(self->rawSocket, SIOCSHWTSTAMP, &ifr) == -1) {
+        perror("ETHERNET_LINUX: Hardware time stamps not supported - using software time stamps");
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+static void
+enableTimestamps(EthernetSocket self)
+{
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+#if (CONFIG_ETHERNET_USE_HW_TIMESTAMPS == 1)
+    if (enableHardwareTimestamps(self))
+        flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+#endif
+
+    if (self->rxRingState == 1) {
+        /* the receive ring contains a software time stamp for each frame - replace it by the hardware time stamp */
+        if (flags & SOF_TIMESTAMPING_RAW_HARDWARE)
+            setsockopt(self->rawSocket, SOL_PACKET, PACKET_TIMESTAMP, &flags, sizeof(flags));
+
+        return;
+    }
+
+    if (setsockopt(self->rawSocket, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0)
+        self->timestampMode = TIMESTAMPS_TIMESTAMPING;
+    else {
+        int enable = 1;
+
+        if (setsockopt(self->rawSocket, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == 0)
+            self->timestampMode = TIMESTAMPS_TIMESTAMPNS;
+        else
+            self->timestampMode = TIMESTAMPS_NONE;
+    }
+}
+
+#ifdef ETHERNET_HAS_RX_RING
+
+static bool
+createRxRing(EthernetSocket self)
+{
+    int version = TPACKET_V3;
+    struct tpacket_req3 req;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1)
+        return false;
+
+    memset(&req, 0, sizeof(req));
+
+    req.tp_block_size = RX_RING_BLOCK_SIZE;
+    req.tp_block_nr = CONFIG_ETHERNET_RX_RING_BLOCKS;
+    req.tp_frame_size = RX_RING_FRAME_SIZE;
+    req.tp_frame_nr = (RX_RING_BLOCK_SIZE / RX_RING_FRAME_SIZE) * CONFIG_ETHERNET_RX_RING_BLOCKS;
+    req.tp_retire_blk_tov = CONFIG_ETHERNET_RX_RING_BLOCK_TIMEOUT;
+
+    if (setsockopt(self->rawSocket, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1)
+        return false;
+
+    self->rxRingSize = (size_t) req.tp_block_size * req.tp_block_nr;
+
+    self->rxRing = (uint8_t*) mmap(NULL, self->rxRingSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+            self->rawSocket, 0);
+
+    if (self->rxRing == MAP_FAILED) {
+        self->rxRing = NULL;
+
+        /* release the ring - frames will be delivered to recvfrom again */
+        memset(&req, 0, sizeof(req));
+        setsockopt(self->rawSocket, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+
+        return false;
+    }
+
+    self->rxRingBlock = 0;
+
+    return true;
+}
+
+static int
+receiveFromRxRing(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int timeoutInMs)
+{
+    int frames = 0;
+    int blocks = 0;
+
+    struct tpacket_block_desc* block =
+            (struct tpacket_block_desc*) (self->rxRing + (self->rxRingBlock * RX_RING_BLOCK_SIZE));
+
+    if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+        if (waitForFrames(self, timeoutInMs) == false)
+            return -1;
+    }
+
+    /* hand over all blocks the kernel has released */
+    while ((blocks < CONFIG_ETHERNET_RX_RING_BLOCKS) && (block->hdr.bh1.block_status & TP_STATUS_USER)) {
+
+        __sync_synchronize();
+
+        struct tpacket3_hdr* frame = (struct tpacket3_hdr*) ((uint8_t*) block + block->hdr.bh1.offset_to_first_pkt);
+
+        uint32_t i;
+        for (i = 0; i < block->hdr.bh1.num_pkts; i++) {
+            uint64_t timestamp = ((uint64_t) frame->tp_sec * 1000000000ULL) + frame->tp_nsec;
+
+            handler(parameter, (uint8_t*) frame + frame->tp_mac, frame->tp_snaplen, timestamp);
+
+            frame = (struct tpacket3_hdr*) ((uint8_t*) frame + frame->tp_next_offset);
+            frames++;
+        }
+
+        __sync_synchronize();
+
+        block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+
+        self->rxRingBlock = (self->rxRingBlock + 1) % CONFIG_ETHERNET_RX_RING_BLOCKS;
+
+        block = (struct tpacket_block_desc*) (self->rxRing + (self->rxRingBlock * RX_RING_BLOCK_SIZE));
+
+        blocks++;
+    }
+
+    return frames;
+}
+
+#endif /* ETHERNET_HAS_RX_RING */
+
+/* get the receive time stamp from the control messages of recvmsg */
+static uint64_t
+getTimestamp(EthernetSocket self, struct msghdr* message)
+{
+    struct cmsghdr* cmsg;
+
+    for (cmsg = CMSG_FIRSTHDR(message); cmsg != NULL; cmsg = CMSG_NXTHDR(message, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET)
+            continue;
+
+        if ((cmsg->cmsg_type == SCM_TIMESTAMPING) && (self->timestampMode == TIMESTAMPS_TIMESTAMPING)) {
+            /* [0] - software time stamp, [2] - raw hardware time stamp */
+            struct timespec* timestamps = (struct timespec*) CMSG_DATA(cmsg);
+
+            if ((timestamps[2].tv_sec != 0) || (timestamps[2].tv_nsec != 0))
+                return ((uint64_t) timestamps[2].tv_sec * 1000000000ULL) + timestamps[2].tv_nsec;
+
+            if ((timestamps[0].tv_sec != 0) || (timestamps[0].tv_nsec != 0))
+                return ((uint64_t) timestamps[0].tv_sec * 1000000000ULL) + timestamps[0].tv_nsec;
+        }
+        else if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec* timestamp = (struct timespec*) CMSG_DATA(cmsg);
+
+            return ((uint64_t) timestamp->tv_sec * 1000000000ULL) + timestamp->tv_nsec;
+        }
+    }
+
+    return getCurrentTimeInNs();
+}
+
+static int
+receiveWithRecvfrom(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int timeoutInMs)
+{
+    int frames = 0;
+
+    struct msghdr message;
+    struct iovec iov;
+    union {
+        uint8_t buffer[CMSG_SPACE(3 * sizeof(struct timespec))];
+        struct cmsghdr align;
+    } control;
+
+    if (self->rxBuffer == NULL)
+        self->rxBuffer = (uint8_t*) malloc(RX_BUFFER_SIZE);
+
+    if (waitForFrames(self, timeoutInMs) == false)
+        return -1;
+
+    while (true) {
+        iov.iov_base = self->rxBuffer;
+        iov.iov_len = RX_BUFFER_SIZE;
+
+        memset(&message, 0, sizeof(message));
+
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+
+        int packetSize = recvmsg(self->rawSocket, &message, MSG_DONTWAIT);
+
+        if (packetSize <= 0)
+            break;
+
+        handler(parameter, self->rxBuffer, packetSize, getTimestamp(self, &message));
+
+        frames++;
+    }
+
+    return frames;
+}
+
+int
+Ethernet_receivePackets(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int timeoutInMs)
+{
+    if (self->rxRingState == 0) {
+        self->rxRingState = -1;
+
+#ifdef ETHERNET_HAS_RX_RING
+        if (createRxRing(self))
+            self->rxRingState = 1;
+        else
+            printf("ETHERNET_LINUX: Failed to create receive ring - using recvfrom\n");
+#endif
+
+        enableTimestamps(self);
+    }
+
+    if (bindSocket(self) == false)
+        return -1;
+
+#ifdef ETHERNET_HAS_RX_RING
+    if (self->rxRingState == 1)
+        return receiveFromRxRing(self, handler, parameter, timeoutInMs);
+#endif
+
+    return receiveWithRecvfrom(self, handler, parameter, timeoutInMs);
+}
+
 void
 Ethernet_sendPacket(EthernetSocket ethSocket, uint8_t* buffer, int packetSize)
 {
@@ -159,9 +577,80 @@ Ethernet_sendPacket(EthernetSocket ethSocket, uint8_t* buffer, int packetSize)
                 0, (struct sockaddr*) &(ethSocket->socketAddress), sizeof(ethSocket->socketAddress));
 }
 
+static int
+sendPacketsWithSendto(EthernetSocket self, uint8_t** buffers, int* packetSizes, int packetCount)
+{
+    int sent = 0;
+
+    while (sent < packetCount) {
+        if (sendto(self->rawSocket, buffers[sent], packetSizes[sent], 0,
+                (struct sockaddr*) &(self->socketAddress), sizeof(self->socketAddress)) == -1)
+            break;
+
+        sent++;
+    }
+
+    return sent;
+}
+
+int
+Ethernet_sendPackets(EthernetSocket self, uint8_t** buffers, int* packetSizes, int packetCount)
+{
+    struct mmsghdr messages[TX_BATCH_SIZE];
+    struct iovec iovecs[TX_BATCH_SIZE];
+
+    int sent = 0;
+
+    while (sent < packetCount) {
+        int batchSize = packetCount - sent;
+
+        if (batchSize > TX_BATCH_SIZE)
+            batchSize = TX_BATCH_SIZE;
+
+        memset(messages, 0, batchSize * sizeof(struct mmsghdr));
+
+        int i;
+
+        for (i = 0; i < batchSize; i++) {
+            iovecs[i].iov_base = buffers[sent + i];
+            iovecs[i].iov_len = packetSizes[sent + i];
+
+            messages[i].msg_hdr.msg_name = &(self->socketAddress);
+            messages[i].msg_hdr.msg_namelen = sizeof(self->socketAddress);
+            messages[i].msg_hdr.msg_iov = &(iovecs[i]);
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(self->rawSocket, messages, batchSize, 0);
+
+        if (result == -1) {
+            if (errno == EINTR)
+                continue;
+
+            /* kernel without sendmmsg support */
+            if (errno == ENOSYS)
+                return sent + sendPacketsWithSendto(self, buffers + sent, packetSizes + sent, packetCount - sent);
+
+            perror("ETHERNET_LINUX: Failed to send frames");
+
+            break;
+        }
+
+        sent += result;
+    }
+
+    return sent;
+}
+
 void
 Ethernet_destroySocket(EthernetSocket ethSocket)
 {
+    if (ethSocket->rxRing != NULL)
+        munmap(ethSocket->rxRing, ethSocket->rxRingSize);
+
+    if (ethSocket->rxBuffer != NULL)
+        free(ethSocket->rxBuffer);
+
     close(ethSocket->rawSocket);
     free(ethSocket);
 }
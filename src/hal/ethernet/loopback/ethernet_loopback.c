@@ -0,0 +1,591 @@
+/*
+ *  ethernet_loopback.c
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+/*
+ * Ethernet HAL without network access.
+ *
+ * All sockets of an interface ID share a frame bus in POSIX shared memory. A frame that is
+ * sent by one socket is received by all other sockets of the same interface ID - in the same
+ * process or in other processes of the host. No special privileges are required.
+ *
+ * The bus is a ring of CONFIG_ETHERNET_LOOPBACK_SLOTS frames. Senders serialize on a process
+ * shared mutex. Receivers read without locking and only wait on the condition variable when
+ * there are no new frames. Receivers that fall behind by more than the size of the ring lose
+ * the oldest frames (like a full socket receive buffer).
+ *
+ * The shared memory is removed when the last socket of the bus is destroyed. A process that is
+ * killed while it has open sockets leaves the bus behind. It is reused by the next process; it
+ * can also be removed by hand (/dev/shm/libiec61850-eth-<interface ID> on Linux).
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "stack_config.h"
+#include "ethernet.h"
+
+#define LOOPBACK_BUS_MAGIC 0x4c4f4f50
+#define LOOPBACK_MAX_FRAME_SIZE 1536
+#define LOOPBACK_MAX_FILTER_ENTRIES 32
+
+/* maximum time in ms to wait for another process that creates the bus */
+#define LOOPBACK_BUS_INIT_TIMEOUT 1000
+
+/* number of attempts to open a bus that is removed by another process at the same time */
+#define LOOPBACK_BUS_OPEN_ATTEMPTS 10
+
+#define LOOPBACK_BUS_NAME_SIZE 64
+
+#define ETHERTYPE_VLAN 0x8100
+
+typedef struct {
+    uint32_t sender; /* ID of the sending socket - a socket does not receive its own frames */
+    int32_t length;
+    uint64_t timestamp; /* time in ns since epoch when the frame has been put on the bus */
+    uint8_t frame[LOOPBACK_MAX_FRAME_SIZE];
+} LoopbackSlot;
+
+typedef struct {
+    volatile uint32_t magic; /* set when the bus is initialized */
+    pthread_mutex_t mutex;
+    pthread_cond_t newFrames;
+    volatile uint32_t writeIndex; /* number of frames sent on the bus */
+    volatile uint32_t nextSocketId;
+    uint32_t users; /* number of sockets using the bus - protected by the mutex */
+    LoopbackSlot slots[CONFIG_ETHERNET_LOOPBACK_SLOTS];
+} LoopbackBus;
+
+struct sEthernetSocket {
+    LoopbackBus* bus;
+    char busName[LOOPBACK_BUS_NAME_SIZE];
+    uint32_t socketId;
+
+    bool isBind;
+    uint32_t readIndex;
+
+    /* software frame filter - 0 entries accept all frames */
+    uint16_t etherType;
+    int appIdCount;
+    uint16_t appIds[LOOPBACK_MAX_FILTER_ENTRIES];
+    int dstAddressCount;
+    uint8_t dstAddresses[LOOPBACK_MAX_FILTER_ENTRIES * 6];
+
+    uint8_t rxBuffer[LOOPBACK_MAX_FRAME_SIZE];
+    uint64_t rxTimestamp;
+};
+
+static void
+getBusName(char* interfaceId, char* busName, int maxLength)
+{
+    int pos = snprintf(busName, maxLength, "/libiec61850-eth-");
+
+    /* shared memory names must not contain further slashes */
+    while ((*interfaceId != 0) && (pos < maxLength - 1)) {
+        char c = *interfaceId++;
+
+        busName[pos++] = (c == '/') ? '_' : c;
+    }
+
+    busName[pos] = 0;
+}
+
+static bool
+lockBus(LoopbackBus* bus)
+{
+    int result = pthread_mutex_lock(&(bus->mutex));
+
+#ifdef PTHREAD_MUTEX_ROBUST
+    /* the previous owner died while sending - the bus content is still consistent */
+    if (result == EOWNERDEAD)
+        result = pthread_mutex_consistent(&(bus->mutex));
+#endif
+
+    return (result == 0);
+}
+
+static void
+initializeBus(LoopbackBus* bus)
+{
+    pthread_mutexattr_t mutexAttributes;
+    pthread_condattr_t condAttributes;
+
+    pthread_mutexattr_init(&mutexAttributes);
+    pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+#ifdef PTHREAD_MUTEX_ROBUST
+    pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+#endif
+    pthread_mutex_init(&(bus->mutex), &mutexAttributes);
+    pthread_mutexattr_destroy(&mutexAttributes);
+
+    pthread_condattr_init(&condAttributes);
+    pthread_condattr_setpshared(&condAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&(bus->newFrames), &condAttributes);
+    pthread_condattr_destroy(&condAttributes);
+
+    bus->writeIndex = 0;
+    bus->nextSocketId = 1;
+    bus->users = 1; /* the socket of the creating process */
+
+    __sync_synchronize();
+
+    bus->magic = LOOPBACK_BUS_MAGIC;
+}
+
+/* result of tryOpenBus if the bus has been removed by another process while it was opened */
+#define LOOPBACK_BUS_REMOVED ((LoopbackBus*) -1)
+
+static LoopbackBus*
+tryOpenBus(char* busName)
+{
+    bool created = true;
+
+    int fd = shm_open(busName, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    if (fd == -1) {
+        if (errno != EEXIST) {
+            perror("ETHERNET_LOOPBACK: Failed to create frame bus");
+            return NULL;
+        }
+
+        created = false;
+
+        fd = shm_open(busName, O_RDWR, 0600);
+
+        if (fd == -1) {
+            /* removed after the first shm_open */
+            if (errno == ENOENT)
+                return LOOPBACK_BUS_REMOVED;
+
+            perror("ETHERNET_LOOPBACK: Failed to open frame bus");
+            return NULL;
+        }
+    }
+    else if (ftruncate(fd, sizeof(LoopbackBus)) == -1) {
+        perror("ETHERNET_LOOPBACK: Failed to allocate frame bus");
+        close(fd);
+        shm_unlink(busName);
+        return NULL;
+    }
+
+    /* wait until the process that creates the bus has set its size */
+    if (created == false) {
+        struct stat fileStatus;
+        int retries = LOOPBACK_BUS_INIT_TIMEOUT;
+
+        while ((fstat(fd, &fileStatus) == 0) && (fileStatus.st_size < (off_t) sizeof(LoopbackBus))) {
+            if (--retries == 0) {
+                printf("ETHERNET_LOOPBACK: Frame bus %s has wrong size\n", busName);
+                close(fd);
+                return NULL;
+            }
+
+            usleep(1000);
+        }
+    }
+
+    LoopbackBus* bus = (LoopbackBus*) mmap(NULL, sizeof(LoopbackBus), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (bus == MAP_FAILED) {
+        perror("ETHERNET_LOOPBACK: Failed to map frame bus");
+        return NULL;
+    }
+
+    if (created) {
+        initializeBus(bus);
+        return bus;
+    }
+
+    int retries = LOOPBACK_BUS_INIT_TIMEOUT;
+
+    while (bus->magic != LOOPBACK_BUS_MAGIC) {
+        if (--retries == 0) {
+            /* the creating process died before the bus was initialized - remove it so it is created again */
+            printf("ETHERNET_LOOPBACK: Frame bus %s is not initialized - removed\n", busName);
+            munmap(bus, sizeof(LoopbackBus));
+            shm_unlink(busName);
+            return LOOPBACK_BUS_REMOVED;
+        }
+
+        usleep(1000);
+    }
+
+    if (lockBus(bus) == false) {
+        munmap(bus, sizeof(LoopbackBus));
+        return NULL;
+    }
+
+    /* the last socket has been destroyed and the bus has been unlinked after it was opened */
+    bool removed = (bus->users == 0);
+
+    if (removed == false)
+        bus->users++;
+
+    pthread_mutex_unlock(&(bus->mutex));
+
+    if (removed) {
+        munmap(bus, sizeof(LoopbackBus));
+        return LOOPBACK_BUS_REMOVED;
+    }
+
+    return bus;
+}
+
+static LoopbackBus*
+openBus(char* busName)
+{
+    int attempts;
+
+    for (attempts = 0; attempts < LOOPBACK_BUS_OPEN_ATTEMPTS; attempts++) {
+        LoopbackBus* bus = tryOpenBus(busName);
+
+        if (bus != LOOPBACK_BUS_REMOVED)
+            return bus;
+    }
+
+    printf("ETHERNET_LOOPBACK: Failed to open frame bus %s\n", busName);
+
+    return NULL;
+}
+
+static void
+closeBus(LoopbackBus* bus, char* busName)
+{
+    if (lockBus(bus)) {
+        bus->users--;
+
+        /* remove the shared memory with the last socket - it is freed when all mappings are gone */
+        if (bus->users == 0)
+            shm_unlink(busName);
+
+        pthread_mutex_unlock(&(bus->mutex));
+    }
+
+    munmap(bus, sizeof(LoopbackBus));
+}
+
+void
+Ethernet_getInterfaceMACAddress(char* interfaceId, uint8_t* addr)
+{
+    /* locally administered address derived from the interface ID */
+    uint32_t hash = 2166136261u;
+
+    while (*interfaceId != 0) {
+        hash ^= (uint8_t) *interfaceId++;
+        hash *= 16777619u;
+    }
+
+    addr[0] = 0x02;
+    addr[1] = 0x00;
+    addr[2] = (uint8_t) (hash >> 24);
+    addr[3] = (uint8_t) (hash >> 16);
+    addr[4] = (uint8_t) (hash >> 8);
+    addr[5] = (uint8_t) hash;
+}
+
+EthernetSocket
+Ethernet_createSocket(char* interfaceId, uint8_t* destAddress)
+{
+    char busName[LOOPBACK_BUS_NAME_SIZE];
+
+    (void) destAddress;
+
+    getBusName(interfaceId, busName, sizeof(busName));
+
+    LoopbackBus* bus = openBus(busName);
+
+    if (bus == NULL)
+        return NULL;
+
+    EthernetSocket self = (EthernetSocket) calloc(1, sizeof(struct sEthernetSocket));
+
+    self->bus = bus;
+    strcpy(self->busName, busName);
+    self->socketId = __sync_fetch_and_add(&(bus->nextSocketId), 1);
+
+    return self;
+}
+
+void
+Ethernet_destroySocket(EthernetSocket self)
+{
+    closeBus(self->bus, self->busName);
+    free(self);
+}
+
+void
+Ethernet_sendPacket(EthernetSocket self, uint8_t* buffer, int packetSize)
+{
+    Ethernet_sendPackets(self, &buffer, &packetSize, 1);
+}
+
+int
+Ethernet_sendPackets(EthernetSocket self, uint8_t** buffers, int* packetSizes, int packetCount)
+{
+    LoopbackBus* bus = self->bus;
+
+    if (lockBus(bus) == false)
+        return 0;
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    uint64_t timestamp = ((uint64_t) now.tv_sec * 1000000000ULL) + now.tv_nsec;
+
+    int i;
+
+    for (i = 0; i < packetCount; i++) {
+        int packetSize = packetSizes[i];
+
+        if (packetSize > LOOPBACK_MAX_FRAME_SIZE)
+            packetSize = LOOPBACK_MAX_FRAME_SIZE;
+
+        LoopbackSlot* slot = &(bus->slots[bus->writeIndex % CONFIG_ETHERNET_LOOPBACK_SLOTS]);
+
+        slot->sender = self->socketId;
+        slot->length = packetSize;
+        slot->timestamp = timestamp;
+        memcpy(slot->frame, buffers[i], packetSize);
+
+        /* publish the frame for the lock free readers */
+        __sync_synchronize();
+
+        bus->writeIndex++;
+    }
+
+    pthread_cond_broadcast(&(bus->newFrames));
+
+    pthread_mutex_unlock(&(bus->mutex));
+
+    return packetCount;
+}
+
+void
+Ethernet_setProtocolFilter(EthernetSocket self, uint16_t etherType)
+{
+    self->etherType = etherType;
+}
+
+bool
+Ethernet_setFrameFilter(EthernetSocket self, uint16_t etherType, uint16_t* appIds, int appIdCount,
+        uint8_t* dstAddresses, int dstAddressCount)
+{
+    if ((appIdCount > LOOPBACK_MAX_FILTER_ENTRIES) || (dstAddressCount > LOOPBACK_MAX_FILTER_ENTRIES))
+        return false;
+
+    self->etherType = etherType;
+
+    if (appIdCount > 0)
+        memcpy(self->appIds, appIds, appIdCount * sizeof(uint16_t));
+
+    self->appIdCount = appIdCount;
+
+    if (dstAddressCount > 0)
+        memcpy(self->dstAddresses, dstAddresses, dstAddressCount * 6);
+
+    self->dstAddressCount = dstAddressCount;
+
+    return true;
+}
+
+bool
+Ethernet_addMulticastAddress(EthernetSocket self, uint8_t* macAddress)
+{
+    (void) self;
+    (void) macAddress;
+
+    /* all frames of the bus are visible to all sockets */
+    return true;
+}
+
+static bool
+acceptFrame(EthernetSocket self, uint8_t* frame, int length)
+{
+    int etherTypeOffset = 12;
+
+    if (length < 16)
+        return false;
+
+    if (((frame[12] << 8) + frame[13]) == ETHERTYPE_VLAN)
+        etherTypeOffset = 16;
+
+    if (self->etherType != 0) {
+        if (((frame[etherTypeOffset] << 8) + frame[etherTypeOffset + 1]) != self->etherType)
+            return false;
+    }
+
+    int i;
+
+    if (self->appIdCount > 0) {
+        if (length < etherTypeOffset + 4)
+            return false;
+
+        uint16_t appId = (frame[etherTypeOffset + 2] << 8) + frame[etherTypeOffset + 3];
+
+        for (i = 0; i < self->appIdCount; i++) {
+            if (self->appIds[i] == appId)
+                break;
+        }
+
+        if (i == self->appIdCount)
+            return false;
+    }
+
+    if (self->dstAddressCount > 0) {
+        for (i = 0; i < self->dstAddressCount; i++) {
+            if (memcmp(frame, self->dstAddresses + (i * 6), 6) == 0)
+                break;
+        }
+
+        if (i == self->dstAddressCount)
+            return false;
+    }
+
+    return true;
+}
+
+/* copy the next accepted frame to the receive buffer - returns the frame size or 0 */
+static int
+readFrame(EthernetSocket self)
+{
+    LoopbackBus* bus = self->bus;
+
+    if (self->isBind == false) {
+        /* like a raw socket only frames sent after the first receive call are received */
+        self->readIndex = bus->writeIndex;
+        self->isBind = true;
+    }
+
+    while (self->readIndex != bus->writeIndex) {
+
+        /* skip the frames that have been (or are being) overwritten */
+        if ((uint32_t) (bus->writeIndex - self->readIndex) >= CONFIG_ETHERNET_LOOPBACK_SLOTS)
+            self->readIndex = bus->writeIndex - CONFIG_ETHERNET_LOOPBACK_SLOTS + 1;
+
+        __sync_synchronize();
+
+        LoopbackSlot* slot = &(bus->slots[self->readIndex % CONFIG_ETHERNET_LOOPBACK_SLOTS]);
+
+        uint32_t sender = slot->sender;
+        int length = slot->length;
+
+        if ((length < 0) || (length > LOOPBACK_MAX_FRAME_SIZE))
+            length = 0;
+
+        memcpy(self->rxBuffer, slot->frame, length);
+
+        self->rxTimestamp = slot->timestamp;
+
+        __sync_synchronize();
+
+        /* the slot has been reused by a sender while copying */
+        if ((uint32_t) (bus->writeIndex - self->readIndex) >= CONFIG_ETHERNET_LOOPBACK_SLOTS)
+            continue;
+
+        self->readIndex++;
+
+        if ((sender != self->socketId) && acceptFrame(self, self->rxBuffer, length))
+            return length;
+    }
+
+    return 0;
+}
+
+static void
+waitForFrames(EthernetSocket self, int timeoutInMs)
+{
+    LoopbackBus* bus = self->bus;
+
+    struct timespec timeout;
+
+    clock_gettime(CLOCK_REALTIME, &timeout);
+
+    timeout.tv_sec += timeoutInMs / 1000;
+    timeout.tv_nsec += (timeoutInMs % 1000) * 1000000;
+
+    if (timeout.tv_nsec >= 1000000000) {
+        timeout.tv_sec++;
+        timeout.tv_nsec -= 1000000000;
+    }
+
+    if (lockBus(bus) == false)
+        return;
+
+    while (self->readIndex == bus->writeIndex) {
+        if (pthread_cond_timedwait(&(bus->newFrames), &(bus->mutex), &timeout) != 0)
+            break;
+    }
+
+    pthread_mutex_unlock(&(bus->mutex));
+}
+
+/* non-blocking receive */
+int
+Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
+{
+    int length = readFrame(self);
+
+    if (length > bufferSize)
+        length = bufferSize;
+
+    if (length > 0)
+        memcpy(buffer, self->rxBuffer, length);
+
+    return length;
+}
+
+int
+Ethernet_receivePackets(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int timeoutInMs)
+{
+    int frameCount = 0;
+
+    int length = readFrame(self);
+
+    if (length == 0) {
+        waitForFrames(self, timeoutInMs);
+
+        length = readFrame(self);
+    }
+
+    while (length > 0) {
+        handler(parameter, self->rxBuffer, length, self->rxTimestamp);
+        frameCount++;
+
+        length = readFrame(self);
+    }
+
+    return frameCount;
+}
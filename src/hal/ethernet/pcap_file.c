@@ -0,0 +1,283 @@
+/*
+ *  pcap_file.c
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "pcap_file.h"
+#include "hal.h"
+#include "thread.h"
+
+#define PCAP_MAGIC_MICROSECONDS 0xa1b2c3d4
+#define PCAP_MAGIC_NANOSECONDS 0xa1b23c4d
+
+#define PCAP_LINKTYPE_ETHERNET 1
+
+#define PCAP_FILE_HEADER_SIZE 24
+#define PCAP_RECORD_HEADER_SIZE 16
+
+#define PCAP_MAX_FRAME_SIZE 65535
+
+/* remaining time until the target time is reached by busy waiting */
+#define REPLAY_SPIN_TIME_IN_NS 2000000LL
+
+struct sPcapReader {
+    FILE* file;
+    bool swapped; /* file has been written in big endian byte order */
+    bool nanoseconds;
+    uint8_t* frameBuffer; /* used by PcapReader_replay */
+};
+
+struct sPcapWriter {
+    FILE* file;
+};
+
+/* decode a little endian (or big endian if swapped) value */
+static uint32_t
+decodeUInt32(uint8_t* buffer, bool swapped)
+{
+    if (swapped)
+        return ((uint32_t) buffer[0] << 24) + (buffer[1] << 16) + (buffer[2] << 8) + buffer[3];
+    else
+        return ((uint32_t) buffer[3] << 24) + (buffer[2] << 16) + (buffer[1] << 8) + buffer[0];
+}
+
+/* pcap files are written in the byte order of the host */
+static void
+encodeUInt32(uint8_t* buffer, uint32_t value)
+{
+    memcpy(buffer, &value, 4);
+}
+
+PcapReader
+PcapReader_open(char* fileName)
+{
+    uint8_t header[PCAP_FILE_HEADER_SIZE];
+    bool swapped = false;
+    uint32_t magic;
+    PcapReader self = NULL;
+
+    FILE* file = fopen(fileName, "rb");
+
+    if (file == NULL)
+        return NULL;
+
+    if (fread(header, PCAP_FILE_HEADER_SIZE, 1, file) != 1)
+        goto exit_error;
+
+    magic = decodeUInt32(header, false);
+
+    if ((magic != PCAP_MAGIC_MICROSECONDS) && (magic != PCAP_MAGIC_NANOSECONDS)) {
+        swapped = true;
+        magic = decodeUInt32(header, true);
+
+        if ((magic != PCAP_MAGIC_MICROSECONDS) && (magic != PCAP_MAGIC_NANOSECONDS))
+            goto exit_error;
+    }
+
+    if ((decodeUInt32(header + 20, swapped) & 0xffff) != PCAP_LINKTYPE_ETHERNET)
+        goto exit_error;
+
+    self = (PcapReader) calloc(1, sizeof(struct sPcapReader));
+
+    self->file = file;
+    self->swapped = swapped;
+    self->nanoseconds = (magic == PCAP_MAGIC_NANOSECONDS);
+
+    return self;
+
+exit_error:
+    fclose(file);
+    return NULL;
+}
+
+int
+PcapReader_readFrame(PcapReader self, uint8_t* buffer, int bufferSize, uint64_t* timestamp)
+{
+    uint8_t header[PCAP_RECORD_HEADER_SIZE];
+
+    if (fread(header, PCAP_RECORD_HEADER_SIZE, 1, self->file) != 1)
+        return 0;
+
+    uint32_t seconds = decodeUInt32(header, self->swapped);
+    uint32_t fraction = decodeUInt32(header + 4, self->swapped);
+    uint32_t capturedLength = decodeUInt32(header + 8, self->swapped);
+
+    if (capturedLength > PCAP_MAX_FRAME_SIZE)
+        return -1;
+
+    if (timestamp != NULL) {
+        if (self->nanoseconds)
+            *timestamp = ((uint64_t) seconds * 1000000000LL) + fraction;
+        else
+            *timestamp = ((uint64_t) seconds * 1000000000LL) + ((uint64_t) fraction * 1000);
+    }
+
+    int frameSize = capturedLength;
+
+    if (frameSize > bufferSize)
+        frameSize = bufferSize;
+
+    if ((frameSize > 0) && (fread(buffer, frameSize, 1, self->file) != 1))
+        return -1;
+
+    /* skip the truncated part */
+    if (capturedLength > (uint32_t) frameSize) {
+        if (fseek(self->file, capturedLength - frameSize, SEEK_CUR) != 0)
+            return -1;
+    }
+
+    return frameSize;
+}
+
+void
+PcapReader_rewind(PcapReader self)
+{
+    fseek(self->file, PCAP_FILE_HEADER_SIZE, SEEK_SET);
+}
+
+static void
+waitUntil(uint64_t targetTime)
+{
+    uint64_t currentTime = Hal_getMonotonicTimeInNs();
+
+    if (currentTime >= targetTime)
+        return;
+
+    /* sleep for longer gaps and busy wait for the remaining time to keep the inter frame gaps accurate */
+    if (targetTime - currentTime > REPLAY_SPIN_TIME_IN_NS)
+        Thread_sleep((int) ((targetTime - currentTime - REPLAY_SPIN_TIME_IN_NS) / 1000000));
+
+    while (Hal_getMonotonicTimeInNs() < targetTime);
+}
+
+int
+PcapReader_replay(PcapReader self, EthernetFrameHandler handler, void* parameter, double speed)
+{
+    if (self->frameBuffer == NULL)
+        self->frameBuffer = (uint8_t*) malloc(PCAP_MAX_FRAME_SIZE);
+
+    int frameCount = 0;
+
+    uint64_t firstTimestamp = 0;
+    uint64_t startTime = 0;
+
+    while (true) {
+        uint64_t timestamp;
+
+        int frameSize = PcapReader_readFrame(self, self->frameBuffer, PCAP_MAX_FRAME_SIZE, &timestamp);
+
+        if (frameSize == 0)
+            break;
+
+        if (frameSize == -1)
+            return -1;
+
+        if (speed > 0) {
+            if (frameCount == 0) {
+                firstTimestamp = timestamp;
+                startTime = Hal_getMonotonicTimeInNs();
+            }
+            else if (timestamp > firstTimestamp)
+                waitUntil(startTime + (uint64_t) ((timestamp - firstTimestamp) / speed));
+        }
+
+        handler(parameter, self->frameBuffer, frameSize, timestamp);
+
+        frameCount++;
+    }
+
+    return frameCount;
+}
+
+void
+PcapReader_close(PcapReader self)
+{
+    fclose(self->file);
+
+    if (self->frameBuffer != NULL)
+        free(self->frameBuffer);
+
+    free(self);
+}
+
+PcapWriter
+PcapWriter_create(char* fileName)
+{
+    uint8_t header[PCAP_FILE_HEADER_SIZE];
+
+    FILE* file = fopen(fileName, "wb");
+
+    if (file == NULL)
+        return NULL;
+
+    memset(header, 0, PCAP_FILE_HEADER_SIZE);
+
+    /* version 2.4 - stored as two 16 bit values */
+    uint16_t version[2] = { 2, 4 };
+
+    encodeUInt32(header, PCAP_MAGIC_NANOSECONDS);
+    memcpy(header + 4, version, 4);
+    encodeUInt32(header + 16, PCAP_MAX_FRAME_SIZE); /* snaplen */
+    encodeUInt32(header + 20, PCAP_LINKTYPE_ETHERNET);
+
+    if (fwrite(header, PCAP_FILE_HEADER_SIZE, 1, file) != 1) {
+        fclose(file);
+        return NULL;
+    }
+
+    PcapWriter self = (PcapWriter) calloc(1, sizeof(struct sPcapWriter));
+
+    self->file = file;
+
+    return self;
+}
+
+bool
+PcapWriter_writeFrame(PcapWriter self, uint8_t* frame, int frameSize, uint64_t timestamp)
+{
+    uint8_t header[PCAP_RECORD_HEADER_SIZE];
+
+    encodeUInt32(header, (uint32_t) (timestamp / 1000000000LL));
+    encodeUInt32(header + 4, (uint32_t) (timestamp % 1000000000LL));
+    encodeUInt32(header + 8, frameSize);
+    encodeUInt32(header + 12, frameSize);
+
+    if (fwrite(header, PCAP_RECORD_HEADER_SIZE, 1, self->file) != 1)
+        return false;
+
+    if (fwrite(frame, frameSize, 1, self->file) != 1)
+        return false;
+
+    return true;
+}
+
+void
+PcapWriter_close(PcapWriter self)
+{
+    fclose(self->file);
+    free(self);
+}
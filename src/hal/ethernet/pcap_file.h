@@ -0,0 +1,136 @@
+/*
+ *  pcap_file.h
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef PCAP_FILE_H_
+#define PCAP_FILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ethernet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \addtogroup hal
+   *
+   *  @{
+   */
+
+/**
+ * @defgroup HAL_PCAP_FILE Read and write ethernet frames in pcap capture files
+ *
+ * Supports the classic pcap file format (microsecond and nanosecond time stamps, both byte
+ * orders) with the ethernet link type. Doesn't require libpcap. The pcapng format is not
+ * supported.
+ *
+ * @{
+ */
+
+typedef struct sPcapReader* PcapReader;
+
+typedef struct sPcapWriter* PcapWriter;
+
+/**
+ * Open a pcap file for reading.
+ *
+ * \return the reader or NULL if the file cannot be opened or is not an ethernet capture
+ */
+PcapReader
+PcapReader_open(char* fileName);
+
+/**
+ * Read the next frame of the file.
+ *
+ * Frames that are larger than the buffer are truncated.
+ *
+ * \param buffer buffer for the frame
+ * \param bufferSize size of the buffer in bytes
+ * \param timestamp returns the capture time in ns since epoch (can be NULL)
+ *
+ * \return the size of the frame in the buffer, 0 at the end of the file, -1 if the file is corrupted
+ */
+int
+PcapReader_readFrame(PcapReader self, uint8_t* buffer, int bufferSize, uint64_t* timestamp);
+
+/**
+ * Continue reading with the first frame of the file.
+ */
+void
+PcapReader_rewind(PcapReader self);
+
+/**
+ * Pass the frames of the file to a frame handler (e.g. the receive path of a GOOSE or SV receiver).
+ *
+ * The time between the frames is reproduced according to the capture time stamps divided
+ * by the speed factor. The handler gets the capture time stamps of the frames as receive time
+ * stamps. Replay starts with the next frame of the file.
+ *
+ * \param handler the callback function that is invoked for each frame
+ * \param parameter user provided parameter that is passed to the callback function
+ * \param speed 1.0 for the original rate, 2.0 for twice the rate, ... or 0 to replay as fast as possible
+ *
+ * \return the number of frames passed to the handler or -1 if the file is corrupted
+ */
+int
+PcapReader_replay(PcapReader self, EthernetFrameHandler handler, void* parameter, double speed);
+
+void
+PcapReader_close(PcapReader self);
+
+/**
+ * Create a new pcap file (nanosecond time stamps, ethernet link type).
+ *
+ * A writer must not be used by multiple threads at the same time.
+ *
+ * \return the writer or NULL if the file cannot be created
+ */
+PcapWriter
+PcapWriter_create(char* fileName);
+
+/**
+ * Append a frame to the file.
+ *
+ * \param timestamp the capture time in ns since epoch (e.g. Hal_getTimeInNs())
+ *
+ * \return true on success
+ */
+bool
+PcapWriter_writeFrame(PcapWriter self, uint8_t* frame, int frameSize, uint64_t timestamp);
+
+/**
+ * Write buffered frames to the file and close it.
+ */
+void
+PcapWriter_close(PcapWriter self);
+
+/*! @} */
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PCAP_FILE_H_ */
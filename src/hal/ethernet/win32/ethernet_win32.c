@@ -272,6 +272,43 @@ Ethernet_sendPacket(EthernetSocket ethSocket, uint8_t* buffer, int packetSize)
         printf("Error sending the packet: %s\n", pcap_geterr(ethSocket->rawSocket));
 }
 
+int
+Ethernet_sendPackets(EthernetSocket self, uint8_t** buffers, int* packetSizes, int packetCount)
+{
+    int queueSize = 0;
+    int i;
+
+    for (i = 0; i < packetCount; i++)
+        queueSize += sizeof(struct pcap_pkthdr) + packetSizes[i];
+
+    /* transmit all frames with a single call to the driver */
+    pcap_send_queue* queue = pcap_sendqueue_alloc(queueSize);
+
+    if (queue == NULL)
+        return 0;
+
+    for (i = 0; i < packetCount; i++) {
+        struct pcap_pkthdr header;
+
+        memset(&header, 0, sizeof(header));
+        header.caplen = packetSizes[i];
+        header.len = packetSizes[i];
+
+        pcap_sendqueue_queue(queue, &header, buffers[i]);
+    }
+
+    int sent = packetCount;
+
+    if (pcap_sendqueue_transmit(self->rawSocket, queue, 0) < (u_int) queueSize) {
+        printf("Error sending the packets: %s\n", pcap_geterr(self->rawSocket));
+        sent = 0;
+    }
+
+    pcap_sendqueue_destroy(queue);
+
+    return sent;
+}
+
 void
 Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType)
 {
@@ -289,6 +326,83 @@ Ethernet_setProtocolFilter(EthernetSocket ethSocket, uint16_t etherType)
 	}
 }
 
+static int
+appendAppIdFilter(char* filterString, int pos, int appIdOffset, uint16_t* appIds, int appIdCount)
+{
+	int i;
+
+	pos += sprintf(filterString + pos, " and (");
+
+	for (i = 0; i < appIdCount; i++)
+		pos += sprintf(filterString + pos, "%sether[%i:2] = 0x%04x", (i == 0) ? "" : " or ",
+				appIdOffset, appIds[i]);
+
+	pos += sprintf(filterString + pos, ")");
+
+	return pos;
+}
+
+bool
+Ethernet_setFrameFilter(EthernetSocket self, uint16_t etherType, uint16_t* appIds, int appIdCount,
+        uint8_t* dstAddresses, int dstAddressCount)
+{
+	struct bpf_program program;
+	int i;
+	int pos = 0;
+	bool success = true;
+
+	char* filterString = (char*) malloc(200 + (appIdCount * 60) + (dstAddressCount * 40));
+
+	pos += sprintf(filterString + pos, "((ether proto 0x%04x", etherType);
+
+	if (appIdCount > 0)
+		pos = appendAppIdFilter(filterString, pos, 14, appIds, appIdCount);
+
+	pos += sprintf(filterString + pos, ") or (vlan and ether proto 0x%04x", etherType);
+
+	if (appIdCount > 0)
+		pos = appendAppIdFilter(filterString, pos, 18, appIds, appIdCount);
+
+	pos += sprintf(filterString + pos, "))");
+
+	if (dstAddressCount > 0) {
+		pos += sprintf(filterString + pos, " and (");
+
+		for (i = 0; i < dstAddressCount; i++) {
+			uint8_t* addr = dstAddresses + (i * 6);
+
+			pos += sprintf(filterString + pos, "%sether dst %02x:%02x:%02x:%02x:%02x:%02x", (i == 0) ? "" : " or ",
+					addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+		}
+
+		pos += sprintf(filterString + pos, ")");
+	}
+
+	if (pcap_compile(self->rawSocket, &program, filterString, 1, 0) < 0) {
+		printf("Compiling packet filter failed!\n");
+		success = false;
+	}
+	else {
+		if (pcap_setfilter(self->rawSocket, &program) < 0) {
+			printf("Setting packet filter failed!\n");
+			success = false;
+		}
+
+		pcap_freecode(&program);
+	}
+
+	free(filterString);
+
+	return success;
+}
+
+/* the adapter is opened in promiscuous mode - all multicast frames are received */
+bool
+Ethernet_addMulticastAddress(EthernetSocket self, uint8_t* macAddress)
+{
+	return true;
+}
+
 int
 Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
 {
@@ -315,4 +429,39 @@ Ethernet_receivePacket(EthernetSocket self, uint8_t* buffer, int bufferSize)
 	}
 }
 
+typedef struct {
+	EthernetFrameHandler handler;
+	void* parameter;
+	int frames;
+} FrameHandlerContext;
+
+static void
+pcapFrameHandler(u_char* user, const struct pcap_pkthdr* header, const u_char* packetData)
+{
+	FrameHandlerContext* context = (FrameHandlerContext*) user;
+
+	uint64_t timestamp = ((uint64_t) header->ts.tv_sec * 1000000000ULL) + ((uint64_t) header->ts.tv_usec * 1000);
+
+	context->handler(context->parameter, (uint8_t*) packetData, header->caplen, timestamp);
+	context->frames++;
+}
+
+/* waits up to the read timeout of the pcap handle - timeoutInMs is not used */
+int
+Ethernet_receivePackets(EthernetSocket self, EthernetFrameHandler handler, void* parameter, int timeoutInMs)
+{
+	FrameHandlerContext context;
+
+	context.handler = handler;
+	context.parameter = parameter;
+	context.frames = 0;
+
+	if (pcap_dispatch(self->rawSocket, -1, pcapFrameHandler, (u_char*) &context) < 0) {
+		printf("winpcap error\n");
+		return -1;
+	}
+
+	return context.frames;
+}
+
 #endif
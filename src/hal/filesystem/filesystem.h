@@ -83,6 +83,30 @@ FileSystem_readFile(FileHandle handle, uint8_t* buffer, int maxSize);
 void
 FileSystem_closeFile(FileHandle handle);
 
+/**
+ * \brief map a file into memory for read access (optional)
+ *
+ * This function is used by the MMS file service when CONFIG_MMS_FILE_SERVICE_USE_MMAP is enabled.
+ * Platforms that don't support memory mapped files return NULL. The file is read with
+ * FileSystem_readFile in this case.
+ *
+ * \param pathName full name (path + filename) of the file
+ * \param fileSize a pointer where to store the size of the mapped file
+ *
+ * \return the address of the mapped file or NULL if the file cannot be mapped
+ */
+uint8_t*
+FileSystem_mapFile(char* pathName, uint32_t* fileSize);
+
+/**
+ * \brief release a file that has been mapped with FileSystem_mapFile
+ *
+ * \param data the address of the mapped file
+ * \param fileSize the size of the mapped file
+ */
+void
+FileSystem_unmapFile(uint8_t* data, uint32_t fileSize);
+
 /**
  * \brief return attributes of the given file
  *
@@ -30,6 +30,8 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #include "filesystem.h"
@@ -91,6 +93,47 @@ FileSystem_closeFile(FileHandle handle)
     fclose((FILE*) handle);
 }
 
+uint8_t*
+FileSystem_mapFile(char* fileName, uint32_t* fileSize)
+{
+    char fullPath[sizeof(CONFIG_VIRTUAL_FILESTORE_BASEPATH) + 255];
+
+    createFullPathFromFileName(fullPath, fileName);
+
+    int fd = open(fullPath, O_RDONLY);
+
+    if (fd == -1)
+        return NULL;
+
+    uint8_t* data = NULL;
+
+    struct stat fileStats;
+
+    /* empty files cannot be mapped */
+    if ((fstat(fd, &fileStats) == 0) && (fileStats.st_size > 0) && (fileStats.st_size <= 0xffffffff)) {
+        void* mapping = mmap(NULL, fileStats.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED) {
+            /* files are read from the beginning to the end */
+            madvise(mapping, fileStats.st_size, MADV_SEQUENTIAL);
+
+            data = (uint8_t*) mapping;
+            *fileSize = (uint32_t) fileStats.st_size;
+        }
+    }
+
+    /* the mapping stays valid after the file has been closed */
+    close(fd);
+
+    return data;
+}
+
+void
+FileSystem_unmapFile(uint8_t* data, uint32_t fileSize)
+{
+    munmap(data, fileSize);
+}
+
 bool
 FileSystem_deleteFile(char* filename)
 {
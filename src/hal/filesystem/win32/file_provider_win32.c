@@ -178,6 +178,18 @@ getNextDirectoryEntry(DirectoryHandle directory, bool* isDirectory)
 }
 
 
+uint8_t*
+FileSystem_mapFile(char* fileName, uint32_t* fileSize)
+{
+    /* not supported - the file is read with FileSystem_readFile */
+    return NULL;
+}
+
+void
+FileSystem_unmapFile(uint8_t* data, uint32_t fileSize)
+{
+}
+
 bool
 FileSystem_deleteFile(char* filename)
 {
@@ -40,6 +40,26 @@ Hal_getTimeInMs()
 
 	return ((uint64_t) tp.tv_sec) * 1000LL + (tp.tv_nsec / 1000000);
 }
+
+uint64_t
+Hal_getTimeInNs()
+{
+    struct timespec tp;
+
+    clock_gettime(CLOCK_REALTIME, &tp);
+
+    return ((uint64_t) tp.tv_sec) * 1000000000LL + tp.tv_nsec;
+}
+
+uint64_t
+Hal_getMonotonicTimeInNs()
+{
+    struct timespec tp;
+
+    clock_gettime(CLOCK_MONOTONIC, &tp);
+
+    return ((uint64_t) tp.tv_sec) * 1000000000LL + tp.tv_nsec;
+}
 #else
 
 #include <sys/time.h>
@@ -54,6 +74,36 @@ Hal_getTimeInMs()
     return ((uint64_t) now.tv_sec * 1000LL) + (now.tv_usec / 1000);
 }
 
+uint64_t
+Hal_getTimeInNs()
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+
+    return ((uint64_t) now.tv_sec * 1000000000LL) + (now.tv_usec * 1000LL);
+}
+
+uint64_t
+Hal_getMonotonicTimeInNs()
+{
+#if defined __linux__
+    /* clock_gettime is always available on Linux (librt/glibc) - a step of the system time must not
+     * affect the monotonic time */
+    struct timespec tp;
+
+    clock_gettime(CLOCK_MONOTONIC, &tp);
+
+    return ((uint64_t) tp.tv_sec) * 1000000000LL + tp.tv_nsec;
+#else
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+
+    return ((uint64_t) now.tv_sec * 1000000000LL) + (now.tv_usec * 1000LL);
+#endif
+}
+
 #endif
 
 #elif defined _WIN32
@@ -73,4 +123,33 @@ Hal_getTimeInMs()
 
 	return (now / 10000LL) - DIFF_TO_UNIXTIME;
 }
+
+uint64_t
+Hal_getTimeInNs()
+{
+    FILETIME ft;
+    uint64_t now;
+
+    static const uint64_t DIFF_TO_UNIXTIME = 11644473600000LL;
+
+    GetSystemTimeAsFileTime(&ft);
+
+    now = (LONGLONG)ft.dwLowDateTime + ((LONGLONG)(ft.dwHighDateTime) << 32LL);
+
+    /* FILETIME has a resolution of 100 ns */
+    return (now - (DIFF_TO_UNIXTIME * 10000LL)) * 100LL;
+}
+
+uint64_t
+Hal_getMonotonicTimeInNs()
+{
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (uint64_t) ((counter.QuadPart / frequency.QuadPart) * 1000000000LL +
+            ((counter.QuadPart % frequency.QuadPart) * 1000000000LL) / frequency.QuadPart);
+}
 #endif
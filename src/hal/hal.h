@@ -50,6 +50,25 @@ extern "C" {
  */
 uint64_t Hal_getTimeInMs(void);
 
+/**
+ * Get the system time in nanoseconds since the UNIX epoch.
+ *
+ * The resolution depends on the platform.
+ *
+ * \return the system time in nanoseconds
+ */
+uint64_t Hal_getTimeInNs(void);
+
+/**
+ * Get a monotonic time stamp in nanoseconds.
+ *
+ * The time is not related to the system time and is only useful to measure time
+ * intervals (e.g. latencies). The resolution depends on the platform.
+ *
+ * \return the time since an arbitrary point in the past in nanoseconds
+ */
+uint64_t Hal_getMonotonicTimeInNs(void);
+
 /*! @} */
 
 /*! @} */
@@ -337,6 +337,19 @@ Socket_write(Socket self, uint8_t* buf, int size)
     return send(self->fd, buf, size, MSG_NOSIGNAL);
 }
 
+int
+Socket_getFileDescriptor(Socket self)
+{
+    return self->fd;
+}
+
+void
+Socket_shutdown(Socket self)
+{
+    if (self->fd != -1)
+        shutdown(self->fd, SHUT_RDWR);
+}
+
 void
 Socket_destroy(Socket self)
 {
@@ -90,6 +90,22 @@ Socket_write(Socket self, uint8_t* buf, int size);
 char*
 Socket_getPeerAddress(Socket self);
 
+/**
+ * Get the operating system handle of the socket (e.g. to supervise it with select or epoll)
+ *
+ * \return the file descriptor of the socket or -1 if the socket is not open
+ */
+int
+Socket_getFileDescriptor(Socket self);
+
+/**
+ * Shut down both directions of the connection without closing the socket. Threads that are
+ * blocked in Socket_read or Socket_write return with an error. The socket still has to be
+ * released with Socket_destroy.
+ */
+void
+Socket_shutdown(Socket self);
+
 void
 Socket_destroy(Socket self);
 
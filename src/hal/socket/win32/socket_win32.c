@@ -274,6 +274,19 @@ Socket_write(Socket self, uint8_t* buf, int size)
 	return send(self->fd, (char*) buf, size, 0);
 }
 
+int
+Socket_getFileDescriptor(Socket self)
+{
+	return (int) self->fd;
+}
+
+void
+Socket_shutdown(Socket self)
+{
+	if (self->fd != -1)
+		shutdown(self->fd, SD_BOTH);
+}
+
 void
 Socket_destroy(Socket self)
 {
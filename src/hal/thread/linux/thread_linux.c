@@ -21,12 +21,20 @@
  *	See COPYING file for the complete license text.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* required for pthread_setaffinity_np */
+#endif
 
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <time.h>
 #include "thread.h"
+#include "hal.h"
 
 struct sThread {
 	ThreadExecutionFunction function;
@@ -36,6 +44,11 @@ struct sThread {
 	bool autodestroy;
 };
 
+struct sCondition {
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+};
+
 Semaphore
 Semaphore_create(int initialValue)
 {
@@ -53,6 +66,36 @@ Semaphore_wait(Semaphore self)
     sem_wait((sem_t*) self);
 }
 
+bool
+Semaphore_waitUntil(Semaphore self, uint64_t timeInMs)
+{
+#if defined(__APPLE__)
+    /* no sem_timedwait available */
+    while (sem_trywait((sem_t*) self) != 0) {
+        struct timeval now;
+
+        gettimeofday(&now, NULL);
+
+        if (((uint64_t) now.tv_sec * 1000LL) + (now.tv_usec / 1000) >= timeInMs)
+            return false;
+
+        usleep(1000);
+    }
+
+    return true;
+#else
+    struct timespec abstime;
+    int result;
+
+    abstime.tv_sec = (time_t) (timeInMs / 1000);
+    abstime.tv_nsec = (long) ((timeInMs % 1000) * 1000000);
+
+    while (((result = sem_timedwait((sem_t*) self, &abstime)) == -1) && (errno == EINTR));
+
+    return (result == 0);
+#endif
+}
+
 void
 Semaphore_post(Semaphore self)
 {
@@ -66,6 +109,91 @@ Semaphore_destroy(Semaphore self)
     free(self);
 }
 
+Condition
+Condition_create(void)
+{
+    Condition self = (Condition) malloc(sizeof(struct sCondition));
+
+    pthread_mutex_init(&(self->mutex), NULL);
+
+#if defined(__APPLE__)
+    /* no pthread_condattr_setclock available - the timeout uses CLOCK_REALTIME */
+    pthread_cond_init(&(self->condition), NULL);
+#else
+    /* a step of the system time must not change the timeout of Condition_waitUntil */
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&(self->condition), &attr);
+    pthread_condattr_destroy(&attr);
+#endif
+
+    return self;
+}
+
+void
+Condition_lock(Condition self)
+{
+    pthread_mutex_lock(&(self->mutex));
+}
+
+void
+Condition_unlock(Condition self)
+{
+    pthread_mutex_unlock(&(self->mutex));
+}
+
+void
+Condition_wait(Condition self)
+{
+    pthread_cond_wait(&(self->condition), &(self->mutex));
+}
+
+bool
+Condition_waitUntil(Condition self, uint64_t timeInMs)
+{
+    struct timespec abstime;
+
+#if defined(__APPLE__)
+    abstime.tv_sec = (time_t) (timeInMs / 1000);
+    abstime.tv_nsec = (long) ((timeInMs % 1000) * 1000000);
+#else
+    /* convert the timeout to the monotonic clock of the condition variable */
+    uint64_t currentTime = Hal_getTimeInMs();
+    uint64_t timeout = 0;
+
+    if (timeInMs > currentTime)
+        timeout = timeInMs - currentTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &abstime);
+
+    abstime.tv_sec += (time_t) (timeout / 1000);
+    abstime.tv_nsec += (long) ((timeout % 1000) * 1000000);
+
+    if (abstime.tv_nsec >= 1000000000) {
+        abstime.tv_sec++;
+        abstime.tv_nsec -= 1000000000;
+    }
+#endif
+
+    return (pthread_cond_timedwait(&(self->condition), &(self->mutex), &abstime) != ETIMEDOUT);
+}
+
+void
+Condition_broadcast(Condition self)
+{
+    pthread_cond_broadcast(&(self->condition));
+}
+
+void
+Condition_destroy(Condition self)
+{
+    pthread_cond_destroy(&(self->condition));
+    pthread_mutex_destroy(&(self->mutex));
+    free(self);
+}
+
 Thread
 Thread_create(ThreadExecutionFunction function, void* parameter, bool autodestroy)
 {
@@ -120,3 +248,45 @@ Thread_sleep(int millies)
 	usleep(millies * 1000);
 }
 
+ThreadId
+Thread_getCurrentId(void)
+{
+    return (ThreadId) pthread_self();
+}
+
+bool
+Thread_setPriority(Thread thread, int priority)
+{
+    struct sched_param param;
+    int policy = SCHED_OTHER;
+
+    if (thread->state != 1)
+        return false;
+
+    param.sched_priority = 0;
+
+    if (priority > 0) {
+        policy = SCHED_FIFO;
+        param.sched_priority = priority;
+    }
+
+    return (pthread_setschedparam(thread->pthread, policy, &param) == 0);
+}
+
+bool
+Thread_setCpuAffinity(Thread thread, int cpu)
+{
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+
+    if ((thread->state != 1) || (cpu < 0) || (cpu >= CPU_SETSIZE))
+        return false;
+
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+
+    return (pthread_setaffinity_np(thread->pthread, sizeof(cpu_set_t), &cpuSet) == 0);
+#else
+    return false;
+#endif
+}
@@ -27,6 +27,7 @@
 #define THREAD_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +51,12 @@ typedef struct sThread* Thread;
 /** Qpaque reference of a Semaphore instance */
 typedef void* Semaphore;
 
+/** Opaque reference of a Condition instance */
+typedef struct sCondition* Condition;
+
+/** Identifier of a thread (see Thread_getCurrentId) */
+typedef uintptr_t ThreadId;
+
 /** Reference to a function that is called when starting the thread */
 typedef void* (*ThreadExecutionFunction) (void*);
 
@@ -90,6 +97,44 @@ Thread_destroy(Thread thread);
 void
 Thread_sleep(int millies);
 
+/**
+ * \brief Get the identifier of the calling thread
+ *
+ * The identifier can be compared with the identifiers returned to other threads to find out
+ * which thread is running a function.
+ */
+ThreadId
+Thread_getCurrentId(void);
+
+/**
+ * \brief Change the scheduling priority of a started thread
+ *
+ * On POSIX systems a priority greater than zero selects the real-time scheduling policy
+ * SCHED_FIFO with the given priority (1-99 on Linux) - this usually requires special privileges.
+ * Priority 0 restores the default time sharing scheduling policy. The function can only be used
+ * with threads that have been created with autodestroy set to false.
+ *
+ * \param thread the Thread instance
+ * \param priority the real-time priority or 0 for the default policy
+ *
+ * \return true if the priority has been changed, false otherwise
+ */
+bool
+Thread_setPriority(Thread thread, int priority);
+
+/**
+ * \brief Bind a started thread to a single CPU core
+ *
+ * The function can only be used with threads that have been created with autodestroy set to false.
+ *
+ * \param thread the Thread instance
+ * \param cpu the number of the CPU core (starting with 0)
+ *
+ * \return true if the affinity has been changed, false if not supported or not allowed
+ */
+bool
+Thread_setCpuAffinity(Thread thread, int cpu);
+
 Semaphore
 Semaphore_create(int initialValue);
 
@@ -97,12 +142,74 @@ Semaphore_create(int initialValue);
 void
 Semaphore_wait(Semaphore self);
 
+/**
+ * \brief Wait until semaphore value is greater than zero or the given point in time is reached.
+ *
+ * The timeout is converted to a relative time when the function is called. A step of the system
+ * time while waiting does not change the timeout.
+ *
+ * \param timeInMs the absolute timeout in the time base of Hal_getTimeInMs
+ *
+ * \return true if the semaphore value has been decreased, false if the timeout is reached
+ */
+bool
+Semaphore_waitUntil(Semaphore self, uint64_t timeInMs);
+
 void
 Semaphore_post(Semaphore self);
 
 void
 Semaphore_destroy(Semaphore self);
 
+/**
+ * \brief Create a condition variable with an associated lock
+ *
+ * A thread waits for a condition by locking the Condition, checking the condition and calling
+ * Condition_wait (or Condition_waitUntil) as long as the condition is not met. Another thread
+ * changes the state while holding the lock and calls Condition_broadcast to wake up the waiting
+ * threads.
+ */
+Condition
+Condition_create(void);
+
+void
+Condition_lock(Condition self);
+
+void
+Condition_unlock(Condition self);
+
+/**
+ * \brief Release the lock and wait until the condition is signaled. The lock is held again
+ * when the function returns.
+ *
+ * Waiting threads can also wake up without a signal (spurious wakeup) - the condition has to be
+ * checked again after the function returns.
+ */
+void
+Condition_wait(Condition self);
+
+/**
+ * \brief Like Condition_wait but returns when the given point in time is reached.
+ *
+ * The timeout is converted to a relative time when the function is called. A step of the system
+ * time while waiting does not change the timeout.
+ *
+ * \param timeInMs the absolute timeout in the time base of Hal_getTimeInMs
+ *
+ * \return false if the timeout is reached, true otherwise
+ */
+bool
+Condition_waitUntil(Condition self, uint64_t timeInMs);
+
+/**
+ * \brief Wake up all threads waiting for the condition
+ */
+void
+Condition_broadcast(Condition self);
+
+void
+Condition_destroy(Condition self);
+
 /*! @} */
 
 /*! @} */
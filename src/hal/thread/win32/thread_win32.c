@@ -23,6 +23,9 @@
 
 #include <windows.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include "hal.h"
 #include "thread.h"
 
 struct sThread {
@@ -33,6 +36,12 @@ struct sThread {
 	bool autodestroy;
 };
 
+/* requires Windows Vista or later */
+struct sCondition {
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE condition;
+};
+
 static DWORD WINAPI
 destroyAutomaticThreadRunner(LPVOID parameter)
 {
@@ -98,10 +107,36 @@ Thread_sleep(int millies)
 	Sleep(millies);
 }
 
+ThreadId
+Thread_getCurrentId(void)
+{
+    return (ThreadId) GetCurrentThreadId();
+}
+
+bool
+Thread_setPriority(Thread thread, int priority)
+{
+	int winPriority = THREAD_PRIORITY_NORMAL;
+
+	if (priority > 0)
+		winPriority = THREAD_PRIORITY_TIME_CRITICAL;
+
+	return (SetThreadPriority(thread->handle, winPriority) != 0);
+}
+
+bool
+Thread_setCpuAffinity(Thread thread, int cpu)
+{
+	if ((cpu < 0) || (cpu >= (int) (sizeof(DWORD_PTR) * 8)))
+		return false;
+
+	return (SetThreadAffinityMask(thread->handle, ((DWORD_PTR) 1) << cpu) != 0);
+}
+
 Semaphore
 Semaphore_create(int initialValue)
 {
-    HANDLE self = CreateSemaphore(NULL, 1, 1, NULL);
+    HANDLE self = CreateSemaphore(NULL, initialValue, LONG_MAX, NULL);
 
     return self;
 }
@@ -113,6 +148,18 @@ Semaphore_wait(Semaphore self)
     WaitForSingleObject((HANDLE) self, INFINITE);
 }
 
+bool
+Semaphore_waitUntil(Semaphore self, uint64_t timeInMs)
+{
+    uint64_t currentTime = Hal_getTimeInMs();
+    DWORD timeout = 0;
+
+    if (timeInMs > currentTime)
+        timeout = (DWORD) (timeInMs - currentTime);
+
+    return (WaitForSingleObject((HANDLE) self, timeout) == WAIT_OBJECT_0);
+}
+
 void
 Semaphore_post(Semaphore self)
 {
@@ -124,3 +171,60 @@ Semaphore_destroy(Semaphore self)
 {
     CloseHandle((HANDLE) self);
 }
+
+Condition
+Condition_create(void)
+{
+    Condition self = (Condition) malloc(sizeof(struct sCondition));
+
+    InitializeCriticalSection(&(self->lock));
+    InitializeConditionVariable(&(self->condition));
+
+    return self;
+}
+
+void
+Condition_lock(Condition self)
+{
+    EnterCriticalSection(&(self->lock));
+}
+
+void
+Condition_unlock(Condition self)
+{
+    LeaveCriticalSection(&(self->lock));
+}
+
+void
+Condition_wait(Condition self)
+{
+    SleepConditionVariableCS(&(self->condition), &(self->lock), INFINITE);
+}
+
+bool
+Condition_waitUntil(Condition self, uint64_t timeInMs)
+{
+    uint64_t currentTime = Hal_getTimeInMs();
+    DWORD timeout = 0;
+
+    if (timeInMs > currentTime)
+        timeout = (DWORD) (timeInMs - currentTime);
+
+    if (SleepConditionVariableCS(&(self->condition), &(self->lock), timeout) == 0)
+        return (GetLastError() != ERROR_TIMEOUT);
+
+    return true;
+}
+
+void
+Condition_broadcast(Condition self)
+{
+    WakeAllConditionVariable(&(self->condition));
+}
+
+void
+Condition_destroy(Condition self)
+{
+    DeleteCriticalSection(&(self->lock));
+    free(self);
+}
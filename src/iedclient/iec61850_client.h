@@ -33,6 +33,7 @@ extern "C" {
 #include "goose_subscriber.h"
 #include "mms_value.h"
 #include "mms_client_connection.h"
+#include "mms_read_plan.h"
 #include "linked_list.h"
 
 /**
@@ -611,6 +612,43 @@ void
 IedConnection_installReportHandler(IedConnection self, char* rcbReference, char* rptId, ReportCallbackFunction handler,
         void* handlerParameter);
 
+/**
+ * \brief Callback function for the data set values of received reports
+ *
+ * Is called for each data set member that is included in a report. The value refers to the
+ * receive buffer and is only valid during the call.
+ *
+ * \param parameter a user provided parameter that is handed to the callback function
+ * \param report the ClientReport instance (the data set values are not available)
+ * \param elementIndex the index of the data set member
+ * \param reason the reason for inclusion of the data set member
+ * \param value the BER encoded value of the data set member (use the MmsRawValue_* functions)
+ */
+typedef void (*ReportValueHandler) (void* parameter, ClientReport report, int elementIndex,
+        ReasonForInclusion reason, MmsRawValue* value);
+
+/**
+ * \brief Install a report handler that gets the data set values without creating MmsValue instances
+ *
+ * The value handler is called for each included data set member directly from the received
+ * message. This avoids the allocation of the MmsValue trees for high report rates. The report
+ * handler (can be NULL) is called after all values of a report have been handled.
+ * ClientReport_getDataSetValues returns NULL for these reports.
+ *
+ * This function will replace a formerly set report handler function for the specified RCB.
+ *
+ * \param connection the connection object
+ * \param rcbReference object reference of the report control block
+ * \param rptId a string that identifies the report. If the rptId is not available then the
+ *        rcbReference is used to identify the report.
+ * \param valueHandler user provided callback function to be invoked for each data set value
+ * \param handler user provided callback function to be invoked when a report has been handled
+ * \param handlerParameter user provided parameter that will be passed to the callback functions
+ */
+void
+IedConnection_installReportValueHandler(IedConnection self, char* rcbReference, char* rptId,
+        ReportValueHandler valueHandler, ReportCallbackFunction handler, void* handlerParameter);
+
 /**
  * \brief uninstall a report handler function for the specified report control block (RCB)
  */
@@ -858,6 +896,66 @@ ClientReportControlBlock_getOwner(ClientReportControlBlock self);
 MmsValue*
 IedConnection_readObject(IedConnection self, IedClientError* error, char* dataAttributeReference, FunctionalConstraint fc);
 
+/**
+ * \brief create a value of the type of a functional constrained data attribute (FCDA) or functional constrained data (FCD).
+ *
+ * The value is created from the type specification in the type cache of the connection. The type
+ * specification is requested from the server only once. The value can be used with IedConnection_readObjectInto.
+ *
+ * \param self  the connection object to operate on
+ * \param error the error code if an error occurs
+ * \param object reference of the object/attribute
+ * \param fc the functional constraint of the data attribute or data object
+ *
+ * \return a new MmsValue instance with default values or NULL if the request failed
+ */
+MmsValue*
+IedConnection_createObjectValue(IedConnection self, IedClientError* error, char* dataAttributeReference,
+        FunctionalConstraint fc);
+
+/**
+ * \brief read a functional constrained data attribute (FCDA) or functional constrained data (FCD) into an existing value.
+ *
+ * Like IedConnection_readObject but the received value is written into the given value (e.g. created
+ * by IedConnection_createObjectValue). Polling an object this way doesn't create new MmsValue instances.
+ *
+ * \param self  the connection object to operate on
+ * \param error the error code if an error occurs
+ * \param object reference of the object/attribute to read
+ * \param fc the functional constraint of the data attribute or data object to read
+ * \param value the value to update. It has to have the type of the object.
+ */
+void
+IedConnection_readObjectInto(IedConnection self, IedClientError* error, char* dataAttributeReference,
+        FunctionalConstraint fc, MmsValue* value);
+
+/**
+ * \brief add a functional constrained data attribute (FCDA) or functional constrained data (FCD) to a read plan
+ *
+ * A read plan reads many objects (also of different logical devices) with a minimal number of
+ * read requests (see MmsReadPlan). The values can be accessed with MmsReadPlan_getValue after the
+ * plan has been executed with IedConnection_executeReadPlan.
+ *
+ * \param self  the connection object to operate on
+ * \param plan the read plan
+ * \param objectReference object reference of the object/attribute to read
+ * \param fc the functional constraint of the data attribute or data object to read
+ *
+ * \return the index of the value in the read plan or -1 if the object reference is invalid
+ */
+int
+IedConnection_addToReadPlan(IedConnection self, MmsReadPlan plan, char* objectReference, FunctionalConstraint fc);
+
+/**
+ * \brief read all objects of a read plan
+ *
+ * \param self  the connection object to operate on
+ * \param error the error code if a request failed
+ * \param plan the read plan
+ */
+void
+IedConnection_executeReadPlan(IedConnection self, IedClientError* error, MmsReadPlan plan);
+
 /**
  * \brief write a functional constrained data attribute (FCDA) or functional constrained data (FCD).
  *
@@ -1250,7 +1348,10 @@ ControlObjectClient_setCommandTerminationHandler(ControlObjectClient self, Comma
  * \brief Retrieve the device model from the server
  *
  * This function retrieves the complete device model from the server. The model is buffered an can be browsed
- * by subsequent API calls. This API call is mapped to multiple ACSI services.
+ * by subsequent API calls. This API call is mapped to multiple ACSI services. The requests for the
+ * different logical devices are sent without waiting for the responses.
+ *
+ * The model cache file (if set) is updated.
  *
  * \param self the connection object
  * \param error the error code if an error occurs
@@ -1259,6 +1360,22 @@ ControlObjectClient_setCommandTerminationHandler(ControlObjectClient self, Comma
 void
 IedConnection_getDeviceModelFromServer(IedConnection self, IedClientError* error);
 
+/**
+ * \brief Set a file to cache the device model of the server
+ *
+ * When the model is required by the browsing functions for the first time the identity of the
+ * server (identify service) and the list of logical devices are compared with the cache file. If
+ * they are unchanged the model is taken from the file. Otherwise the model is retrieved from the
+ * server and stored in the file. Changes of the model that don't change the identity or the list
+ * of logical devices are not detected - use IedConnection_getDeviceModelFromServer to update the
+ * cache in this case.
+ *
+ * \param self the connection object
+ * \param fileName the name of the cache file or NULL to disable the cache
+ */
+void
+IedConnection_setModelCacheFile(IedConnection self, char* fileName);
+
 /**
  * \brief Get the list of logical devices available at the server (DEPRECATED)
  *
@@ -1404,6 +1521,26 @@ MmsVariableSpecification*
 IedConnection_getVariableSpecification(IedConnection self, IedClientError* error, char* dataAttributeReference,
         FunctionalConstraint fc);
 
+/**
+ * \brief return the MMS variable type specification of the data attribute from the type cache of the connection.
+ *
+ * Like IedConnection_getVariableSpecification but the type specification is requested from the server only
+ * at the first call for a data attribute.
+ *
+ * \param self the connection object
+ * \param error the error code if an error occurs
+ * \param dataAttributeReference string that represents the DA reference
+ * \param fc functional constraint of the DA
+ *
+ * \return MmsVariableSpecification of the data attribute. It belongs to the connection and must not be deleted.
+ *         The cache is cleared when the connection is established again (also by an automatic reconnect).
+ *         This invalidates the returned object - use IedConnection_createObjectValue to create values
+ *         when the connection can be reestablished at any time.
+ */
+MmsVariableSpecification*
+IedConnection_getCachedVariableSpecification(IedConnection self, IedClientError* error, char* dataAttributeReference,
+        FunctionalConstraint fc);
+
 /** @} */
 
 /**
@@ -1466,6 +1603,9 @@ typedef bool
  *
  * Download a file from the server.
  *
+ * The file is read with several outstanding FileRead requests (see IedConnection_setFileReadWindowSize).
+ * The handler is called by the calling thread.
+ *
  * \param self the connection object
  * \param error the error code if an error occurs
  * \param fileName the name of the file to be read from the server
@@ -1488,6 +1628,20 @@ IedConnection_getFile(IedConnection self, IedClientError* error, char* fileName,
 void
 IedConnection_deleteFile(IedConnection self, IedClientError* error, char* fileName);
 
+/**
+ * \brief Set the number of outstanding FileRead requests used by IedConnection_getFile
+ *
+ * A larger window avoids that the download of large files (e.g. COMTRADE disturbance records)
+ * is limited by the round trip time of the connection. The server has to answer the requests in
+ * the order they have been received. A window size of 1 can be used for servers that don't
+ * support this. The default is CONFIG_MMS_CLIENT_FILE_READ_WINDOW_SIZE.
+ *
+ * \param self the connection object
+ * \param windowSize the maximum number of outstanding FileRead requests
+ */
+void
+IedConnection_setFileReadWindowSize(IedConnection self, int windowSize);
+
 
 /** @} */
 
@@ -0,0 +1,301 @@
+/*
+ *  client_model_cache.c
+ *
+ *  Stores the device model (the names of the variables and data sets of all logical devices)
+ *  of a server in a file to avoid the discovery when connecting to the same server again.
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+
+#include "iec61850_client.h"
+
+#include "stack_config.h"
+
+#include "ied_connection_private.h"
+
+/*
+ * The cache file is a text file with one entry per line:
+ *
+ * libiec61850 model cache 1
+ * vendor <vendor name>
+ * model <model name>
+ * revision <revision>
+ * LD <logical device name>
+ * V <variable name>
+ * DS <data set name>
+ *
+ * The V and DS lines belong to the preceding LD line. The cache is valid when the identity
+ * of the server and the list of logical devices are unchanged.
+ */
+
+#define MODEL_CACHE_HEADER "libiec61850 model cache 1"
+
+/* MMS identifiers have at most 64 characters - the identity strings are truncated */
+#define MODEL_CACHE_MAX_LINE_LENGTH 256
+
+static char*
+getIdentityString(MmsServerIdentity* identity, int index)
+{
+    char* value = NULL;
+
+    if (identity != NULL) {
+        if (index == 0)
+            value = identity->vendorName;
+        else if (index == 1)
+            value = identity->modelName;
+        else
+            value = identity->revision;
+    }
+
+    if (value == NULL)
+        return "";
+
+    return value;
+}
+
+static void
+writeIdentityString(FILE* file, char* key, char* value)
+{
+    fprintf(file, "%s ", key);
+
+    int i;
+
+    /* the string must not contain line breaks */
+    for (i = 0; (value[i] != 0) && (i < (MODEL_CACHE_MAX_LINE_LENGTH - 16)); i++) {
+        if ((value[i] == '\n') || (value[i] == '\r'))
+            fputc(' ', file);
+        else
+            fputc(value[i], file);
+    }
+
+    fputc('\n', file);
+}
+
+static void
+writeNames(FILE* file, char* key, LinkedList names)
+{
+    LinkedList name = LinkedList_getNext(names);
+
+    while (name != NULL) {
+        fprintf(file, "%s %s\n", key, (char*) name->data);
+
+        name = LinkedList_getNext(name);
+    }
+}
+
+void
+private_IedConnection_saveModelCache(IedConnection self, MmsServerIdentity* identity)
+{
+    int fileNameLength = strlen(self->modelCacheFile);
+
+    char* tmpFileName = (char*) malloc(fileNameLength + 5);
+
+    memcpy(tmpFileName, self->modelCacheFile, fileNameLength);
+    strcpy(tmpFileName + fileNameLength, ".tmp");
+
+    /* write to a temporary file first to never leave an incomplete cache file behind */
+    FILE* file = fopen(tmpFileName, "w");
+
+    if (file == NULL) {
+        if (DEBUG_IED_CLIENT)
+            printf("DEBUG_IED_CLIENT: cannot write model cache file %s\n", tmpFileName);
+
+        free(tmpFileName);
+        return;
+    }
+
+    fprintf(file, "%s\n", MODEL_CACHE_HEADER);
+
+    writeIdentityString(file, "vendor", getIdentityString(identity, 0));
+    writeIdentityString(file, "model", getIdentityString(identity, 1));
+    writeIdentityString(file, "revision", getIdentityString(identity, 2));
+
+    LinkedList device = LinkedList_getNext(self->logicalDevices);
+
+    while (device != NULL) {
+        ICLogicalDevice* ld = (ICLogicalDevice*) device->data;
+
+        fprintf(file, "LD %s\n", ld->name);
+
+        writeNames(file, "V", ld->variables);
+        writeNames(file, "DS", ld->dataSets);
+
+        device = LinkedList_getNext(device);
+    }
+
+    bool success = (ferror(file) == 0);
+
+    if (fclose(file) != 0)
+        success = false;
+
+    if (success) {
+        remove(self->modelCacheFile);
+
+        if (rename(tmpFileName, self->modelCacheFile) != 0)
+            success = false;
+    }
+
+    if (success == false) {
+        if (DEBUG_IED_CLIENT)
+            printf("DEBUG_IED_CLIENT: failed to write model cache file %s\n", self->modelCacheFile);
+
+        remove(tmpFileName);
+    }
+
+    free(tmpFileName);
+}
+
+/* read a line without the line break. Returns false at the end of the file or for too long lines */
+static bool
+readLine(FILE* file, char* line)
+{
+    if (fgets(line, MODEL_CACHE_MAX_LINE_LENGTH, file) == NULL)
+        return false;
+
+    int length = strlen(line);
+
+    if ((length == 0) || (line[length - 1] != '\n'))
+        return false;
+
+    line[length - 1] = 0;
+
+    return true;
+}
+
+static bool
+checkIdentityString(FILE* file, char* line, char* key, char* value)
+{
+    int keyLength = strlen(key);
+
+    if (readLine(file, line) == false)
+        return false;
+
+    if ((strncmp(line, key, keyLength) != 0) || (line[keyLength] != ' '))
+        return false;
+
+    /* compare like the string was written */
+    char* cachedValue = line + keyLength + 1;
+
+    int i;
+
+    for (i = 0; (value[i] != 0) && (i < (MODEL_CACHE_MAX_LINE_LENGTH - 16)); i++) {
+        char c = value[i];
+
+        if ((c == '\n') || (c == '\r'))
+            c = ' ';
+
+        if (cachedValue[i] != c)
+            return false;
+    }
+
+    return (cachedValue[i] == 0);
+}
+
+static LinkedList
+parseModel(FILE* file, char* line, LinkedList domainNames)
+{
+    LinkedList logicalDevices = LinkedList_create();
+
+    LinkedList domainName = domainNames;
+    ICLogicalDevice* ld = NULL;
+
+    /* the names are added with insertAfter to avoid searching the end of the lists */
+    LinkedList lastVariable = NULL;
+    LinkedList lastDataSet = NULL;
+
+    while (readLine(file, line)) {
+
+        if (strncmp(line, "LD ", 3) == 0) {
+            domainName = LinkedList_getNext(domainName);
+
+            if ((domainName == NULL) || (strcmp((char*) domainName->data, line + 3) != 0))
+                goto parse_error;
+
+            ld = ICLogicalDevice_create(line + 3);
+
+            ICLogicalDevice_setVariableList(ld, LinkedList_create());
+            ICLogicalDevice_setDataSetList(ld, LinkedList_create());
+
+            lastVariable = ld->variables;
+            lastDataSet = ld->dataSets;
+
+            LinkedList_add(logicalDevices, ld);
+        }
+        else if ((strncmp(line, "V ", 2) == 0) && (ld != NULL))
+            lastVariable = LinkedList_insertAfter(lastVariable, copyString(line + 2));
+        else if ((strncmp(line, "DS ", 3) == 0) && (ld != NULL))
+            lastDataSet = LinkedList_insertAfter(lastDataSet, copyString(line + 3));
+        else
+            goto parse_error;
+    }
+
+    /* all logical devices of the server have to be in the cache */
+    if (LinkedList_getNext(domainName) != NULL)
+        goto parse_error;
+
+    if (!feof(file))
+        goto parse_error;
+
+    return logicalDevices;
+
+parse_error:
+    LinkedList_destroyDeep(logicalDevices, (LinkedListValueDeleteFunction) ICLogicalDevice_destroy);
+
+    return NULL;
+}
+
+bool
+private_IedConnection_loadModelCache(IedConnection self, MmsServerIdentity* identity, LinkedList domainNames)
+{
+    FILE* file = fopen(self->modelCacheFile, "r");
+
+    if (file == NULL)
+        return false;
+
+    char* line = (char*) malloc(MODEL_CACHE_MAX_LINE_LENGTH);
+
+    LinkedList logicalDevices = NULL;
+
+    if (readLine(file, line) && (strcmp(line, MODEL_CACHE_HEADER) == 0)) {
+
+        if (checkIdentityString(file, line, "vendor", getIdentityString(identity, 0)) &&
+                checkIdentityString(file, line, "model", getIdentityString(identity, 1)) &&
+                checkIdentityString(file, line, "revision", getIdentityString(identity, 2)))
+        {
+            logicalDevices = parseModel(file, line, domainNames);
+        }
+    }
+
+    free(line);
+    fclose(file);
+
+    if (logicalDevices == NULL) {
+        if (DEBUG_IED_CLIENT)
+            printf("DEBUG_IED_CLIENT: model cache file %s is not valid for this server\n", self->modelCacheFile);
+
+        return false;
+    }
+
+    self->logicalDevices = logicalDevices;
+
+    return true;
+}
@@ -34,11 +34,13 @@
 struct sClientReport
 {
     ReportCallbackFunction callback;
+    ReportValueHandler valueHandler;
     void* callbackParameter;
     char* rcbReference;
     char* rptId;
     MmsValue* entryId;
     MmsValue* dataSetValues;
+    int dataSetSize;
     ReasonForInclusion* reasonForInclusion;
     bool hasTimestamp;
     uint64_t timestamp;
@@ -138,6 +140,38 @@ ClientReport_getDataSetValues(ClientReport self)
     return self->dataSetValues;
 }
 
+/* FNV-1a hash of the RptID */
+static int
+getHashIndex(uint8_t* rptId, int length)
+{
+    uint32_t hash = 2166136261U;
+    int i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= rptId[i];
+        hash *= 16777619U;
+    }
+
+    return hash % IED_CONNECTION_REPORT_HASH_TABLE_SIZE;
+}
+
+static char*
+getReportKey(ClientReport report)
+{
+    if (report->rptId != NULL)
+        return report->rptId;
+    else
+        return report->rcbReference;
+}
+
+static LinkedList
+getReportTableEntry(IedConnection self, ClientReport report)
+{
+    char* key = getReportKey(report);
+
+    return self->reportTable[getHashIndex((uint8_t*) key, strlen(key))];
+}
+
 static ClientReport
 lookupReportHandler(IedConnection self, char* rcbReference)
 {
@@ -155,9 +189,28 @@ lookupReportHandler(IedConnection self, char* rcbReference)
     return NULL;
 }
 
-void
-IedConnection_installReportHandler(IedConnection self, char* rcbReference, char* rptId, ReportCallbackFunction handler,
-        void* handlerParameter)
+static ClientReport
+lookupReportByRptId(IedConnection self, uint8_t* rptId, int rptIdSize)
+{
+    LinkedList element = LinkedList_getNext(self->reportTable[getHashIndex(rptId, rptIdSize)]);
+
+    while (element != NULL) {
+        ClientReport report = (ClientReport) element->data;
+
+        char* key = getReportKey(report);
+
+        if ((strlen(key) == (size_t) rptIdSize) && (memcmp(key, rptId, rptIdSize) == 0))
+            return report;
+
+        element = LinkedList_getNext(element);
+    }
+
+    return NULL;
+}
+
+static void
+installReport(IedConnection self, char* rcbReference, char* rptId, ReportCallbackFunction handler,
+        ReportValueHandler valueHandler, void* handlerParameter)
 {
     ClientReport report = lookupReportHandler(self, rcbReference);
 
@@ -170,6 +223,7 @@ IedConnection_installReportHandler(IedConnection self, char* rcbReference, char*
 
     report = ClientReport_create();
     report->callback = handler;
+    report->valueHandler = valueHandler;
     report->callbackParameter = handlerParameter;
     report->rcbReference = copyString(rcbReference);
 
@@ -179,17 +233,33 @@ IedConnection_installReportHandler(IedConnection self, char* rcbReference, char*
         report->rptId = NULL;
 
     LinkedList_add(self->enabledReports, report);
+    LinkedList_add(getReportTableEntry(self, report), report);
 
     if (DEBUG_IED_CLIENT)
         printf("DEBUG_IED_CLIENT: Installed new report callback handler for %s\n", rcbReference);
 }
 
+void
+IedConnection_installReportHandler(IedConnection self, char* rcbReference, char* rptId, ReportCallbackFunction handler,
+        void* handlerParameter)
+{
+    installReport(self, rcbReference, rptId, handler, NULL, handlerParameter);
+}
+
+void
+IedConnection_installReportValueHandler(IedConnection self, char* rcbReference, char* rptId,
+        ReportValueHandler valueHandler, ReportCallbackFunction handler, void* handlerParameter)
+{
+    installReport(self, rcbReference, rptId, handler, valueHandler, handlerParameter);
+}
+
 void
 IedConnection_uninstallReportHandler(IedConnection self, char* rcbReference)
 {
     ClientReport report = lookupReportHandler(self, rcbReference);
 
     if (report != NULL) {
+        LinkedList_remove(getReportTableEntry(self, report), report);
         LinkedList_remove(self->enabledReports, report);
         ClientReport_destroy(report);
     }
@@ -232,166 +302,198 @@ IedConnection_triggerGIReport(IedConnection self, IedClientError* error, char* r
     }
 }
 
-void
-private_IedConnection_handleReport(IedConnection self, MmsValue* value)
+static ReasonForInclusion
+getReasonForInclusion(MmsRawValue* reasonForInclusion)
 {
-    MmsValue* rptIdValue = MmsValue_getElement(value, 0);
+    if (MmsRawValue_getBitStringBit(reasonForInclusion, 1) == true)
+        return REASON_DATA_CHANGE;
+    else if (MmsRawValue_getBitStringBit(reasonForInclusion, 2) == true)
+        return REASON_QUALITY_CHANGE;
+    else if (MmsRawValue_getBitStringBit(reasonForInclusion, 3) == true)
+        return REASON_DATA_UPDATE;
+    else if (MmsRawValue_getBitStringBit(reasonForInclusion, 4) == true)
+        return REASON_INTEGRITY;
+    else if (MmsRawValue_getBitStringBit(reasonForInclusion, 5) == true)
+        return REASON_GI;
+    else
+        return REASON_UNKNOWN;
+}
 
-    LinkedList element = LinkedList_getNext(self->enabledReports);
-    ClientReport report = NULL;
+static void
+updateDataSetValue(ClientReport report, int elementIndex, MmsRawValue* rawValue)
+{
+    MmsValue* newElementValue = MmsRawValue_toMmsValue(rawValue);
 
-    while (element != NULL) {
-        report = (ClientReport) element->data;
+    if (newElementValue == NULL)
+        return;
 
-        char* rptId =report->rptId;
+    MmsValue* dataSetElement = MmsValue_getElement(report->dataSetValues, elementIndex);
 
-        if (rptId == NULL)
-            rptId = report->rcbReference;
+    if (dataSetElement == NULL)
+        MmsValue_setElement(report->dataSetValues, elementIndex, newElementValue);
+    else {
+        MmsValue_update(dataSetElement, newElementValue);
+        MmsValue_delete(newElementValue);
+    }
 
-        if (strcmp(MmsValue_toString(rptIdValue), rptId) == 0) {
-            break;
-        }
+    if (DEBUG_IED_CLIENT)
+        printf("DEBUG_IED_CLIENT:  update element value type: %i\n", rawValue->type);
+}
 
-        element = LinkedList_getNext(element);
-    }
+void
+private_IedConnection_handleReport(IedConnection self, MmsRawValue* values, int valueCount)
+{
+    if ((valueCount < 2) || (values[0].type != MMS_VISIBLE_STRING))
+        return;
+
+    ClientReport report = lookupReportByRptId(self, values[0].buffer, values[0].size);
+
+    if (report == NULL) {
+        if (DEBUG_IED_CLIENT)
+            printf("DEBUG_IED_CLIENT: received report with unknown ID\n");
 
-    if (report == NULL)
         return;
+    }
 
     if (DEBUG_IED_CLIENT)
-        printf("DEBUG_IED_CLIENT: received report with ID %s\n", MmsValue_toString(rptIdValue));
+        printf("DEBUG_IED_CLIENT: received report with ID %s\n", getReportKey(report));
 
-    MmsValue* optFlds = MmsValue_getElement(value, 1);
+    MmsRawValue* optFlds = &(values[1]);
+
+    if (optFlds->type != MMS_BIT_STRING)
+        return;
 
     int inclusionIndex = 2;
 
     /* has sequence-number */
-    if (MmsValue_getBitStringBit(optFlds, 1) == true)
+    if (MmsRawValue_getBitStringBit(optFlds, 1) == true)
         inclusionIndex++;
 
     /* has report-timestamp */
-    if (MmsValue_getBitStringBit(optFlds, 2) == true) {
-        MmsValue* timeStampValue = MmsValue_getElement(value, inclusionIndex);
+    if (MmsRawValue_getBitStringBit(optFlds, 2) == true) {
 
-        if (MmsValue_getType(timeStampValue) == MMS_BINARY_TIME) {
+        if ((inclusionIndex < valueCount) && (values[inclusionIndex].type == MMS_BINARY_TIME)) {
             report->hasTimestamp = true;
-            report->timestamp = MmsValue_getBinaryTimeAsUtcMs(timeStampValue);
+            report->timestamp = MmsRawValue_getTimeInMs(&(values[inclusionIndex]));
         }
 
         inclusionIndex++;
     }
 
-    if (MmsValue_getBitStringBit(optFlds, 4) == true) /* check if data set name is present */
+    if (MmsRawValue_getBitStringBit(optFlds, 4) == true) /* check if data set name is present */
        inclusionIndex++;
 
-    if (DEBUG_IED_CLIENT)
-        printf("DEBUG_IED_CLIENT: Found enabled report!\n");
-
     /* skip bufOvfl */
-    if (MmsValue_getBitStringBit(optFlds, 6) == true)
+    if (MmsRawValue_getBitStringBit(optFlds, 6) == true)
         inclusionIndex++;
 
-    /* skip entryId */
-    if (MmsValue_getBitStringBit(optFlds, 7) == true) {
-        MmsValue* entryId = MmsValue_getElement(value, inclusionIndex);
+    /* entryId */
+    if (MmsRawValue_getBitStringBit(optFlds, 7) == true) {
+
+        if (inclusionIndex < valueCount) {
+            MmsValue* entryId = MmsRawValue_toMmsValue(&(values[inclusionIndex]));
 
-        if (report->entryId != NULL) {
+            if (entryId != NULL) {
+                if (report->entryId != NULL)
+                    MmsValue_delete(report->entryId);
 
-            if (!MmsValue_update(report->entryId, entryId)) {
-                MmsValue_delete(report->entryId);
-                report->entryId = MmsValue_clone(entryId);
+                report->entryId = entryId;
             }
         }
-        else {
-            report->entryId = MmsValue_clone(entryId);
-        }
 
         inclusionIndex++;
     }
 
     /* skip confRev */
-    if (MmsValue_getBitStringBit(optFlds, 8) == true)
+    if (MmsRawValue_getBitStringBit(optFlds, 8) == true)
         inclusionIndex++;
 
     /* skip segmentation fields */
-    if (MmsValue_getBitStringBit(optFlds, 9) == true)
+    if (MmsRawValue_getBitStringBit(optFlds, 9) == true)
         inclusionIndex += 2;
 
-    MmsValue* inclusion = MmsValue_getElement(value, inclusionIndex);
+    if ((inclusionIndex >= valueCount) || (values[inclusionIndex].type != MMS_BIT_STRING)) {
+        if (DEBUG_IED_CLIENT)
+            printf("DEBUG_IED_CLIENT: malformed report\n");
+
+        return;
+    }
+
+    MmsRawValue* inclusion = &(values[inclusionIndex]);
 
-    int dataSetSize = MmsValue_getBitStringSize(inclusion);
+    int dataSetSize = MmsRawValue_getBitStringSize(inclusion);
 
-    int includedElements = MmsValue_getNumberOfSetBits(inclusion);
+    int includedElements = 0;
+
+    int i;
+
+    for (i = 0; i < dataSetSize; i++) {
+        if (MmsRawValue_getBitStringBit(inclusion, i))
+            includedElements++;
+    }
 
     if (DEBUG_IED_CLIENT)
         printf("DEBUG_IED_CLIENT: Report includes %i data set elements of %i\n", includedElements,
                 dataSetSize);
 
     int valueIndex = inclusionIndex + 1;
+
     /* skip data-reference fields */
-    if (MmsValue_getBitStringBit(optFlds, 5) == true)
+    if (MmsRawValue_getBitStringBit(optFlds, 5) == true)
         valueIndex += includedElements;
 
-    int i;
-
-    if (report->dataSetValues == NULL) {
-        report->dataSetValues = MmsValue_createEmtpyArray(dataSetSize);
-        report->reasonForInclusion = (ReasonForInclusion*)
-                malloc(sizeof(ReasonForInclusion) * dataSetSize);
+    bool hasReasonForInclusion = MmsRawValue_getBitStringBit(optFlds, 3);
+    int reasonForInclusionIndex = valueIndex + includedElements;
 
-        int elementIndex;
+    if (valueIndex + includedElements > valueCount)
+        return;
 
-        for (elementIndex = 0; elementIndex < dataSetSize; elementIndex++)
-            report->reasonForInclusion[elementIndex] = REASON_NOT_INCLUDED;
+    if (hasReasonForInclusion && (reasonForInclusionIndex + includedElements > valueCount))
+        return;
 
-    }
+    if (report->dataSetSize != dataSetSize) {
+        if (report->dataSetValues != NULL) {
+            MmsValue_delete(report->dataSetValues);
+            report->dataSetValues = NULL;
+        }
 
-    MmsValue* dataSetValues = report->dataSetValues;
+        if (report->reasonForInclusion != NULL)
+            free(report->reasonForInclusion);
 
-    bool hasReasonForInclusion = MmsValue_getBitStringBit(optFlds, 3);
-    int reasonForInclusionIndex = valueIndex + includedElements;
+        report->reasonForInclusion = (ReasonForInclusion*)
+                malloc(sizeof(ReasonForInclusion) * dataSetSize);
 
-    for (i = 0; i < dataSetSize; i++) {
-        if (MmsValue_getBitStringBit(inclusion, i) == true) {
+        report->dataSetSize = dataSetSize;
+    }
 
-            MmsValue* dataSetElement = MmsValue_getElement(dataSetValues, i);
+    /* data set values are only stored for classic report handlers */
+    if ((report->valueHandler == NULL) && (report->dataSetValues == NULL))
+        report->dataSetValues = MmsValue_createEmtpyArray(dataSetSize);
 
-            MmsValue* newElementValue = MmsValue_getElement(value, valueIndex);
+    for (i = 0; i < dataSetSize; i++) {
+        if (MmsRawValue_getBitStringBit(inclusion, i) == true) {
 
-            if (dataSetElement == NULL)
-                MmsValue_setElement(dataSetValues, i, MmsValue_clone(newElementValue));
+            if (hasReasonForInclusion) {
+                report->reasonForInclusion[i] = getReasonForInclusion(&(values[reasonForInclusionIndex]));
+                reasonForInclusionIndex++;
+            }
             else
-                MmsValue_update(dataSetElement, newElementValue);
+                report->reasonForInclusion[i] = REASON_UNKNOWN;
 
-            if (DEBUG_IED_CLIENT)
-                printf("DEBUG_IED_CLIENT:  update element value type: %i\n", MmsValue_getType(newElementValue));
+            if (report->valueHandler != NULL)
+                report->valueHandler(report->callbackParameter, report, i, report->reasonForInclusion[i],
+                        &(values[valueIndex]));
+            else
+                updateDataSetValue(report, i, &(values[valueIndex]));
 
             valueIndex++;
-
-            if (hasReasonForInclusion) {
-                MmsValue* reasonForInclusion = MmsValue_getElement(value, reasonForInclusionIndex);
-
-                if (MmsValue_getBitStringBit(reasonForInclusion, 1) == true)
-                    report->reasonForInclusion[i] = REASON_DATA_CHANGE;
-                else if (MmsValue_getBitStringBit(reasonForInclusion, 2) == true)
-                    report->reasonForInclusion[i] = REASON_QUALITY_CHANGE;
-                else if (MmsValue_getBitStringBit(reasonForInclusion, 3) == true)
-                    report->reasonForInclusion[i] = REASON_DATA_UPDATE;
-                else if (MmsValue_getBitStringBit(reasonForInclusion, 4) == true)
-                    report->reasonForInclusion[i] = REASON_INTEGRITY;
-                else if (MmsValue_getBitStringBit(reasonForInclusion, 5) == true)
-                    report->reasonForInclusion[i] = REASON_GI;
-            }
-            else {
-                report->reasonForInclusion[i] = REASON_UNKNOWN;
-            }
         }
         else {
             report->reasonForInclusion[i] = REASON_NOT_INCLUDED;
         }
     }
+
     if (report->callback != NULL) {
         report->callback(report->callbackParameter, report);
     }
 }
-
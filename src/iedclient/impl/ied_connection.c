@@ -32,13 +32,11 @@
 
 #include "ied_connection_private.h"
 #include "mms_value_internal.h"
+#include "hal.h"
 
-typedef struct sICLogicalDevice
-{
-    char* name;
-    LinkedList variables;
-    LinkedList dataSets;
-} ICLogicalDevice;
+#ifndef CONFIG_MMS_CLIENT_FILE_READ_WINDOW_SIZE
+#define CONFIG_MMS_CLIENT_FILE_READ_WINDOW_SIZE 4
+#endif
 
 struct sClientDataSet
 {
@@ -104,7 +102,7 @@ iedConnection_mapDataAccessErrorToIedError(MmsDataAccessError mmsError)
 }
 
 
-static ICLogicalDevice*
+ICLogicalDevice*
 ICLogicalDevice_create(char* name)
 {
     ICLogicalDevice* self = (ICLogicalDevice*) calloc(1, sizeof(struct sICLogicalDevice));
@@ -114,19 +112,19 @@ ICLogicalDevice_create(char* name)
     return self;
 }
 
-static void
+void
 ICLogicalDevice_setVariableList(ICLogicalDevice* self, LinkedList variables)
 {
     self->variables = variables;
 }
 
-static void
+void
 ICLogicalDevice_setDataSetList(ICLogicalDevice* self, LinkedList dataSets)
 {
     self->dataSets = dataSets;
 }
 
-static void
+void
 ICLogicalDevice_destroy(ICLogicalDevice* self)
 {
     free(self->name);
@@ -355,32 +353,49 @@ handleLastApplErrorMessage(IedConnection self, MmsValue* value)
 }
 
 static void
-informationReportHandler(void* parameter, char* domainName,
-        char* variableListName, MmsValue* value, bool isVariableListName)
+informationReportHandler(void* parameter, char* domainName, char* variableListName, LinkedList attributes,
+        MmsRawValue* values, int valueCount)
 {
     IedConnection self = (IedConnection) parameter;
 
+    if (variableListName != NULL) {
+
+        if (DEBUG_IED_CLIENT)
+            printf("DEBUG_IED_CLIENT: received information report for %s\n", variableListName);
+
+        private_IedConnection_handleReport(self, values, valueCount);
+
+        return;
+    }
+
+    LinkedList firstAttribute = LinkedList_getNext(attributes);
+
+    if ((firstAttribute == NULL) || (valueCount < 1))
+        return;
+
+    char* itemName = (char*) firstAttribute->data;
+
     if (DEBUG_IED_CLIENT)
-        printf("DEBUG_IED_CLIENT: received information report for %s\n", variableListName);
+        printf("DEBUG_IED_CLIENT: received information report for %s\n", itemName);
 
     if (domainName == NULL) {
 
-        if (isVariableListName) {
+        if (strcmp(itemName, "LastApplError") == 0) {
+            MmsValue* value = MmsRawValue_toMmsValue(values);
 
-            private_IedConnection_handleReport(self, value);
-        }
-        else {
-            if (strcmp(variableListName, "LastApplError") == 0)
+            if (value != NULL) {
                 handleLastApplErrorMessage(self, value);
-            else {
-                if (DEBUG_IED_CLIENT)
-                    printf("IED_CLIENT: Received unknown variable list report for list: %s\n", variableListName);
+                MmsValue_delete(value);
             }
         }
+        else {
+            if (DEBUG_IED_CLIENT)
+                printf("IED_CLIENT: Received unknown variable list report for list: %s\n", itemName);
+        }
     }
     else {
         if (DEBUG_IED_CLIENT)
-            printf("IED_CLIENT: RCVD CommandTermination for %s/%s\n", domainName, variableListName);
+            printf("IED_CLIENT: RCVD CommandTermination for %s/%s\n", domainName, itemName);
 
         LinkedList control = LinkedList_getNext(self->clientControls);
 
@@ -389,14 +404,12 @@ informationReportHandler(void* parameter, char* domainName,
 
            char* objectRef = ControlObjectClient_getObjectReference(object);
 
-           if (doesReportMatchControlObject(domainName, variableListName, objectRef))
+           if (doesReportMatchControlObject(domainName, itemName, objectRef))
                private_ControlObjectClient_invokeCommandTerminationHandler(object);
 
            control = LinkedList_getNext(control);
         }
     }
-
-    MmsValue_delete(value);
 }
 
 IedConnection
@@ -405,9 +418,17 @@ IedConnection_create()
     IedConnection self = (IedConnection) calloc(1, sizeof(struct sIedConnection));
 
     self->enabledReports = LinkedList_create();
+
+    int i;
+
+    for (i = 0; i < IED_CONNECTION_REPORT_HASH_TABLE_SIZE; i++)
+        self->reportTable[i] = LinkedList_create();
+
     self->logicalDevices = NULL;
     self->clientControls = LinkedList_create();
 
+    self->fileReadWindowSize = CONFIG_MMS_CLIENT_FILE_READ_WINDOW_SIZE;
+
     self->connection = MmsConnection_create();
 
     self->state = IED_STATE_IDLE;
@@ -467,7 +488,7 @@ IedConnection_connect(IedConnection self, IedClientError* error, char* hostname,
     if (IedConnection_getState(self) != IED_STATE_CONNECTED) {
 
         MmsConnection_setConnectionLostHandler(self->connection, connectionLostHandler, (void*) self);
-        MmsConnection_setInformationReportHandler(self->connection, informationReportHandler, self);
+        MmsConnection_setRawInformationReportHandler(self->connection, informationReportHandler, self);
 
         if (MmsConnection_connect(self->connection, &mmsError, hostname, tcpPort)) {
             *error = IED_ERROR_OK;
@@ -537,9 +558,17 @@ IedConnection_destroy(IedConnection self)
     if (self->logicalDevices != NULL)
         LinkedList_destroyDeep(self->logicalDevices, (LinkedListValueDeleteFunction) ICLogicalDevice_destroy);
 
+    if (self->modelCacheFile != NULL)
+        free(self->modelCacheFile);
+
     if (self->enabledReports != NULL)
         LinkedList_destroyDeep(self->enabledReports, (LinkedListValueDeleteFunction) ClientReport_destroy);
 
+    int i;
+
+    for (i = 0; i < IED_CONNECTION_REPORT_HASH_TABLE_SIZE; i++)
+        LinkedList_destroyStatic(self->reportTable[i]);
+
     LinkedList_destroyStatic(self->clientControls);
 
     Semaphore_destroy(self->stateMutex);
@@ -582,6 +611,37 @@ IedConnection_getVariableSpecification(IedConnection self, IedClientError* error
     return varSpec;
 }
 
+MmsVariableSpecification*
+IedConnection_getCachedVariableSpecification(IedConnection self, IedClientError* error, char* objectReference,
+        FunctionalConstraint fc)
+{
+    char domainIdBuffer[65];
+    char itemIdBuffer[129];
+
+    char* domainId;
+    char* itemId;
+
+    domainId = MmsMapping_getMmsDomainFromObjectReference(objectReference, domainIdBuffer);
+    itemId = MmsMapping_createMmsVariableNameFromObjectReference(objectReference, fc, itemIdBuffer);
+
+    if ((domainId == NULL) || (itemId == NULL)) {
+        *error = IED_ERROR_OBJECT_REFERENCE_INVALID;
+        return NULL;
+    }
+
+    MmsError mmsError;
+
+    MmsVariableSpecification* varSpec =
+            MmsConnection_getCachedVariableAccessAttributes(self->connection, &mmsError, domainId, itemId);
+
+    if (varSpec != NULL)
+        *error = IED_ERROR_OK;
+    else
+        *error = iedConnection_mapMmsErrorToIedError(mmsError);
+
+    return varSpec;
+}
+
 MmsValue*
 IedConnection_readObject(IedConnection self, IedClientError* error, char* objectReference,
         FunctionalConstraint fc)
@@ -614,6 +674,91 @@ IedConnection_readObject(IedConnection self, IedClientError* error, char* object
     return value;
 }
 
+MmsValue*
+IedConnection_createObjectValue(IedConnection self, IedClientError* error, char* objectReference,
+        FunctionalConstraint fc)
+{
+    char domainIdBuffer[65];
+    char itemIdBuffer[129];
+
+    char* domainId;
+    char* itemId;
+
+    domainId = MmsMapping_getMmsDomainFromObjectReference(objectReference, domainIdBuffer);
+    itemId = MmsMapping_createMmsVariableNameFromObjectReference(objectReference, fc, itemIdBuffer);
+
+    if ((domainId == NULL) || (itemId == NULL)) {
+        *error = IED_ERROR_OBJECT_REFERENCE_INVALID;
+        return NULL;
+    }
+
+    MmsError mmsError;
+
+    MmsValue* value = MmsConnection_createVariableValue(self->connection, &mmsError, domainId, itemId);
+
+    if (value != NULL)
+        *error = IED_ERROR_OK;
+    else
+        *error = iedConnection_mapMmsErrorToIedError(mmsError);
+
+    return value;
+}
+
+void
+IedConnection_readObjectInto(IedConnection self, IedClientError* error, char* objectReference,
+        FunctionalConstraint fc, MmsValue* value)
+{
+    char domainIdBuffer[65];
+    char itemIdBuffer[129];
+
+    char* domainId;
+    char* itemId;
+
+    domainId = MmsMapping_getMmsDomainFromObjectReference(objectReference, domainIdBuffer);
+    itemId = MmsMapping_createMmsVariableNameFromObjectReference(objectReference, fc, itemIdBuffer);
+
+    if ((domainId == NULL) || (itemId == NULL)) {
+        *error = IED_ERROR_OBJECT_REFERENCE_INVALID;
+        return;
+    }
+
+    MmsError mmsError;
+
+    MmsConnection_readVariableInto(self->connection, &mmsError, domainId, itemId, value);
+
+    *error = iedConnection_mapMmsErrorToIedError(mmsError);
+}
+
+int
+IedConnection_addToReadPlan(IedConnection self, MmsReadPlan plan, char* objectReference, FunctionalConstraint fc)
+{
+    char domainIdBuffer[65];
+    char itemIdBuffer[129];
+
+    char* domainId;
+    char* itemId;
+
+    (void) self;
+
+    domainId = MmsMapping_getMmsDomainFromObjectReference(objectReference, domainIdBuffer);
+    itemId = MmsMapping_createMmsVariableNameFromObjectReference(objectReference, fc, itemIdBuffer);
+
+    if ((domainId == NULL) || (itemId == NULL))
+        return -1;
+
+    return MmsReadPlan_addVariable(plan, domainId, itemId);
+}
+
+void
+IedConnection_executeReadPlan(IedConnection self, IedClientError* error, MmsReadPlan plan)
+{
+    MmsError mmsError;
+
+    MmsReadPlan_execute(plan, self->connection, &mmsError);
+
+    *error = iedConnection_mapMmsErrorToIedError(mmsError);
+}
+
 bool
 IedConnection_readBooleanValue(IedConnection self, IedClientError* error, char* objectReference, FunctionalConstraint fc)
 {
@@ -893,67 +1038,286 @@ IedConnection_writeVisibleStringValue(IedConnection self, IedClientError* error,
     MmsValue mmsValue;
     mmsValue.deleteValue = 0;
     mmsValue.type = MMS_VISIBLE_STRING;
-    mmsValue.value.visibleString = value;
+    mmsValue.value.visibleString.buf = value;
+    mmsValue.value.visibleString.size = strlen(value) + 1;
 
     IedConnection_writeObject(self, error, objectReference, fc, &mmsValue);
 }
 
+typedef struct {
+    Condition condition; /* protects and signals the state of the discovery */
+    MmsConnection connection;
+    int pendingRequests;
+    MmsError error;
+} ModelDiscovery;
+
+/* a get name list request and its continuations */
+typedef struct {
+    ModelDiscovery* discovery;
+    char* domainId;
+    MmsObjectClass objectClass;
+    LinkedList names;
+    LinkedList lastName;
+} NameListRequest;
+
+static void
+nameListResponseHandler(uint32_t invokeId, void* parameter, MmsError mmsError, LinkedList nameList,
+        bool moreFollows);
+
+/* has to be called without holding the lock - the handler can be called by the calling thread */
+static bool
+sendNameListRequest(NameListRequest* request, char* continueAfter)
+{
+    ModelDiscovery* discovery = request->discovery;
+    MmsError mmsError;
+
+    if (MmsConnection_getNameListAsync(discovery->connection, &mmsError, request->domainId, request->objectClass,
+            false, continueAfter, nameListResponseHandler, request) == 0)
+    {
+        Condition_lock(discovery->condition);
+        discovery->error = mmsError;
+        Condition_unlock(discovery->condition);
+
+        return false;
+    }
+
+    return true;
+}
+
+static void
+nameListResponseHandler(uint32_t invokeId, void* parameter, MmsError mmsError, LinkedList nameList,
+        bool moreFollows)
+{
+    NameListRequest* request = (NameListRequest*) parameter;
+    ModelDiscovery* discovery = request->discovery;
+
+    (void) invokeId;
+
+    bool sendContinuation = false;
+
+    Condition_lock(discovery->condition);
+
+    if (nameList != NULL) {
+        /* append the received names without copying */
+        request->lastName->next = nameList->next;
+        nameList->next = NULL;
+        LinkedList_destroyStatic(nameList);
+
+        request->lastName = LinkedList_getLastElement(request->lastName);
+
+        if (moreFollows && (request->lastName != request->names) && (discovery->error == MMS_ERROR_NONE))
+            sendContinuation = true;
+    }
+    else
+        discovery->error = mmsError;
+
+    Condition_unlock(discovery->condition);
+
+    if (sendContinuation) {
+        if (sendNameListRequest(request, (char*) request->lastName->data))
+            return;
+    }
+
+    Condition_lock(discovery->condition);
+
+    discovery->pendingRequests--;
+
+    if (discovery->pendingRequests == 0)
+        Condition_broadcast(discovery->condition);
+
+    Condition_unlock(discovery->condition);
+}
+
+static void
+initNameListRequest(NameListRequest* request, ModelDiscovery* discovery, char* domainId,
+        MmsObjectClass objectClass)
+{
+    request->discovery = discovery;
+    request->domainId = domainId;
+    request->objectClass = objectClass;
+    request->names = LinkedList_create();
+    request->lastName = request->names;
+}
+
+/* get the variable and data set names of all logical devices with pipelined requests */
+static void
+discoverDeviceModel(IedConnection self, IedClientError* error, LinkedList logicalDeviceNames)
+{
+    ModelDiscovery discovery;
+
+    discovery.condition = Condition_create();
+    discovery.connection = self->connection;
+    discovery.pendingRequests = 0;
+    discovery.error = MMS_ERROR_NONE;
+
+    int deviceCount = LinkedList_size(logicalDeviceNames);
+
+    /* two requests for each logical device (variables and data sets) */
+    NameListRequest* requests = (NameListRequest*) calloc(2 * deviceCount, sizeof(NameListRequest));
+
+    LinkedList logicalDevice = LinkedList_getNext(logicalDeviceNames);
+
+    int i = 0;
+
+    while (logicalDevice != NULL) {
+        char* name = (char*) logicalDevice->data;
+
+        initNameListRequest(&(requests[i]), &discovery, name, MMS_NAMED_VARIABLE);
+        initNameListRequest(&(requests[i + 1]), &discovery, name, MMS_NAMED_VARIABLE_LIST);
+
+        i += 2;
+
+        logicalDevice = LinkedList_getNext(logicalDevice);
+    }
+
+    for (i = 0; i < 2 * deviceCount; i++) {
+        Condition_lock(discovery.condition);
+        discovery.pendingRequests++;
+        Condition_unlock(discovery.condition);
+
+        if (sendNameListRequest(&(requests[i]), NULL) == false) {
+            Condition_lock(discovery.condition);
+            discovery.pendingRequests--;
+            Condition_unlock(discovery.condition);
+            break;
+        }
+    }
+
+    /* timeouts are only checked by the connection when messages are exchanged */
+    uint32_t checkInterval = 1000;
+
+    Condition_lock(discovery.condition);
+
+    while (discovery.pendingRequests > 0) {
+        if (Condition_waitUntil(discovery.condition, Hal_getTimeInMs() + checkInterval) == false) {
+            Condition_unlock(discovery.condition);
+
+            MmsConnection_checkTimeouts(self->connection);
+
+            Condition_lock(discovery.condition);
+        }
+    }
+
+    Condition_unlock(discovery.condition);
+
+    Condition_destroy(discovery.condition);
+
+    if (discovery.error == MMS_ERROR_NONE) {
+        LinkedList logicalDevices = LinkedList_create();
+
+        for (i = 0; i < 2 * deviceCount; i += 2) {
+            ICLogicalDevice* icLogicalDevice = ICLogicalDevice_create(requests[i].domainId);
+
+            ICLogicalDevice_setVariableList(icLogicalDevice, requests[i].names);
+            ICLogicalDevice_setDataSetList(icLogicalDevice, requests[i + 1].names);
+
+            LinkedList_add(logicalDevices, icLogicalDevice);
+        }
+
+        self->logicalDevices = logicalDevices;
+
+        *error = IED_ERROR_OK;
+    }
+    else {
+        for (i = 0; i < 2 * deviceCount; i++)
+            LinkedList_destroy(requests[i].names);
+
+        *error = iedConnection_mapMmsErrorToIedError(discovery.error);
+    }
+
+    free(requests);
+}
+
+static void
+deleteDeviceModel(IedConnection self)
+{
+    if (self->logicalDevices != NULL) {
+        LinkedList_destroyDeep(self->logicalDevices, (LinkedListValueDeleteFunction) ICLogicalDevice_destroy);
+        self->logicalDevices = NULL;
+    }
+}
+
 void
 IedConnection_getDeviceModelFromServer(IedConnection self, IedClientError* error)
 {
     MmsError mmsError = MMS_ERROR_NONE;
-    *error = IED_ERROR_OK;
 
     LinkedList logicalDeviceNames = MmsConnection_getDomainNames(self->connection, &mmsError);
 
     if (logicalDeviceNames != NULL) {
 
-        if (self->logicalDevices != NULL) {
-            LinkedList_destroyDeep(self->logicalDevices, (LinkedListValueDeleteFunction) ICLogicalDevice_destroy);
-            self->logicalDevices = NULL;
-        }
+        deleteDeviceModel(self);
 
-        LinkedList logicalDevice = LinkedList_getNext(logicalDeviceNames);
+        discoverDeviceModel(self, error, logicalDeviceNames);
 
-        LinkedList logicalDevices = LinkedList_create();
+        if ((*error == IED_ERROR_OK) && (self->modelCacheFile != NULL)) {
+            MmsServerIdentity* identity = MmsConnection_identify(self->connection, &mmsError);
 
-        while (logicalDevice != NULL) {
-            char* name = (char*) logicalDevice->data;
+            private_IedConnection_saveModelCache(self, identity);
+
+            if (identity != NULL)
+                MmsServerIdentity_destroy(identity);
+        }
+
+        LinkedList_destroy(logicalDeviceNames);
+    }
+    else {
+        *error = iedConnection_mapMmsErrorToIedError(mmsError);
+    }
+}
+
+/* get the device model from the cache file if it is still valid or from the server */
+static void
+loadDeviceModel(IedConnection self, IedClientError* error)
+{
+    if (self->modelCacheFile == NULL) {
+        IedConnection_getDeviceModelFromServer(self, error);
+        return;
+    }
 
-            ICLogicalDevice* icLogicalDevice = ICLogicalDevice_create(name);
+    MmsError mmsError = MMS_ERROR_NONE;
 
-            LinkedList variables = MmsConnection_getDomainVariableNames(self->connection,
-                    &mmsError, name);
+    /* identify is optional - servers without identify service use an empty identity */
+    MmsServerIdentity* identity = MmsConnection_identify(self->connection, &mmsError);
 
-            if (variables != NULL)
-                ICLogicalDevice_setVariableList(icLogicalDevice, variables);
-            else {
-                *error = iedConnection_mapMmsErrorToIedError(mmsError);
-                break;
-            }
+    LinkedList logicalDeviceNames = MmsConnection_getDomainNames(self->connection, &mmsError);
 
-            LinkedList dataSets = MmsConnection_getDomainVariableListNames(self->connection,
-                    &mmsError, name);
+    if (logicalDeviceNames != NULL) {
 
-            if (dataSets != NULL)
-                ICLogicalDevice_setDataSetList(icLogicalDevice, dataSets);
-            else {
-                *error = iedConnection_mapMmsErrorToIedError(mmsError);
-                break;
-            }
+        deleteDeviceModel(self);
 
-            LinkedList_add(logicalDevices, icLogicalDevice);
+        if (private_IedConnection_loadModelCache(self, identity, logicalDeviceNames)) {
+            if (DEBUG_IED_CLIENT)
+                printf("DEBUG_IED_CLIENT: use device model from cache file %s\n", self->modelCacheFile);
 
-            logicalDevice = LinkedList_getNext(logicalDevice);
+            *error = IED_ERROR_OK;
         }
+        else {
+            discoverDeviceModel(self, error, logicalDeviceNames);
 
-        self->logicalDevices = logicalDevices;
+            if (*error == IED_ERROR_OK)
+                private_IedConnection_saveModelCache(self, identity);
+        }
 
         LinkedList_destroy(logicalDeviceNames);
     }
-    else {
+    else
         *error = iedConnection_mapMmsErrorToIedError(mmsError);
-    }
+
+    if (identity != NULL)
+        MmsServerIdentity_destroy(identity);
+}
+
+void
+IedConnection_setModelCacheFile(IedConnection self, char* fileName)
+{
+    if (self->modelCacheFile != NULL)
+        free(self->modelCacheFile);
+
+    if (fileName != NULL)
+        self->modelCacheFile = copyString(fileName);
+    else
+        self->modelCacheFile = NULL;
 }
 
 LinkedList /*<char*>*/
@@ -962,7 +1326,7 @@ IedConnection_getLogicalDeviceList(IedConnection self, IedClientError* error)
     *error = IED_ERROR_OK;
 
     if (self->logicalDevices == NULL) {
-        IedConnection_getDeviceModelFromServer(self, error);
+        loadDeviceModel(self, error);
 
         if (*error != IED_ERROR_OK)
             return NULL;
@@ -1045,18 +1409,18 @@ struct sClientProvidedFileReadHandler {
     IedClientGetFileHandler handler;
     void* handlerParameter;
     bool retVal;
-    uint32_t byteReceived;
 };
 
-static void
-mmsFileReadHandler(void* parameter, int32_t frsmId, uint8_t* buffer, uint32_t bytesReceived)
+static bool
+mmsFileDataSink(void* parameter, int32_t frsmId, uint8_t* buffer, uint32_t bytesReceived)
 {
     struct sClientProvidedFileReadHandler* handler = (struct sClientProvidedFileReadHandler*) parameter;
 
+    (void) frsmId;
 
     handler->retVal = handler->handler(handler->handlerParameter, buffer, bytesReceived);
 
-    handler->byteReceived += bytesReceived;
+    return handler->retVal;
 }
 
 uint32_t
@@ -1081,34 +1445,38 @@ IedConnection_getFile(IedConnection self, IedClientError* error, char* fileName,
     clientFileReadHandler.handler = handler;
     clientFileReadHandler.handlerParameter = handlerParameter;
     clientFileReadHandler.retVal = true;
-    clientFileReadHandler.byteReceived = 0;
-
-    bool continueRead = true;
 
-    while (continueRead == true) {
-        bool moreFollows =
-                MmsConnection_fileRead(self->connection, &mmsError, frsmId, mmsFileReadHandler,
-                        &clientFileReadHandler);
+    uint32_t bytesReceived =
+            MmsConnection_fileReadWindowed(self->connection, &mmsError, frsmId, self->fileReadWindowSize,
+                    mmsFileDataSink, &clientFileReadHandler);
 
-        if (mmsError != MMS_ERROR_NONE) {
-            *error = iedConnection_mapMmsErrorToIedError(mmsError);
-            return 0;
-        }
+    if (mmsError != MMS_ERROR_NONE) {
+        *error = iedConnection_mapMmsErrorToIedError(mmsError);
 
-        if (clientFileReadHandler.retVal == true) {
-            *error = IED_ERROR_UNKNOWN;
-            break;
-        }
+        /* release the file at the server - the result is not relevant */
+        MmsConnection_fileClose(self->connection, &mmsError, frsmId);
 
-        if (moreFollows == false)
-            break;
+        return 0;
     }
 
     MmsConnection_fileClose(self->connection, &mmsError, frsmId);
 
     *error = iedConnection_mapMmsErrorToIedError(mmsError);
 
-    return clientFileReadHandler.byteReceived;
+    /* download stopped by the handler */
+    if ((*error == IED_ERROR_OK) && (clientFileReadHandler.retVal == false))
+        *error = IED_ERROR_UNKNOWN;
+
+    return bytesReceived;
+}
+
+void
+IedConnection_setFileReadWindowSize(IedConnection self, int windowSize)
+{
+    if (windowSize < 1)
+        windowSize = 1;
+
+    self->fileReadWindowSize = windowSize;
 }
 
 void
@@ -1138,7 +1506,7 @@ IedConnection_getLogicalDeviceDirectory(IedConnection self, IedClientError* erro
         char* logicalDeviceName)
 {
     if (self->logicalDevices == NULL)
-        IedConnection_getDeviceModelFromServer(self, error);
+        loadDeviceModel(self, error);
 
     if (self->logicalDevices == NULL)
         return NULL;
@@ -1228,7 +1596,7 @@ IedConnection_getLogicalNodeDirectory(IedConnection self, IedClientError* error,
         char* logicalNodeReference, ACSIClass acsiClass)
 {
     if (self->logicalDevices == NULL)
-        IedConnection_getDeviceModelFromServer(self, error);
+        loadDeviceModel(self, error);
 
     char lnRefCopy[193];
 
@@ -1375,7 +1743,7 @@ IedConnection_getLogicalNodeVariables(IedConnection self, IedClientError* error,
         char* logicalNodeReference)
 {
     if (self->logicalDevices == NULL)
-        IedConnection_getDeviceModelFromServer(self, error);
+        loadDeviceModel(self, error);
 
     char lnRefCopy[193];
 
@@ -1446,7 +1814,7 @@ getDataDirectory(IedConnection self, IedClientError* error,
         char* dataReference, bool withFc)
 {
     if (self->logicalDevices == NULL)
-        IedConnection_getDeviceModelFromServer(self, error);
+        loadDeviceModel(self, error);
 
     char dataRefCopy[193];
 
@@ -30,12 +30,28 @@
 
 #include "thread.h"
 
+/* number of hash buckets used to find the report handler of a received RptID */
+#define IED_CONNECTION_REPORT_HASH_TABLE_SIZE 32
+
+typedef struct sICLogicalDevice
+{
+    char* name;
+    LinkedList variables;
+    LinkedList dataSets;
+} ICLogicalDevice;
+
 struct sIedConnection
 {
     MmsConnection connection;
     IedConnectionState state;
     LinkedList enabledReports;
+
+    /* enabled reports (not owned) hashed by RptID (or RCB reference if the RptID is not known) */
+    LinkedList reportTable[IED_CONNECTION_REPORT_HASH_TABLE_SIZE];
+
     LinkedList logicalDevices;
+    char* modelCacheFile;
+    int fileReadWindowSize;
     LinkedList clientControls;
     LastApplError lastApplError;
     Semaphore stateMutex;
@@ -69,6 +85,24 @@ struct sClientReportControlBlock {
 IedClientError
 private_IedConnection_mapMmsErrorToIedError(MmsError mmsError);
 
+ICLogicalDevice*
+ICLogicalDevice_create(char* name);
+
+void
+ICLogicalDevice_setVariableList(ICLogicalDevice* self, LinkedList variables);
+
+void
+ICLogicalDevice_setDataSetList(ICLogicalDevice* self, LinkedList dataSets);
+
+void
+ICLogicalDevice_destroy(ICLogicalDevice* self);
+
+bool
+private_IedConnection_loadModelCache(IedConnection self, MmsServerIdentity* identity, LinkedList domainNames);
+
+void
+private_IedConnection_saveModelCache(IedConnection self, MmsServerIdentity* identity);
+
 void
 private_IedConnection_addControlClient(IedConnection self, ControlObjectClient control);
 
@@ -79,7 +113,7 @@ bool
 private_ClientReportControlBlock_updateValues(ClientReportControlBlock self, MmsValue* values);
 
 void
-private_IedConnection_handleReport(IedConnection self, MmsValue* value);
+private_IedConnection_handleReport(IedConnection self, MmsRawValue* values, int valueCount);
 
 IedClientError
 iedConnection_mapMmsErrorToIedError(MmsError mmsError);
@@ -199,6 +199,18 @@ ClientConnection_getPeerAddress(ClientConnection self);
 void*
 ClientConnection_getSecurityToken(ClientConnection self);
 
+/**
+ * \brief Get the statistics of the outgoing message queue of this connection
+ *
+ * Reports are not written to the socket by the event thread but handed over to a per-connection
+ * send queue. The counters can be used to detect clients that are too slow to receive all reports.
+ *
+ * \param self the ClientConnection instance
+ * \param statistics pointer to a structure where the counters will be stored
+ */
+void
+ClientConnection_getSendQueueStatistics(ClientConnection self, IsoSendQueueStatistics* statistics);
+
 /**
  * \brief User provided callback function that is invoked whenever a new client connects or an existing connection is closed
  *        or detected as lost.
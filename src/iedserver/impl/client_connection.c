@@ -106,3 +106,11 @@ ClientConnection_getSecurityToken(ClientConnection self)
 
     return IsoConnection_getSecurityToken(mmsConnection->isoConnection);
 }
+
+void
+ClientConnection_getSendQueueStatistics(ClientConnection self, IsoSendQueueStatistics* statistics)
+{
+    MmsServerConnection* mmsConnection = (MmsServerConnection*) self->serverConnectionHandle;
+
+    IsoConnection_getSendQueueStatistics(mmsConnection->isoConnection, statistics);
+}
@@ -823,7 +823,8 @@ ControlObject_sendLastApplError(ControlObject* self, MmsServerConnection* connec
 
     MmsValue* ctlObjValue = &ctlObjValueMemory;
     ctlObjValue->type = MMS_VISIBLE_STRING;
-    ctlObjValue->value.visibleString = ctlObj;
+    ctlObjValue->value.visibleString.buf = ctlObj;
+    ctlObjValue->value.visibleString.size = strlen(ctlObj) + 1;
 
     MmsValue_setElement(lastApplError, 0, ctlObjValue);
 
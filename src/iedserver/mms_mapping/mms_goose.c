@@ -235,12 +235,19 @@ MmsGooseControlBlock_enable(MmsGooseControlBlock self)
                 dataSetEntry = dataSetEntry->sibling;
             }
 
+            self->nextPublishTime = 0;
+
             self->goEna = true;
         }
 
     }
 
     Semaphore_post(self->publisherMutex);
+
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+    /* publish the initial message without waiting for the next scheduled retransmission */
+    Semaphore_post(self->mmsMapping->gooseSignal);
+#endif
 }
 
 void
@@ -267,17 +274,36 @@ MmsGooseControlBlock_disable(MmsGooseControlBlock self)
 }
 
 
-void
-MmsGooseControlBlock_checkAndPublish(MmsGooseControlBlock self, uint64_t currentTime)
+static uint64_t
+getNextPublishTime(MmsGooseControlBlock self, uint64_t currentTime, int interval)
 {
-    if (currentTime >= self->nextPublishTime) {
+    /* keep the retransmission schedule independent of the publishing latency */
+    uint64_t nextPublishTime = self->nextPublishTime + interval;
 
-        Semaphore_wait(self->publisherMutex);
+    if (nextPublishTime <= currentTime)
+        nextPublishTime = currentTime + interval;
+
+    return nextPublishTime;
+}
+
+uint64_t
+MmsGooseControlBlock_checkAndPublish(MmsGooseControlBlock self, uint64_t currentTime,
+        GooseTransmitQueue queue)
+{
+    uint64_t nextPublishTime;
+
+    Semaphore_wait(self->publisherMutex);
 
-        GoosePublisher_publish(self->publisher, self->dataSetValues);
+    if ((currentTime >= self->nextPublishTime) && (self->publisher != NULL)) {
+
+        if (queue != NULL)
+            GoosePublisher_enqueue(self->publisher, self->dataSetValues, queue);
+        else
+            GoosePublisher_publish(self->publisher, self->dataSetValues);
 
         if (self->retransmissionsLeft > 0) {
-            self->nextPublishTime = currentTime + CONFIG_GOOSE_EVENT_RETRANSMISSION_INTERVAL;
+            self->nextPublishTime = getNextPublishTime(self, currentTime,
+                    CONFIG_GOOSE_EVENT_RETRANSMISSION_INTERVAL);
 
 
             if (self->retransmissionsLeft > 1)
@@ -293,21 +319,67 @@ MmsGooseControlBlock_checkAndPublish(MmsGooseControlBlock self, uint64_t current
             GoosePublisher_setTimeAllowedToLive(self->publisher,
                                 CONFIG_GOOSE_STABLE_STATE_TRANSMISSION_INTERVAL * 3);
 
-            self->nextPublishTime = currentTime +
-                CONFIG_GOOSE_STABLE_STATE_TRANSMISSION_INTERVAL;
+            self->nextPublishTime = getNextPublishTime(self, currentTime,
+                    CONFIG_GOOSE_STABLE_STATE_TRANSMISSION_INTERVAL);
         }
-
-        Semaphore_post(self->publisherMutex);
     }
+
+    nextPublishTime = self->nextPublishTime;
+
+    Semaphore_post(self->publisherMutex);
+
+    return nextPublishTime;
 }
 
 void
 MmsGooseControlBlock_observedObjectChanged(MmsGooseControlBlock self)
 {
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 0)
+    /* retransmissions with the old stNum that are already queued by the event worker thread
+     * have to be sent before the event message */
+    Semaphore_wait(self->mmsMapping->gooseTransmitQueueLock);
+
+    if (self->mmsMapping->gooseTransmitQueue != NULL)
+        GooseTransmitQueue_flush(self->mmsMapping->gooseTransmitQueue);
+#endif
+
     Semaphore_wait(self->publisherMutex);
 
+    if (self->publisher == NULL) {
+        Semaphore_post(self->publisherMutex);
+
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 0)
+        Semaphore_post(self->mmsMapping->gooseTransmitQueueLock);
+#endif
+        return;
+    }
+
     uint64_t currentTime = GoosePublisher_increaseStNum(self->publisher);
 
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+
+    /* the GOOSE publisher thread sends the event message and the retransmissions */
+    self->nextPublishTime = currentTime;
+
+    if (CONFIG_GOOSE_EVENT_RETRANSMISSION_COUNT > 0) {
+        self->retransmissionsLeft = CONFIG_GOOSE_EVENT_RETRANSMISSION_COUNT + 1;
+
+        GoosePublisher_setTimeAllowedToLive(self->publisher,
+                           CONFIG_GOOSE_EVENT_RETRANSMISSION_INTERVAL * 3);
+    }
+    else {
+        self->retransmissionsLeft = 0;
+
+        GoosePublisher_setTimeAllowedToLive(self->publisher,
+                           CONFIG_GOOSE_STABLE_STATE_TRANSMISSION_INTERVAL * 3);
+    }
+
+    Semaphore_post(self->publisherMutex);
+
+    Semaphore_post(self->mmsMapping->gooseSignal);
+
+#else
+
     self->retransmissionsLeft = CONFIG_GOOSE_EVENT_RETRANSMISSION_COUNT;
 
     if (self->retransmissionsLeft > 0) {
@@ -328,6 +400,10 @@ MmsGooseControlBlock_observedObjectChanged(MmsGooseControlBlock self)
     GoosePublisher_publish(self->publisher, self->dataSetValues);
 
     Semaphore_post(self->publisherMutex);
+
+    Semaphore_post(self->mmsMapping->gooseTransmitQueueLock);
+
+#endif /* (CONFIG_GOOSE_PUBLISHER_THREAD == 1) */
 }
 
 static MmsVariableSpecification*
@@ -56,8 +56,16 @@ MmsGooseControlBlock_getDataSet(MmsGooseControlBlock self);
 bool
 MmsGooseControlBlock_isEnabled(MmsGooseControlBlock self);
 
-void
-MmsGooseControlBlock_checkAndPublish(MmsGooseControlBlock self, uint64_t currentTime);
+/**
+ * \brief publish the GOOSE message if the next (re)transmission is due
+ *
+ * \param queue the message is added to the queue if not NULL. Otherwise it is sent immediately.
+ *
+ * \return the time of the next scheduled (re)transmission
+ */
+uint64_t
+MmsGooseControlBlock_checkAndPublish(MmsGooseControlBlock self, uint64_t currentTime,
+        GooseTransmitQueue queue);
 
 void
 MmsGooseControlBlock_observedObjectChanged(MmsGooseControlBlock self);
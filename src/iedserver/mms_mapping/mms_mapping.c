@@ -66,7 +66,7 @@ MmsMapping_createPhyComAddrStructure(MmsVariableSpecification* namedVariable)
 
     element = (MmsVariableSpecification*) calloc(1, sizeof(MmsVariableSpecification));
     element->name = copyString("Addr");
-    element->type = MMS_VISIBLE_STRING;
+    element->type = MMS_OCTET_STRING;
     element->typeSpec.octetString = 6;
     namedVariable->typeSpec.structure.elements[0] = element;
 
@@ -753,6 +753,12 @@ MmsMapping_create(IedModel* model)
 
 #if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
         self->gseControls = LinkedList_create();
+
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+        self->gooseSignal = Semaphore_create(0);
+#else
+        self->gooseTransmitQueueLock = Semaphore_create(1);
+#endif
 #endif
 
 #if (CONFIG_IEC61850_CONTROL_SERVICE == 1)
@@ -785,6 +791,21 @@ MmsMapping_destroy(MmsMapping* self)
 #endif
 
 #if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+    if (self->gooseThread != NULL) {
+        self->gooseThreadRunning = false;
+        Semaphore_post(self->gooseSignal);
+        Thread_destroy(self->gooseThread);
+    }
+
+    Semaphore_destroy(self->gooseSignal);
+#else
+    Semaphore_destroy(self->gooseTransmitQueueLock);
+#endif
+
+    if (self->gooseTransmitQueue != NULL)
+        GooseTransmitQueue_destroy(self->gooseTransmitQueue);
+
     LinkedList_destroyDeep(self->gseControls, (LinkedListValueDeleteFunction) MmsGooseControlBlock_destroy);
 #endif
 
@@ -1701,27 +1722,118 @@ MmsMapping_createMmsVariableNameFromObjectReference(char* objectReference,
 
 #if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
 
-static void
+/* returns the time of the next scheduled GOOSE (re)transmission */
+static uint64_t
 GOOSE_processGooseEvents(MmsMapping* self, uint64_t currentTimeInMs)
 {
+    uint64_t nextPublishTime = currentTimeInMs + CONFIG_GOOSE_STABLE_STATE_TRANSMISSION_INTERVAL;
+
     LinkedList element = LinkedList_getNext(self->gseControls);
 
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 0)
+    Semaphore_wait(self->gooseTransmitQueueLock);
+#endif
+
     while (element != NULL) {
         MmsGooseControlBlock mmsGCB = (MmsGooseControlBlock) element->data;
 
         if (MmsGooseControlBlock_isEnabled(mmsGCB)) {
-            MmsGooseControlBlock_checkAndPublish(mmsGCB, currentTimeInMs);
+
+            /* the queue (and its socket) is created when the first GoCB is enabled */
+            if ((CONFIG_GOOSE_TRANSMIT_QUEUE_SIZE > 0) && (self->gooseTransmitQueue == NULL) &&
+                    (self->gooseTransmitQueueFailed == false))
+            {
+                self->gooseTransmitQueue = GooseTransmitQueue_create(NULL, CONFIG_GOOSE_TRANSMIT_QUEUE_SIZE);
+
+                if (self->gooseTransmitQueue == NULL) {
+                    if (DEBUG_IDE_SERVER)
+                        printf("IED_SERVER: failed to create GOOSE transmit queue!\n");
+
+                    self->gooseTransmitQueueFailed = true;
+                }
+            }
+
+            uint64_t gcbPublishTime = MmsGooseControlBlock_checkAndPublish(mmsGCB, currentTimeInMs,
+                    self->gooseTransmitQueue);
+
+            if (gcbPublishTime < nextPublishTime)
+                nextPublishTime = gcbPublishTime;
         }
 
         element = LinkedList_getNext(element);
     }
+
+    /* send all messages that are due in this cycle with a single system call */
+    if (self->gooseTransmitQueue != NULL)
+        GooseTransmitQueue_flush(self->gooseTransmitQueue);
+
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 0)
+    Semaphore_post(self->gooseTransmitQueueLock);
+#endif
+
+    return nextPublishTime;
+}
+
+#if (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+
+/* GOOSE publisher thread
+ *
+ * Sleeps until the next scheduled retransmission of any enabled GOOSE control block or
+ * until it is woken up by a data set change (MmsGooseControlBlock_observedObjectChanged).
+ */
+static void
+goosePublisherThread(MmsMapping* self)
+{
+    while (self->gooseThreadRunning) {
+        uint64_t nextPublishTime = GOOSE_processGooseEvents(self, Hal_getTimeInMs());
+
+        Semaphore_waitUntil(self->gooseSignal, nextPublishTime);
+    }
+
+    if (DEBUG_IDE_SERVER)
+        printf("IED_SERVER: GOOSE publisher thread finished!\n");
+}
+
+static void
+startGoosePublisherThread(MmsMapping* self)
+{
+    self->gooseThreadRunning = true;
+
+    self->gooseThread = Thread_create((ThreadExecutionFunction) goosePublisherThread, self, false);
+    Thread_start(self->gooseThread);
+
+    if (CONFIG_GOOSE_PUBLISHER_THREAD_PRIORITY > 0) {
+        if (!Thread_setPriority(self->gooseThread, CONFIG_GOOSE_PUBLISHER_THREAD_PRIORITY))
+            if (DEBUG_IDE_SERVER)
+                printf("IED_SERVER: failed to set priority of GOOSE publisher thread!\n");
+    }
+
+    if (CONFIG_GOOSE_PUBLISHER_THREAD_CPU >= 0) {
+        if (!Thread_setCpuAffinity(self->gooseThread, CONFIG_GOOSE_PUBLISHER_THREAD_CPU))
+            if (DEBUG_IDE_SERVER)
+                printf("IED_SERVER: failed to set CPU affinity of GOOSE publisher thread!\n");
+    }
+}
+
+static void
+stopGoosePublisherThread(MmsMapping* self)
+{
+    if (self->gooseThread != NULL) {
+        self->gooseThreadRunning = false;
+        Semaphore_post(self->gooseSignal);
+
+        Thread_destroy(self->gooseThread);
+        self->gooseThread = NULL;
+    }
 }
 
+#endif /* (CONFIG_GOOSE_PUBLISHER_THREAD == 1) */
+
 #endif /* (CONFIG_INCLUDE_GOOSE_SUPPORT == 1) */
 
-/* single worker thread for all enabled GOOSE and report control blocks
+/* single worker thread for all enabled report control blocks and control objects
  *
- * TODO move GOOSE processing to other (high-priority) thread
+ * GOOSE control blocks are handled by the GOOSE publisher thread if CONFIG_GOOSE_PUBLISHER_THREAD is set
  * */
 static void
 eventWorkerThread(MmsMapping* self)
@@ -1732,7 +1844,7 @@ eventWorkerThread(MmsMapping* self)
     while (running) {
         uint64_t currentTimeInMs = Hal_getTimeInMs();
 
-#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1) && (CONFIG_GOOSE_PUBLISHER_THREAD == 0)
         GOOSE_processGooseEvents(self, currentTimeInMs);
 #endif
 
@@ -1763,11 +1875,19 @@ MmsMapping_startEventWorkerThread(MmsMapping* self)
     Thread thread = Thread_create((ThreadExecutionFunction) eventWorkerThread, self, false);
     self->reportWorkerThread = thread;
     Thread_start(thread);
+
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1) && (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+    startGoosePublisherThread(self);
+#endif
 }
 
 void
 MmsMapping_stopEventWorkerThread(MmsMapping* self)
 {
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1) && (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+    stopGoosePublisherThread(self);
+#endif
+
     if (self->reportThreadRunning) {
 
         self->reportThreadRunning = false;
@@ -24,9 +24,14 @@
 #ifndef MMS_MAPPING_INTERNAL_H_
 #define MMS_MAPPING_INTERNAL_H_
 
+#include "stack_config.h"
 #include "thread.h"
 #include "linked_list.h"
 
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
+#include "goose_publisher.h"
+#endif
+
 struct sMmsMapping {
     IedModel* model;
     MmsDevice* mmsDevice;
@@ -41,6 +46,22 @@ struct sMmsMapping {
     bool reportThreadFinished;
     Thread reportWorkerThread;
 
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1) && (CONFIG_GOOSE_PUBLISHER_THREAD == 1)
+    bool gooseThreadRunning;
+    Thread gooseThread;
+    Semaphore gooseSignal; /* wakes up the GOOSE publisher thread */
+#endif
+
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1)
+    GooseTransmitQueue gooseTransmitQueue; /* messages of all GoCBs that are due at the same time */
+    bool gooseTransmitQueueFailed; /* the queue could not be created - messages are sent separately */
+#endif
+
+#if (CONFIG_INCLUDE_GOOSE_SUPPORT == 1) && (CONFIG_GOOSE_PUBLISHER_THREAD == 0)
+    /* held while retransmissions are queued and by threads publishing events (keeps the stNum order) */
+    Semaphore gooseTransmitQueueLock;
+#endif
+
     IedServer iedServer;
 
     IedConnectionIndicationHandler connectionIndicationHandler;
@@ -39,6 +39,16 @@
 #define DEBUG_IED_SERVER 0
 #endif
 
+#ifndef CONFIG_REPORTING_URCB_DROP_OLDEST_ON_OVERFLOW
+#define CONFIG_REPORTING_URCB_DROP_OLDEST_ON_OVERFLOW 1
+#endif
+
+#if (CONFIG_REPORTING_URCB_DROP_OLDEST_ON_OVERFLOW == 1)
+#define URCB_SEND_QUEUE_POLICY ISO_SEND_QUEUE_DROP_OLDEST
+#else
+#define URCB_SEND_QUEUE_POLICY ISO_SEND_QUEUE_BLOCK
+#endif
+
 #if (CONFIG_IEC61850_REPORT_SERVICE == 1)
 
 static ReportBuffer*
@@ -51,6 +61,7 @@ ReportBuffer_create(void)
     self->memoryBlockSize = CONFIG_REPORTING_DEFAULT_REPORT_BUFFER_SIZE;
     self->memoryBlock = (uint8_t*) malloc(self->memoryBlockSize);
     self->reportsCount = 0;
+    self->isOverflow = false;
 
     return self;
 }
@@ -346,7 +357,9 @@ sendReport(ReportControl* self, bool isIntegrity, bool isGI)
     for (i = 0; i < self->dataSet->elementCount; i++)
         self->inclusionFlags[i] = REPORT_CONTROL_NONE;
 
-    MmsServerConnection_sendInformationReportVMDSpecific(self->clientConnection, "RPT", reportElements, false);
+    /* a slow client must not stall the event thread - the report is lost if the send queue is full */
+    MmsServerConnection_enqueueInformationReportVMDSpecific(self->clientConnection, "RPT", reportElements,
+            URCB_SEND_QUEUE_POLICY);
 
     /* Increase sequence number */
     self->sqNum++;
@@ -525,6 +538,7 @@ purgeBuf(ReportControl* rc)
     reportBuffer->oldestReport = NULL;
     reportBuffer->nextToTransmit = NULL;
     reportBuffer->reportsCount = 0;
+    reportBuffer->isOverflow = false;
 }
 
 static void
@@ -1422,6 +1436,9 @@ enqueueReport(ReportControl* reportControl, bool isIntegrity, bool isGI)
                 printf("\n");
 #endif
 
+                if (buffer->nextToTransmit != NULL)
+                    buffer->isOverflow = true;
+
                 buffer->reportsCount = 0;
                 buffer->oldestReport = (ReportBufferEntry*) entryBufPos;
                 buffer->oldestReport->next = NULL;
@@ -1445,8 +1462,10 @@ enqueueReport(ReportControl* reportControl, bool isIntegrity, bool isGI)
                 while ((entryBufPos + bufferEntrySize) > (uint8_t*) buffer->oldestReport) {
                     assert(buffer->oldestReport != NULL);
 
-                    if (buffer->nextToTransmit == buffer->oldestReport)
+                    if (buffer->nextToTransmit == buffer->oldestReport) {
                         buffer->nextToTransmit = buffer->oldestReport->next;
+                        buffer->isOverflow = true;
+                    }
 
 #if (DEBUG_IED_SERVER == 1)
                     printf("IED_SERVER: REMOVE report with ID ");
@@ -1478,8 +1497,10 @@ enqueueReport(ReportControl* reportControl, bool isIntegrity, bool isGI)
                 while ((uint8_t*) buffer->oldestReport > buffer->memoryBlock) {
                     assert(buffer->oldestReport != NULL);
 
-                    if (buffer->nextToTransmit == buffer->oldestReport)
+                    if (buffer->nextToTransmit == buffer->oldestReport) {
                         buffer->nextToTransmit = buffer->oldestReport->next;
+                        buffer->isOverflow = true;
+                    }
 
 #if (DEBUG_IED_SERVER == 1)
                     printf("IED_SERVER: REMOVE report with ID ");
@@ -1498,8 +1519,10 @@ enqueueReport(ReportControl* reportControl, bool isIntegrity, bool isGI)
 
                     assert(buffer->oldestReport != NULL);
 
-                    if (buffer->nextToTransmit == buffer->oldestReport)
+                    if (buffer->nextToTransmit == buffer->oldestReport) {
                         buffer->nextToTransmit = buffer->oldestReport->next;
+                        buffer->isOverflow = true;
+                    }
 
 #if (DEBUG_IED_SERVER == 1)
                     printf("IED_SERVER: REMOVE report with ID ");
@@ -1519,8 +1542,10 @@ enqueueReport(ReportControl* reportControl, bool isIntegrity, bool isGI)
 
                     assert(buffer->oldestReport != NULL);
 
-                    if (buffer->nextToTransmit == buffer->oldestReport)
+                    if (buffer->nextToTransmit == buffer->oldestReport) {
                         buffer->nextToTransmit = buffer->oldestReport->next;
+                        buffer->isOverflow = true;
+                    }
 
 #if (DEBUG_IED_SERVER == 1)
                     printf("IED_SERVER: REMOVE report with ID ");
@@ -1648,6 +1673,10 @@ sendNextReportEntry(ReportControl* self)
     if (self->reportBuffer->nextToTransmit == NULL)
         return;
 
+    /* keep the entry in the report buffer until the client connection can take it */
+    if (MmsServerConnection_isSendQueueFull(self->clientConnection))
+        return;
+
     char* localStorage = (char*) malloc(LOCAL_STORAGE_MEMORY_SIZE); /* reserve 4k for dynamic memory allocation -
                                      this can be optimized - maybe there is a good guess for the
                                      required memory size */
@@ -1740,7 +1769,7 @@ sendNextReportEntry(ReportControl* self)
 
         bufOvfl->deleteValue = 0;
         bufOvfl->type = MMS_BOOLEAN;
-        bufOvfl->value.boolean = false;
+        bufOvfl->value.boolean = self->reportBuffer->isOverflow;
 
         if (MemAllocLinkedList_add(reportElements, bufOvfl) == NULL)
             goto return_out_of_memory;
@@ -1868,7 +1897,16 @@ sendNextReportEntry(ReportControl* self)
         }
     }
 
-    MmsServerConnection_sendInformationReportVMDSpecific(self->clientConnection, "RPT", (LinkedList) reportElements, false);
+    if (!MmsServerConnection_enqueueInformationReportVMDSpecific(self->clientConnection, "RPT",
+            (LinkedList) reportElements, ISO_SEND_QUEUE_REJECT))
+    {
+        if (DEBUG_IED_SERVER)
+            printf("IED_SERVER: sendNextReportEntry: send queue is full - retry later\n");
+
+        goto cleanup_and_return;
+    }
+
+    self->reportBuffer->isOverflow = false;
 
     /* Increase sequence number */
     self->sqNum++;
@@ -40,6 +40,7 @@ typedef struct {
     ReportBufferEntry* oldestReport;
     ReportBufferEntry* lastEnqueuedReport;
     ReportBufferEntry* nextToTransmit;
+    bool isOverflow;      /* true if a report was removed before it has been sent (BufOvfl) */
 } ReportBuffer;
 
 typedef struct {
@@ -49,6 +49,18 @@
 
 #define ISO_CLIENT_BUFFER_SIZE CONFIG_MMS_MAXIMUM_PDU_SIZE + 100
 
+#ifndef CONFIG_ISO_CLIENT_RECEIVE_BUFFERS
+#define CONFIG_ISO_CLIENT_RECEIVE_BUFFERS 4
+#endif
+
+typedef struct sIsoReceiveBuffer* IsoReceiveBuffer;
+
+struct sIsoReceiveBuffer {
+    uint8_t* memory; /* the complete message (allocated when the buffer is used for the first time) */
+    ByteBuffer payload; /* the part of the message that is passed to the API client */
+    bool inUse;
+};
+
 struct sIsoClientConnection
 {
     IsoIndicationCallback callback;
@@ -61,56 +73,127 @@ struct sIsoClientConnection
     AcseConnection acseConnection;
 
     uint8_t* sendBuffer; /* send buffer */
-    uint8_t* cotpBuf; /* receive buffer */
-    ByteBuffer* cotpBuffer;
+    ByteBuffer* cotpBuffer; /* wraps the memory of the current receive buffer */
 
     ByteBuffer* transmitPayloadBuffer;
     Semaphore transmitBufferMutex;
 
-    ByteBuffer* receivePayloadBuffer;
-    Semaphore receiveBufferMutex;
+    /*
+     * A received message is passed to the API client together with its receive buffer. The next
+     * messages are received into other buffers of the pool while the API client holds the buffer.
+     */
+    struct sIsoReceiveBuffer receiveBuffers[CONFIG_ISO_CLIENT_RECEIVE_BUFFERS];
+    Semaphore freeReceiveBuffers; /* counts the buffers that are not in use */
+    Semaphore receiveBufferLock; /* protects the inUse flags */
+    IsoReceiveBuffer currentReceiveBuffer; /* buffer that is filled by the COTP layer */
 
     Thread thread;
+    bool useReceiveThread;
 };
 
-static void*
-connectionHandlingThread(void* threadParameter)
+/* blocks until the API client has released a buffer when all buffers are in use */
+static IsoReceiveBuffer
+acquireReceiveBuffer(IsoClientConnection self)
 {
-    IsoClientConnection self = (IsoClientConnection) threadParameter;
+    Semaphore_wait(self->freeReceiveBuffers);
+
+    Semaphore_wait(self->receiveBufferLock);
+
+    IsoReceiveBuffer buffer = NULL;
+
+    int i;
+
+    /* prefer the buffers with the lower index - the other buffers are only allocated when required */
+    for (i = 0; i < CONFIG_ISO_CLIENT_RECEIVE_BUFFERS; i++) {
+        if (self->receiveBuffers[i].inUse == false) {
+            buffer = &(self->receiveBuffers[i]);
+            buffer->inUse = true;
+            break;
+        }
+    }
+
+    Semaphore_post(self->receiveBufferLock);
+
+    if (buffer->memory == NULL)
+        buffer->memory = (uint8_t*) malloc(ISO_CLIENT_BUFFER_SIZE);
+
+    return buffer;
+}
+
+/* provide a buffer for the next message to the COTP layer */
+static void
+attachReceiveBuffer(IsoClientConnection self)
+{
+    if (self->currentReceiveBuffer == NULL) {
+        self->currentReceiveBuffer = acquireReceiveBuffer(self);
+
+        ByteBuffer_wrap(self->cotpBuffer, self->currentReceiveBuffer->memory, 0, ISO_CLIENT_BUFFER_SIZE);
+    }
+}
+
+/* transfer the ownership of the current receive buffer to the API client */
+static ByteBuffer*
+detachReceiveBuffer(IsoClientConnection self, uint8_t* payload, int payloadSize)
+{
+    IsoReceiveBuffer buffer = self->currentReceiveBuffer;
 
+    self->currentReceiveBuffer = NULL;
+
+    ByteBuffer_wrap(&(buffer->payload), payload, payloadSize, payloadSize);
+
+    return &(buffer->payload);
+}
+
+/* pass a received message to the upper layers - returns false for an invalid message */
+static bool
+handleMessage(IsoClientConnection self)
+{
     IsoSessionIndication sessionIndication;
 
+    sessionIndication =
+            IsoSession_parseMessage(self->session,
+                    CotpConnection_getPayload(self->cotpConnection));
+
     if (DEBUG_ISO_CLIENT)
-        printf("ISO_CLIENT_CONNECTION: new connection\n");
+        printf("ISO_CLIENT_CONNECTION: parse message\n");
+
+    if (sessionIndication != SESSION_DATA) {
+        if (DEBUG_ISO_CLIENT)
+            printf("ISO_CLIENT_CONNECTION: Invalid session message\n");
+        return false;
+    }
 
-    Semaphore_wait(self->receiveBufferMutex);
+    if (!IsoPresentation_parseUserData(self->presentation, IsoSession_getUserData(self->session))) {
+        if (DEBUG_ISO_CLIENT)
+            printf("ISO_CLIENT_CONNECTION: Invalid presentation message\n");
+        return false;
+    }
 
-    while (CotpConnection_parseIncomingMessage(self->cotpConnection) == DATA_INDICATION) {
+    ByteBuffer* payload = detachReceiveBuffer(self, self->presentation->nextPayload.buffer,
+            self->presentation->nextPayload.size);
 
-        sessionIndication =
-                IsoSession_parseMessage(self->session,
-                        CotpConnection_getPayload(self->cotpConnection));
+    self->callback(ISO_IND_DATA, self->callbackParameter, payload);
 
-        if (DEBUG_ISO_CLIENT)
-            printf("ISO_CLIENT_CONNECTION: parse message\n");
+    return true;
+}
 
-        if (sessionIndication != SESSION_DATA) {
-            if (DEBUG_ISO_CLIENT)
-                printf("ISO_CLIENT_CONNECTION: Invalid session message\n");
-            break;
-        }
+static void*
+connectionHandlingThread(void* threadParameter)
+{
+    IsoClientConnection self = (IsoClientConnection) threadParameter;
 
-        if (!IsoPresentation_parseUserData(self->presentation, IsoSession_getUserData(self->session))) {
-            if (DEBUG_ISO_CLIENT)
-                printf("ISO_CLIENT_CONNECTION: Invalid presentation message\n");
-            break;
-        }
+    if (DEBUG_ISO_CLIENT)
+        printf("ISO_CLIENT_CONNECTION: new connection\n");
+
+    while (true) {
+        /* waits when the API client holds all buffers */
+        attachReceiveBuffer(self);
 
-        self->callback(ISO_IND_DATA, self->callbackParameter,
-                &(self->presentation->nextPayload));
+        if (CotpConnection_parseIncomingMessage(self->cotpConnection) != DATA_INDICATION)
+            break;
 
-        /* wait for user to release the buffer */
-        Semaphore_wait(self->receiveBufferMutex);
+        if (handleMessage(self) == false)
+            break;
     }
 
     self->callback(ISO_IND_CLOSED, self->callbackParameter, NULL);
@@ -129,6 +212,7 @@ IsoClientConnection_create(IsoIndicationCallback callback, void* callbackParamet
     self->callback = callback;
     self->callbackParameter = callbackParameter;
     self->state = STATE_IDLE;
+    self->useReceiveThread = true;
 
     self->sendBuffer = (uint8_t*) malloc(ISO_CLIENT_BUFFER_SIZE);
 
@@ -136,11 +220,10 @@ IsoClientConnection_create(IsoIndicationCallback callback, void* callbackParamet
     self->transmitPayloadBuffer->buffer = self->sendBuffer;
     self->transmitPayloadBuffer->maxSize = ISO_CLIENT_BUFFER_SIZE;
 
-    self->receivePayloadBuffer = (ByteBuffer*) calloc(1, sizeof(ByteBuffer));
-
     self->transmitBufferMutex = Semaphore_create(1);
 
-    self->receiveBufferMutex = Semaphore_create(1);
+    self->freeReceiveBuffers = Semaphore_create(CONFIG_ISO_CLIENT_RECEIVE_BUFFERS);
+    self->receiveBufferLock = Semaphore_create(1);
 
     return self;
 }
@@ -180,6 +263,9 @@ IsoClientConnection_sendMessage(IsoClientConnection self, ByteBuffer* payloadBuf
 void
 IsoClientConnection_close(IsoClientConnection self)
 {
+    /* without receive thread the closed connection has to be reported here */
+    bool reportClosed = ((self->useReceiveThread == false) && (self->state == STATE_ASSOCIATED));
+
     if (DEBUG_ISO_CLIENT)
         printf("ISO_CLIENT: IsoClientConnection_close\n");
 
@@ -191,6 +277,9 @@ IsoClientConnection_close(IsoClientConnection self)
     }
 
     self->state = STATE_IDLE;
+
+    if (reportClosed)
+        self->callback(ISO_IND_CLOSED, self->callbackParameter, NULL);
 }
 
 void
@@ -210,8 +299,13 @@ IsoClientConnection_destroy(IsoClientConnection self)
     if (self->thread != NULL)
         Thread_destroy(self->thread);
 
-    if (self->cotpBuf != NULL)
-        free(self->cotpBuf);
+    int i;
+
+    for (i = 0; i < CONFIG_ISO_CLIENT_RECEIVE_BUFFERS; i++) {
+        if (self->receiveBuffers[i].memory != NULL)
+            free(self->receiveBuffers[i].memory);
+    }
+
     if (self->cotpBuffer != NULL)
         free(self->cotpBuffer);
     if (self->cotpConnection != NULL) {
@@ -224,9 +318,9 @@ IsoClientConnection_destroy(IsoClientConnection self)
         free(self->presentation);
 
     free(self->transmitPayloadBuffer);
-    free(self->receivePayloadBuffer);
 
-    Semaphore_destroy(self->receiveBufferMutex);
+    Semaphore_destroy(self->freeReceiveBuffers);
+    Semaphore_destroy(self->receiveBufferLock);
     Semaphore_destroy(self->transmitBufferMutex);
 
     free(self->sendBuffer);
@@ -307,6 +401,9 @@ void
 IsoClientConnection_associate(IsoClientConnection self, IsoConnectionParameters params,
         ByteBuffer* payload)
 {
+    /* the transmit buffer that contains the payload is released when the request is sent */
+    bool transmitBufferReleased = false;
+
     Socket socket = TcpSocket_create();
 
     self->socket = socket;
@@ -314,9 +411,9 @@ IsoClientConnection_associate(IsoClientConnection self, IsoConnectionParameters
     if (!Socket_connect(socket, params->hostname, params->tcpPort))
         goto returnError;
 
-    self->cotpBuf = (uint8_t*) malloc(ISO_CLIENT_BUFFER_SIZE);
     self->cotpBuffer = (ByteBuffer*) calloc(1, sizeof(ByteBuffer));
-    ByteBuffer_wrap(self->cotpBuffer, self->cotpBuf, 0, ISO_CLIENT_BUFFER_SIZE);
+
+    attachReceiveBuffer(self);
 
     self->cotpConnection = (CotpConnection*) calloc(1, sizeof(CotpConnection));
     CotpConnection_init(self->cotpConnection, socket, self->cotpBuffer);
@@ -378,6 +475,7 @@ IsoClientConnection_associate(IsoClientConnection self, IsoConnectionParameters
     CotpConnection_sendDataMessage(self->cotpConnection, sessionBuffer);
 
     Semaphore_post(self->transmitBufferMutex);
+    transmitBufferReleased = true;
 
     cotpIndication = CotpConnection_parseIncomingMessage(self->cotpConnection);
 
@@ -414,21 +512,24 @@ IsoClientConnection_associate(IsoClientConnection self, IsoConnectionParameters
     }
 	*/
 
-    ByteBuffer_wrap(self->receivePayloadBuffer, self->acseConnection.userDataBuffer,
-            self->acseConnection.userDataBufferSize, self->acseConnection.userDataBufferSize);
-
-    Semaphore_wait(self->receiveBufferMutex);
+    ByteBuffer* receivePayload = detachReceiveBuffer(self, self->acseConnection.userDataBuffer,
+            self->acseConnection.userDataBufferSize);
 
-    self->callback(ISO_IND_ASSOCIATION_SUCCESS, self->callbackParameter, self->receivePayloadBuffer);
+    self->callback(ISO_IND_ASSOCIATION_SUCCESS, self->callbackParameter, receivePayload);
 
     self->state = STATE_ASSOCIATED;
 
-    self->thread = Thread_create(connectionHandlingThread, self, false);
-    Thread_start(self->thread);
+    if (self->useReceiveThread) {
+        self->thread = Thread_create(connectionHandlingThread, self, false);
+        Thread_start(self->thread);
+    }
 
     return;
 
     returnError:
+    if (transmitBufferReleased == false)
+        Semaphore_post(self->transmitBufferMutex);
+
     self->callback(ISO_IND_ASSOCIATION_FAILED, self->callbackParameter, NULL);
 
     self->state = STATE_ERROR;
@@ -449,7 +550,78 @@ IsoClientConnection_allocateTransmitBuffer(IsoClientConnection self)
 }
 
 void
-IsoClientConnection_releaseReceiveBuffer(IsoClientConnection self)
+IsoClientConnection_releaseTransmitBuffer(IsoClientConnection self)
+{
+    Semaphore_post(self->transmitBufferMutex);
+}
+
+void
+IsoClientConnection_releaseReceiveBuffer(IsoClientConnection self, ByteBuffer* payload)
 {
-    Semaphore_post(self->receiveBufferMutex);
+    bool released = false;
+
+    Semaphore_wait(self->receiveBufferLock);
+
+    int i;
+
+    for (i = 0; i < CONFIG_ISO_CLIENT_RECEIVE_BUFFERS; i++) {
+        IsoReceiveBuffer buffer = &(self->receiveBuffers[i]);
+
+        if ((payload == &(buffer->payload)) && buffer->inUse) {
+            buffer->inUse = false;
+            released = true;
+            break;
+        }
+    }
+
+    Semaphore_post(self->receiveBufferLock);
+
+    if (released)
+        Semaphore_post(self->freeReceiveBuffers);
+    else if (DEBUG_ISO_CLIENT)
+        printf("ISO_CLIENT: release of unknown receive buffer\n");
+}
+
+void
+IsoClientConnection_disableReceiveThread(IsoClientConnection self)
+{
+    self->useReceiveThread = false;
+}
+
+Socket
+IsoClientConnection_getSocket(IsoClientConnection self)
+{
+    return self->socket;
+}
+
+bool
+IsoClientConnection_handleIncomingData(IsoClientConnection self)
+{
+    if (self->state != STATE_ASSOCIATED)
+        return false;
+
+    if (CotpConnection_readToBuffer(self->cotpConnection) <= 0)
+        goto connectionClosed;
+
+    while (true) {
+        /* waits when the API client holds all buffers - an incomplete message stays in its buffer */
+        attachReceiveBuffer(self);
+
+        CotpIndication indication = CotpConnection_parseBufferedMessage(self->cotpConnection);
+
+        if (indication == OK)
+            return true;
+
+        if ((indication != DATA_INDICATION) || (handleMessage(self) == false))
+            goto connectionClosed;
+    }
+
+connectionClosed:
+    if (DEBUG_ISO_CLIENT)
+        printf("ISO_CLIENT_CONNECTION: connection closed\n");
+
+    /* closes the socket and calls the callback with ISO_IND_CLOSED */
+    IsoClientConnection_close(self);
+
+    return false;
 }
@@ -30,6 +30,7 @@
 
 #include "byte_buffer.h"
 #include "iso_connection_parameters.h"
+#include "socket.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -81,12 +82,43 @@ ByteBuffer*
 IsoClientConnection_allocateTransmitBuffer(IsoClientConnection self);
 
 /*
- * The client should release the receive buffer in order for the IsoClientConnection to
- * reuse the buffer! If this function is not called then the reception of messages is
- * blocked!
+ * Release the payload buffer without sending a message (e.g. when the request cannot be sent)
  */
 void
-IsoClientConnection_releaseReceiveBuffer(IsoClientConnection self);
+IsoClientConnection_releaseTransmitBuffer(IsoClientConnection self);
+
+/*
+ * The payload that is passed to the callback with ISO_IND_ASSOCIATION_SUCCESS or ISO_IND_DATA
+ * is owned by the API client until it is returned with this function. It can be released by
+ * any thread (e.g. after a response has been processed by the thread waiting for it). The next
+ * messages are received into other buffers in the meantime (up to CONFIG_ISO_CLIENT_RECEIVE_BUFFERS).
+ * The reception of messages is blocked when the API client holds all buffers!
+ */
+void
+IsoClientConnection_releaseReceiveBuffer(IsoClientConnection self, ByteBuffer* payload);
+
+/*
+ * Don't start a receive thread when the association has been established. Has to be called before
+ * IsoClientConnection_associate. Incoming messages are then processed by
+ * IsoClientConnection_handleIncomingData (e.g. called by an event loop that supervises the socket).
+ * IsoClientConnection_close reports the closed connection to the callback in this mode.
+ */
+void
+IsoClientConnection_disableReceiveThread(IsoClientConnection self);
+
+Socket
+IsoClientConnection_getSocket(IsoClientConnection self);
+
+/*
+ * Read the available data from the socket and pass the received messages to the callback function.
+ * Must only be called when the socket is readable. Blocks while the API client holds all receive
+ * buffers.
+ *
+ * Returns false when the connection has been closed (the socket has been closed and the callback
+ * has been called with ISO_IND_CLOSED).
+ */
+bool
+IsoClientConnection_handleIncomingData(IsoClientConnection self);
 
 void*
 IsoClientConnection_getSecurityToken(IsoClientConnection self);
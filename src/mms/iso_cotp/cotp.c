@@ -409,6 +409,10 @@ CotpConnection_init(CotpConnection* self, Socket socket,
     CotpConnection_setTpduSize(self, COTP_MAX_TPDU_SIZE);
 
     self->writeBuffer = NULL;
+
+    self->readBuffer = NULL;
+    self->readBufferSize = 0;
+    self->readBufferLength = 0;
 }
 
 void
@@ -416,6 +420,9 @@ CotpConnection_destroy(CotpConnection* self)
 {
     if (self->writeBuffer != NULL)
         ByteBuffer_destroy(self->writeBuffer);
+
+    if (self->readBuffer != NULL)
+        free(self->readBuffer);
 }
 
 int /* in byte */
@@ -649,3 +656,86 @@ CotpConnection_parseIncomingMessage(CotpConnection* self)
 
     return parseIncomingMessage(self);
 }
+
+int
+CotpConnection_readToBuffer(CotpConnection* self)
+{
+    if (self->readBuffer == NULL) {
+        self->readBufferSize = CotpConnection_getTpduSize(self) + 4;
+        self->readBuffer = (uint8_t*) malloc(self->readBufferSize);
+        self->readBufferLength = 0;
+    }
+
+    int readBytes = Socket_read(self->socket, self->readBuffer + self->readBufferLength,
+            self->readBufferSize - self->readBufferLength);
+
+    if (readBytes > 0)
+        self->readBufferLength += readBytes;
+
+    return readBytes;
+}
+
+CotpIndication
+CotpConnection_parseBufferedMessage(CotpConnection* self)
+{
+    CotpIndication indication = OK;
+    int bufPos = 0;
+
+    while ((self->readBufferLength - bufPos) >= 4) {
+        uint8_t* tpkt = self->readBuffer + bufPos;
+
+        if ((tpkt[0] != 3) || (tpkt[1] != 0))
+            return ERROR;
+
+        int rfc1006Length = (tpkt[2] * 0x100) + tpkt[3];
+
+        if (rfc1006Length < 7)
+            return ERROR;
+
+        if (rfc1006Length > self->readBufferSize) {
+            /* TPKT is larger than the negotiated TPDU size -> grow the buffer */
+            self->readBufferSize = rfc1006Length;
+            self->readBuffer = (uint8_t*) realloc(self->readBuffer, self->readBufferSize);
+            break;
+        }
+
+        if ((self->readBufferLength - bufPos) < rfc1006Length)
+            break;
+
+        /* only data TPDUs are expected after the connection has been established */
+        if ((tpkt[4] != 2) || (tpkt[5] != 0xf0)) {
+            if (DEBUG_COTP)
+                printf("COTP: unexpected TPDU type %02x\n", tpkt[5]);
+            return ERROR;
+        }
+
+        /* the previous TPDU was the last unit of a message -> start a new message */
+        if (self->isLastDataUnit)
+            self->payload->size = 0;
+
+        self->isLastDataUnit = ((tpkt[6] & 0x80) != 0);
+
+        int payloadLength = rfc1006Length - 7;
+
+        if ((self->payload->size + payloadLength) > self->payload->maxSize)
+            return ERROR;
+
+        memcpy(self->payload->buffer + self->payload->size, tpkt + 7, payloadLength);
+        self->payload->size += payloadLength;
+
+        bufPos += rfc1006Length;
+
+        if (self->isLastDataUnit) {
+            indication = DATA_INDICATION;
+            break;
+        }
+    }
+
+    /* remove the parsed TPKTs from the buffer */
+    if (bufPos > 0) {
+        self->readBufferLength -= bufPos;
+        memmove(self->readBuffer, self->readBuffer + bufPos, self->readBufferLength);
+    }
+
+    return indication;
+}
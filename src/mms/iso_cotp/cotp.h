@@ -47,6 +47,9 @@ typedef struct {
     bool isLastDataUnit;
     ByteBuffer* payload;
     ByteBuffer* writeBuffer;
+    uint8_t* readBuffer; /* received TPKTs that have not been parsed yet (CotpConnection_readToBuffer) */
+    int readBufferSize;
+    int readBufferLength;
 } CotpConnection;
 
 typedef enum {
@@ -68,6 +71,27 @@ CotpConnection_destroy(CotpConnection* self);
 CotpIndication
 CotpConnection_parseIncomingMessage(CotpConnection* self);
 
+/**
+ * Read the data that is available on the socket into the read buffer of the connection.
+ *
+ * Only one read call is performed. When the function is called after the socket has been reported
+ * readable (e.g. by select or epoll) it doesn't block and a return value of 0 means that the
+ * connection has been closed by the peer.
+ *
+ * \return the number of bytes read or -1 in case of an error
+ */
+int
+CotpConnection_readToBuffer(CotpConnection* self);
+
+/**
+ * Parse the data TPDUs in the read buffer and reassemble the next message in the payload buffer.
+ *
+ * \return DATA_INDICATION when a complete message is in the payload buffer (call again to parse the
+ *         next buffered message), OK when more data is required, ERROR for an invalid or unexpected TPDU
+ */
+CotpIndication
+CotpConnection_parseBufferedMessage(CotpConnection* self);
+
 CotpIndication
 CotpConnection_sendConnectionRequestMessage(CotpConnection* self, IsoConnectionParameters isoParameters);
 
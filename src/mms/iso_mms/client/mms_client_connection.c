@@ -36,201 +36,66 @@
 #include <assert.h>
 
 #define CONFIG_MMS_CONNECTION_DEFAULT_TIMEOUT 2000
-#define OUTSTANDING_CALLS 10
+
+#ifndef CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS
+#define CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS 32
+#endif
 
 static void
 handleUnconfirmedMmsPdu(MmsConnection self, ByteBuffer* message)
 {
-    if (self->reportHandler != NULL) {
-        MmsPdu_t* mmsPdu = 0; /* allow asn1c to allocate structure */
-
-        if (DEBUG_MMS_CLIENT)
-            printf("MMS_CLIENT: report handler revd size:%i\n", ByteBuffer_getSize(message));
-
-        asn_dec_rval_t  rval = ber_decode(NULL, &asn_DEF_MmsPdu,
-                (void**) &mmsPdu, ByteBuffer_getBuffer(message), ByteBuffer_getSize(message));
-
-        if (rval.code == RC_OK) {
-            if (DEBUG_MMS_CLIENT)
-                printf("MMS_CLIENT: received report (size:%i)\n", (int) rval.consumed);
-
-            if (mmsPdu->present == MmsPdu_PR_unconfirmedPDU) {
-
-                if (mmsPdu->choice.unconfirmedPDU.unconfirmedService.present ==
-                        UnconfirmedService_PR_informationReport)
-                        {
-                    char* domainId = NULL;
-
-                    InformationReport_t* report =
-                            &(mmsPdu->choice.unconfirmedPDU.unconfirmedService.choice.informationReport);
-
-                    if (report->variableAccessSpecification.present ==
-                            VariableAccessSpecification_PR_variableListName)
-                            {
-                        if (report->variableAccessSpecification.choice.variableListName.present
-                                == ObjectName_PR_vmdspecific)
-                                {
-                            int nameSize =
-                                    report->variableAccessSpecification.choice.variableListName.choice.vmdspecific.size;
-                            uint8_t* buffer =
-                                    report->variableAccessSpecification.choice.variableListName.choice.vmdspecific.buf;
-
-                            char* variableListName = createStringFromBuffer(buffer, nameSize);
-
-                            int listSize = report->listOfAccessResult.list.count;
-
-                            MmsValue* values = mmsClient_parseListOfAccessResults(
-                                    report->listOfAccessResult.list.array, listSize, true);
-
-                            //self->reportHandler(self->reportHandlerParameter, domainId, variableListName, values, true);
-                            self->reportHandler(self->reportHandlerParameter, domainId, variableListName, values, NULL, 0);
-
-                            free(variableListName);
-                        }
-                        else {
-                            // Ignore domain and association specific information reports (not used by IEC 61850)
-                        }
+    char* domainName;
+    char* variableListName;
+    LinkedList attributes;
 
-                    }
-                    else if (report->variableAccessSpecification.present ==
-                            VariableAccessSpecification_PR_listOfVariable)
-                            {
-								int attributesCount = report->variableAccessSpecification.choice.listOfVariable.list.count;
-								int i;
-								LinkedList attributes = LinkedList_create();
-								for (i = 0; i < attributesCount; i++) {
-
-									VariableSpecification_t varSpec =report->variableAccessSpecification.choice.listOfVariable.list.array[i]->variableSpecification;
-
-									char *itemName = createStringFromBuffer(varSpec.choice.name.choice.domainspecific.itemId.buf, varSpec.choice.name.choice.domainspecific.itemId.size);
-
-									LinkedList_add(attributes, itemName);
-								}
-
-								if (self->reportHandler != NULL) {
+    if (DEBUG_MMS_CLIENT)
+        printf("MMS_CLIENT: report handler revd size:%i\n", ByteBuffer_getSize(message));
 
-									int listSize = report->listOfAccessResult.list.count;
+    if (self->rawReportHandler != NULL) {
+        int valueCount;
 
-									MmsValue* values = mmsClient_parseListOfAccessResults(
-											report->listOfAccessResult.list.array, listSize, true);
+        if (mmsClient_parseRawInformationReport(message, &domainName, &variableListName, &attributes,
+                &(self->rawReportValues), &(self->rawReportValuesSize), &valueCount)) {
 
-									//FIXME
-									//self->reportHandler(self->reportHandlerParameter, domainId, variableListName, values, attributes, attributesCount);
-									self->reportHandler(self->reportHandlerParameter, domainId, NULL, values, attributes, attributesCount);
-								}
-								LinkedList_destroy(attributes);
+            self->rawReportHandler(self->rawReportHandlerParameter, domainName, variableListName, attributes,
+                    self->rawReportValues, valueCount);
+        }
+        else {
+            if (DEBUG_MMS_CLIENT)
+                printf("handleUnconfirmedMmsPdu: unrecognized or malformed information report\n");
 
-/*
-						//TODO add code to handle reports with more than one variable
-
-                        int listSize = report->listOfAccessResult.list.count;
-                        int variableSpecSize = report->variableAccessSpecification.choice.listOfVariable.list.count;
-
-                        if (listSize != variableSpecSize) {
-                            if (DEBUG_MMS_CLIENT)
-                                printf("report contains wrong number of access results\n");
-                            return;
-                        }
-
-                        MmsValue* values = mmsClient_parseListOfAccessResults(
-                                report->listOfAccessResult.list.array, listSize, false);
-
-                        int i;
-                        for (i = 0; i < variableSpecSize; i++) {
-                            if (report->variableAccessSpecification.choice.listOfVariable.list.array[i]->variableSpecification.present
-                                    ==
-                                    VariableSpecification_PR_name)
-                                    {
-                                if (report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                        ->variableSpecification.choice.name.present == ObjectName_PR_vmdspecific) {
-
-                                    int nameSize =
-                                            report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                                    ->variableSpecification.choice.name.choice.vmdspecific.size;
-
-                                    uint8_t* buffer =
-                                            report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                                    ->variableSpecification.choice.name.choice.vmdspecific.buf;
-
-                                    if (nameSize < 129) {
-                                        char variableListName[129];
-                                        memcpy(variableListName, buffer, nameSize);
-                                        variableListName[nameSize] = 0;
-
-                                        self->reportHandler(self->reportHandlerParameter, domainId, variableListName,
-                                                values, false);
-
-                                        // report handler should have deleted the MmsValue!
-                                        values = NULL;
-                                    }
-                                    else
-                                        MmsValue_delete(values);
-                                }
-                                else if (report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                        ->variableSpecification.choice.name.present == ObjectName_PR_domainspecific) {
-
-                                    int domainNameSize =
-                                        report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                            ->variableSpecification.choice.name.choice.domainspecific.domainId.size;
-
-                                    int itemNameSize =
-                                         report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                             ->variableSpecification.choice.name.choice.domainspecific.itemId.size;
-
-                                    if (domainNameSize < 65 && itemNameSize < 65) {
-                                        char domainNameStr[65];
-                                        char itemNameStr[65];
-
-                                        uint8_t* domainNameBuffer =
-                                            report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                                   ->variableSpecification.choice.name.choice.domainspecific.domainId.buf;
-
-                                        uint8_t* itemNamebuffer =
-                                                report->variableAccessSpecification.choice.listOfVariable.list.array[i]
-                                                       ->variableSpecification.choice.name.choice.domainspecific.itemId.buf;
-
-                                        memcpy(domainNameStr, domainNameBuffer, domainNameSize);
-                                        domainNameStr[domainNameSize] = 0;
-                                        memcpy(itemNameStr, itemNamebuffer, itemNameSize);
-                                        itemNameStr[itemNameSize] = 0;
-
-                                        self->reportHandler(self->reportHandlerParameter, domainNameStr, itemNameStr,
-                                                values, false);
-
-                                        // report handler should have deleted the MmsValue!
-                                        values = NULL;
-                                    }
-                                    else
-                                        MmsValue_delete(values);
-                                }
-
-                            }
-
-                        }
-
-                        //TODO handle CommandTermination request!
-
-                        if (values != NULL)
-  							MmsValue_delete(values);
-  */
-		  			}
-                    else {
-                        // Ignore
-                        if (DEBUG_MMS_CLIENT)
-                            printf("unrecognized information report\n");
-                    }
+            return;
+        }
+    }
+    else if (self->reportHandler != NULL) {
+        MmsValue* values;
 
-                }
+        if (mmsClient_parseInformationReport(message, &domainName, &variableListName, &attributes, &values)) {
 
-            }
+            if (attributes != NULL)
+                self->reportHandler(self->reportHandlerParameter, domainName, NULL, values, attributes,
+                        LinkedList_size(attributes));
+            else
+                self->reportHandler(self->reportHandlerParameter, NULL, variableListName, values, NULL, 0);
         }
         else {
             if (DEBUG_MMS_CLIENT)
-                printf("handleUnconfirmedMmsPdu: error parsing PDU at %u\n", (uint32_t) rval.consumed);
-        }
+                printf("handleUnconfirmedMmsPdu: unrecognized or malformed information report\n");
 
-        asn_DEF_MmsPdu.free_struct(&asn_DEF_MmsPdu, mmsPdu, 0);
+            return;
+        }
     }
+    else
+        return;
+
+    if (domainName != NULL)
+        free(domainName);
+
+    if (variableListName != NULL)
+        free(variableListName);
+
+    if (attributes != NULL)
+        LinkedList_destroy(attributes);
 }
 
 static uint32_t
@@ -246,15 +111,37 @@ getNextInvokeId(MmsConnection self)
     return nextInvokeId;
 }
 
+/* all messages are sent with this function - MmsConnection_connect replaces the IsoClientConnection */
+static ByteBuffer*
+allocateTransmitBuffer(MmsConnection self)
+{
+    Semaphore_wait(self->isoClientLock);
+
+    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+
+    Semaphore_post(self->isoClientLock);
+
+    return payload;
+}
+
+/* returns a copy of the outstanding call - asynchronous calls are removed from the table */
 static bool
-checkForOutstandingCall(MmsConnection self, uint32_t invokeId)
+checkForOutstandingCall(MmsConnection self, uint32_t invokeId, MmsOutstandingCall call)
 {
     int i = 0;
 
     Semaphore_wait(self->outstandingCallsLock);
 
-    for (i = 0; i < OUTSTANDING_CALLS; i++) {
-        if (self->outstandingCalls[i] == invokeId) {
+    for (i = 0; i < CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS; i++) {
+        if ((self->outstandingCalls[i].isUsed) && (self->outstandingCalls[i].invokeId == invokeId)) {
+
+            *call = self->outstandingCalls[i];
+
+            if (call->type != MMS_CALL_TYPE_NONE) {
+                self->outstandingCalls[i].isUsed = false;
+                self->outstandingAsyncCalls--;
+            }
+
             Semaphore_post(self->outstandingCallsLock);
             return true;
         }
@@ -265,41 +152,339 @@ checkForOutstandingCall(MmsConnection self, uint32_t invokeId)
     return false;
 }
 
+/* has to be called with the outstandingCallsLock */
 static bool
-addToOutstandingCalls(MmsConnection self, uint32_t invokeId)
+addCallToTable(MmsConnection self, MmsOutstandingCall call)
 {
     int i = 0;
 
-    Semaphore_wait(self->outstandingCallsLock);
+    for (i = 0; i < CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS; i++) {
+        if (self->outstandingCalls[i].isUsed == false) {
+            self->outstandingCalls[i] = *call;
+            self->outstandingCalls[i].isUsed = true;
+
+            if (call->type != MMS_CALL_TYPE_NONE)
+                self->outstandingAsyncCalls++;
 
-    for (i = 0; i < OUTSTANDING_CALLS; i++) {
-        if (self->outstandingCalls[i] == 0) {
-            self->outstandingCalls[i] = invokeId;
-            Semaphore_post(self->outstandingCallsLock);
             return true;
         }
     }
 
-    Semaphore_post(self->outstandingCallsLock);
-
     return false;
 }
 
 static void
+initOutstandingCall(MmsConnection self, MmsOutstandingCall call, uint32_t invokeId, MmsOutstandingCallType type,
+        void* userCallback, void* userParameter, int32_t frsmId)
+{
+    call->isUsed = false;
+    call->invokeId = invokeId;
+    call->type = type;
+    call->userCallback = userCallback;
+    call->userParameter = userParameter;
+    call->frsmId = frsmId;
+    call->timeout = Hal_getTimeInMs() + self->requestTimeout;
+}
+
+static bool
+addToOutstandingCalls(MmsConnection self, uint32_t invokeId, MmsOutstandingCallType type, void* userCallback,
+        void* userParameter, int32_t frsmId)
+{
+    struct sMmsOutstandingCall call;
+    bool added;
+
+    initOutstandingCall(self, &call, invokeId, type, userCallback, userParameter, frsmId);
+
+    Semaphore_wait(self->outstandingCallsLock);
+    added = addCallToTable(self, &call);
+    Semaphore_post(self->outstandingCallsLock);
+
+    return added;
+}
+
+/* returns false if the call has already been removed (e.g. completed by the receive thread) */
+static bool
 removeFromOutstandingCalls(MmsConnection self, uint32_t invokeId)
 {
+    bool removed = false;
     int i = 0;
 
     Semaphore_wait(self->outstandingCallsLock);
 
-    for (i = 0; i < OUTSTANDING_CALLS; i++) {
-        if (self->outstandingCalls[i] == invokeId) {
-            self->outstandingCalls[i] = 0;
+    for (i = 0; i < CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS; i++) {
+        if ((self->outstandingCalls[i].isUsed) && (self->outstandingCalls[i].invokeId == invokeId)) {
+            self->outstandingCalls[i].isUsed = false;
+
+            if (self->outstandingCalls[i].type != MMS_CALL_TYPE_NONE)
+                self->outstandingAsyncCalls--;
+
+            removed = true;
+            break;
+        }
+    }
+
+    Semaphore_post(self->outstandingCallsLock);
+
+    return removed;
+}
+
+/* collect information of a FileRead response for the asynchronous handler */
+typedef struct {
+    uint8_t* buffer;
+    uint32_t bytesReceived;
+} FileReadData;
+
+static void
+fileReadDataHandler(void* parameter, int32_t frsmId, uint8_t* buffer, uint32_t bytesReceived)
+{
+    FileReadData* fileReadData = (FileReadData*) parameter;
+
+    (void) frsmId;
+
+    fileReadData->buffer = buffer;
+    fileReadData->bytesReceived = bytesReceived;
+}
+
+/* pass the result of an asynchronous request to the user callback. The response is NULL in case of an error */
+static void
+completeAsyncCall(MmsConnection self, MmsOutstandingCall call, MmsError mmsError, ByteBuffer* response,
+        int32_t bufPos)
+{
+    (void) self;
+
+    switch (call->type) {
+
+    case MMS_CALL_TYPE_READ_VARIABLE:
+    case MMS_CALL_TYPE_READ_MULTIPLE_VARIABLES:
+        {
+            MmsValue* value = NULL;
+
+            if (response != NULL) {
+                value = mmsClient_parseReadResponse(response, NULL,
+                        (call->type == MMS_CALL_TYPE_READ_MULTIPLE_VARIABLES));
+
+                if (value == NULL)
+                    mmsError = MMS_ERROR_PARSING_RESPONSE;
+            }
+
+            ((MmsReadResponseHandler) call->userCallback)(call->invokeId, call->userParameter, mmsError, value);
+        }
+        break;
+
+    case MMS_CALL_TYPE_WRITE_VARIABLE:
+        if (response != NULL)
+            mmsClient_parseWriteResponse(response, bufPos, &mmsError);
+
+        ((MmsWriteResponseHandler) call->userCallback)(call->invokeId, call->userParameter, mmsError);
+        break;
+
+    case MMS_CALL_TYPE_GET_NAME_LIST:
+        {
+            LinkedList nameList = NULL;
+            bool moreFollows = false;
+
+            if (response != NULL) {
+                moreFollows = mmsClient_parseGetNameListResponse(&nameList, response, NULL);
+
+                if (nameList == NULL)
+                    mmsError = MMS_ERROR_PARSING_RESPONSE;
+            }
+
+            ((MmsGetNameListResponseHandler) call->userCallback)(call->invokeId, call->userParameter, mmsError,
+                    nameList, moreFollows);
+        }
+        break;
+
+    case MMS_CALL_TYPE_FILE_READ:
+        {
+            FileReadData fileReadData = {NULL, 0};
+            bool moreFollows = false;
+
+            if (response != NULL) {
+                if (mmsClient_parseFileReadResponse(response, bufPos, call->frsmId, &moreFollows,
+                        fileReadDataHandler, &fileReadData) == false)
+                {
+                    mmsError = MMS_ERROR_PARSING_RESPONSE;
+                    moreFollows = false;
+                }
+            }
+
+            ((MmsFileReadResponseHandler) call->userCallback)(call->invokeId, call->userParameter, mmsError,
+                    call->frsmId, fileReadData.buffer, fileReadData.bytesReceived, moreFollows);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* number of asynchronous requests that can be sent before a response is received */
+static int
+getRequestWindow(MmsConnection self)
+{
+    int window = self->parameters.maxServOutstandingCalling;
+
+    if ((window < 1) || (window > CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS))
+        window = CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS;
+
+    return window;
+}
+
+/* has to be called with the outstandingCallsLock */
+static void
+addToRequestQueue(MmsConnection self, MmsOutstandingCall call, ByteBuffer* message)
+{
+    MmsQueuedRequest request = (MmsQueuedRequest) malloc(sizeof(struct sMmsQueuedRequest) + message->size);
+
+    request->call = *call;
+    request->next = NULL;
+    request->messageSize = message->size;
+    request->message = (uint8_t*) (request + 1);
+
+    memcpy(request->message, message->buffer, message->size);
+
+    if (self->requestQueueTail == NULL)
+        self->requestQueueHead = request;
+    else
+        self->requestQueueTail->next = request;
+
+    self->requestQueueTail = request;
+}
+
+/* has to be called with the outstandingCallsLock */
+static MmsQueuedRequest
+removeFirstQueuedRequest(MmsConnection self)
+{
+    MmsQueuedRequest request = self->requestQueueHead;
+
+    if (request != NULL) {
+        self->requestQueueHead = request->next;
+
+        if (self->requestQueueHead == NULL)
+            self->requestQueueTail = NULL;
+    }
+
+    return request;
+}
+
+/* send queued requests while there are free slots in the request window. The timeout of a
+ * queued request starts when it is sent */
+static void
+sendQueuedRequests(MmsConnection self)
+{
+    while (true) {
+        MmsQueuedRequest request = NULL;
+
+        Semaphore_wait(self->outstandingCallsLock);
+
+        if ((self->requestQueueHead != NULL) && (self->associationState == MMS_STATE_CONNECTED) &&
+                (self->outstandingAsyncCalls < getRequestWindow(self)))
+        {
+            self->requestQueueHead->call.timeout = Hal_getTimeInMs() + self->requestTimeout;
+
+            if (addCallToTable(self, &(self->requestQueueHead->call)))
+                request = removeFirstQueuedRequest(self);
+        }
+
+        Semaphore_post(self->outstandingCallsLock);
+
+        if (request == NULL)
             break;
+
+        ByteBuffer* payload = allocateTransmitBuffer(self);
+
+        memcpy(payload->buffer, request->message, request->messageSize);
+        payload->size = request->messageSize;
+
+        IsoClientConnection_sendMessage(self->isoClient, payload);
+
+        if (self->timeoutScheduler != NULL)
+            self->timeoutScheduler(self->timeoutSchedulerParameter, request->call.timeout);
+
+        free(request);
+    }
+}
+
+/* complete all outstanding asynchronous requests or only the sent requests whose timeout has elapsed.
+ * Queued requests are only completed when all requests are completed (connection lost or destroyed) */
+static void
+completeAsyncCalls(MmsConnection self, MmsError mmsError, bool timedOutOnly)
+{
+    uint64_t currentTime = Hal_getTimeInMs();
+
+    int i;
+
+    for (i = 0; i < CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS; i++) {
+        struct sMmsOutstandingCall call;
+        bool complete = false;
+
+        Semaphore_wait(self->outstandingCallsLock);
+
+        call = self->outstandingCalls[i];
+
+        if (call.isUsed && (call.type != MMS_CALL_TYPE_NONE)) {
+            if ((timedOutOnly == false) || (currentTime >= call.timeout)) {
+                self->outstandingCalls[i].isUsed = false;
+                self->outstandingAsyncCalls--;
+                complete = true;
+            }
+        }
+
+        Semaphore_post(self->outstandingCallsLock);
+
+        if (complete) {
+            if (DEBUG_MMS_CLIENT)
+                printf("MMS_CLIENT: complete request %u with error %i\n", call.invokeId, mmsError);
+
+            completeAsyncCall(self, &call, mmsError, NULL, 0);
+        }
+    }
+
+    /* queued requests have not been sent yet - their timeout starts when they are sent */
+    while (timedOutOnly == false) {
+        MmsQueuedRequest request = NULL;
+
+        Semaphore_wait(self->outstandingCallsLock);
+        request = removeFirstQueuedRequest(self);
+        Semaphore_post(self->outstandingCallsLock);
+
+        if (request == NULL)
+            break;
+
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: complete queued request %u with error %i\n", request->call.invokeId, mmsError);
+
+        completeAsyncCall(self, &(request->call), mmsError, NULL, 0);
+
+        free(request);
+    }
+
+    if (timedOutOnly)
+        sendQueuedRequests(self);
+}
+
+uint64_t
+mmsClient_getNextRequestTimeout(MmsConnection self)
+{
+    uint64_t nextTimeout = 0;
+
+    int i;
+
+    Semaphore_wait(self->outstandingCallsLock);
+
+    for (i = 0; i < CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS; i++) {
+        MmsOutstandingCall call = &(self->outstandingCalls[i]);
+
+        if (call->isUsed && (call->type != MMS_CALL_TYPE_NONE)) {
+            if ((nextTimeout == 0) || (call->timeout < nextTimeout))
+                nextTimeout = call->timeout;
         }
     }
 
     Semaphore_post(self->outstandingCallsLock);
+
+    return nextTimeout;
 }
 
 static ByteBuffer*
@@ -307,47 +492,48 @@ sendRequestAndWaitForResponse(MmsConnection self, uint32_t invokeId, ByteBuffer*
 {
     ByteBuffer* receivedMessage = NULL;
 
-    uint64_t startTime = Hal_getTimeInMs();
-
-    uint64_t waitUntilTime = startTime + self->requestTimeout;
-
-    uint64_t currentTime = startTime;
+    uint64_t waitUntilTime = Hal_getTimeInMs() + self->requestTimeout;
 
     bool success = false;
+    bool connectionLost = false;
 
-    addToOutstandingCalls(self, invokeId);
+    if (addToOutstandingCalls(self, invokeId, MMS_CALL_TYPE_NONE, NULL, NULL, 0) == false) {
+        /* release the transmit buffer without sending the request */
+        IsoClientConnection_releaseTransmitBuffer(self->isoClient);
+        self->lastResponseError = MMS_ERROR_OUTSTANDING_CALL_LIMIT;
+        return NULL;
+    }
 
     IsoClientConnection_sendMessage(self->isoClient, message);
 
-    while (currentTime < waitUntilTime) {
-        uint32_t receivedInvokeId;
-
-        if (self->associationState == MMS_STATE_CLOSED)
-            goto connection_lost;
+    /* the receive thread signals the condition when the response is stored */
+    Condition_lock(self->lastResponseCondition);
 
-        Semaphore_wait(self->lastResponseLock);
-        receivedInvokeId = self->responseInvokeId;
-        Semaphore_post(self->lastResponseLock);
+    while (self->responseInvokeId != invokeId) {
 
-        if (receivedInvokeId == invokeId) {
-            receivedMessage = self->lastResponse;
-            success = true;
+        if (self->associationState == MMS_STATE_CLOSED) {
+            connectionLost = true;
             break;
         }
 
-        Thread_sleep(10);
+        if (Condition_waitUntil(self->lastResponseCondition, waitUntilTime) == false)
+            if (self->responseInvokeId != invokeId)
+                break;
+    }
 
-        currentTime = Hal_getTimeInMs();
+    if (self->responseInvokeId == invokeId) {
+        receivedMessage = self->lastResponse;
+        success = true;
     }
 
-    if (!success) {
+    Condition_unlock(self->lastResponseCondition);
+
+    if ((success == false) && (connectionLost == false)) {
         if (DEBUG_MMS_CLIENT)
             printf("TIMEOUT for request %u: \n", invokeId);
         self->lastResponseError = MMS_ERROR_SERVICE_TIMEOUT;
     }
 
-    connection_lost:
-
     removeFromOutstandingCalls(self, invokeId);
 
     return receivedMessage;
@@ -356,35 +542,38 @@ sendRequestAndWaitForResponse(MmsConnection self, uint32_t invokeId, ByteBuffer*
 static void
 releaseResponse(MmsConnection self)
 {
-    Semaphore_wait(self->lastResponseLock);
+    Condition_lock(self->lastResponseCondition);
+    ByteBuffer* response = self->lastResponse;
+    self->lastResponse = NULL;
     self->responseInvokeId = 0;
     self->lastResponseError = MMS_ERROR_NONE;
-    Semaphore_post(self->lastResponseLock);
+    Condition_broadcast(self->lastResponseCondition);
+    Condition_unlock(self->lastResponseCondition);
 
-    IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+    /* the receive buffer of the response is owned by the connection until the response has been processed */
+    if (response != NULL)
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, response);
 }
 
-static uint32_t
-getResponseInvokeId(MmsConnection self)
+static void
+waitUntilLastResponseHasBeenProcessed(MmsConnection self)
 {
-    uint32_t currentInvokeId;
+    Condition_lock(self->lastResponseCondition);
 
-    Semaphore_wait(self->lastResponseLock);
-    currentInvokeId = self->responseInvokeId;
-    Semaphore_post(self->lastResponseLock);
+    while (self->responseInvokeId != 0)
+        Condition_wait(self->lastResponseCondition);
 
-    return currentInvokeId;
+    Condition_unlock(self->lastResponseCondition);
 }
 
+/* change a state variable and wake up the threads waiting for a response */
 static void
-waitUntilLastResponseHasBeenProcessed(MmsConnection self)
+setStateAndSignal(MmsConnection self, int* state, int value)
 {
-    uint32_t currentInvokeId = getResponseInvokeId(self);
-
-    while (currentInvokeId != 0) {
-        Thread_sleep(1);
-        currentInvokeId = getResponseInvokeId(self);
-    }
+    Condition_lock(self->lastResponseCondition);
+    *state = value;
+    Condition_broadcast(self->lastResponseCondition);
+    Condition_unlock(self->lastResponseCondition);
 }
 
 typedef struct sMmsServiceError
@@ -591,6 +780,122 @@ parseConfirmedErrorPDU(ByteBuffer* message, uint32_t* invokeId, MmsServiceError*
     return -1;
 }
 
+static MmsError
+convertRejectReasonToMmsError(uint8_t reasonTag, uint32_t reasonCode)
+{
+    if (reasonTag == 0x81) { /* confirmed-requestPDU */
+        switch (reasonCode) {
+        case 1:
+            return MMS_ERROR_REJECT_UNRECOGNIZED_SERVICE;
+        case 2:
+            return MMS_ERROR_REJECT_UNRECOGNIZED_MODIFIER;
+        case 4:
+            return MMS_ERROR_REJECT_REQUEST_INVALID_ARGUMENT;
+        default:
+            return MMS_ERROR_REJECT_OTHER;
+        }
+    }
+    else if (reasonTag == 0x85) { /* pdu-error */
+        switch (reasonCode) {
+        case 0:
+            return MMS_ERROR_REJECT_UNKNOWN_PDU_TYPE;
+        case 1:
+            return MMS_ERROR_REJECT_INVALID_PDU;
+        default:
+            return MMS_ERROR_REJECT_OTHER;
+        }
+    }
+
+    return MMS_ERROR_REJECT_OTHER;
+}
+
+/* returns -1 if the message cannot be parsed. hasInvokeId is false if the reject has no originalInvokeID */
+static int
+parseRejectPDU(ByteBuffer* message, uint32_t* invokeId, bool* hasInvokeId, MmsError* rejectError)
+{
+    uint8_t* buffer = message->buffer;
+    int maxBufPos = message->size;
+    int bufPos = 0;
+    int length;
+
+    *hasInvokeId = false;
+    *rejectError = MMS_ERROR_REJECT_OTHER;
+
+    uint8_t tag = buffer[bufPos++];
+    if (tag != 0xa4)
+        goto exit_error;
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, maxBufPos);
+    if (bufPos < 0)
+        goto exit_error;
+
+    int endPos = bufPos + length;
+
+    if (endPos > maxBufPos) {
+        if (DEBUG_MMS_CLIENT)
+            printf("parseRejectPDU: message to short!\n");
+        goto exit_error;
+    }
+
+    while (bufPos < endPos) {
+        tag = buffer[bufPos++];
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        if (bufPos < 0)
+            goto exit_error;
+
+        if (tag == 0x80) { /* originalInvokeID */
+            *invokeId = BerDecoder_decodeUint32(buffer, length, bufPos);
+            *hasInvokeId = true;
+        }
+        else if ((tag >= 0x81) && (tag <= 0x8a)) /* rejectReason */
+            *rejectError = convertRejectReasonToMmsError(tag, BerDecoder_decodeUint32(buffer, length, bufPos));
+
+        bufPos += length;
+    }
+
+    return bufPos;
+
+    exit_error:
+    return -1;
+}
+
+/* pass the error of a confirmed error or reject PDU to the request with the invoke ID */
+static void
+completeCallWithError(MmsConnection self, uint32_t invokeId, MmsError mmsError, ByteBuffer* payload)
+{
+    struct sMmsOutstandingCall call;
+
+    if (checkForOutstandingCall(self, invokeId, &call)) {
+
+        if (call.type != MMS_CALL_TYPE_NONE) {
+            completeAsyncCall(self, &call, mmsError, NULL, 0);
+
+            IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
+
+            completeAsyncCalls(self, MMS_ERROR_SERVICE_TIMEOUT, true);
+
+            return;
+        }
+
+        waitUntilLastResponseHasBeenProcessed(self);
+
+        Condition_lock(self->lastResponseCondition);
+        self->lastResponseError = mmsError;
+        self->responseInvokeId = invokeId;
+        Condition_broadcast(self->lastResponseCondition);
+        Condition_unlock(self->lastResponseCondition);
+
+        /* the error has been parsed - the message is not required by the waiting thread */
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
+    }
+    else {
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: unexpected message from server!\n");
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
+    }
+}
+
 static void
 mmsIsoCallback(IsoIndication indication, void* parameter, ByteBuffer* payload)
 {
@@ -602,8 +907,13 @@ mmsIsoCallback(IsoIndication indication, void* parameter, ByteBuffer* payload)
     if (indication == ISO_IND_CLOSED) {
         if (DEBUG_MMS_CLIENT)
             printf("MMS_CLIENT: mmsIsoCallback: Connection lost or closed by client!\n");
+        Condition_lock(self->lastResponseCondition);
         self->connectionState = MMS_CON_IDLE;
         self->associationState = MMS_STATE_CLOSED;
+        Condition_broadcast(self->lastResponseCondition);
+        Condition_unlock(self->lastResponseCondition);
+
+        completeAsyncCalls(self, MMS_ERROR_CONNECTION_LOST, false);
 
         /* Call user provided callback function */
         if (self->connectionLostHandler != NULL)
@@ -622,7 +932,7 @@ mmsIsoCallback(IsoIndication indication, void* parameter, ByteBuffer* payload)
 
     if (payload != NULL) {
         if (ByteBuffer_getSize(payload) < 1) {
-            IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+            IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
             return;
         }
     }
@@ -647,34 +957,34 @@ mmsIsoCallback(IsoIndication indication, void* parameter, ByteBuffer* payload)
     }
     else if (tag == 0xa3) { /* unconfirmed PDU */
         handleUnconfirmedMmsPdu(self, payload);
-        IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
     }
     else if (tag == 0x8b) { /* conclude request PDU */
         if (DEBUG_MMS_CLIENT)
             printf("MMS_CLIENT: received conclude.request\n");
 
-        self->concludeState = CONCLUDE_STATE_REQUESTED;
+        setStateAndSignal(self, &(self->concludeState), CONCLUDE_STATE_REQUESTED);
 
         /* block all new user requests */
-        IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
     }
     else if (tag == 0x8c) { /* conclude response PDU */
         if (DEBUG_MMS_CLIENT)
             printf("MMS_CLIENT: received conclude.reponse+\n");
 
-        self->concludeState = CONCLUDE_STATE_ACCEPTED;
+        setStateAndSignal(self, &(self->concludeState), CONCLUDE_STATE_ACCEPTED);
 
         IsoClientConnection_release(self->isoClient);
 
-        IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
     }
     else if (tag == 0x8d) { /* conclude error PDU */
         if (DEBUG_MMS_CLIENT)
             printf("MMS_CLIENT: received conclude.reponse-\n");
 
-        self->concludeState = CONCLUDE_STATE_REJECTED;
+        setStateAndSignal(self, &(self->concludeState), CONCLUDE_STATE_REJECTED);
 
-        IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
     }
     else if (tag == 0xa2) { /* confirmed error PDU */
         if (DEBUG_MMS_CLIENT)
@@ -685,24 +995,30 @@ mmsIsoCallback(IsoIndication indication, void* parameter, ByteBuffer* payload)
         if (parseConfirmedErrorPDU(payload, &invokeId, &serviceError) < 0) {
             if (DEBUG_MMS_CLIENT)
                 printf("MMS_CLIENT: Error parsing confirmedErrorPDU!\n");
+            goto exit_with_error;
         }
         else {
-            if (checkForOutstandingCall(self, invokeId)) {
+            completeCallWithError(self, invokeId, convertServiceErrorToMmsError(serviceError), payload);
+            return;
+        }
+    }
+    else if (tag == 0xa4) { /* reject PDU */
+        uint32_t invokeId = 0;
+        bool hasInvokeId;
+        MmsError rejectError;
 
-                waitUntilLastResponseHasBeenProcessed(self);
+        if (parseRejectPDU(payload, &invokeId, &hasInvokeId, &rejectError) < 0)
+            goto exit_with_error;
 
-                Semaphore_wait(self->lastResponseLock);
-                self->lastResponseError = convertServiceErrorToMmsError(serviceError);
-                self->responseInvokeId = invokeId;
-                Semaphore_post(self->lastResponseLock);
-            }
-            else {
-                if (DEBUG_MMS_CLIENT)
-                    printf("MMS_CLIENT: unexpected message from server!\n");
-                IsoClientConnection_releaseReceiveBuffer(self->isoClient);
-                return;
-            }
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: reject PDU (invokeId: %u error: %i)\n", invokeId, rejectError);
+
+        if (hasInvokeId) {
+            completeCallWithError(self, invokeId, rejectError, payload);
+            return;
         }
+
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
     }
     else if (tag == 0xa1) { /* confirmed response PDU */
 
@@ -729,26 +1045,45 @@ mmsIsoCallback(IsoIndication indication, void* parameter, ByteBuffer* payload)
 
             bufPos += invokeIdLength;
 
-            if (checkForOutstandingCall(self, invokeId)) {
+            struct sMmsOutstandingCall call;
+
+            if (checkForOutstandingCall(self, invokeId, &call)) {
+
+                if (call.type != MMS_CALL_TYPE_NONE) {
+                    /* the response is parsed and passed to the user callback by the receive thread */
+                    completeAsyncCall(self, &call, MMS_ERROR_NONE, payload, bufPos);
+
+                    IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
+
+                    completeAsyncCalls(self, MMS_ERROR_SERVICE_TIMEOUT, true);
+
+                    return;
+                }
 
                 waitUntilLastResponseHasBeenProcessed(self);
 
-                Semaphore_wait(self->lastResponseLock);
+                Condition_lock(self->lastResponseCondition);
                 self->lastResponse = payload;
                 self->lastResponseBufPos = bufPos;
                 self->responseInvokeId = invokeId;
-                Semaphore_post(self->lastResponseLock);
+                Condition_broadcast(self->lastResponseCondition);
+                Condition_unlock(self->lastResponseCondition);
             }
             else {
                 if (DEBUG_MMS_CLIENT)
                     printf("MMS_CLIENT: unexpected message from server!\n");
-                IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+                IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
                 return;
             }
         }
         else
             goto exit_with_error;
     }
+    else {
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: unsupported MMS-PDU: %02x\n", tag);
+        IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
+    }
 
     if (DEBUG_MMS_CLIENT)
         printf("MMS_CLIENT: LEAVE mmsIsoCallback - OK\n");
@@ -759,7 +1094,7 @@ mmsIsoCallback(IsoIndication indication, void* parameter, ByteBuffer* payload)
 
     if (DEBUG_MMS_CLIENT)
         printf("received malformed message from server!\n");
-    IsoClientConnection_releaseReceiveBuffer(self->isoClient);
+    IsoClientConnection_releaseReceiveBuffer(self->isoClient, payload);
 
 
     if (DEBUG_MMS_CLIENT)
@@ -782,12 +1117,20 @@ MmsConnection_create()
     self->requestTimeout = CONFIG_MMS_CONNECTION_DEFAULT_TIMEOUT;
 
     self->lastInvokeIdLock = Semaphore_create(1);
-    self->lastResponseLock = Semaphore_create(1);
+    self->lastResponseCondition = Condition_create();
     self->outstandingCallsLock = Semaphore_create(1);
 
+    self->isoClientLock = Semaphore_create(1);
+
+    self->typeSpecCacheLock = Semaphore_create(1);
+    self->typeSpecCache = StringMap_create();
+
     self->lastResponseError = MMS_ERROR_NONE;
 
-    self->outstandingCalls = (uint32_t*) calloc(OUTSTANDING_CALLS, sizeof(uint32_t));
+    self->outstandingCalls = (MmsOutstandingCall) calloc(CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS,
+            sizeof(struct sMmsOutstandingCall));
+
+    self->useReceiveThread = true;
 
     self->isoParameters = IsoConnectionParameters_create();
 
@@ -810,11 +1153,21 @@ MmsConnection_destroy(MmsConnection self)
         IsoConnectionParameters_destroy(self->isoParameters);
 
     Semaphore_destroy(self->lastInvokeIdLock);
-    Semaphore_destroy(self->lastResponseLock);
+    Condition_destroy(self->lastResponseCondition);
     Semaphore_destroy(self->outstandingCallsLock);
+    Semaphore_destroy(self->isoClientLock);
 
     free(self->outstandingCalls);
 
+    Map_deleteDeep(self->typeSpecCache, true, (void (*)(void*)) MmsVariableSpecification_destroy);
+    Semaphore_destroy(self->typeSpecCacheLock);
+
+    if (self->rawReportValues != NULL)
+        free(self->rawReportValues);
+
+    while (self->requestQueueHead != NULL)
+        free(removeFirstQueuedRequest(self));
+
     free(self);
 }
 
@@ -871,14 +1224,40 @@ waitForConnectResponse(MmsConnection self)
 bool
 MmsConnection_connect(MmsConnection self, MmsError* mmsError, char* serverName, int serverPort)
 {
-    self->isoClient = IsoClientConnection_create((IsoIndicationCallback) mmsIsoCallback, (void*) self);
+    /* the server can be another one */
+    MmsConnection_clearTypeSpecCache(self);
+
+    IsoClientConnection isoClient = IsoClientConnection_create((IsoIndicationCallback) mmsIsoCallback, (void*) self);
+
+    if (self->useReceiveThread == false)
+        IsoClientConnection_disableReceiveThread(isoClient);
 
     IsoConnectionParameters_setTcpParameters(self->isoParameters, serverName, serverPort);
 
     if (self->parameters.maxPduSize == -1)
         self->parameters.maxPduSize = CONFIG_MMS_MAXIMUM_PDU_SIZE;
 
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    /* other threads can send with the new IsoClientConnection when the association request is sent */
+    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(isoClient);
+
+    /*
+     * Other threads can still use the IsoClientConnection of a previous connection (e.g. when the
+     * connection manager reconnects). It is replaced when the message they are sending is completed.
+     */
+    Semaphore_wait(self->isoClientLock);
+
+    IsoClientConnection previousIsoClient = self->isoClient;
+
+    if (previousIsoClient != NULL)
+        IsoClientConnection_allocateTransmitBuffer(previousIsoClient);
+
+    self->isoClient = isoClient;
+
+    Semaphore_post(self->isoClientLock);
+
+    /* release the resources of a previous connection */
+    if (previousIsoClient != NULL)
+        IsoClientConnection_destroy(previousIsoClient);
 
     mmsClient_createInitiateRequest(self, payload);
 
@@ -928,15 +1307,11 @@ MmsConnection_abort(MmsConnection self, MmsError* mmsError)
 static void
 sendConcludeRequestAndWaitForResponse(MmsConnection self)
 {
-    uint64_t startTime = Hal_getTimeInMs();
-
-    uint64_t waitUntilTime = startTime + self->requestTimeout;
-
-    uint64_t currentTime = startTime;
+    uint64_t waitUntilTime = Hal_getTimeInMs() + self->requestTimeout;
 
     bool success = false;
 
-    ByteBuffer* concludeMessage = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* concludeMessage = allocateTransmitBuffer(self);
 
     mmsClient_createConcludeRequest(self, concludeMessage);
 
@@ -944,27 +1319,27 @@ sendConcludeRequestAndWaitForResponse(MmsConnection self)
 
     IsoClientConnection_sendMessage(self->isoClient, concludeMessage);
 
-    while (currentTime < waitUntilTime) {
+    Condition_lock(self->lastResponseCondition);
 
-        if (self->associationState == MMS_STATE_CLOSED)
-            return;
+    while (self->associationState != MMS_STATE_CLOSED) {
 
         if (self->concludeState != CONCLUDE_STATE_REQUESTED) {
             success = true;
             break;
         }
 
-        Thread_sleep(10);
-
-        currentTime = Hal_getTimeInMs();
+        if (Condition_waitUntil(self->lastResponseCondition, waitUntilTime) == false)
+            if (self->concludeState == CONCLUDE_STATE_REQUESTED)
+                break;
     }
 
-    if (!success) {
+    Condition_unlock(self->lastResponseCondition);
+
+    if ((success == false) && (self->associationState != MMS_STATE_CLOSED)) {
         if (DEBUG_MMS_CLIENT)
             printf("TIMEOUT for conclude request\n");
         self->lastResponseError = MMS_ERROR_SERVICE_TIMEOUT;
     }
-
 }
 
 void
@@ -997,6 +1372,32 @@ MmsConnection_setInformationReportHandler(MmsConnection self, MmsInformationRepo
     self->reportHandlerParameter = parameter;
 }
 
+void
+MmsConnection_setRawInformationReportHandler(MmsConnection self, MmsRawInformationReportHandler handler,
+        void* parameter)
+{
+    self->rawReportHandler = handler;
+    self->rawReportHandlerParameter = parameter;
+}
+
+static void
+createGetNameListRequest(uint32_t invokeId, ByteBuffer* payload, char* domainId, MmsObjectClass objectClass,
+        bool associationSpecific, char* continueAfter)
+{
+    if (associationSpecific)
+        mmsClient_createMmsGetNameListRequestAssociationSpecific(invokeId,
+                payload, continueAfter);
+    else {
+
+        if (objectClass == MMS_DOMAIN_NAMES)
+            mmsClient_createMmsGetNameListRequestVMDspecific(invokeId,
+                    payload, continueAfter);
+        else
+            mmsClient_createGetNameListRequestDomainOrVMDSpecific(invokeId, domainId,
+                    payload, objectClass, continueAfter);
+    }
+}
+
 static bool
 mmsClient_getNameListSingleRequest(
         LinkedList* nameList,
@@ -1011,20 +1412,9 @@ mmsClient_getNameListSingleRequest(
 
     uint32_t invokeId = getNextInvokeId(self);
 
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
-    if (associationSpecific)
-        mmsClient_createMmsGetNameListRequestAssociationSpecific(invokeId,
-                payload, continueAfter);
-    else {
-
-        if (objectClass == MMS_DOMAIN_NAMES)
-            mmsClient_createMmsGetNameListRequestVMDspecific(invokeId,
-                    payload, continueAfter);
-        else
-            mmsClient_createGetNameListRequestDomainOrVMDSpecific(invokeId, domainId,
-                    payload, objectClass, continueAfter);
-    }
+    createGetNameListRequest(invokeId, payload, domainId, objectClass, associationSpecific, continueAfter);
 
     ByteBuffer* responseMessage = sendRequestAndWaitForResponse(self, invokeId, payload);
 
@@ -1103,7 +1493,7 @@ MmsValue*
 MmsConnection_readVariable(MmsConnection self, MmsError* mmsError,
         char* domainId, char* itemId)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
 	if(payload == NULL)
 		return NULL;
@@ -1136,7 +1526,7 @@ MmsConnection_readArrayElements(MmsConnection self, MmsError* mmsError,
         char* domainId, char* itemId,
         uint32_t startIndex, uint32_t numberOfElements)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     MmsValue* value = NULL;
 
@@ -1166,7 +1556,7 @@ MmsValue*
 MmsConnection_readMultipleVariables(MmsConnection self, MmsError* mmsError,
         char* domainId, LinkedList /*<char*>*/items)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     MmsValue* value = NULL;
 
@@ -1196,7 +1586,7 @@ MmsConnection_readNamedVariableListValues(MmsConnection self, MmsError* mmsError
         char* domainId, char* listName,
         bool specWithResult)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     MmsValue* value = NULL;
 
@@ -1230,7 +1620,7 @@ MmsConnection_readNamedVariableListValuesAssociationSpecific(
         char* listName,
         bool specWithResult)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     MmsValue* value = NULL;
 
@@ -1260,7 +1650,7 @@ LinkedList /* <MmsVariableAccessSpecification*> */
 MmsConnection_readNamedVariableListDirectory(MmsConnection self, MmsError* mmsError,
         char* domainId, char* listName, bool* deletable)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1291,7 +1681,7 @@ LinkedList /* <MmsVariableAccessSpecification*> */
 MmsConnection_readNamedVariableListDirectoryAssociationSpecific(MmsConnection self, MmsError* mmsError,
         char* listName, bool* deletable)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1322,7 +1712,7 @@ void
 MmsConnection_defineNamedVariableList(MmsConnection self, MmsError* mmsError,
         char* domainId, char* listName, LinkedList variableSpecs)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1349,7 +1739,7 @@ void
 MmsConnection_defineNamedVariableListAssociationSpecific(MmsConnection self,
         MmsError* mmsError, char* listName, LinkedList variableSpecs)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1376,88 +1766,217 @@ void
 MmsConnection_deleteNamedVariableList(MmsConnection self, MmsError* mmsError,
         char* domainId, char* listName)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
+
+    *mmsError = MMS_ERROR_NONE;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createDeleteNamedVariableListRequest(invokeId, payload, domainId, listName);
+
+    ByteBuffer* responseMessage = sendRequestAndWaitForResponse(self, invokeId, payload);
+
+    if (self->lastResponseError != MMS_ERROR_NONE)
+        *mmsError = self->lastResponseError;
+    else if (responseMessage != NULL)
+        if (!mmsClient_parseDeleteNamedVariableListResponse(self->lastResponse, NULL))
+            *mmsError = MMS_ERROR_ACCESS_OTHER;
+
+    releaseResponse(self);
+
+    if (self->associationState == MMS_STATE_CLOSED)
+        *mmsError = MMS_ERROR_CONNECTION_LOST;
+}
+
+void
+MmsConnection_deleteAssociationSpecificNamedVariableList(MmsConnection self,
+        MmsError* mmsError, char* listName)
+{
+    ByteBuffer* payload = allocateTransmitBuffer(self);
+
+    *mmsError = MMS_ERROR_NONE;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createDeleteAssociationSpecificNamedVariableListRequest(
+            invokeId, payload, listName);
+
+    ByteBuffer* responseMessage = sendRequestAndWaitForResponse(self, invokeId, payload);
+
+    if (self->lastResponseError != MMS_ERROR_NONE)
+        *mmsError = self->lastResponseError;
+    else if (responseMessage != NULL)
+        if (!mmsClient_parseDeleteNamedVariableListResponse(self->lastResponse, NULL))
+            *mmsError = MMS_ERROR_ACCESS_OTHER;
+
+    releaseResponse(self);
+
+    if (self->associationState == MMS_STATE_CLOSED)
+        *mmsError = MMS_ERROR_CONNECTION_LOST;
+}
+
+MmsVariableSpecification*
+MmsConnection_getVariableAccessAttributes(MmsConnection self, MmsError* mmsError,
+        char* domainId, char* itemId)
+{
+    ByteBuffer* payload = allocateTransmitBuffer(self);
+
+    MmsVariableSpecification* typeSpec = NULL;
+
+    *mmsError = MMS_ERROR_NONE;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createGetVariableAccessAttributesRequest(invokeId, domainId, itemId, payload);
+
+    ByteBuffer* responseMessage = sendRequestAndWaitForResponse(self, invokeId, payload);
+
+    if (self->lastResponseError != MMS_ERROR_NONE)
+        *mmsError = self->lastResponseError;
+    else if (responseMessage != NULL)
+        typeSpec = mmsClient_parseGetVariableAccessAttributesResponse(self->lastResponse, NULL);
+
+    releaseResponse(self);
+
+    if (self->associationState == MMS_STATE_CLOSED)
+        *mmsError = MMS_ERROR_CONNECTION_LOST;
+
+    return typeSpec;
+}
+
+static char*
+createTypeSpecCacheKey(char* domainId, char* itemId)
+{
+    /* VMD specific variables have an empty domain part */
+    if (domainId == NULL)
+        domainId = "";
+
+    int domainIdLength = strlen(domainId);
+    int itemIdLength = strlen(itemId);
+
+    char* key = (char*) malloc(domainIdLength + itemIdLength + 2);
+
+    memcpy(key, domainId, domainIdLength);
+    key[domainIdLength] = '/';
+    memcpy(key + domainIdLength + 1, itemId, itemIdLength + 1);
+
+    return key;
+}
+
+/* returns the cached type specification with typeSpecCacheLock held or NULL (lock not held) */
+static MmsVariableSpecification*
+getCachedTypeSpecAndLock(MmsConnection self, MmsError* mmsError, char* domainId, char* itemId)
+{
+    char* key = createTypeSpecCacheKey(domainId, itemId);
 
     *mmsError = MMS_ERROR_NONE;
 
-    uint32_t invokeId = getNextInvokeId(self);
+    Semaphore_wait(self->typeSpecCacheLock);
 
-    mmsClient_createDeleteNamedVariableListRequest(invokeId, payload, domainId, listName);
+    MmsVariableSpecification* typeSpec = (MmsVariableSpecification*) Map_getEntry(self->typeSpecCache, key);
 
-    ByteBuffer* responseMessage = sendRequestAndWaitForResponse(self, invokeId, payload);
+    if (typeSpec == NULL) {
+        /* the lock is not held during the request - another thread can request the same type */
+        Semaphore_post(self->typeSpecCacheLock);
 
-    if (self->lastResponseError != MMS_ERROR_NONE)
-        *mmsError = self->lastResponseError;
-    else if (responseMessage != NULL)
-        if (!mmsClient_parseDeleteNamedVariableListResponse(self->lastResponse, NULL))
-            *mmsError = MMS_ERROR_ACCESS_OTHER;
+        MmsVariableSpecification* newTypeSpec = MmsConnection_getVariableAccessAttributes(self, mmsError,
+                domainId, itemId);
 
-    releaseResponse(self);
+        if (newTypeSpec == NULL) {
+            free(key);
+            return NULL;
+        }
 
-    if (self->associationState == MMS_STATE_CLOSED)
-        *mmsError = MMS_ERROR_CONNECTION_LOST;
+        Semaphore_wait(self->typeSpecCacheLock);
+
+        typeSpec = (MmsVariableSpecification*) Map_getEntry(self->typeSpecCache, key);
+
+        if (typeSpec == NULL) {
+            Map_addEntry(self->typeSpecCache, key, newTypeSpec);
+            typeSpec = newTypeSpec;
+            key = NULL;
+        }
+        else
+            MmsVariableSpecification_destroy(newTypeSpec);
+    }
+
+    if (key != NULL)
+        free(key);
+
+    return typeSpec;
+}
+
+MmsVariableSpecification*
+MmsConnection_getCachedVariableAccessAttributes(MmsConnection self, MmsError* mmsError,
+        char* domainId, char* itemId)
+{
+    MmsVariableSpecification* typeSpec = getCachedTypeSpecAndLock(self, mmsError, domainId, itemId);
+
+    if (typeSpec != NULL)
+        Semaphore_post(self->typeSpecCacheLock);
+
+    return typeSpec;
 }
 
 void
-MmsConnection_deleteAssociationSpecificNamedVariableList(MmsConnection self,
-        MmsError* mmsError, char* listName)
+MmsConnection_clearTypeSpecCache(MmsConnection self)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    Semaphore_wait(self->typeSpecCacheLock);
 
-    *mmsError = MMS_ERROR_NONE;
+    Map_deleteDeep(self->typeSpecCache, true, (void (*)(void*)) MmsVariableSpecification_destroy);
+    self->typeSpecCache = StringMap_create();
 
-    uint32_t invokeId = getNextInvokeId(self);
+    Semaphore_post(self->typeSpecCacheLock);
+}
 
-    mmsClient_createDeleteAssociationSpecificNamedVariableListRequest(
-            invokeId, payload, listName);
+MmsValue*
+MmsConnection_createVariableValue(MmsConnection self, MmsError* mmsError, char* domainId, char* itemId)
+{
+    MmsVariableSpecification* typeSpec = getCachedTypeSpecAndLock(self, mmsError, domainId, itemId);
 
-    ByteBuffer* responseMessage = sendRequestAndWaitForResponse(self, invokeId, payload);
+    if (typeSpec == NULL)
+        return NULL;
 
-    if (self->lastResponseError != MMS_ERROR_NONE)
-        *mmsError = self->lastResponseError;
-    else if (responseMessage != NULL)
-        if (!mmsClient_parseDeleteNamedVariableListResponse(self->lastResponse, NULL))
-            *mmsError = MMS_ERROR_ACCESS_OTHER;
+    /* the cache can be cleared by a reconnect - the type is only used while the lock is held */
+    MmsValue* value = MmsValue_newDefaultValue(typeSpec);
 
-    releaseResponse(self);
+    Semaphore_post(self->typeSpecCacheLock);
 
-    if (self->associationState == MMS_STATE_CLOSED)
-        *mmsError = MMS_ERROR_CONNECTION_LOST;
+    if (value == NULL)
+        *mmsError = MMS_ERROR_DEFINITION_TYPE_UNSUPPORTED;
+
+    return value;
 }
 
-MmsVariableSpecification*
-MmsConnection_getVariableAccessAttributes(MmsConnection self, MmsError* mmsError,
-        char* domainId, char* itemId)
+void
+MmsConnection_readVariableInto(MmsConnection self, MmsError* mmsError,
+        char* domainId, char* itemId, MmsValue* value)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
-
-    MmsVariableSpecification* typeSpec = NULL;
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
     uint32_t invokeId = getNextInvokeId(self);
 
-    mmsClient_createGetVariableAccessAttributesRequest(invokeId, domainId, itemId, payload);
+    mmsClient_createReadRequest(invokeId, domainId, itemId, payload);
 
     ByteBuffer* responseMessage = sendRequestAndWaitForResponse(self, invokeId, payload);
 
     if (self->lastResponseError != MMS_ERROR_NONE)
         *mmsError = self->lastResponseError;
     else if (responseMessage != NULL)
-        typeSpec = mmsClient_parseGetVariableAccessAttributesResponse(self->lastResponse, NULL);
+        *mmsError = mmsClient_parseReadResponseInto(self->lastResponse, NULL, value);
 
     releaseResponse(self);
 
     if (self->associationState == MMS_STATE_CLOSED)
         *mmsError = MMS_ERROR_CONNECTION_LOST;
-
-    return typeSpec;
 }
 
 MmsServerIdentity*
 MmsConnection_identify(MmsConnection self, MmsError* mmsError)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     MmsServerIdentity* identity = NULL;
 
@@ -1486,7 +2005,7 @@ void
 MmsConnection_getServerStatus(MmsConnection self, MmsError* mmsError, int* vmdLogicalStatus, int* vmdPhysicalStatus,
         bool extendedDerivation)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1516,7 +2035,7 @@ int32_t
 MmsConnection_fileOpen(MmsConnection self, MmsError* mmsError, char* filename, uint32_t initialPosition,
         uint32_t* fileSize, uint64_t* lastModified)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1546,7 +2065,7 @@ MmsConnection_fileOpen(MmsConnection self, MmsError* mmsError, char* filename, u
 void
 MmsConnection_fileClose(MmsConnection self, MmsError* mmsError, int32_t frsmId)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
      *mmsError = MMS_ERROR_NONE;
 
@@ -1570,7 +2089,7 @@ MmsConnection_fileClose(MmsConnection self, MmsError* mmsError, int32_t frsmId)
 void
 MmsConnection_fileDelete(MmsConnection self, MmsError* mmsError, char* fileName)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
      *mmsError = MMS_ERROR_NONE;
 
@@ -1596,7 +2115,7 @@ bool
 MmsConnection_fileRead(MmsConnection self, MmsError* mmsError, int32_t frsmId, MmsFileReadHandler handler,
         void* handlerParameter)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1610,7 +2129,8 @@ MmsConnection_fileRead(MmsConnection self, MmsError* mmsError, int32_t frsmId, M
     if (self->lastResponseError != MMS_ERROR_NONE)
         *mmsError = self->lastResponseError;
     else if (responseMessage != NULL) {
-        if (mmsClient_parseFileReadResponse(self, frsmId, &moreFollows, handler, handlerParameter) == false)
+        if (mmsClient_parseFileReadResponse(self->lastResponse, self->lastResponseBufPos, frsmId, &moreFollows,
+                handler, handlerParameter) == false)
             *mmsError = MMS_ERROR_PARSING_RESPONSE;
     }
 
@@ -1627,7 +2147,7 @@ bool
 MmsConnection_getFileDirectory(MmsConnection self, MmsError* mmsError, char* fileSpecification, char* continueAfter,
         MmsFileDirectoryHandler handler, void* handlerParameter)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1657,7 +2177,7 @@ MmsConnection_getFileDirectory(MmsConnection self, MmsError* mmsError, char* fil
 void
 MmsConnection_fileRename(MmsConnection self, MmsError* mmsError, char* currentFileName, char* newFileName)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1684,7 +2204,7 @@ MmsConnection_writeVariable(MmsConnection self, MmsError* mmsError,
         char* domainId, char* itemId,
         MmsValue* value)
 {
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     *mmsError = MMS_ERROR_NONE;
 
@@ -1715,7 +2235,7 @@ MmsConnection_writeMultipleVariables(MmsConnection self, MmsError* mmsError, cha
 
     uint32_t invokeId = getNextInvokeId(self);
 
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
     mmsClient_createWriteMultipleItemsRequest(invokeId, domainId, items, values, payload);
 
@@ -1737,6 +2257,394 @@ MmsConnection_writeMultipleVariables(MmsConnection self, MmsError* mmsError, cha
         *mmsError = MMS_ERROR_CONNECTION_LOST;
 }
 
+static ByteBuffer*
+allocateAsyncRequestBuffer(MmsConnection self, MmsError* mmsError)
+{
+    if ((self->isoClient == NULL) || (self->associationState != MMS_STATE_CONNECTED)) {
+        *mmsError = MMS_ERROR_CONNECTION_LOST;
+        return NULL;
+    }
+
+    return allocateTransmitBuffer(self);
+}
+
+static uint32_t
+sendAsyncRequest(MmsConnection self, MmsError* mmsError, uint32_t invokeId, ByteBuffer* payload,
+        MmsOutstandingCallType type, void* handler, void* parameter, int32_t frsmId)
+{
+    struct sMmsOutstandingCall call;
+    bool added = false;
+    bool queued = false;
+
+    initOutstandingCall(self, &call, invokeId, type, handler, parameter, frsmId);
+
+    Semaphore_wait(self->outstandingCallsLock);
+
+    /* the connection may have been closed after the transmit buffer has been allocated */
+    if (self->associationState == MMS_STATE_CONNECTED) {
+
+        if ((self->requestQueueHead == NULL) && (self->outstandingAsyncCalls < getRequestWindow(self)))
+            added = addCallToTable(self, &call);
+
+        if (added == false) {
+            /* no free slot -> the request is sent when a response has been received */
+            addToRequestQueue(self, &call, payload);
+            queued = true;
+        }
+    }
+
+    Semaphore_post(self->outstandingCallsLock);
+
+    if (added == false) {
+        IsoClientConnection_releaseTransmitBuffer(self->isoClient);
+
+        if (queued == false) {
+            *mmsError = MMS_ERROR_CONNECTION_LOST;
+            return 0;
+        }
+    }
+    else
+        IsoClientConnection_sendMessage(self->isoClient, payload);
+
+    *mmsError = MMS_ERROR_NONE;
+
+    /* the timeout of a queued request is scheduled when it is sent */
+    if ((queued == false) && (self->timeoutScheduler != NULL))
+        self->timeoutScheduler(self->timeoutSchedulerParameter, call.timeout);
+
+    completeAsyncCalls(self, MMS_ERROR_SERVICE_TIMEOUT, true);
+
+    return invokeId;
+}
+
+uint32_t
+MmsConnection_readVariableAsync(MmsConnection self, MmsError* mmsError, char* domainId, char* itemId,
+        MmsReadResponseHandler handler, void* parameter)
+{
+    ByteBuffer* payload = allocateAsyncRequestBuffer(self, mmsError);
+
+    if (payload == NULL)
+        return 0;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createReadRequest(invokeId, domainId, itemId, payload);
+
+    return sendAsyncRequest(self, mmsError, invokeId, payload, MMS_CALL_TYPE_READ_VARIABLE,
+            (void*) handler, parameter, 0);
+}
+
+uint32_t
+MmsConnection_readMultipleVariablesAsync(MmsConnection self, MmsError* mmsError, char* domainId,
+        LinkedList /*<char*>*/ items, MmsReadResponseHandler handler, void* parameter)
+{
+    ByteBuffer* payload = allocateAsyncRequestBuffer(self, mmsError);
+
+    if (payload == NULL)
+        return 0;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createReadRequestMultipleValues(invokeId, domainId, items, payload);
+
+    return sendAsyncRequest(self, mmsError, invokeId, payload, MMS_CALL_TYPE_READ_MULTIPLE_VARIABLES,
+            (void*) handler, parameter, 0);
+}
+
+uint32_t
+mmsClient_readVariablesAsync(MmsConnection self, MmsError* mmsError, char** domainIds, char** itemIds,
+        int valuesCount, MmsReadResponseHandler handler, void* parameter)
+{
+    ByteBuffer* payload = allocateAsyncRequestBuffer(self, mmsError);
+
+    if (payload == NULL)
+        return 0;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createReadRequestMultipleDomains(invokeId, domainIds, itemIds, valuesCount, payload);
+
+    return sendAsyncRequest(self, mmsError, invokeId, payload, MMS_CALL_TYPE_READ_MULTIPLE_VARIABLES,
+            (void*) handler, parameter, 0);
+}
+
+uint32_t
+MmsConnection_readNamedVariableListValuesAsync(MmsConnection self, MmsError* mmsError, char* domainId,
+        char* listName, bool specWithResult, MmsReadResponseHandler handler, void* parameter)
+{
+    ByteBuffer* payload = allocateAsyncRequestBuffer(self, mmsError);
+
+    if (payload == NULL)
+        return 0;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createReadNamedVariableListRequest(invokeId, domainId, listName, payload, specWithResult);
+
+    return sendAsyncRequest(self, mmsError, invokeId, payload, MMS_CALL_TYPE_READ_MULTIPLE_VARIABLES,
+            (void*) handler, parameter, 0);
+}
+
+uint32_t
+MmsConnection_writeVariableAsync(MmsConnection self, MmsError* mmsError, char* domainId, char* itemId,
+        MmsValue* value, MmsWriteResponseHandler handler, void* parameter)
+{
+    ByteBuffer* payload = allocateAsyncRequestBuffer(self, mmsError);
+
+    if (payload == NULL)
+        return 0;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createWriteRequest(invokeId, domainId, itemId, value, payload);
+
+    return sendAsyncRequest(self, mmsError, invokeId, payload, MMS_CALL_TYPE_WRITE_VARIABLE,
+            (void*) handler, parameter, 0);
+}
+
+uint32_t
+MmsConnection_getNameListAsync(MmsConnection self, MmsError* mmsError, char* domainId,
+        MmsObjectClass objectClass, bool associationSpecific, char* continueAfter,
+        MmsGetNameListResponseHandler handler, void* parameter)
+{
+    ByteBuffer* payload = allocateAsyncRequestBuffer(self, mmsError);
+
+    if (payload == NULL)
+        return 0;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    createGetNameListRequest(invokeId, payload, domainId, objectClass, associationSpecific, continueAfter);
+
+    return sendAsyncRequest(self, mmsError, invokeId, payload, MMS_CALL_TYPE_GET_NAME_LIST,
+            (void*) handler, parameter, 0);
+}
+
+uint32_t
+MmsConnection_fileReadAsync(MmsConnection self, MmsError* mmsError, int32_t frsmId,
+        MmsFileReadResponseHandler handler, void* parameter)
+{
+    ByteBuffer* payload = allocateAsyncRequestBuffer(self, mmsError);
+
+    if (payload == NULL)
+        return 0;
+
+    uint32_t invokeId = getNextInvokeId(self);
+
+    mmsClient_createFileReadRequest(invokeId, payload, frsmId);
+
+    return sendAsyncRequest(self, mmsError, invokeId, payload, MMS_CALL_TYPE_FILE_READ,
+            (void*) handler, parameter, frsmId);
+}
+
+/* data block of a file transfer that has been received but not yet passed to the sink */
+typedef struct {
+    uint32_t size;
+    uint8_t* data;
+} FileTransferBlock;
+
+/* state of a file transfer with several outstanding FileRead requests */
+typedef struct {
+    MmsConnection connection;
+    int32_t frsmId;
+
+    Condition condition; /* protects and signals the state of the transfer */
+    int pendingRequests;
+    bool finished; /* last data received, request failed or transfer stopped by the sink */
+    LinkedList receivedBlocks; /* FileTransferBlock objects in the order of the data */
+    MmsError lastError;
+} FileTransfer;
+
+static void
+fileTransferResponseHandler(uint32_t invokeId, void* parameter, MmsError mmsError, int32_t frsmId,
+        uint8_t* buffer, uint32_t bytesReceived, bool moreFollows);
+
+/*
+ * The request has to be counted in pendingRequests by the caller. Has to be called without
+ * holding the lock - the handler can be called by the calling thread.
+ */
+static void
+sendFileTransferRequest(FileTransfer* transfer)
+{
+    MmsError mmsError = MMS_ERROR_NONE;
+
+    Condition_lock(transfer->condition);
+    bool finished = transfer->finished;
+    Condition_unlock(transfer->condition);
+
+    if ((finished == false) && (MmsConnection_fileReadAsync(transfer->connection, &mmsError, transfer->frsmId,
+            fileTransferResponseHandler, transfer) != 0))
+        return;
+
+    Condition_lock(transfer->condition);
+
+    if (mmsError != MMS_ERROR_NONE) {
+        transfer->lastError = mmsError;
+        transfer->finished = true;
+    }
+
+    transfer->pendingRequests--;
+
+    Condition_broadcast(transfer->condition);
+
+    Condition_unlock(transfer->condition);
+}
+
+/* stores the data for the thread that waits in MmsConnection_fileReadWindowed - the sink is not called here */
+static void
+fileTransferResponseHandler(uint32_t invokeId, void* parameter, MmsError mmsError, int32_t frsmId,
+        uint8_t* buffer, uint32_t bytesReceived, bool moreFollows)
+{
+    FileTransfer* transfer = (FileTransfer*) parameter;
+
+    (void) invokeId;
+    (void) frsmId;
+
+    Condition_lock(transfer->condition);
+
+    /* responses to the requests that are still outstanding after the last data are ignored */
+    if (transfer->finished == false) {
+
+        if (mmsError != MMS_ERROR_NONE) {
+            if (DEBUG_MMS_CLIENT)
+                printf("MMS_CLIENT: file transfer: read request failed (error %i)\n", mmsError);
+
+            transfer->lastError = mmsError;
+            transfer->finished = true;
+        }
+        else {
+            FileTransferBlock* block = (FileTransferBlock*) malloc(sizeof(FileTransferBlock));
+
+            block->size = bytesReceived;
+            block->data = (uint8_t*) malloc(bytesReceived > 0 ? bytesReceived : 1);
+            memcpy(block->data, buffer, bytesReceived);
+
+            LinkedList_add(transfer->receivedBlocks, block);
+
+            if (moreFollows == false)
+                transfer->finished = true;
+        }
+    }
+
+    transfer->pendingRequests--;
+
+    Condition_broadcast(transfer->condition);
+
+    Condition_unlock(transfer->condition);
+}
+
+static void
+fileTransferBlock_destroy(FileTransferBlock* self)
+{
+    free(self->data);
+    free(self);
+}
+
+uint32_t
+MmsConnection_fileReadWindowed(MmsConnection self, MmsError* mmsError, int32_t frsmId, int windowSize,
+        MmsFileDataSink sink, void* sinkParameter)
+{
+    FileTransfer transfer;
+
+    transfer.connection = self;
+    transfer.frsmId = frsmId;
+    transfer.condition = Condition_create();
+    transfer.pendingRequests = 0;
+    transfer.finished = false;
+    transfer.receivedBlocks = LinkedList_create();
+    transfer.lastError = MMS_ERROR_NONE;
+
+    uint32_t bytesReceived = 0;
+
+    if (windowSize < 1)
+        windowSize = 1;
+
+    Condition_lock(transfer.condition);
+    transfer.pendingRequests = windowSize;
+    Condition_unlock(transfer.condition);
+
+    int i;
+
+    for (i = 0; i < windowSize; i++)
+        sendFileTransferRequest(&transfer);
+
+    /* wait for the responses - timeouts are only checked by the connection when messages are exchanged */
+    uint32_t checkInterval = self->requestTimeout;
+
+    if (checkInterval == 0)
+        checkInterval = 1000;
+
+    Condition_lock(transfer.condition);
+
+    while (true) {
+        LinkedList element = LinkedList_getNext(transfer.receivedBlocks);
+
+        if (element != NULL) {
+            FileTransferBlock* block = (FileTransferBlock*) element->data;
+
+            LinkedList_remove(transfer.receivedBlocks, block);
+
+            Condition_unlock(transfer.condition);
+
+            /* the sink is called by this thread so it can use the blocking functions of the connection */
+            bool continueTransfer = sink(sinkParameter, frsmId, block->data, block->size);
+
+            bytesReceived += block->size;
+
+            fileTransferBlock_destroy(block);
+
+            Condition_lock(transfer.condition);
+
+            if (continueTransfer == false) {
+                transfer.finished = true;
+
+                LinkedList_destroyDeep(transfer.receivedBlocks, (LinkedListValueDeleteFunction) fileTransferBlock_destroy);
+                transfer.receivedBlocks = LinkedList_create();
+            }
+            else if (transfer.finished == false) {
+                /* request the next block when the previous one has been consumed */
+                transfer.pendingRequests++;
+
+                Condition_unlock(transfer.condition);
+
+                sendFileTransferRequest(&transfer);
+
+                Condition_lock(transfer.condition);
+            }
+        }
+        else if (transfer.pendingRequests > 0) {
+            if (Condition_waitUntil(transfer.condition, Hal_getTimeInMs() + checkInterval) == false) {
+                Condition_unlock(transfer.condition);
+
+                MmsConnection_checkTimeouts(self);
+
+                Condition_lock(transfer.condition);
+            }
+        }
+        else
+            break;
+    }
+
+    Condition_unlock(transfer.condition);
+
+    LinkedList_destroyDeep(transfer.receivedBlocks, (LinkedListValueDeleteFunction) fileTransferBlock_destroy);
+
+    Condition_destroy(transfer.condition);
+
+    *mmsError = transfer.lastError;
+
+    if (DEBUG_MMS_CLIENT)
+        printf("MMS_CLIENT: file transfer: %u bytes received (window %i)\n", bytesReceived, windowSize);
+
+    return bytesReceived;
+}
+
+void
+MmsConnection_checkTimeouts(MmsConnection self)
+{
+    completeAsyncCalls(self, MMS_ERROR_SERVICE_TIMEOUT, true);
+}
+
 void
 MmsServerIdentity_destroy(MmsServerIdentity* self)
 {
@@ -1800,7 +2708,7 @@ MmsIndication MmsConnection_sendUnconfirmedPDU(MmsConnection self, MmsError* cli
 		) {
 
     uint32_t invokeId = getNextInvokeId(self);
-    ByteBuffer* payload = IsoClientConnection_allocateTransmitBuffer(self->isoClient);
+    ByteBuffer* payload = allocateTransmitBuffer(self);
 
 	*clientError = MMS_ERROR_NONE;
 
@@ -1812,7 +2720,7 @@ MmsIndication MmsConnection_sendUnconfirmedPDU(MmsConnection self, MmsError* cli
 	mmsClient_createUnconfirmedPDU(domainId, itemId, timeStamp, payload);
 
 
-   	addToOutstandingCalls(self, invokeId);
+   	addToOutstandingCalls(self, invokeId, MMS_CALL_TYPE_NONE, NULL, NULL, 0);
 
 	IsoClientConnection_sendMessage(self->isoClient, payload);
 
@@ -68,6 +68,40 @@ typedef enum {
 typedef void (*MmsInformationReportHandler) (void* parameter, char* domainName,
         char* variableListName, MmsValue* value, LinkedList attributes, int attributesCount);
 
+/**
+ * \brief BER encoded value of a received information report
+ *
+ * Refers to the receive buffer of the connection and is only valid during the call of the
+ * handler. The values can be accessed with the MmsRawValue_* functions without creating
+ * MmsValue instances.
+ */
+typedef struct {
+    /** the type of the value (MMS_DATA_ACCESS_ERROR if the access result is a failure) */
+    MmsType type;
+
+    /** the BER tag of the value */
+    uint8_t tag;
+
+    /** the content octets of the value (without tag and length) */
+    uint8_t* buffer;
+
+    /** the number of content octets */
+    int size;
+} MmsRawValue;
+
+/**
+ * \brief Handler for information reports that gets the values in their BER encoded form
+ *
+ * \param parameter user provided parameter
+ * \param domainName the domain ID of the first variable of a list of variables or NULL
+ * \param variableListName the name of the VMD specific named variable list or NULL
+ * \param attributes the item IDs of the variables if the report contains a list of variables or NULL
+ * \param values the values of the report (only valid during the call of the handler)
+ * \param valueCount the number of values
+ */
+typedef void (*MmsRawInformationReportHandler) (void* parameter, char* domainName, char* variableListName,
+        LinkedList attributes, MmsRawValue* values, int valueCount);
+
 /**
  * Opaque handle for MMS client connection instance.
  */
@@ -110,6 +144,87 @@ void
 MmsConnection_setInformationReportHandler(MmsConnection self, MmsInformationReportHandler handler,
         void* parameter);
 
+/**
+ * \brief Install a handler function for MMS information reports that doesn't create MmsValue instances
+ *
+ * The values are passed to the handler in their BER encoded form and can be accessed with the
+ * MmsRawValue_* functions. This avoids the allocation of the MmsValue trees for high report rates.
+ * When a raw handler is installed the handler installed with MmsConnection_setInformationReportHandler
+ * is not called.
+ *
+ * \param self MmsConnection instance to operate on
+ * \param handler the handler function to install for this client connection (NULL to uninstall)
+ * \param parameter a user specified parameter that will be passed to the handler function on each
+ *        invocation.
+ */
+void
+MmsConnection_setRawInformationReportHandler(MmsConnection self, MmsRawInformationReportHandler handler,
+        void* parameter);
+
+/**
+ * \brief Create an MmsValue instance from a raw value
+ *
+ * \return the new MmsValue instance (has to be deleted by the caller) or NULL if the value is malformed
+ */
+MmsValue*
+MmsRawValue_toMmsValue(MmsRawValue* self);
+
+/**
+ * \brief Get the number of elements of a raw value of type MMS_ARRAY or MMS_STRUCTURE
+ */
+int
+MmsRawValue_getElementCount(MmsRawValue* self);
+
+/**
+ * \brief Get an element of a raw value of type MMS_ARRAY or MMS_STRUCTURE
+ *
+ * \param index the index of the element
+ * \param element returns the element
+ *
+ * \return true if the element exists, false otherwise
+ */
+bool
+MmsRawValue_getElement(MmsRawValue* self, int index, MmsRawValue* element);
+
+bool
+MmsRawValue_getBoolean(MmsRawValue* self);
+
+/**
+ * \brief Get the value of a raw value of type MMS_INTEGER or MMS_UNSIGNED
+ */
+int64_t
+MmsRawValue_toInt64(MmsRawValue* self);
+
+/**
+ * \brief Get the value of a raw value of type MMS_UNSIGNED or MMS_INTEGER
+ */
+uint32_t
+MmsRawValue_toUint32(MmsRawValue* self);
+
+/**
+ * \brief Get the value of a raw value of type MMS_FLOAT (32 or 64 bit)
+ */
+double
+MmsRawValue_toDouble(MmsRawValue* self);
+
+/**
+ * \brief Get the size in bits of a raw value of type MMS_BIT_STRING
+ */
+int
+MmsRawValue_getBitStringSize(MmsRawValue* self);
+
+/**
+ * \brief Get a bit of a raw value of type MMS_BIT_STRING. Out of range bits are false.
+ */
+bool
+MmsRawValue_getBitStringBit(MmsRawValue* self, int bitPos);
+
+/**
+ * \brief Get the time in ms since epoch of a raw value of type MMS_UTC_TIME or MMS_BINARY_TIME
+ */
+uint64_t
+MmsRawValue_getTimeInMs(MmsRawValue* self);
+
 /**
  * \brief Get the connection parameters for an MmsConnection instance
  *
@@ -373,6 +488,74 @@ MmsVariableSpecification*
 MmsConnection_getVariableAccessAttributes(MmsConnection self, MmsError* mmsError,
 		char* domainId, char* itemId);
 
+/**
+ * \brief Get the variable access attributes of a MMS named variable from the type cache of the connection
+ *
+ * When the type of the variable is not yet known it is requested from the server and stored in the
+ * cache. Further calls for the same variable don't send a request.
+ *
+ * \param self MmsConnection instance to operate on
+ * \param mmsError user provided variable to store error code
+ * \param domainId the domain name of the variable or NULL for a VMD specific named variable
+ * \param itemId name of the variable
+ *
+ * \return Returns a MmsTypeSpecification object or NULL if the request failed. The object belongs to the
+ *         cache and must not be deleted by the caller. It is valid until the cache is cleared. This also
+ *         happens when the connection is established again (e.g. by an automatic reconnect of the
+ *         connection manager) - use MmsConnection_createVariableValue if that can happen at any time.
+ */
+MmsVariableSpecification*
+MmsConnection_getCachedVariableAccessAttributes(MmsConnection self, MmsError* mmsError,
+        char* domainId, char* itemId);
+
+/**
+ * \brief Remove all variable access attributes from the type cache of the connection
+ *
+ * The cache is also cleared when the connection is established again. All type specifications that
+ * were returned by MmsConnection_getCachedVariableAccessAttributes are deleted.
+ *
+ * \param self MmsConnection instance to operate on
+ */
+void
+MmsConnection_clearTypeSpecCache(MmsConnection self);
+
+/**
+ * \brief Create a value of the type of a MMS named variable
+ *
+ * The value is created from the cached variable access attributes. It can be used with
+ * MmsConnection_readVariableInto to read the variable repeatedly without creating new values.
+ *
+ * \param self MmsConnection instance to operate on
+ * \param mmsError user provided variable to store error code
+ * \param domainId the domain name of the variable or NULL for a VMD specific named variable
+ * \param itemId name of the variable
+ *
+ * \return Returns a new MmsValue object with default values or NULL if the type is not known. The caller
+ *         has to delete the value with MmsValue_delete.
+ */
+MmsValue*
+MmsConnection_createVariableValue(MmsConnection self, MmsError* mmsError, char* domainId, char* itemId);
+
+/**
+ * \brief Read a single variable from the server into an existing value
+ *
+ * The response is decoded directly into the given value instead of creating a new MmsValue object.
+ * The value has to have the type of the variable (see MmsConnection_createVariableValue). Memory is
+ * only allocated when a string, octet string or integer of the response does not fit into the value.
+ *
+ * If the response doesn't match the type of the value the error is MMS_ERROR_PARSING_RESPONSE. In this
+ * case (and if the server reports an access error) the content of the value is undefined.
+ *
+ * \param self MmsConnection instance to operate on
+ * \param mmsError user provided variable to store error code
+ * \param domainId the domain name of the variable to be read or NULL to read a VMD specific named variable
+ * \param itemId name of the variable to be read
+ * \param value the value that is updated with the result of the read request
+ */
+void
+MmsConnection_readVariableInto(MmsConnection self, MmsError* mmsError,
+        char* domainId, char* itemId, MmsValue* value);
+
 /**
  * \brief Read the values of a domain specific named variable list
  *
@@ -661,6 +844,193 @@ MmsConnection_getFileDirectory(MmsConnection self, MmsError* mmsError, char* fil
         MmsFileDirectoryHandler handler, void* handlerParameter);
 
 
+/*******************************************************************************
+ * asynchronous (non-blocking) functions
+ *******************************************************************************/
+
+/*
+ * The asynchronous functions send the request and return immediately with the invoke ID of the
+ * request. The response is passed to the user provided handler. Several requests can be
+ * outstanding at the same time. The number of requests that are sent before a response is received
+ * is limited to the negotiated maxServOutstandingCalling parameter (at most
+ * CONFIG_MMS_CLIENT_MAX_OUTSTANDING_CALLS). Further requests are queued by the connection and
+ * sent in order when responses arrive.
+ *
+ * The handlers are called by the receive thread of the connection (they can be called before the
+ * function that sends the request returns). A handler must not call the blocking functions of
+ * the connection because no other message can be received until the handler returns. The
+ * asynchronous functions can be used to send follow-up requests.
+ *
+ * Confirmed errors and rejects of the server are passed to the handler as MmsError
+ * (MMS_ERROR_REJECT_* for rejects). If the server does not respond the request is completed with
+ * MMS_ERROR_SERVICE_TIMEOUT when the request timeout has elapsed. The timeout of a queued request
+ * starts when it is sent. Timeouts are checked when a response is received and when a new request
+ * is sent; MmsConnection_checkTimeouts can be used to check them in between.
+ * All outstanding and queued requests are completed with MMS_ERROR_CONNECTION_LOST when the connection
+ * is closed.
+ */
+
+/**
+ * \brief User provided handler for the response of asynchronous read requests
+ *
+ * \param invokeId the invoke ID of the request
+ * \param parameter user provided parameter
+ * \param mmsError the result of the request (MMS_ERROR_NONE on success)
+ * \param value the read result or NULL in case of an error. The API user is responsible to free the value.
+ */
+typedef void
+(*MmsReadResponseHandler) (uint32_t invokeId, void* parameter, MmsError mmsError, MmsValue* value);
+
+/**
+ * \brief User provided handler for the response of asynchronous write requests
+ */
+typedef void
+(*MmsWriteResponseHandler) (uint32_t invokeId, void* parameter, MmsError mmsError);
+
+/**
+ * \brief User provided handler for the response of asynchronous get name list requests
+ *
+ * \param nameList list of the names (char*) or NULL in case of an error. The API user is responsible
+ *        to free the list (e.g. with LinkedList_destroy).
+ * \param moreFollows true if the server has more names. They can be requested with the last name of
+ *        the list as continuation point.
+ */
+typedef void
+(*MmsGetNameListResponseHandler) (uint32_t invokeId, void* parameter, MmsError mmsError, LinkedList nameList,
+        bool moreFollows);
+
+/**
+ * \brief User provided handler for the response of asynchronous file read requests
+ *
+ * \param buffer the received data (only valid during the call of the handler)
+ * \param bytesReceived number of bytes in the buffer
+ * \param moreFollows true if more data follows, false if the last data has been received
+ */
+typedef void
+(*MmsFileReadResponseHandler) (uint32_t invokeId, void* parameter, MmsError mmsError, int32_t frsmId,
+        uint8_t* buffer, uint32_t bytesReceived, bool moreFollows);
+
+/**
+ * \brief Read a single variable from the server (asynchronous version of MmsConnection_readVariable)
+ *
+ * \param self MmsConnection instance to operate on
+ * \param mmsError user provided variable to store the error code if the request cannot be sent
+ * \param domainId the domain name of the variable to be read
+ * \param itemId name of the variable to be read
+ * \param handler callback that is invoked with the response
+ * \param parameter user provided parameter that is passed to the callback function
+ *
+ * \return the invoke ID of the request or 0 if the request cannot be sent
+ */
+uint32_t
+MmsConnection_readVariableAsync(MmsConnection self, MmsError* mmsError, char* domainId, char* itemId,
+        MmsReadResponseHandler handler, void* parameter);
+
+/**
+ * \brief Read multiple variables of a domain from the server (asynchronous version of
+ * MmsConnection_readMultipleVariables)
+ *
+ * The handler receives an MMS_ARRAY that contains the values of the variables.
+ *
+ * \return the invoke ID of the request or 0 if the request cannot be sent
+ */
+uint32_t
+MmsConnection_readMultipleVariablesAsync(MmsConnection self, MmsError* mmsError, char* domainId,
+        LinkedList /*<char*>*/ items, MmsReadResponseHandler handler, void* parameter);
+
+/**
+ * \brief Read the values of a named variable list (data set) (asynchronous version of
+ * MmsConnection_readNamedVariableListValues)
+ *
+ * \return the invoke ID of the request or 0 if the request cannot be sent
+ */
+uint32_t
+MmsConnection_readNamedVariableListValuesAsync(MmsConnection self, MmsError* mmsError, char* domainId,
+        char* listName, bool specWithResult, MmsReadResponseHandler handler, void* parameter);
+
+/**
+ * \brief Write a single variable to the server (asynchronous version of MmsConnection_writeVariable)
+ *
+ * The value is encoded before the function returns and can be freed by the caller.
+ *
+ * \return the invoke ID of the request or 0 if the request cannot be sent
+ */
+uint32_t
+MmsConnection_writeVariableAsync(MmsConnection self, MmsError* mmsError, char* domainId, char* itemId,
+        MmsValue* value, MmsWriteResponseHandler handler, void* parameter);
+
+/**
+ * \brief Request a list of names from the server (single request of the get name list service)
+ *
+ * \param domainId the domain for domain specific object classes (ignored for MMS_DOMAIN_NAMES and
+ *        association specific requests)
+ * \param objectClass the class of the requested objects
+ * \param associationSpecific request the association specific objects (e.g. named variable lists)
+ * \param continueAfter continuation point (last name of the previous response) or NULL
+ *
+ * \return the invoke ID of the request or 0 if the request cannot be sent
+ */
+uint32_t
+MmsConnection_getNameListAsync(MmsConnection self, MmsError* mmsError, char* domainId,
+        MmsObjectClass objectClass, bool associationSpecific, char* continueAfter,
+        MmsGetNameListResponseHandler handler, void* parameter);
+
+/**
+ * \brief Read the next data block from a file (asynchronous version of MmsConnection_fileRead)
+ *
+ * \return the invoke ID of the request or 0 if the request cannot be sent
+ */
+uint32_t
+MmsConnection_fileReadAsync(MmsConnection self, MmsError* mmsError, int32_t frsmId,
+        MmsFileReadResponseHandler handler, void* parameter);
+
+/**
+ * \brief User provided sink for the data of MmsConnection_fileReadWindowed
+ *
+ * \param buffer the received data (only valid during the call of the sink)
+ * \param bytesReceived number of bytes in the buffer
+ *
+ * \return true to continue the transfer, false to stop it
+ */
+typedef bool
+(*MmsFileDataSink) (void* parameter, int32_t frsmId, uint8_t* buffer, uint32_t bytesReceived);
+
+/**
+ * \brief Read the rest of an open file with several outstanding FileRead requests
+ *
+ * Instead of waiting for each data block before the next one is requested the function keeps
+ * windowSize FileRead requests outstanding. This way the transfer of large files (e.g. COMTRADE
+ * disturbance records) is not limited by the round trip time of the connection.
+ *
+ * The FileRead service has no file position parameter. The server has to answer the requests
+ * in the order they have been received (like the libiec61850 server does). Otherwise a window
+ * size of 1 has to be used. Responses to the requests that are still outstanding when the last
+ * data block has been received are ignored.
+ *
+ * The sink is called by the calling thread in the order of the data blocks, so it can use the
+ * blocking functions of the connection. The next request is sent when a block has been passed to
+ * the sink. The function blocks until all requests have been answered and has to be called from
+ * the application thread (not from a handler of the connection).
+ *
+ * \param frsmId the FRSM ID (file read state machine) handle of the file
+ * \param windowSize the maximum number of outstanding FileRead requests
+ * \param sink callback that is invoked to deliver the received data
+ * \param sinkParameter user provided parameter that is passed to the sink
+ *
+ * \return the number of bytes delivered to the sink
+ */
+uint32_t
+MmsConnection_fileReadWindowed(MmsConnection self, MmsError* mmsError, int32_t frsmId, int windowSize,
+        MmsFileDataSink sink, void* sinkParameter);
+
+/**
+ * \brief Complete the asynchronous requests whose timeout has elapsed
+ *
+ * The handlers of the requests are called with MMS_ERROR_SERVICE_TIMEOUT by the calling thread.
+ */
+void
+MmsConnection_checkTimeouts(MmsConnection self);
+
 MmsIndication MmsConnection_sendUnconfirmedPDU(MmsConnection self, MmsError* clientError,
 				char* domainId, char* itemId, uint32_t timeStamp);
 
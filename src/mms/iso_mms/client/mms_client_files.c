@@ -470,11 +470,11 @@ mmsClient_parseFileOpenResponse(MmsConnection self, int32_t* frsmId, uint32_t* f
 
 
 bool
-mmsClient_parseFileReadResponse(MmsConnection self, int32_t frsmId,  bool* moreFollows, MmsFileReadHandler handler, void* handlerParameter)
+mmsClient_parseFileReadResponse(ByteBuffer* message, int32_t bufPos, int32_t frsmId, bool* moreFollows,
+        MmsFileReadHandler handler, void* handlerParameter)
 {
-    uint8_t* buffer = self->lastResponse->buffer;
-    int maxBufPos = self->lastResponse->size;
-    int bufPos = self->lastResponseBufPos;
+    uint8_t* buffer = message->buffer;
+    int maxBufPos = message->size;
     int length;
 
     uint8_t tag = buffer[bufPos++];
@@ -190,6 +190,7 @@ mmsClient_parseGetNameListResponse(LinkedList* nameList, ByteBuffer* message, ui
 exit_error:
     if (*nameList != NULL) {
         LinkedList_destroy(*nameList);
+        *nameList = NULL;
     }
 
     if (DEBUG) printf("parseNameListResponse: error parsing message!\n");
@@ -30,6 +30,7 @@
 #include "ber_decode.h"
 
 #include "thread.h"
+#include "string_map.h"
 
 #ifndef DEBUG_MMS_CLIENT
 #define DEBUG_MMS_CLIENT 0
@@ -54,23 +55,67 @@ typedef enum {
 #define CONCLUDE_STATE_REJECTED 2
 #define CONCLUDE_STATE_ACCEPTED 3
 
+typedef enum {
+    MMS_CALL_TYPE_NONE, /* synchronous request - the response is handed over to the waiting caller */
+    MMS_CALL_TYPE_READ_VARIABLE,
+    MMS_CALL_TYPE_READ_MULTIPLE_VARIABLES, /* also used for named variable lists */
+    MMS_CALL_TYPE_WRITE_VARIABLE,
+    MMS_CALL_TYPE_GET_NAME_LIST,
+    MMS_CALL_TYPE_FILE_READ
+} MmsOutstandingCallType;
+
+typedef struct sMmsOutstandingCall* MmsOutstandingCall;
+
+struct sMmsOutstandingCall {
+    bool isUsed;
+    uint32_t invokeId;
+    MmsOutstandingCallType type;
+    void* userCallback;
+    void* userParameter;
+    int32_t frsmId; /* for file read requests */
+    uint64_t timeout;
+};
+
+typedef struct sMmsQueuedRequest* MmsQueuedRequest;
+
+/* asynchronous request that waits for a free slot in the request window */
+struct sMmsQueuedRequest {
+    struct sMmsOutstandingCall call;
+    MmsQueuedRequest next;
+    int messageSize;
+    uint8_t* message; /* encoded request - allocated together with the structure */
+};
+
+/* used by the connection manager to supervise the timeouts of asynchronous requests */
+typedef void (*MmsRequestTimeoutScheduler)(void* parameter, uint64_t timeout);
+
 /* private instance variables */
 struct sMmsConnection {
     Semaphore lastInvokeIdLock;
     uint32_t lastInvokeId;
 
-	Semaphore lastResponseLock;
+	Condition lastResponseCondition; /* protects and signals the response and state variables */
     uint32_t responseInvokeId;
 	ByteBuffer* lastResponse;
 	uint32_t lastResponseBufPos;
 	MmsError lastResponseError;
 
-	Semaphore outstandingCallsLock;
-	uint32_t* outstandingCalls;
+	Semaphore outstandingCallsLock; /* also protects the request queue */
+	MmsOutstandingCall outstandingCalls;
+	int outstandingAsyncCalls;
+	MmsQueuedRequest requestQueueHead;
+	MmsQueuedRequest requestQueueTail;
+
+	MmsRequestTimeoutScheduler timeoutScheduler;
+	void* timeoutSchedulerParameter;
+
+	/* messages are received by a connection manager instead of a receive thread */
+	bool useReceiveThread;
 
 	uint32_t requestTimeout;
 
 	IsoClientConnection isoClient;
+	Semaphore isoClientLock; /* held when isoClient is replaced and while a transmit buffer is allocated */
 	AssociationState associationState;
 	ConnectionState connectionState;
 	//uint8_t* buffer;
@@ -81,11 +126,22 @@ struct sMmsConnection {
 	MmsInformationReportHandler reportHandler;
 	void* reportHandlerParameter;
 
+	MmsRawInformationReportHandler rawReportHandler;
+	void* rawReportHandlerParameter;
+
+	/* reused for the values of the received reports (only accessed by the receiving thread) */
+	MmsRawValue* rawReportValues;
+	int rawReportValuesSize;
+
 	MmsConnectionLostHandler connectionLostHandler;
 	void* connectionLostHandlerParameter;
 
 	/* state of an active connection conclude/release process */
 	int concludeState;
+
+	/* type specifications of the variables hashed by "domainId/itemId" */
+	Semaphore typeSpecCacheLock;
+	Map typeSpecCache;
 };
 
 
@@ -98,9 +154,50 @@ typedef enum {
 } MmsObjectClass;
 
  */
+/* returns the earliest timeout of the sent asynchronous requests or 0 if there is none */
+uint64_t
+mmsClient_getNextRequestTimeout(MmsConnection self);
+
+/* builds the value list from the asn1c structure (used by the report decoder benchmark for comparison) */
 MmsValue*
 mmsClient_parseListOfAccessResults(AccessResult_t** accessResultList, int listSize, bool createArray);
 
+/* decodes the access results between bufPos and endPos directly from the BER encoded message */
+MmsValue*
+mmsClient_decodeListOfAccessResults(uint8_t* buffer, int bufPos, int endPos, bool createArray);
+
+/* decodes the content of a single Data element (NULL if it is malformed or nested too deeply) */
+MmsValue*
+mmsClient_decodeDataElement(uint8_t tag, uint8_t* buffer, int bufPos, int length);
+
+/* writes the content of a single Data element into an existing value of the same type */
+bool
+mmsClient_updateDataElement(MmsValue* value, uint8_t tag, uint8_t* buffer, int bufPos, int length);
+
+/*
+ * Splits the elements between bufPos and endPos into raw values. Returns the number of elements
+ * (also if it is larger than maxValues) or -1 if the elements are malformed.
+ */
+int
+mmsClient_splitRawValues(uint8_t* buffer, int bufPos, int endPos, MmsRawValue* values, int maxValues);
+
+/*
+ * Decodes an information report PDU without asn1c. Returns either the variable list name (VMD specific
+ * named variable list) or the item names of the list of variables and the domain name of the first
+ * variable (if domain specific). The values are always returned as array.
+ */
+bool
+mmsClient_parseInformationReport(ByteBuffer* message, char** domainName, char** variableListName,
+        LinkedList* attributes, MmsValue** values);
+
+/*
+ * Like mmsClient_parseInformationReport but returns the values in BER encoded form. The values array
+ * is resized when required.
+ */
+bool
+mmsClient_parseRawInformationReport(ByteBuffer* message, char** domainName, char** variableListName,
+        LinkedList* attributes, MmsRawValue** values, int* valuesSize, int* valueCount);
+
 uint32_t
 mmsClient_getInvokeId(ConfirmedResponsePdu_t* confirmedResponse);
 
@@ -129,6 +226,13 @@ mmsClient_createGetNameListRequestDomainOrVMDSpecific(long invokeId, char* domai
 MmsValue*
 mmsClient_parseReadResponse(ByteBuffer* message, uint32_t* invokeId, bool createArray);
 
+/* decodes the result of a read response for a single variable into value */
+MmsError
+mmsClient_parseReadResponseInto(ByteBuffer* message, uint32_t* invokeId, MmsValue* value);
+
+MmsError
+mmsClient_mapDataAccessErrorToMmsError(uint32_t dataAccessError);
+
 int
 mmsClient_createReadRequest(uint32_t invokeId, char* domainId, char* itemId, ByteBuffer* writeBuffer);
 
@@ -140,6 +244,15 @@ int
 mmsClient_createReadRequestMultipleValues(uint32_t invokeId, char* domainId, LinkedList /*<char*>*/ items,
 		ByteBuffer* writeBuffer);
 
+int
+mmsClient_createReadRequestMultipleDomains(uint32_t invokeId, char** domainIds, char** itemIds, int valuesCount,
+		ByteBuffer* writeBuffer);
+
+/* asynchronous read of variables of different domains - the handler receives an MMS_ARRAY */
+uint32_t
+mmsClient_readVariablesAsync(MmsConnection self, MmsError* mmsError, char** domainIds, char** itemIds,
+        int valuesCount, MmsReadResponseHandler handler, void* parameter);
+
 int
 mmsClient_createReadNamedVariableListRequest(uint32_t invokeId, char* domainId, char* itemId,
 		ByteBuffer* writeBuffer, bool specWithResult);
@@ -234,7 +347,8 @@ void
 mmsClient_createFileReadRequest(uint32_t invokeId, ByteBuffer* request, int32_t frsmId);
 
 bool
-mmsClient_parseFileReadResponse(MmsConnection self, int32_t frsmId, bool* moreFollows, MmsFileReadHandler handler, void* handlerParameter);
+mmsClient_parseFileReadResponse(ByteBuffer* message, int32_t bufPos, int32_t frsmId, bool* moreFollows,
+        MmsFileReadHandler handler, void* handlerParameter);
 
 void
 mmsClient_createFileCloseRequest(uint32_t invokeId, ByteBuffer* request, int32_t frsmId);
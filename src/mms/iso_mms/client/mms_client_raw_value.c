@@ -0,0 +1,259 @@
+/*
+ *  mms_client_raw_value.c
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+#include "mms_client_connection.h"
+#include "stack_config.h"
+
+#include "mms_client_internal.h"
+#include "mms_value_internal.h"
+
+static MmsType
+getTypeFromTag(uint8_t tag)
+{
+    switch (tag) {
+    case 0xa1:
+        return MMS_ARRAY;
+    case 0xa2:
+        return MMS_STRUCTURE;
+    case 0x83:
+        return MMS_BOOLEAN;
+    case 0x84:
+        return MMS_BIT_STRING;
+    case 0x85:
+        return MMS_INTEGER;
+    case 0x86:
+        return MMS_UNSIGNED;
+    case 0x87:
+        return MMS_FLOAT;
+    case 0x89:
+        return MMS_OCTET_STRING;
+    case 0x8a:
+        return MMS_VISIBLE_STRING;
+    case 0x8b:
+        return MMS_GENERALIZED_TIME;
+    case 0x8c:
+        return MMS_BINARY_TIME;
+    case 0x8d:
+        return MMS_BCD;
+    case 0x8f:
+        return MMS_OBJ_ID;
+    case 0x90:
+        return MMS_STRING;
+    case 0x91:
+        return MMS_UTC_TIME;
+    default: /* 0x80 - failure */
+        return MMS_DATA_ACCESS_ERROR;
+    }
+}
+
+int
+mmsClient_splitRawValues(uint8_t* buffer, int bufPos, int endPos, MmsRawValue* values, int maxValues)
+{
+    int valueCount = 0;
+    int length;
+
+    while (bufPos < endPos) {
+        uint8_t tag = buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+            return -1;
+
+        if (valueCount < maxValues) {
+            values[valueCount].type = getTypeFromTag(tag);
+            values[valueCount].tag = tag;
+            values[valueCount].buffer = buffer + bufPos;
+            values[valueCount].size = length;
+        }
+
+        bufPos += length;
+        valueCount++;
+    }
+
+    return valueCount;
+}
+
+MmsValue*
+MmsRawValue_toMmsValue(MmsRawValue* self)
+{
+    if (self->tag == 0x80) {
+        uint32_t errorCode = BerDecoder_decodeUint32(self->buffer, self->size, 0);
+
+        if ((self->size > 0) && (errorCode < 12))
+            return MmsValue_newDataAccessError((MmsDataAccessError) errorCode);
+        else
+            return MmsValue_newDataAccessError(DATA_ACCESS_ERROR_UNKNOWN);
+    }
+
+    return mmsClient_decodeDataElement(self->tag, self->buffer, 0, self->size);
+}
+
+int
+MmsRawValue_getElementCount(MmsRawValue* self)
+{
+    if ((self->type != MMS_ARRAY) && (self->type != MMS_STRUCTURE))
+        return 0;
+
+    int elementCount = mmsClient_splitRawValues(self->buffer, 0, self->size, NULL, 0);
+
+    if (elementCount < 0)
+        return 0;
+
+    return elementCount;
+}
+
+bool
+MmsRawValue_getElement(MmsRawValue* self, int index, MmsRawValue* element)
+{
+    if ((self->type != MMS_ARRAY) && (self->type != MMS_STRUCTURE))
+        return false;
+
+    int bufPos = 0;
+    int length;
+    int elementIndex = 0;
+
+    while (bufPos < self->size) {
+        uint8_t tag = self->buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(self->buffer, &length, bufPos, self->size);
+
+        if ((bufPos < 0) || (length < 0) || (length > (self->size - bufPos)))
+            return false;
+
+        if (elementIndex == index) {
+            element->type = getTypeFromTag(tag);
+            element->tag = tag;
+            element->buffer = self->buffer + bufPos;
+            element->size = length;
+
+            return true;
+        }
+
+        bufPos += length;
+        elementIndex++;
+    }
+
+    return false;
+}
+
+bool
+MmsRawValue_getBoolean(MmsRawValue* self)
+{
+    if ((self->type == MMS_BOOLEAN) && (self->size > 0))
+        return BerDecoder_decodeBoolean(self->buffer, 0);
+
+    return false;
+}
+
+int64_t
+MmsRawValue_toInt64(MmsRawValue* self)
+{
+    int64_t value = 0;
+
+    if ((self->type == MMS_INTEGER) || (self->type == MMS_UNSIGNED)) {
+
+        /* sign extension */
+        if ((self->type == MMS_INTEGER) && (self->size > 0) && (self->buffer[0] & 0x80))
+            value = -1;
+
+        int i;
+        for (i = 0; i < self->size; i++)
+            value = (int64_t) (((uint64_t) value << 8) | self->buffer[i]);
+    }
+
+    return value;
+}
+
+uint32_t
+MmsRawValue_toUint32(MmsRawValue* self)
+{
+    if ((self->type == MMS_INTEGER) || (self->type == MMS_UNSIGNED))
+        return (uint32_t) MmsRawValue_toInt64(self);
+
+    return 0;
+}
+
+double
+MmsRawValue_toDouble(MmsRawValue* self)
+{
+    if (self->type == MMS_FLOAT) {
+        if (self->size == 5)
+            return (double) BerDecoder_decodeFloat(self->buffer, 0);
+
+        if (self->size == 9)
+            return BerDecoder_decodeDouble(self->buffer, 0);
+    }
+
+    return 0;
+}
+
+int
+MmsRawValue_getBitStringSize(MmsRawValue* self)
+{
+    if ((self->type == MMS_BIT_STRING) && (self->size > 0)) {
+        int bitStringSize = ((self->size - 1) * 8) - self->buffer[0];
+
+        /* invalid padding (more than 7 bits or padding of an empty bit string) */
+        if ((self->buffer[0] < 8) && (bitStringSize >= 0))
+            return bitStringSize;
+    }
+
+    return 0;
+}
+
+bool
+MmsRawValue_getBitStringBit(MmsRawValue* self, int bitPos)
+{
+    if ((bitPos >= 0) && (bitPos < MmsRawValue_getBitStringSize(self))) {
+        uint8_t bitMask = (uint8_t) (1 << (7 - (bitPos % 8)));
+
+        return ((self->buffer[1 + (bitPos / 8)] & bitMask) != 0);
+    }
+
+    return false; /* out of range bits are always zero */
+}
+
+uint64_t
+MmsRawValue_getTimeInMs(MmsRawValue* self)
+{
+    MmsValue value;
+
+    if ((self->type == MMS_UTC_TIME) && (self->size == 8)) {
+        value.type = MMS_UTC_TIME;
+        memcpy(value.value.utcTime, self->buffer, 8);
+
+        return MmsValue_getUtcTimeInMs(&value);
+    }
+
+    if ((self->type == MMS_BINARY_TIME) && ((self->size == 4) || (self->size == 6))) {
+        value.type = MMS_BINARY_TIME;
+        value.value.binaryTime.size = self->size;
+        memcpy(value.value.binaryTime.buf, self->buffer, self->size);
+
+        return MmsValue_getBinaryTimeAsUtcMs(&value);
+    }
+
+    return 0;
+}
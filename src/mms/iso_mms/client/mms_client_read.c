@@ -34,6 +34,9 @@
 #include "mms_common_internal.h"
 #include "mms_value_internal.h"
 
+/* maximum nesting level of arrays and structures accepted by the decoder - protects the stack against malicious messages */
+#define MMS_CLIENT_MAX_DECODE_DEPTH 32
+
 MmsValue*
 mmsClient_parseListOfAccessResults(AccessResult_t** accessResultList, int listSize, bool createArray)
 {
@@ -171,13 +174,14 @@ mmsClient_parseListOfAccessResults(AccessResult_t** accessResultList, int listSi
 
             int strSize = accessResultList[i]->choice.visiblestring.size;
 
-            value->value.visibleString = (char*) malloc(strSize + 1);
+            value->value.visibleString.buf = (char*) malloc(strSize + 1);
+            value->value.visibleString.size = strSize + 1;
 
-            memcpy(value->value.visibleString,
+            memcpy(value->value.visibleString.buf,
                     accessResultList[i]->choice.visiblestring.buf,
                     strSize);
 
-            value->value.visibleString[strSize] = 0;
+            value->value.visibleString.buf[strSize] = 0;
         }
         else if (presentType == AccessResult_PR_mMSString) {
         	value = (MmsValue*) calloc(1, sizeof(MmsValue));
@@ -186,12 +190,13 @@ mmsClient_parseListOfAccessResults(AccessResult_t** accessResultList, int listSi
 
         	int strSize = accessResultList[i]->choice.mMSString.size;
 
-        	value->value.visibleString = (char*) malloc(strSize + 1);
+        	value->value.visibleString.buf = (char*) malloc(strSize + 1);
+        	value->value.visibleString.size = strSize + 1;
 
-        	memcpy(value->value.visibleString,
+        	memcpy(value->value.visibleString.buf,
         			accessResultList[i]->choice.mMSString.buf, strSize);
 
-        	value->value.visibleString[strSize] = 0;
+        	value->value.visibleString.buf[strSize] = 0;
 
         }
         else if (presentType == AccessResult_PR_utctime) {
@@ -239,6 +244,509 @@ mmsClient_parseListOfAccessResults(AccessResult_t** accessResultList, int listSi
     return valueList;
 }
 
+/*
+ * Direct BER decoding of the MMS Data type. Builds the MmsValue tree from the message buffer
+ * without decoding the message into the asn1c structures first.
+ */
+
+/* returns the number of TLV elements between bufPos and endPos or -1 if the elements are malformed */
+static int
+countDataElements(uint8_t* buffer, int bufPos, int endPos)
+{
+    int elementCount = 0;
+    int length;
+
+    while (bufPos < endPos) {
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos + 1, endPos);
+
+        if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+            return -1;
+
+        bufPos += length;
+        elementCount++;
+    }
+
+    return elementCount;
+}
+
+static MmsValue*
+decodeDataElement(uint8_t tag, uint8_t* buffer, int bufPos, int length, int depth);
+
+static MmsValue*
+decodeConstructedData(MmsType type, uint8_t* buffer, int bufPos, int endPos, int depth)
+{
+    if (depth >= MMS_CLIENT_MAX_DECODE_DEPTH) {
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: maximum nesting level of data exceeded\n");
+
+        return NULL;
+    }
+
+    int elementCount = countDataElements(buffer, bufPos, endPos);
+
+    if (elementCount < 0)
+        return NULL;
+
+    MmsValue* value = (MmsValue*) calloc(1, sizeof(MmsValue));
+    value->type = type;
+    value->value.structure.size = elementCount;
+    value->value.structure.components = (MmsValue**) calloc(elementCount, sizeof(MmsValue*));
+
+    int i = 0;
+    int length;
+
+    while (bufPos < endPos) {
+        uint8_t tag = buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        MmsValue* element = decodeDataElement(tag, buffer, bufPos, length, depth + 1);
+
+        if (element == NULL) {
+            MmsValue_delete(value);
+            return NULL;
+        }
+
+        value->value.structure.components[i++] = element;
+
+        bufPos += length;
+    }
+
+    return value;
+}
+
+static MmsValue*
+decodeFloat(uint8_t* buffer, int bufPos, int length)
+{
+    int formatWidth;
+
+    if (length == 5)
+        formatWidth = 32;
+    else if (length == 9)
+        formatWidth = 64;
+    else
+        return NULL;
+
+    MmsValue* value = (MmsValue*) calloc(1, sizeof(MmsValue));
+    value->type = MMS_FLOAT;
+    value->value.floatingPoint.formatWidth = formatWidth;
+    value->value.floatingPoint.exponentWidth = buffer[bufPos];
+    value->value.floatingPoint.buf = (uint8_t*) malloc(length - 1);
+
+#if (ORDER_LITTLE_ENDIAN == 1)
+    memcpyReverseByteOrder(value->value.floatingPoint.buf, buffer + bufPos + 1, length - 1);
+#else
+    memcpy(value->value.floatingPoint.buf, buffer + bufPos + 1, length - 1);
+#endif
+
+    return value;
+}
+
+static MmsValue*
+decodeString(MmsType type, uint8_t* buffer, int bufPos, int length)
+{
+    MmsValue* value = (MmsValue*) calloc(1, sizeof(MmsValue));
+    value->type = type;
+    value->value.visibleString.buf = (char*) malloc(length + 1);
+    value->value.visibleString.size = length + 1;
+    memcpy(value->value.visibleString.buf, buffer + bufPos, length);
+    value->value.visibleString.buf[length] = 0;
+
+    return value;
+}
+
+/* decode the content of a Data element. Returns NULL if the element is malformed or nested too deeply */
+static MmsValue*
+decodeDataElement(uint8_t tag, uint8_t* buffer, int bufPos, int length, int depth)
+{
+    MmsValue* value = NULL;
+
+    switch (tag) {
+    case 0xa1: /* array */
+        value = decodeConstructedData(MMS_ARRAY, buffer, bufPos, bufPos + length, depth);
+        break;
+
+    case 0xa2: /* structure */
+        value = decodeConstructedData(MMS_STRUCTURE, buffer, bufPos, bufPos + length, depth);
+        break;
+
+    case 0x83: /* boolean */
+        if (length > 0)
+            value = MmsValue_newBoolean(BerDecoder_decodeBoolean(buffer, bufPos));
+        break;
+
+    case 0x84: /* bit string */
+        /* an empty bit string has no padding bits */
+        if ((length > 0) && (buffer[bufPos] < 8) && ((length > 1) || (buffer[bufPos] == 0))) {
+            value = (MmsValue*) calloc(1, sizeof(MmsValue));
+            value->type = MMS_BIT_STRING;
+            value->value.bitString.size = ((length - 1) * 8) - buffer[bufPos];
+            value->value.bitString.buf = (uint8_t*) malloc(length - 1);
+            memcpy(value->value.bitString.buf, buffer + bufPos + 1, length - 1);
+        }
+        break;
+
+    case 0x85: /* integer */
+        value = MmsValue_newIntegerFromBerInteger(BerInteger_createFromBuffer(buffer + bufPos, length));
+        break;
+
+    case 0x86: /* unsigned */
+        value = MmsValue_newUnsignedFromBerInteger(BerInteger_createFromBuffer(buffer + bufPos, length));
+        break;
+
+    case 0x87: /* floating point */
+        value = decodeFloat(buffer, bufPos, length);
+        break;
+
+    case 0x89: /* octet string */
+        value = (MmsValue*) calloc(1, sizeof(MmsValue));
+        value->type = MMS_OCTET_STRING;
+        value->value.octetString.size = length;
+        value->value.octetString.maxSize = length;
+        value->value.octetString.buf = (uint8_t*) malloc(length);
+        memcpy(value->value.octetString.buf, buffer + bufPos, length);
+        break;
+
+    case 0x8a: /* visible string */
+        value = decodeString(MMS_VISIBLE_STRING, buffer, bufPos, length);
+        break;
+
+    case 0x8c: /* binary time */
+        if (length <= 6) {
+            value = (MmsValue*) calloc(1, sizeof(MmsValue));
+            value->type = MMS_BINARY_TIME;
+            value->value.binaryTime.size = length;
+            memcpy(value->value.binaryTime.buf, buffer + bufPos, length);
+        }
+        break;
+
+    case 0x90: /* MMS string */
+        value = decodeString(MMS_STRING, buffer, bufPos, length);
+        break;
+
+    case 0x91: /* UTC time */
+        if (length == 8) {
+            value = (MmsValue*) calloc(1, sizeof(MmsValue));
+            value->type = MMS_UTC_TIME;
+            memcpy(value->value.utcTime, buffer + bufPos, 8);
+        }
+        break;
+
+    default:
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: unsupported data type (tag %02x)\n", tag);
+
+        value = MmsValue_newDataAccessError(DATA_ACCESS_ERROR_OBJECT_VALUE_INVALID);
+        break;
+    }
+
+    return value;
+}
+
+MmsValue*
+mmsClient_decodeDataElement(uint8_t tag, uint8_t* buffer, int bufPos, int length)
+{
+    return decodeDataElement(tag, buffer, bufPos, length, 0);
+}
+
+MmsValue*
+mmsClient_decodeListOfAccessResults(uint8_t* buffer, int bufPos, int endPos, bool createArray)
+{
+    int elementCount = countDataElements(buffer, bufPos, endPos);
+
+    if (elementCount < 0)
+        return NULL;
+
+    MmsValue* valueList = NULL;
+    MmsValue* value = NULL;
+
+    if ((elementCount > 1) || createArray)
+        valueList = MmsValue_createEmtpyArray(elementCount);
+
+    int i = 0;
+    int length;
+
+    while (bufPos < endPos) {
+        uint8_t tag = buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        if (tag == 0x80) { /* failure */
+            uint32_t errorCode = BerDecoder_decodeUint32(buffer, length, bufPos);
+
+            if (DEBUG_MMS_CLIENT) printf("access error!\n");
+
+            if ((length > 0) && (errorCode < 12))
+                value = MmsValue_newDataAccessError((MmsDataAccessError) errorCode);
+            else
+                value = MmsValue_newDataAccessError(DATA_ACCESS_ERROR_UNKNOWN);
+        }
+        else {
+            value = mmsClient_decodeDataElement(tag, buffer, bufPos, length);
+
+            if (value == NULL) {
+                if (valueList != NULL)
+                    MmsValue_delete(valueList);
+
+                return NULL;
+            }
+        }
+
+        if (valueList != NULL)
+            MmsValue_setElement(valueList, i, value);
+
+        bufPos += length;
+        i++;
+    }
+
+    if (valueList == NULL)
+        valueList = value;
+
+    return valueList;
+}
+
+
+/*
+ * Update-in-place decoding of the MMS Data type. The values are written into an existing MmsValue
+ * of the same structure. Memory is only allocated when an integer or a string does not fit into
+ * the existing buffer.
+ */
+
+static bool
+updateConstructedData(MmsValue* value, uint8_t* buffer, int bufPos, int endPos)
+{
+    int elementCount = value->value.structure.size;
+    int i = 0;
+    int length;
+
+    while (bufPos < endPos) {
+        if (i == elementCount)
+            return false;
+
+        uint8_t tag = buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+            return false;
+
+        MmsValue* element = value->value.structure.components[i];
+
+        if ((element == NULL) || (mmsClient_updateDataElement(element, tag, buffer, bufPos, length) == false))
+            return false;
+
+        bufPos += length;
+        i++;
+    }
+
+    return (i == elementCount);
+}
+
+static bool
+updateInteger(MmsValue* value, uint8_t* buffer, int bufPos, int length)
+{
+    Asn1PrimitiveValue* integer = value->value.integer;
+
+    if ((length < 1) || (length > 255))
+        return false;
+
+    if (length > integer->maxSize) {
+        free(integer->octets);
+        integer->octets = (uint8_t*) malloc(length);
+        integer->maxSize = length;
+    }
+
+    memcpy(integer->octets, buffer + bufPos, length);
+    integer->size = length;
+
+    return true;
+}
+
+static void
+updateString(MmsValue* value, uint8_t* buffer, int bufPos, int length)
+{
+    if ((value->value.visibleString.buf == NULL) || (value->value.visibleString.size <= length)) {
+        if (value->value.visibleString.buf != NULL)
+            free(value->value.visibleString.buf);
+
+        value->value.visibleString.buf = (char*) malloc(length + 1);
+        value->value.visibleString.size = length + 1;
+    }
+
+    memcpy(value->value.visibleString.buf, buffer + bufPos, length);
+    value->value.visibleString.buf[length] = 0;
+}
+
+/* write the content of a Data element into value. Returns false if the element is malformed or of another type */
+bool
+mmsClient_updateDataElement(MmsValue* value, uint8_t tag, uint8_t* buffer, int bufPos, int length)
+{
+    switch (tag) {
+    case 0xa1: /* array */
+        if (value->type != MMS_ARRAY)
+            return false;
+
+        return updateConstructedData(value, buffer, bufPos, bufPos + length);
+
+    case 0xa2: /* structure */
+        if (value->type != MMS_STRUCTURE)
+            return false;
+
+        return updateConstructedData(value, buffer, bufPos, bufPos + length);
+
+    case 0x83: /* boolean */
+        if ((value->type != MMS_BOOLEAN) || (length < 1))
+            return false;
+
+        value->value.boolean = BerDecoder_decodeBoolean(buffer, bufPos);
+        return true;
+
+    case 0x84: /* bit string */
+        if ((value->type != MMS_BIT_STRING) || (length < 1) || (buffer[bufPos] > 7))
+            return false;
+
+        /* an empty bit string has no padding bits */
+        if ((length == 1) && (buffer[bufPos] != 0))
+            return false;
+
+        if ((length - 1) != ((value->value.bitString.size + 7) / 8))
+            return false;
+
+        value->value.bitString.size = ((length - 1) * 8) - buffer[bufPos];
+        memcpy(value->value.bitString.buf, buffer + bufPos + 1, length - 1);
+        return true;
+
+    case 0x85: /* integer */
+        if (value->type != MMS_INTEGER)
+            return false;
+
+        return updateInteger(value, buffer, bufPos, length);
+
+    case 0x86: /* unsigned */
+        if (value->type != MMS_UNSIGNED)
+            return false;
+
+        return updateInteger(value, buffer, bufPos, length);
+
+    case 0x87: /* floating point */
+        if ((value->type != MMS_FLOAT) || (length != ((value->value.floatingPoint.formatWidth / 8) + 1)))
+            return false;
+
+        value->value.floatingPoint.exponentWidth = buffer[bufPos];
+
+#if (ORDER_LITTLE_ENDIAN == 1)
+        memcpyReverseByteOrder(value->value.floatingPoint.buf, buffer + bufPos + 1, length - 1);
+#else
+        memcpy(value->value.floatingPoint.buf, buffer + bufPos + 1, length - 1);
+#endif
+        return true;
+
+    case 0x89: /* octet string */
+        if ((value->type != MMS_OCTET_STRING) || (length > 0xffff))
+            return false;
+
+        if (length > value->value.octetString.maxSize) {
+            free(value->value.octetString.buf);
+            value->value.octetString.buf = (uint8_t*) malloc(length);
+            value->value.octetString.maxSize = length;
+        }
+
+        memcpy(value->value.octetString.buf, buffer + bufPos, length);
+        value->value.octetString.size = length;
+        return true;
+
+    case 0x8a: /* visible string */
+        if (value->type != MMS_VISIBLE_STRING)
+            return false;
+
+        updateString(value, buffer, bufPos, length);
+        return true;
+
+    case 0x8c: /* binary time */
+        if ((value->type != MMS_BINARY_TIME) || (length > 6))
+            return false;
+
+        value->value.binaryTime.size = length;
+        memcpy(value->value.binaryTime.buf, buffer + bufPos, length);
+        return true;
+
+    case 0x90: /* MMS string */
+        if (value->type != MMS_STRING)
+            return false;
+
+        updateString(value, buffer, bufPos, length);
+        return true;
+
+    case 0x91: /* UTC time */
+        if ((value->type != MMS_UTC_TIME) || (length != 8))
+            return false;
+
+        memcpy(value->value.utcTime, buffer + bufPos, 8);
+        return true;
+
+    default:
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: unsupported data type (tag %02x)\n", tag);
+
+        return false;
+    }
+}
+
+/* returns the position of the list of access results of a read response or -1 if the message is malformed */
+static int
+findListOfAccessResults(ByteBuffer* message, uint32_t* invokeId, int* endPos)
+{
+    uint8_t* buffer = ByteBuffer_getBuffer(message);
+    int maxBufPos = ByteBuffer_getSize(message);
+    int bufPos = 0;
+    int length;
+
+    if ((maxBufPos < 1) || (buffer[bufPos++] != 0xa1)) /* confirmed response PDU */
+        return -1;
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, maxBufPos);
+
+    if ((bufPos < 0) || (bufPos >= maxBufPos) || (buffer[bufPos++] != 0x02)) /* invoke ID */
+        return -1;
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, maxBufPos);
+
+    if ((bufPos < 0) || (length < 0) || (length > (maxBufPos - bufPos)))
+        return -1;
+
+    if (invokeId != NULL)
+        *invokeId = BerDecoder_decodeUint32(buffer, length, bufPos);
+
+    bufPos += length;
+
+    if ((bufPos >= maxBufPos) || (buffer[bufPos++] != 0xa4)) /* read response */
+        return -1;
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, maxBufPos);
+
+    if ((bufPos < 0) || (length < 0) || (length > (maxBufPos - bufPos)))
+        return -1;
+
+    int readResponseEndPos = bufPos + length;
+
+    while (bufPos < readResponseEndPos) {
+        uint8_t tag = buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, readResponseEndPos);
+
+        if ((bufPos < 0) || (length < 0) || (length > (readResponseEndPos - bufPos)))
+            return -1;
+
+        if (tag == 0xa1) { /* list of access results */
+            *endPos = bufPos + length;
+            return bufPos;
+        }
+
+        bufPos += length; /* ignore variable access specification */
+    }
+
+    return -1;
+}
 
 /*
  * \param createArray if multiple variables should be read (e.g. if a data set is read) an array should
@@ -247,34 +755,50 @@ mmsClient_parseListOfAccessResults(AccessResult_t** accessResultList, int listSi
 MmsValue*
 mmsClient_parseReadResponse(ByteBuffer* message, uint32_t* invokeId, bool createArray)
 {
-	MmsPdu_t* mmsPdu = 0; /* allow asn1c to allocate structure */
+    int endPos;
+    int bufPos = findListOfAccessResults(message, invokeId, &endPos);
 
-	MmsValue* valueList = NULL;
+    if (bufPos < 0)
+        return NULL;
 
-	asn_dec_rval_t rval = ber_decode(NULL, &asn_DEF_MmsPdu,
-			(void**) &mmsPdu, ByteBuffer_getBuffer(message), ByteBuffer_getSize(message));
+    return mmsClient_decodeListOfAccessResults(ByteBuffer_getBuffer(message), bufPos, endPos, createArray);
+}
 
-	if (rval.code != RC_OK)
-	    return NULL;
+MmsError
+mmsClient_parseReadResponseInto(ByteBuffer* message, uint32_t* invokeId, MmsValue* value)
+{
+    uint8_t* buffer = ByteBuffer_getBuffer(message);
+    int endPos;
+    int length;
 
-	if (mmsPdu->present == MmsPdu_PR_confirmedResponsePdu) {
+    int bufPos = findListOfAccessResults(message, invokeId, &endPos);
 
-	    if (invokeId != NULL)
-	        *invokeId = mmsClient_getInvokeId(&mmsPdu->choice.confirmedResponsePdu);
+    if ((bufPos < 0) || (bufPos >= endPos))
+        return MMS_ERROR_PARSING_RESPONSE;
 
-		if (mmsPdu->choice.confirmedResponsePdu.confirmedServiceResponse.present == ConfirmedServiceResponse_PR_read) {
-			ReadResponse_t* response = &(mmsPdu->choice.confirmedResponsePdu.confirmedServiceResponse.choice.read);
+    uint8_t tag = buffer[bufPos++];
 
-			int elementCount = response->listOfAccessResult.list.count;
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
 
-			valueList = mmsClient_parseListOfAccessResults(response->listOfAccessResult.list.array,
-			        elementCount, createArray);
-		}
-	}
+    /* exactly one access result is expected */
+    if ((bufPos < 0) || (length < 0) || ((bufPos + length) != endPos))
+        return MMS_ERROR_PARSING_RESPONSE;
 
-	asn_DEF_MmsPdu.free_struct(&asn_DEF_MmsPdu, mmsPdu, 0);
+    if (tag == 0x80) { /* failure */
+        if (length < 1)
+            return MMS_ERROR_OTHER;
+
+        return mmsClient_mapDataAccessErrorToMmsError(BerDecoder_decodeUint32(buffer, length, bufPos));
+    }
+
+    if (mmsClient_updateDataElement(value, tag, buffer, bufPos, length) == false) {
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CLIENT: read response does not match the type of the value\n");
 
-	return valueList;
+        return MMS_ERROR_PARSING_RESPONSE;
+    }
+
+    return MMS_ERROR_NONE;
 }
 
 
@@ -563,3 +1087,42 @@ mmsClient_createReadRequestMultipleValues(uint32_t invokeId, char* domainId, Lin
 	return rval.encoded;
 }
 
+
+/**
+ * Request multiple values of different domains
+ */
+int
+mmsClient_createReadRequestMultipleDomains(uint32_t invokeId, char** domainIds, char** itemIds, int valuesCount,
+		ByteBuffer* writeBuffer)
+{
+	MmsPdu_t* mmsPdu = mmsClient_createConfirmedRequestPdu(invokeId);
+
+	ReadRequest_t* readRequest = createReadRequest(mmsPdu);
+
+	readRequest->specificationWithResult = NULL;
+
+	ListOfVariableSeq_t** listOfVars = createListOfVariables(readRequest, valuesCount);
+
+	int i;
+
+	for (i = 0; i < valuesCount; i++)
+		listOfVars[i] = createVariableIdentifier(domainIds[i], itemIds[i]);
+
+	asn_enc_rval_t rval;
+
+	rval = der_encode(&asn_DEF_MmsPdu, mmsPdu,
+		(asn_app_consume_bytes_f*) mmsClient_write_out, (void*) writeBuffer);
+
+	for (i = 0; i < valuesCount; i++) {
+		free(listOfVars[i]);
+	}
+	free(listOfVars);
+
+	readRequest->variableAccessSpecification.choice.listOfVariable.list.count = 0;
+	readRequest->variableAccessSpecification.choice.listOfVariable.list.size = 0;
+	readRequest->variableAccessSpecification.choice.listOfVariable.list.array = NULL;
+
+	asn_DEF_MmsPdu.free_struct(&asn_DEF_MmsPdu, mmsPdu, 0);
+
+	return rval.encoded;
+}
@@ -0,0 +1,390 @@
+/*
+ *  mms_client_read_plan.c
+ *
+ *  Reads many variables with a minimal number of pipelined read requests.
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+
+#include "mms_read_plan.h"
+
+#include "stack_config.h"
+#include "mms_client_internal.h"
+#include "mms_access_result.h"
+#include "thread.h"
+#include "hal.h"
+
+#ifndef DEBUG_MMS_CLIENT
+#define DEBUG_MMS_CLIENT 0
+#endif
+
+/* estimated encoded size of a value that has not been read before */
+#define READ_PLAN_DEFAULT_VALUE_SIZE 32
+
+/* maximum size of the PDU without the variables or values */
+#define READ_PLAN_PDU_OVERHEAD 32
+
+/* maximum encoding size of a variable specification without the names */
+#define READ_PLAN_VARIABLE_OVERHEAD 12
+
+struct sMmsReadPlan {
+    int size;
+    int maxSize;
+
+    char** domainIds;
+    char** itemIds;
+    int* estimatedSizes;
+    MmsValue** values;
+
+    Condition condition; /* protects and signals the state of an execution */
+    MmsConnection connection;
+    int maxPduSize;
+    int pendingRequests;
+    int requestCount;
+    int readValues;
+    MmsError lastError;
+};
+
+typedef struct {
+    MmsReadPlan plan;
+    int first;
+    int count;
+} ReadPlanRequest;
+
+MmsReadPlan
+MmsReadPlan_create()
+{
+    MmsReadPlan self = (MmsReadPlan) calloc(1, sizeof(struct sMmsReadPlan));
+
+    self->condition = Condition_create();
+
+    return self;
+}
+
+int
+MmsReadPlan_addVariable(MmsReadPlan self, char* domainId, char* itemId)
+{
+    if (self->size == self->maxSize) {
+        if (self->maxSize == 0)
+            self->maxSize = 16;
+        else
+            self->maxSize = self->maxSize * 2;
+
+        self->domainIds = (char**) realloc(self->domainIds, self->maxSize * sizeof(char*));
+        self->itemIds = (char**) realloc(self->itemIds, self->maxSize * sizeof(char*));
+        self->estimatedSizes = (int*) realloc(self->estimatedSizes, self->maxSize * sizeof(int));
+        self->values = (MmsValue**) realloc(self->values, self->maxSize * sizeof(MmsValue*));
+    }
+
+    int index = self->size;
+
+    self->domainIds[index] = copyString(domainId);
+    self->itemIds[index] = copyString(itemId);
+    self->estimatedSizes[index] = READ_PLAN_DEFAULT_VALUE_SIZE;
+    self->values[index] = NULL;
+
+    self->size++;
+
+    return index;
+}
+
+int
+MmsReadPlan_getSize(MmsReadPlan self)
+{
+    return self->size;
+}
+
+char*
+MmsReadPlan_getDomainId(MmsReadPlan self, int index)
+{
+    if ((index < 0) || (index >= self->size))
+        return NULL;
+
+    return self->domainIds[index];
+}
+
+char*
+MmsReadPlan_getItemId(MmsReadPlan self, int index)
+{
+    if ((index < 0) || (index >= self->size))
+        return NULL;
+
+    return self->itemIds[index];
+}
+
+MmsValue*
+MmsReadPlan_getValue(MmsReadPlan self, int index)
+{
+    if ((index < 0) || (index >= self->size))
+        return NULL;
+
+    return self->values[index];
+}
+
+int
+MmsReadPlan_getRequestCount(MmsReadPlan self)
+{
+    return self->requestCount;
+}
+
+static void
+deleteValues(MmsReadPlan self)
+{
+    int i;
+
+    for (i = 0; i < self->size; i++) {
+        if (self->values[i] != NULL) {
+            MmsValue_delete(self->values[i]);
+            self->values[i] = NULL;
+        }
+    }
+}
+
+void
+MmsReadPlan_destroy(MmsReadPlan self)
+{
+    deleteValues(self);
+
+    int i;
+
+    for (i = 0; i < self->size; i++) {
+        free(self->domainIds[i]);
+        free(self->itemIds[i]);
+    }
+
+    free(self->domainIds);
+    free(self->itemIds);
+    free(self->estimatedSizes);
+    free(self->values);
+
+    Condition_destroy(self->condition);
+
+    free(self);
+}
+
+static void
+readResponseHandler(uint32_t invokeId, void* parameter, MmsError mmsError, MmsValue* value);
+
+/* has to be called without holding the lock - the handler can be called by the calling thread */
+static void
+sendRequest(MmsReadPlan self, int first, int count)
+{
+    ReadPlanRequest* request = (ReadPlanRequest*) malloc(sizeof(ReadPlanRequest));
+
+    request->plan = self;
+    request->first = first;
+    request->count = count;
+
+    Condition_lock(self->condition);
+    self->pendingRequests++;
+    self->requestCount++;
+    Condition_unlock(self->condition);
+
+    if (DEBUG_MMS_CLIENT)
+        printf("MMS_CLIENT: read plan: request for %i variables starting at %i\n", count, first);
+
+    MmsError mmsError;
+
+    if (mmsClient_readVariablesAsync(self->connection, &mmsError, self->domainIds + first, self->itemIds + first,
+            count, readResponseHandler, request) == 0)
+    {
+        free(request);
+
+        Condition_lock(self->condition);
+        self->lastError = mmsError;
+        self->pendingRequests--;
+        Condition_broadcast(self->condition);
+        Condition_unlock(self->condition);
+    }
+}
+
+static bool
+isSplittableError(MmsError mmsError)
+{
+    /* confirmed errors and rejects (e.g. if the response would exceed the PDU size) */
+    return ((mmsError == MMS_ERROR_PARSING_RESPONSE) || (mmsError >= MMS_ERROR_VMDSTATE_OTHER));
+}
+
+static void
+readResponseHandler(uint32_t invokeId, void* parameter, MmsError mmsError, MmsValue* value)
+{
+    ReadPlanRequest* request = (ReadPlanRequest*) parameter;
+    MmsReadPlan self = request->plan;
+
+    (void) invokeId;
+
+    bool split = false;
+
+    Condition_lock(self->condition);
+
+    if ((value != NULL) && (MmsValue_getType(value) == MMS_ARRAY) && ((int) MmsValue_getArraySize(value) == request->count)) {
+        int i;
+
+        for (i = 0; i < request->count; i++) {
+            MmsValue* element = MmsValue_getElement(value, i);
+
+            /* take the element out of the response */
+            MmsValue_setElement(value, i, NULL);
+
+            self->values[request->first + i] = element;
+            self->estimatedSizes[request->first + i] = mmsServer_encodeAccessResult(element, NULL, 0, false);
+        }
+
+        self->readValues += request->count;
+    }
+    else {
+        if (value != NULL)
+            mmsError = MMS_ERROR_PARSING_RESPONSE;
+
+        if ((request->count > 1) && isSplittableError(mmsError)) {
+            int i;
+
+            /* the response is probably too large -> the variables are not grouped that way again */
+            int minimumSize = (self->maxPduSize / request->count) + 1;
+
+            for (i = request->first; i < request->first + request->count; i++) {
+                if (self->estimatedSizes[i] < minimumSize)
+                    self->estimatedSizes[i] = minimumSize;
+            }
+
+            split = true;
+        }
+        else {
+            if (DEBUG_MMS_CLIENT)
+                printf("MMS_CLIENT: read plan: request failed (error %i)\n", mmsError);
+
+            self->lastError = mmsError;
+        }
+    }
+
+    /* the parts of a split request are sent before the request is completed */
+    if (split == false) {
+        self->pendingRequests--;
+
+        if (self->pendingRequests == 0)
+            Condition_broadcast(self->condition);
+    }
+
+    Condition_unlock(self->condition);
+
+    if (value != NULL)
+        MmsValue_delete(value);
+
+    if (split) {
+        int firstCount = request->count / 2;
+
+        sendRequest(self, request->first, firstCount);
+        sendRequest(self, request->first + firstCount, request->count - firstCount);
+
+        Condition_lock(self->condition);
+        self->pendingRequests--;
+
+        if (self->pendingRequests == 0)
+            Condition_broadcast(self->condition);
+
+        Condition_unlock(self->condition);
+    }
+
+    free(request);
+}
+
+static int
+getVariableRequestSize(MmsReadPlan self, int index)
+{
+    return strlen(self->domainIds[index]) + strlen(self->itemIds[index]) + READ_PLAN_VARIABLE_OVERHEAD;
+}
+
+int
+MmsReadPlan_execute(MmsReadPlan self, MmsConnection connection, MmsError* mmsError)
+{
+    deleteValues(self);
+
+    int maxPduSize = connection->parameters.maxPduSize;
+
+    /* the request and the response also have to fit into the local buffers */
+    if ((maxPduSize <= 0) || (maxPduSize > CONFIG_MMS_MAXIMUM_PDU_SIZE))
+        maxPduSize = CONFIG_MMS_MAXIMUM_PDU_SIZE;
+
+    self->connection = connection;
+    self->maxPduSize = maxPduSize;
+    self->pendingRequests = 0;
+    self->requestCount = 0;
+    self->readValues = 0;
+    self->lastError = MMS_ERROR_NONE;
+
+    int availableSize = maxPduSize - READ_PLAN_PDU_OVERHEAD;
+
+    int first = 0;
+    int requestSize = 0;
+    int responseSize = 0;
+    int i;
+
+    for (i = 0; i < self->size; i++) {
+        int variableRequestSize = getVariableRequestSize(self, i);
+
+        if ((i > first) && (((requestSize + variableRequestSize) > availableSize) ||
+                ((responseSize + self->estimatedSizes[i]) > availableSize)))
+        {
+            sendRequest(self, first, i - first);
+
+            first = i;
+            requestSize = 0;
+            responseSize = 0;
+        }
+
+        requestSize += variableRequestSize;
+        responseSize += self->estimatedSizes[i];
+    }
+
+    if (i > first)
+        sendRequest(self, first, i - first);
+
+    /* wait for the responses - timeouts are only checked by the connection when messages are exchanged */
+    uint32_t checkInterval = connection->requestTimeout;
+
+    if (checkInterval == 0)
+        checkInterval = 1000;
+
+    Condition_lock(self->condition);
+
+    while (self->pendingRequests > 0) {
+        if (Condition_waitUntil(self->condition, Hal_getTimeInMs() + checkInterval) == false) {
+            Condition_unlock(self->condition);
+
+            MmsConnection_checkTimeouts(connection);
+
+            Condition_lock(self->condition);
+        }
+    }
+
+    *mmsError = self->lastError;
+
+    int readValues = self->readValues;
+
+    Condition_unlock(self->condition);
+
+    if (DEBUG_MMS_CLIENT)
+        printf("MMS_CLIENT: read plan: %i of %i variables read with %i requests\n", readValues, self->size,
+                self->requestCount);
+
+    return readValues;
+}
@@ -39,9 +39,9 @@ createNewDomainVariableSpecification(char* domainId, char* itemId)
 	VariableSpecification_t* varSpec = calloc(1, sizeof(ListOfVariableSeq_t));
 	varSpec->present = VariableSpecification_PR_name;
 	varSpec->choice.name.present = ObjectName_PR_domainspecific;
-	varSpec->choice.name.choice.domainspecific.domainId.buf = domainId;
+	varSpec->choice.name.choice.domainspecific.domainId.buf = (uint8_t*) domainId;
 	varSpec->choice.name.choice.domainspecific.domainId.size = strlen(domainId);
-	varSpec->choice.name.choice.domainspecific.itemId.buf = itemId;
+	varSpec->choice.name.choice.domainspecific.itemId.buf = (uint8_t*) itemId;
 	varSpec->choice.name.choice.domainspecific.itemId.size = strlen(itemId);
 
 	return varSpec;
@@ -71,7 +71,7 @@ mmsClient_createUnconfirmedPDU(char* domainId, char* itemId, uint32_t time_stamp
 	listOfVars->alternateAccess = NULL;
 	listOfVars->variableSpecification.present = VariableSpecification_PR_name;
 	listOfVars->variableSpecification.choice.name.present = ObjectName_PR_domainspecific;
-	listOfVars->variableSpecification.choice.name.choice.domainspecific.domainId.buf = domainId;
+	listOfVars->variableSpecification.choice.name.choice.domainspecific.domainId.buf = (uint8_t*) domainId;
 	listOfVars->variableSpecification.choice.name.choice.domainspecific.domainId.size = strlen(domainId);
 	listOfVars->variableSpecification.choice.name.choice.domainspecific.itemId.buf = "Transfer_Report_ACK";
 	listOfVars->variableSpecification.choice.name.choice.domainspecific.itemId.size = strlen("Transfer_Report_ACK");
@@ -167,3 +167,250 @@ mmsClient_createUnconfirmedPDU(char* domainId, char* itemId, uint32_t time_stamp
 
 	return rval.encoded;
 }
+
+static void
+releaseInformationReportHeader(char** domainName, char** variableListName, LinkedList* attributes)
+{
+    if (*domainName != NULL) {
+        free(*domainName);
+        *domainName = NULL;
+    }
+
+    if (*variableListName != NULL) {
+        free(*variableListName);
+        *variableListName = NULL;
+    }
+
+    if (*attributes != NULL) {
+        LinkedList_destroy(*attributes);
+        *attributes = NULL;
+    }
+}
+
+/*
+ * decode the content of an ObjectName. Returns the item ID of domain specific names. The domain ID
+ * is returned when domainId is not NULL.
+ */
+static char*
+decodeObjectName(uint8_t* buffer, int bufPos, int endPos, char** domainId)
+{
+    int length;
+
+    if (bufPos >= endPos)
+        return NULL;
+
+    uint8_t tag = buffer[bufPos++];
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+    if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+        return NULL;
+
+    if ((tag == 0x80) || (tag == 0x82)) /* vmd-specific or aa-specific */
+        return createStringFromBuffer(buffer + bufPos, length);
+
+    if (tag == 0xa1) { /* domain-specific */
+        endPos = bufPos + length;
+
+        if ((bufPos >= endPos) || (buffer[bufPos++] != 0x1a)) /* domain ID */
+            return NULL;
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+            return NULL;
+
+        int domainIdPos = bufPos;
+        int domainIdLength = length;
+
+        bufPos += length;
+
+        if ((bufPos >= endPos) || (buffer[bufPos++] != 0x1a)) /* item ID */
+            return NULL;
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+            return NULL;
+
+        if (domainId != NULL)
+            *domainId = createStringFromBuffer(buffer + domainIdPos, domainIdLength);
+
+        return createStringFromBuffer(buffer + bufPos, length);
+    }
+
+    return NULL;
+}
+
+/*
+ * add the names of the variables of a list of variables to the attributes list. Returns the domain ID
+ * of the first variable if it is domain specific.
+ */
+static bool
+decodeListOfVariables(uint8_t* buffer, int bufPos, int endPos, LinkedList attributes, char** domainName)
+{
+    int length;
+
+    while (bufPos < endPos) {
+        if (buffer[bufPos++] != 0x30)
+            return false;
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+        if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+            return false;
+
+        int sequenceEnd = bufPos + length;
+
+        /* variable specification (only name is supported) - alternate access is ignored */
+        if ((bufPos >= sequenceEnd) || (buffer[bufPos++] != 0xa0))
+            return false;
+
+        bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, sequenceEnd);
+
+        if ((bufPos < 0) || (length < 0) || (length > (sequenceEnd - bufPos)))
+            return false;
+
+        char* itemName;
+
+        if (LinkedList_getNext(attributes) == NULL)
+            itemName = decodeObjectName(buffer, bufPos, bufPos + length, domainName);
+        else
+            itemName = decodeObjectName(buffer, bufPos, bufPos + length, NULL);
+
+        if (itemName == NULL)
+            return false;
+
+        LinkedList_add(attributes, itemName);
+
+        bufPos = sequenceEnd;
+    }
+
+    return true;
+}
+
+/*
+ * parse the variable access specification of an information report. Returns the position of the
+ * content of the list of access results.
+ */
+static bool
+parseInformationReportHeader(ByteBuffer* message, char** domainName, char** variableListName, LinkedList* attributes,
+        int* accessResultsPos, int* accessResultsEnd)
+{
+    uint8_t* buffer = ByteBuffer_getBuffer(message);
+    int maxBufPos = ByteBuffer_getSize(message);
+    int bufPos = 0;
+    int length;
+
+    bool isValid = false;
+
+    *domainName = NULL;
+    *variableListName = NULL;
+    *attributes = NULL;
+
+    if ((maxBufPos < 1) || (buffer[bufPos++] != 0xa3)) /* unconfirmed PDU */
+        return false;
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, maxBufPos);
+
+    if ((bufPos < 0) || (bufPos >= maxBufPos) || (buffer[bufPos++] != 0xa0)) /* information report */
+        return false;
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, maxBufPos);
+
+    if ((bufPos < 0) || (length < 0) || (length > (maxBufPos - bufPos)) || (length < 2))
+        return false;
+
+    int endPos = bufPos + length;
+
+    uint8_t tag = buffer[bufPos++];
+
+    bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+    if ((bufPos < 0) || (length < 0) || (length > (endPos - bufPos)))
+        return false;
+
+    if (tag == 0xa1) { /* variable list name */
+
+        /* Ignore domain and association specific information reports (not used by IEC 61850) */
+        if ((length > 0) && (buffer[bufPos] == 0x80)) {
+            *variableListName = decodeObjectName(buffer, bufPos, bufPos + length, NULL);
+            isValid = (*variableListName != NULL);
+        }
+    }
+    else if (tag == 0xa0) { /* list of variables */
+        *attributes = LinkedList_create();
+        isValid = decodeListOfVariables(buffer, bufPos, bufPos + length, *attributes, domainName);
+    }
+
+    bufPos += length;
+
+    if (isValid) {
+        isValid = false;
+
+        if ((bufPos < endPos) && (buffer[bufPos++] == 0xa0)) { /* list of access results */
+            bufPos = BerDecoder_decodeLength(buffer, &length, bufPos, endPos);
+
+            if ((bufPos >= 0) && (length >= 0) && (length <= (endPos - bufPos))) {
+                *accessResultsPos = bufPos;
+                *accessResultsEnd = bufPos + length;
+
+                isValid = true;
+            }
+        }
+    }
+
+    if (!isValid)
+        releaseInformationReportHeader(domainName, variableListName, attributes);
+
+    return isValid;
+}
+
+bool
+mmsClient_parseInformationReport(ByteBuffer* message, char** domainName, char** variableListName,
+        LinkedList* attributes, MmsValue** values)
+{
+    int bufPos;
+    int endPos;
+
+    *values = NULL;
+
+    if (parseInformationReportHeader(message, domainName, variableListName, attributes, &bufPos, &endPos)) {
+        *values = mmsClient_decodeListOfAccessResults(ByteBuffer_getBuffer(message), bufPos, endPos, true);
+
+        if (*values != NULL)
+            return true;
+
+        releaseInformationReportHeader(domainName, variableListName, attributes);
+    }
+
+    return false;
+}
+
+bool
+mmsClient_parseRawInformationReport(ByteBuffer* message, char** domainName, char** variableListName,
+        LinkedList* attributes, MmsRawValue** values, int* valuesSize, int* valueCount)
+{
+    int bufPos;
+    int endPos;
+
+    if (parseInformationReportHeader(message, domainName, variableListName, attributes, &bufPos, &endPos)) {
+        uint8_t* buffer = ByteBuffer_getBuffer(message);
+
+        *valueCount = mmsClient_splitRawValues(buffer, bufPos, endPos, *values, *valuesSize);
+
+        if (*valueCount > *valuesSize) {
+            *valuesSize = *valueCount;
+            *values = (MmsRawValue*) realloc(*values, *valuesSize * sizeof(MmsRawValue));
+
+            *valueCount = mmsClient_splitRawValues(buffer, bufPos, endPos, *values, *valuesSize);
+        }
+
+        if (*valueCount >= 0)
+            return true;
+
+        releaseInformationReportHeader(domainName, variableListName, attributes);
+    }
+
+    return false;
+}
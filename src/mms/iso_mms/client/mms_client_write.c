@@ -31,8 +31,8 @@
 
 #include "stack_config.h"
 
-static MmsError
-mapDataAccessErrorToMmsError(uint32_t dataAccessError)
+MmsError
+mmsClient_mapDataAccessErrorToMmsError(uint32_t dataAccessError)
 {
     switch (dataAccessError) {
     case 0:
@@ -164,7 +164,7 @@ mmsClient_parseWriteResponse(ByteBuffer* message, int32_t bufPos, MmsError* mmsE
             uint32_t dataAccessErrorCode =
                     BerDecoder_decodeUint32(buf, length, bufPos);
 
-            *mmsError = mapDataAccessErrorToMmsError(dataAccessErrorCode);
+            *mmsError = mmsClient_mapDataAccessErrorToMmsError(dataAccessErrorCode);
         }
     }
     else
@@ -0,0 +1,775 @@
+/*
+ *  mms_connection_manager.c
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+
+#include "mms_connection_manager.h"
+
+#if defined(__linux__)
+
+#include "mms_client_internal.h"
+#include "iso_client_connection.h"
+#include "socket.h"
+#include "thread.h"
+#include "hal.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#define TIMER_TICK_MS 10
+#define TIMER_WHEEL_SLOTS 512 /* timers up to 5.12 s in the future are found without additional rounds */
+
+#define DEFAULT_MIN_RECONNECT_INTERVAL 1000
+#define DEFAULT_MAX_RECONNECT_INTERVAL 60000
+
+#define CONNECTION_STATE_IDLE 0 /* waiting for the next connect attempt */
+#define CONNECTION_STATE_CONNECTING 1
+#define CONNECTION_STATE_CONNECTED 2
+#define CONNECTION_STATE_REMOVED 3
+
+typedef struct sManagedConnection* ManagedConnection;
+
+typedef struct sManagerTimer* ManagerTimer;
+
+struct sManagerTimer {
+    ManagerTimer next;
+    ManagerTimer prev;
+    ManagerTimer nextExpired; /* list of expired timers while they are processed */
+    uint64_t expiry; /* monotonic time in ms */
+    bool armed;
+    void (*handler) (ManagedConnection connection);
+    ManagedConnection connection;
+};
+
+struct sManagedConnection {
+    MmsConnectionManager manager;
+    MmsConnection connection;
+    char* hostname;
+    int tcpPort;
+
+    MmsConnectionStateHandler stateHandler;
+    void* stateHandlerParameter;
+
+    /* serializes the processing of incoming messages, timers, connect attempts and the removal */
+    Semaphore lock;
+
+    int state;
+    int socketFd;
+    uint32_t reconnectInterval;
+    uint32_t reconnectJitter;
+
+    struct sManagerTimer requestTimer;
+    struct sManagerTimer reconnectTimer;
+
+    ManagedConnection nextConnectRequest;
+};
+
+struct sMmsConnectionManager {
+    int epollFd;
+    int eventFd; /* signaled to stop the I/O threads */
+    int timerFd;
+    volatile bool running;
+
+    int numberOfIoThreads;
+    Thread* ioThreads;
+
+    int numberOfConnectThreads;
+    Thread* connectThreads;
+
+    Semaphore connectionsLock;
+    LinkedList /* <ManagedConnection> */ connections; /* removed connections are kept until destroy */
+
+    Semaphore connectQueueLock;
+    Semaphore connectQueueSignal;
+    ManagedConnection connectQueueHead;
+    ManagedConnection connectQueueTail;
+
+    Semaphore timerLock;
+    ManagerTimer timerWheel[TIMER_WHEEL_SLOTS];
+    uint64_t lastTick; /* all slots up to this tick have been processed */
+
+    uint32_t minReconnectInterval;
+    uint32_t maxReconnectInterval;
+};
+
+/*******************************************************************************
+ * timer wheel
+ *******************************************************************************/
+
+/* the wheel uses a monotonic time base like the timerfd that ticks it - a step of the system
+ * time (Hal_getTimeInMs) must not stall the timers */
+static uint64_t
+getMonotonicTimeInMs(void)
+{
+    return Hal_getMonotonicTimeInNs() / 1000000;
+}
+
+/* converts a time stamp of the MmsConnection (Hal_getTimeInMs) to the monotonic time of the wheel */
+static uint64_t
+toMonotonicTime(uint64_t timeInMs)
+{
+    uint64_t currentTime = Hal_getTimeInMs();
+    uint64_t delay = 0;
+
+    if (timeInMs > currentTime)
+        delay = timeInMs - currentTime;
+
+    return getMonotonicTimeInMs() + delay;
+}
+
+/* has to be called with the timerLock */
+static void
+unlinkTimer(MmsConnectionManager self, ManagerTimer timer)
+{
+    if (timer->prev != NULL)
+        timer->prev->next = timer->next;
+    else
+        self->timerWheel[(timer->expiry + TIMER_TICK_MS - 1) / TIMER_TICK_MS % TIMER_WHEEL_SLOTS] = timer->next;
+
+    if (timer->next != NULL)
+        timer->next->prev = timer->prev;
+
+    timer->armed = false;
+}
+
+/* start the timer - a timer that is already running is only changed when the new expiry is earlier */
+static void
+armTimer(MmsConnectionManager self, ManagerTimer timer, uint64_t expiry)
+{
+    Semaphore_wait(self->timerLock);
+
+    if (timer->armed) {
+        if (timer->expiry <= expiry) {
+            Semaphore_post(self->timerLock);
+            return;
+        }
+
+        unlinkTimer(self, timer);
+    }
+
+    /* timers that are already expired are handled with the next tick */
+    if ((expiry + TIMER_TICK_MS - 1) / TIMER_TICK_MS <= self->lastTick)
+        expiry = (self->lastTick + 1) * TIMER_TICK_MS;
+
+    int slot = (expiry + TIMER_TICK_MS - 1) / TIMER_TICK_MS % TIMER_WHEEL_SLOTS;
+
+    timer->expiry = expiry;
+    timer->armed = true;
+    timer->prev = NULL;
+    timer->next = self->timerWheel[slot];
+
+    if (timer->next != NULL)
+        timer->next->prev = timer;
+
+    self->timerWheel[slot] = timer;
+
+    Semaphore_post(self->timerLock);
+}
+
+static void
+cancelTimer(MmsConnectionManager self, ManagerTimer timer)
+{
+    Semaphore_wait(self->timerLock);
+
+    if (timer->armed)
+        unlinkTimer(self, timer);
+
+    Semaphore_post(self->timerLock);
+}
+
+static void
+processTimers(MmsConnectionManager self)
+{
+    uint64_t currentTime = getMonotonicTimeInMs();
+    uint64_t currentTick = currentTime / TIMER_TICK_MS;
+
+    ManagerTimer expiredTimers = NULL;
+
+    Semaphore_wait(self->timerLock);
+
+    /* after a long delay every slot is only visited once */
+    if (currentTick > self->lastTick + TIMER_WHEEL_SLOTS)
+        self->lastTick = currentTick - TIMER_WHEEL_SLOTS;
+
+    while (self->lastTick < currentTick) {
+        self->lastTick++;
+
+        ManagerTimer timer = self->timerWheel[self->lastTick % TIMER_WHEEL_SLOTS];
+
+        while (timer != NULL) {
+            ManagerTimer next = timer->next;
+
+            /* timers of later rounds stay in the slot */
+            if (timer->expiry <= currentTime) {
+                unlinkTimer(self, timer);
+                timer->nextExpired = expiredTimers;
+                expiredTimers = timer;
+            }
+
+            timer = next;
+        }
+    }
+
+    Semaphore_post(self->timerLock);
+
+    /* the handlers are called without the lock because they can start timers */
+    while (expiredTimers != NULL) {
+        ManagerTimer timer = expiredTimers;
+
+        expiredTimers = timer->nextExpired;
+
+        timer->handler(timer->connection);
+    }
+}
+
+/*******************************************************************************
+ * connection handling
+ *******************************************************************************/
+
+static void
+addToConnectQueue(MmsConnectionManager self, ManagedConnection managedConnection)
+{
+    Semaphore_wait(self->connectQueueLock);
+
+    managedConnection->nextConnectRequest = NULL;
+
+    if (self->connectQueueTail == NULL)
+        self->connectQueueHead = managedConnection;
+    else
+        self->connectQueueTail->nextConnectRequest = managedConnection;
+
+    self->connectQueueTail = managedConnection;
+
+    Semaphore_post(self->connectQueueLock);
+
+    Semaphore_post(self->connectQueueSignal);
+}
+
+static ManagedConnection
+removeFromConnectQueue(MmsConnectionManager self)
+{
+    Semaphore_wait(self->connectQueueLock);
+
+    ManagedConnection managedConnection = self->connectQueueHead;
+
+    if (managedConnection != NULL) {
+        self->connectQueueHead = managedConnection->nextConnectRequest;
+
+        if (self->connectQueueHead == NULL)
+            self->connectQueueTail = NULL;
+    }
+
+    Semaphore_post(self->connectQueueLock);
+
+    return managedConnection;
+}
+
+/* has to be called with the lock of the connection */
+static void
+scheduleReconnect(ManagedConnection self)
+{
+    MmsConnectionManager manager = self->manager;
+
+    self->state = CONNECTION_STATE_IDLE;
+
+    uint32_t delay = self->reconnectInterval + (self->reconnectJitter % (self->reconnectInterval / 4 + 1));
+
+    armTimer(manager, &(self->reconnectTimer), getMonotonicTimeInMs() + delay);
+
+    self->reconnectInterval *= 2;
+
+    if (self->reconnectInterval > manager->maxReconnectInterval)
+        self->reconnectInterval = manager->maxReconnectInterval;
+}
+
+static void
+handleReconnectTimer(ManagedConnection self)
+{
+    Semaphore_wait(self->lock);
+
+    if (self->state == CONNECTION_STATE_IDLE) {
+        self->state = CONNECTION_STATE_CONNECTING;
+        addToConnectQueue(self->manager, self);
+    }
+
+    Semaphore_post(self->lock);
+}
+
+static void
+handleRequestTimer(ManagedConnection self)
+{
+    Semaphore_wait(self->lock);
+
+    if (self->state == CONNECTION_STATE_CONNECTED) {
+        MmsConnection_checkTimeouts(self->connection);
+
+        uint64_t nextTimeout = mmsClient_getNextRequestTimeout(self->connection);
+
+        if (nextTimeout != 0)
+            armTimer(self->manager, &(self->requestTimer), toMonotonicTime(nextTimeout));
+    }
+
+    Semaphore_post(self->lock);
+}
+
+/* called by the MmsConnection when an asynchronous request has been sent or queued */
+static void
+requestTimeoutScheduler(void* parameter, uint64_t timeout)
+{
+    ManagedConnection self = (ManagedConnection) parameter;
+
+    armTimer(self->manager, &(self->requestTimer), toMonotonicTime(timeout));
+}
+
+static void
+connectManagedConnection(MmsConnectionManager self, ManagedConnection managedConnection)
+{
+    bool connected = false;
+
+    Semaphore_wait(managedConnection->lock);
+
+    /* the connection may have been removed in the meantime */
+    if (managedConnection->state != CONNECTION_STATE_CONNECTING) {
+        Semaphore_post(managedConnection->lock);
+        return;
+    }
+
+    MmsError mmsError;
+
+    if (MmsConnection_connect(managedConnection->connection, &mmsError, managedConnection->hostname,
+            managedConnection->tcpPort))
+    {
+        Socket socket = IsoClientConnection_getSocket(managedConnection->connection->isoClient);
+
+        managedConnection->socketFd = Socket_getFileDescriptor(socket);
+
+        struct epoll_event event;
+
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.ptr = managedConnection;
+
+        if (epoll_ctl(self->epollFd, EPOLL_CTL_ADD, managedConnection->socketFd, &event) == 0) {
+            managedConnection->state = CONNECTION_STATE_CONNECTED;
+            managedConnection->reconnectInterval = self->minReconnectInterval;
+            connected = true;
+        }
+        else {
+            IsoClientConnection_close(managedConnection->connection->isoClient);
+            scheduleReconnect(managedConnection);
+        }
+    }
+    else {
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CONNECTION_MANAGER: failed to connect to %s:%i\n", managedConnection->hostname,
+                    managedConnection->tcpPort);
+
+        scheduleReconnect(managedConnection);
+    }
+
+    Semaphore_post(managedConnection->lock);
+
+    if (connected && (managedConnection->stateHandler != NULL))
+        managedConnection->stateHandler(managedConnection->stateHandlerParameter, managedConnection->connection,
+                true);
+}
+
+static void
+handleConnectionEvent(MmsConnectionManager self, ManagedConnection managedConnection)
+{
+    bool connectionLost = false;
+
+    Semaphore_wait(managedConnection->lock);
+
+    if (managedConnection->state == CONNECTION_STATE_CONNECTED) {
+
+        if (IsoClientConnection_handleIncomingData(managedConnection->connection->isoClient)) {
+            struct epoll_event event;
+
+            event.events = EPOLLIN | EPOLLONESHOT;
+            event.data.ptr = managedConnection;
+
+            epoll_ctl(self->epollFd, EPOLL_CTL_MOD, managedConnection->socketFd, &event);
+        }
+        else {
+            /* the socket has been closed and removed from the epoll instance */
+            cancelTimer(self, &(managedConnection->requestTimer));
+            scheduleReconnect(managedConnection);
+            connectionLost = true;
+        }
+    }
+
+    Semaphore_post(managedConnection->lock);
+
+    if (connectionLost && (managedConnection->stateHandler != NULL))
+        managedConnection->stateHandler(managedConnection->stateHandlerParameter, managedConnection->connection,
+                false);
+}
+
+/* has to be called with the lock of the connection */
+static void
+closeManagedConnection(MmsConnectionManager self, ManagedConnection managedConnection)
+{
+    if (managedConnection->state == CONNECTION_STATE_CONNECTED) {
+        /* remove the socket before it is closed - the descriptor can be reused by a new connection */
+        epoll_ctl(self->epollFd, EPOLL_CTL_DEL, managedConnection->socketFd, NULL);
+
+        IsoClientConnection_close(managedConnection->connection->isoClient);
+    }
+
+    managedConnection->state = CONNECTION_STATE_REMOVED;
+
+    cancelTimer(self, &(managedConnection->requestTimer));
+    cancelTimer(self, &(managedConnection->reconnectTimer));
+
+    managedConnection->connection->timeoutScheduler = NULL;
+    managedConnection->connection->timeoutSchedulerParameter = NULL;
+    managedConnection->connection->useReceiveThread = true;
+}
+
+static void
+destroyManagedConnection(ManagedConnection self)
+{
+    Semaphore_destroy(self->lock);
+    free(self->hostname);
+    free(self);
+}
+
+/*******************************************************************************
+ * threads
+ *******************************************************************************/
+
+static void*
+ioThread(void* parameter)
+{
+    MmsConnectionManager self = (MmsConnectionManager) parameter;
+
+    while (self->running) {
+        struct epoll_event event;
+
+        /* one event per call - the other events can be processed by other threads in the meantime */
+        if (epoll_wait(self->epollFd, &event, 1, -1) < 1)
+            continue;
+
+        if (event.data.ptr == &(self->eventFd))
+            break;
+
+        if (event.data.ptr == &(self->timerFd)) {
+            uint64_t expirations;
+
+            if (read(self->timerFd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                processTimers(self);
+
+            event.events = EPOLLIN | EPOLLONESHOT;
+            epoll_ctl(self->epollFd, EPOLL_CTL_MOD, self->timerFd, &event);
+
+            continue;
+        }
+
+        handleConnectionEvent(self, (ManagedConnection) event.data.ptr);
+    }
+
+    return NULL;
+}
+
+static void*
+connectThread(void* parameter)
+{
+    MmsConnectionManager self = (MmsConnectionManager) parameter;
+
+    while (true) {
+        Semaphore_wait(self->connectQueueSignal);
+
+        if (self->running == false)
+            break;
+
+        ManagedConnection managedConnection = removeFromConnectQueue(self);
+
+        if (managedConnection != NULL)
+            connectManagedConnection(self, managedConnection);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * public API
+ *******************************************************************************/
+
+MmsConnectionManager
+MmsConnectionManager_create(int ioThreads, int connectThreads)
+{
+    MmsConnectionManager self = (MmsConnectionManager) calloc(1, sizeof(struct sMmsConnectionManager));
+
+    if (ioThreads < 1)
+        ioThreads = 1;
+
+    if (connectThreads < 1)
+        connectThreads = 1;
+
+    self->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    self->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    self->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if ((self->epollFd == -1) || (self->eventFd == -1) || (self->timerFd == -1)) {
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CONNECTION_MANAGER: failed to create event descriptors\n");
+
+        if (self->epollFd != -1)
+            close(self->epollFd);
+
+        if (self->eventFd != -1)
+            close(self->eventFd);
+
+        if (self->timerFd != -1)
+            close(self->timerFd);
+
+        free(self);
+
+        return NULL;
+    }
+
+    struct epoll_event event;
+
+    /* level triggered without EPOLLONESHOT - wakes up all I/O threads when signaled */
+    event.events = EPOLLIN;
+    event.data.ptr = &(self->eventFd);
+    epoll_ctl(self->epollFd, EPOLL_CTL_ADD, self->eventFd, &event);
+
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = &(self->timerFd);
+    epoll_ctl(self->epollFd, EPOLL_CTL_ADD, self->timerFd, &event);
+
+    struct itimerspec tick;
+
+    tick.it_interval.tv_sec = 0;
+    tick.it_interval.tv_nsec = TIMER_TICK_MS * 1000000L;
+    tick.it_value = tick.it_interval;
+
+    timerfd_settime(self->timerFd, 0, &tick, NULL);
+
+    self->connectionsLock = Semaphore_create(1);
+    self->connections = LinkedList_create();
+
+    self->connectQueueLock = Semaphore_create(1);
+    self->connectQueueSignal = Semaphore_create(0);
+
+    self->timerLock = Semaphore_create(1);
+    self->lastTick = getMonotonicTimeInMs() / TIMER_TICK_MS;
+
+    self->minReconnectInterval = DEFAULT_MIN_RECONNECT_INTERVAL;
+    self->maxReconnectInterval = DEFAULT_MAX_RECONNECT_INTERVAL;
+
+    self->running = true;
+
+    int i;
+
+    self->numberOfIoThreads = ioThreads;
+    self->ioThreads = (Thread*) calloc(ioThreads, sizeof(Thread));
+
+    for (i = 0; i < ioThreads; i++) {
+        self->ioThreads[i] = Thread_create(ioThread, self, false);
+        Thread_start(self->ioThreads[i]);
+    }
+
+    self->numberOfConnectThreads = connectThreads;
+    self->connectThreads = (Thread*) calloc(connectThreads, sizeof(Thread));
+
+    for (i = 0; i < connectThreads; i++) {
+        self->connectThreads[i] = Thread_create(connectThread, self, false);
+        Thread_start(self->connectThreads[i]);
+    }
+
+    return self;
+}
+
+void
+MmsConnectionManager_setReconnectInterval(MmsConnectionManager self, uint32_t minIntervalInMs,
+        uint32_t maxIntervalInMs)
+{
+    if (minIntervalInMs < 1)
+        minIntervalInMs = 1;
+
+    if (maxIntervalInMs < minIntervalInMs)
+        maxIntervalInMs = minIntervalInMs;
+
+    self->minReconnectInterval = minIntervalInMs;
+    self->maxReconnectInterval = maxIntervalInMs;
+}
+
+void
+MmsConnectionManager_addConnection(MmsConnectionManager self, MmsConnection connection, char* hostname,
+        int tcpPort, MmsConnectionStateHandler handler, void* parameter)
+{
+    ManagedConnection managedConnection = (ManagedConnection) calloc(1, sizeof(struct sManagedConnection));
+
+    managedConnection->manager = self;
+    managedConnection->connection = connection;
+    managedConnection->hostname = copyString(hostname);
+    managedConnection->tcpPort = tcpPort;
+    managedConnection->stateHandler = handler;
+    managedConnection->stateHandlerParameter = parameter;
+    managedConnection->lock = Semaphore_create(1);
+    managedConnection->socketFd = -1;
+    managedConnection->reconnectInterval = self->minReconnectInterval;
+
+    managedConnection->requestTimer.handler = handleRequestTimer;
+    managedConnection->requestTimer.connection = managedConnection;
+    managedConnection->reconnectTimer.handler = handleReconnectTimer;
+    managedConnection->reconnectTimer.connection = managedConnection;
+
+    connection->useReceiveThread = false;
+    connection->timeoutScheduler = requestTimeoutScheduler;
+    connection->timeoutSchedulerParameter = managedConnection;
+
+    Semaphore_wait(self->connectionsLock);
+
+    /* spread the reconnect attempts of the connections */
+    managedConnection->reconnectJitter = LinkedList_size(self->connections) * 7919;
+
+    LinkedList_add(self->connections, managedConnection);
+
+    Semaphore_post(self->connectionsLock);
+
+    managedConnection->state = CONNECTION_STATE_CONNECTING;
+
+    addToConnectQueue(self, managedConnection);
+}
+
+void
+MmsConnectionManager_removeConnection(MmsConnectionManager self, MmsConnection connection)
+{
+    ManagedConnection managedConnection = NULL;
+
+    Semaphore_wait(self->connectionsLock);
+
+    LinkedList element = LinkedList_getNext(self->connections);
+
+    while (element != NULL) {
+        ManagedConnection candidate = (ManagedConnection) element->data;
+
+        if ((candidate->connection == connection) && (candidate->state != CONNECTION_STATE_REMOVED)) {
+            managedConnection = candidate;
+            break;
+        }
+
+        element = LinkedList_getNext(element);
+    }
+
+    Semaphore_post(self->connectionsLock);
+
+    if (managedConnection == NULL)
+        return;
+
+    Semaphore_wait(managedConnection->lock);
+
+    closeManagedConnection(self, managedConnection);
+
+    Semaphore_post(managedConnection->lock);
+}
+
+void
+MmsConnectionManager_destroy(MmsConnectionManager self)
+{
+    int i;
+
+    self->running = false;
+
+    uint64_t signal = 1;
+
+    if (write(self->eventFd, &signal, sizeof(signal)) != sizeof(signal)) {
+        if (DEBUG_MMS_CLIENT)
+            printf("MMS_CONNECTION_MANAGER: failed to signal the I/O threads\n");
+    }
+
+    for (i = 0; i < self->numberOfConnectThreads; i++)
+        Semaphore_post(self->connectQueueSignal);
+
+    for (i = 0; i < self->numberOfIoThreads; i++)
+        Thread_destroy(self->ioThreads[i]);
+
+    for (i = 0; i < self->numberOfConnectThreads; i++)
+        Thread_destroy(self->connectThreads[i]);
+
+    LinkedList element = LinkedList_getNext(self->connections);
+
+    while (element != NULL) {
+        ManagedConnection managedConnection = (ManagedConnection) element->data;
+
+        if (managedConnection->state != CONNECTION_STATE_REMOVED)
+            closeManagedConnection(self, managedConnection);
+
+        destroyManagedConnection(managedConnection);
+
+        element = LinkedList_getNext(element);
+    }
+
+    LinkedList_destroyStatic(self->connections);
+
+    close(self->timerFd);
+    close(self->eventFd);
+    close(self->epollFd);
+
+    Semaphore_destroy(self->connectionsLock);
+    Semaphore_destroy(self->connectQueueLock);
+    Semaphore_destroy(self->connectQueueSignal);
+    Semaphore_destroy(self->timerLock);
+
+    free(self->ioThreads);
+    free(self->connectThreads);
+
+    free(self);
+}
+
+#else /* defined(__linux__) */
+
+MmsConnectionManager
+MmsConnectionManager_create(int ioThreads, int connectThreads)
+{
+    return NULL;
+}
+
+void
+MmsConnectionManager_setReconnectInterval(MmsConnectionManager self, uint32_t minIntervalInMs,
+        uint32_t maxIntervalInMs)
+{
+}
+
+void
+MmsConnectionManager_addConnection(MmsConnectionManager self, MmsConnection connection, char* hostname,
+        int tcpPort, MmsConnectionStateHandler handler, void* parameter)
+{
+}
+
+void
+MmsConnectionManager_removeConnection(MmsConnectionManager self, MmsConnection connection)
+{
+}
+
+void
+MmsConnectionManager_destroy(MmsConnectionManager self)
+{
+}
+
+#endif /* defined(__linux__) */
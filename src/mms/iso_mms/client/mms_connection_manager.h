@@ -0,0 +1,138 @@
+/*
+ *  mms_connection_manager.h
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef MMS_CONNECTION_MANAGER_H_
+#define MMS_CONNECTION_MANAGER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "libiec61850_common_api.h"
+#include "mms_client_connection.h"
+
+/**
+ * \defgroup mms_connection_manager MMS connection manager
+ *
+ * Handles many client connections (e.g. a data concentrator or gateway connected to hundreds of
+ * IEDs) with a small number of threads instead of one receive thread per connection.
+ *
+ * The sockets of all established connections are supervised by a single epoll instance. Incoming
+ * messages are processed by a pool of I/O threads - each connection is only handled by one thread
+ * at a time. The timeouts of asynchronous requests and the reconnect delays are supervised by a
+ * timer wheel that is shared by all connections. Connections are (re)established by separate
+ * connect threads because connecting and the association handshake are blocking. Lost connections
+ * are reconnected automatically with an exponential backoff.
+ *
+ * The connections should be used with the asynchronous functions of the MmsConnection. The response
+ * handlers are called by the I/O threads and must not call blocking functions of the connection.
+ * The number of requests in flight per connection is limited by the connection itself (see
+ * the asynchronous functions of MmsConnection).
+ *
+ * Only available on Linux. On other platforms MmsConnectionManager_create returns NULL.
+ *
+ * @{
+ */
+
+typedef struct sMmsConnectionManager* MmsConnectionManager;
+
+/**
+ * \brief Handler that is called when a managed connection has been established or has been lost
+ *
+ * Requests can be sent when the connection has been established. The handler is called by a thread
+ * of the connection manager and must not block.
+ *
+ * \param parameter user provided parameter
+ * \param connection the connection
+ * \param connected true when the connection has been established, false when it has been lost
+ */
+typedef void
+(*MmsConnectionStateHandler) (void* parameter, MmsConnection connection, bool connected);
+
+/**
+ * \brief Create a new connection manager and start its threads
+ *
+ * \param ioThreads number of threads that process incoming messages
+ * \param connectThreads number of threads that establish connections (the number of connection
+ *        attempts that can run in parallel)
+ *
+ * \return the new instance or NULL if not supported on this platform
+ */
+MmsConnectionManager
+MmsConnectionManager_create(int ioThreads, int connectThreads);
+
+/**
+ * \brief Set the delay between reconnect attempts
+ *
+ * The first reconnect attempt is done after the minimum interval. The delay is doubled for
+ * each failed attempt up to the maximum interval. The delays of the connections are slightly
+ * different to prevent that all connections are reestablished at the same time.
+ *
+ * \param minIntervalInMs the delay after the connection has been lost (default 1000 ms)
+ * \param maxIntervalInMs the maximum delay (default 60000 ms)
+ */
+void
+MmsConnectionManager_setReconnectInterval(MmsConnectionManager self, uint32_t minIntervalInMs,
+        uint32_t maxIntervalInMs);
+
+/**
+ * \brief Add a connection that is established and supervised by the manager
+ *
+ * The connection must not be connected. It is connected by a connect thread of the manager. The
+ * connection parameters (e.g. ISO parameters, request timeout) have to be configured before.
+ *
+ * \param connection the connection (not connected)
+ * \param hostname the host name or IP address of the server
+ * \param tcpPort the TCP port of the server
+ * \param handler handler that is informed about state changes of the connection (can be NULL)
+ * \param parameter user provided parameter that is passed to the handler
+ */
+void
+MmsConnectionManager_addConnection(MmsConnectionManager self, MmsConnection connection, char* hostname,
+        int tcpPort, MmsConnectionStateHandler handler, void* parameter);
+
+/**
+ * \brief Stop managing a connection
+ *
+ * The connection is closed when it is established (the outstanding requests are completed with
+ * MMS_ERROR_CONNECTION_LOST). It has to be removed before it is destroyed. This function must not
+ * be called by the handlers of the connection.
+ */
+void
+MmsConnectionManager_removeConnection(MmsConnectionManager self, MmsConnection connection);
+
+/**
+ * \brief Close all managed connections, stop the threads and release all resources of the manager
+ *
+ * The MmsConnection instances are not destroyed.
+ */
+void
+MmsConnectionManager_destroy(MmsConnectionManager self);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MMS_CONNECTION_MANAGER_H_ */
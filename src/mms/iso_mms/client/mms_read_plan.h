@@ -0,0 +1,137 @@
+/*
+ *  mms_read_plan.h
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef MMS_READ_PLAN_H_
+#define MMS_READ_PLAN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "libiec61850_common_api.h"
+#include "mms_client_connection.h"
+
+/**
+ * \defgroup mms_read_plan MMS read plan
+ *
+ * Reads a large number of variables (e.g. all measurements of an IED) with as few read requests
+ * as possible.
+ *
+ * The variables can belong to different domains. When the plan is executed the variables are
+ * grouped into read requests that fit into the negotiated maximum PDU size. The size of the
+ * responses is estimated with the size of the values of the last execution (or a default size
+ * for variables that have not been read yet). If the server rejects a request because the
+ * response would be too large the request is split and the parts are sent again. All requests
+ * are sent without waiting for the responses (the number of outstanding requests is limited by
+ * the connection).
+ *
+ * A plan can be executed repeatedly (e.g. for cyclic polling).
+ *
+ * @{
+ */
+
+typedef struct sMmsReadPlan* MmsReadPlan;
+
+/**
+ * \brief Create a new (empty) read plan
+ */
+MmsReadPlan
+MmsReadPlan_create(void);
+
+/**
+ * \brief Add a variable to the plan
+ *
+ * \param domainId the domain of the variable
+ * \param itemId the name of the variable
+ *
+ * \return the index of the variable in the plan (used to access the value)
+ */
+int
+MmsReadPlan_addVariable(MmsReadPlan self, char* domainId, char* itemId);
+
+/**
+ * \brief Get the number of variables of the plan
+ */
+int
+MmsReadPlan_getSize(MmsReadPlan self);
+
+/**
+ * \brief Get the domain of a variable of the plan
+ *
+ * \param index the index returned by MmsReadPlan_addVariable
+ */
+char*
+MmsReadPlan_getDomainId(MmsReadPlan self, int index);
+
+/**
+ * \brief Get the name of a variable of the plan
+ *
+ * \param index the index returned by MmsReadPlan_addVariable
+ */
+char*
+MmsReadPlan_getItemId(MmsReadPlan self, int index);
+
+/**
+ * \brief Read all variables of the plan
+ *
+ * Blocks until all responses have been received. Has to be called from the application
+ * thread (not from a handler of the connection).
+ *
+ * \param connection the connection to the server
+ * \param mmsError returns MMS_ERROR_NONE if all requests have been answered, otherwise the
+ *        error of the last failed request. Access errors of single variables are returned as
+ *        values of type MMS_DATA_ACCESS_ERROR.
+ *
+ * \return the number of variables that have been read (including data access errors)
+ */
+int
+MmsReadPlan_execute(MmsReadPlan self, MmsConnection connection, MmsError* mmsError);
+
+/**
+ * \brief Get the value of a variable after the plan has been executed
+ *
+ * The value is owned by the plan and is valid until the plan is executed again or destroyed.
+ *
+ * \param index the index returned by MmsReadPlan_addVariable
+ *
+ * \return the value or NULL if the variable has not been read
+ */
+MmsValue*
+MmsReadPlan_getValue(MmsReadPlan self, int index);
+
+/**
+ * \brief Get the number of read requests of the last execution
+ */
+int
+MmsReadPlan_getRequestCount(MmsReadPlan self);
+
+void
+MmsReadPlan_destroy(MmsReadPlan self);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MMS_READ_PLAN_H_ */
@@ -52,6 +52,7 @@ typedef enum
     MMS_ERROR_PARSING_RESPONSE = 4,
     MMS_ERROR_HARDWARE_FAULT = 5,
     MMS_ERROR_CONCLUDE_REJECTED = 6,
+    MMS_ERROR_OUTSTANDING_CALL_LIMIT = 7,
     MMS_ERROR_OTHER = 9,
 
     /* confirmed error PDU codes */
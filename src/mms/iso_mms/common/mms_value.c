@@ -153,14 +153,14 @@ MmsValue_equals(MmsValue* self, MmsValue* otherValue)
 
         case MMS_VISIBLE_STRING:
         case MMS_STRING:
-            if (self->value.visibleString != NULL) {
-                if (otherValue->value.visibleString != NULL) {
-                    if (strcmp(self->value.visibleString, otherValue->value.visibleString) == 0)
+            if (self->value.visibleString.buf != NULL) {
+                if (otherValue->value.visibleString.buf != NULL) {
+                    if (strcmp(self->value.visibleString.buf, otherValue->value.visibleString.buf) == 0)
                         return true;
                 }
             }
             else {
-                if (otherValue->value.visibleString == NULL)
+                if (otherValue->value.visibleString.buf == NULL)
                     return true;
             }
             break;
@@ -258,10 +258,10 @@ MmsValue_update(MmsValue* self, MmsValue* update)
 			else return false;
 			break;
 		case MMS_VISIBLE_STRING:
-			MmsValue_setVisibleString(self, update->value.visibleString);
+			MmsValue_setVisibleString(self, update->value.visibleString.buf);
 			break;
 		case MMS_STRING:
-			MmsValue_setMmsString(self, update->value.visibleString);
+			MmsValue_setMmsString(self, update->value.visibleString.buf);
 			break;
 		case MMS_BINARY_TIME:
 			self->value.binaryTime.size = update->value.binaryTime.size;
@@ -868,7 +868,7 @@ MmsValue_getSizeInMemory(MmsValue* self)
         break;
     case MMS_STRING:
     case MMS_VISIBLE_STRING:
-        memorySize += strlen(self->value.visibleString);
+        memorySize += strlen(self->value.visibleString.buf);
         memorySize += 1; /* add space for 0 character */
         break;
     default:
@@ -933,9 +933,10 @@ MmsValue_cloneToBuffer(MmsValue* self, uint8_t* destinationAddress)
         break;
     case MMS_STRING:
     case MMS_VISIBLE_STRING:
-        newValue->value.visibleString = (char*) destinationAddress;
-        strcpy((char*) destinationAddress, self->value.visibleString);
-        destinationAddress += (strlen(self->value.visibleString) + 1);
+        newValue->value.visibleString.buf = (char*) destinationAddress;
+        newValue->value.visibleString.size = strlen(self->value.visibleString.buf) + 1;
+        strcpy((char*) destinationAddress, self->value.visibleString.buf);
+        destinationAddress += newValue->value.visibleString.size;
         break;
     default:
         break;
@@ -1005,9 +1006,10 @@ MmsValue_clone(MmsValue* value)
 	    break;
     case MMS_VISIBLE_STRING:
 	case MMS_STRING:
-	    size = strlen(value->value.visibleString) + 1;
-        newValue->value.visibleString = (char*) malloc(size);
-        strcpy(newValue->value.visibleString, value->value.visibleString);
+	    size = strlen(value->value.visibleString.buf) + 1;
+        newValue->value.visibleString.buf = (char*) malloc(size);
+        newValue->value.visibleString.size = size;
+        strcpy(newValue->value.visibleString.buf, value->value.visibleString.buf);
 	    break;
 	case MMS_DATA_ACCESS_ERROR:
 	    newValue->value.dataAccessError = value->value.dataAccessError;
@@ -1051,8 +1053,8 @@ MmsValue_delete(MmsValue* value)
         break;
     case MMS_VISIBLE_STRING:
     case MMS_STRING:
-        if (value->value.visibleString != NULL)
-            free(value->value.visibleString);
+        if (value->value.visibleString.buf != NULL)
+            free(value->value.visibleString.buf);
         break;
     case MMS_ARRAY:
     case MMS_STRUCTURE:
@@ -1096,8 +1098,8 @@ MmsValue_deleteConditional(MmsValue* value)
             break;
         case MMS_VISIBLE_STRING:
         case MMS_STRING:
-            if (value->value.visibleString != NULL)
-                free(value->value.visibleString);
+            if (value->value.visibleString.buf != NULL)
+                free(value->value.visibleString.buf);
             break;
         case MMS_ARRAY:
         case MMS_STRUCTURE:
@@ -1299,10 +1301,14 @@ MmsValue_newDefaultValue(MmsVariableSpecification* typeSpec)
 static inline void
 setVisibleStringValue(MmsValue* value, char* string)
 {
-	if (string != NULL)
-		value->value.visibleString = copyString(string);
-	else
-		value->value.visibleString = NULL;
+	if (string != NULL) {
+		value->value.visibleString.buf = copyString(string);
+		value->value.visibleString.size = strlen(string) + 1;
+	}
+	else {
+		value->value.visibleString.buf = NULL;
+		value->value.visibleString.size = 0;
+	}
 }
 
 MmsValue*
@@ -1410,10 +1416,14 @@ MmsValue_getDataAccessError(MmsValue* self)
 static inline void
 setMmsStringValue(MmsValue* value, char* string)
 {
-	if (string != NULL)
-		value->value.visibleString = copyString(string);
-	else
-		value->value.visibleString = NULL;
+	if (string != NULL) {
+		value->value.visibleString.buf = copyString(string);
+		value->value.visibleString.size = strlen(string) + 1;
+	}
+	else {
+		value->value.visibleString.buf = NULL;
+		value->value.visibleString.size = 0;
+	}
 }
 
 MmsValue*
@@ -1431,8 +1441,8 @@ void
 MmsValue_setMmsString(MmsValue* value, char* string)
 {
 	if (value->type == MMS_STRING) {
-		if (value->value.visibleString != NULL)
-			free(value->value.visibleString);
+		if (value->value.visibleString.buf != NULL)
+			free(value->value.visibleString.buf);
 
 		setMmsStringValue(value, string);
 	}
@@ -1444,7 +1454,8 @@ MmsValue_newVisibleStringFromByteArray(uint8_t* byteArray, int size)
 	MmsValue* value = (MmsValue*) calloc(1, sizeof(MmsValue));
 	value->type = MMS_VISIBLE_STRING;
 
-	value->value.visibleString = createStringFromBuffer(byteArray, size);
+	value->value.visibleString.buf = createStringFromBuffer(byteArray, size);
+	value->value.visibleString.size = size + 1;
 
 	return value;
 }
@@ -1453,8 +1464,8 @@ void
 MmsValue_setVisibleString(MmsValue* value, char* string)
 {
 	if (value->type == MMS_VISIBLE_STRING) {
-		if (value->value.visibleString != NULL)
-			free(value->value.visibleString);
+		if (value->value.visibleString.buf != NULL)
+			free(value->value.visibleString.buf);
 
 		setVisibleStringValue(value, string);
 	}
@@ -1464,7 +1475,7 @@ char*
 MmsValue_toString(MmsValue* value)
 {
 	if ((value->type == MMS_VISIBLE_STRING) || (value->type == MMS_STRING))
-		return value->value.visibleString;
+		return value->value.visibleString.buf;
 
 	return NULL;
 }
@@ -51,7 +51,10 @@ struct ATTRIBUTE_PACKED sMmsValue {
             int size;     /* Number of bits */
             uint8_t* buf;
         } bitString;
-        char* visibleString;
+        struct {
+            int size;     /* size of the allocated buffer */
+            char* buf;
+        } visibleString;
         uint8_t utcTime[8];
         struct {
             uint8_t size;
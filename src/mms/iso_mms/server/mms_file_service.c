@@ -30,6 +30,9 @@
 
 #define CONFIG_MMS_FILE_SERVICE_MAX_FILENAME_LENGTH 256
 
+/* maximum size of a FileRead response without the file data */
+#define FILE_READ_RESPONSE_OVERHEAD 24
+
 static void
 createNullResponseExtendedTag(uint32_t invokeId, ByteBuffer* response, uint8_t tag)
 {
@@ -98,6 +101,21 @@ getNextFrsmId(MmsServerConnection* connection)
     return nextFrsmId;
 }
 
+static void
+closeFrsm(MmsFileReadStateMachine* frsm)
+{
+#if (CONFIG_MMS_FILE_SERVICE_USE_MMAP == 1)
+    if (frsm->mappedFile != NULL) {
+        FileSystem_unmapFile(frsm->mappedFile, frsm->mappedFileSize);
+        frsm->mappedFile = NULL;
+    }
+#endif
+
+    FileSystem_closeFile(frsm->fileHandle);
+    frsm->fileHandle = NULL;
+    frsm->frsmId = 0;
+}
+
 static int
 encodeFileAttributes(uint8_t tag, uint32_t fileSize, char* gtString, uint8_t* buffer, int bufPos)
 {
@@ -290,6 +308,11 @@ mmsServer_handleFileOpenRequest(
                 frsm->readPosition = filePosition;
                 frsm->frsmId = getNextFrsmId(connection);
 
+#if (CONFIG_MMS_FILE_SERVICE_USE_MMAP == 1)
+                /* the chunks are copied from the mapped file - fall back to FileSystem_readFile if not possible */
+                frsm->mappedFile = FileSystem_mapFile(filename, &(frsm->mappedFileSize));
+#endif
+
                 createFileOpenResponse(invokeId, response, filename, frsm);
             }
             else
@@ -315,14 +338,30 @@ exit_reject_invalid_pdu:
 
 
 static void
-createFileReadResponse(uint32_t invokeId, ByteBuffer* response,  MmsFileReadStateMachine* frsm)
+createFileReadResponse(MmsServerConnection* connection, uint32_t invokeId, ByteBuffer* response,
+        MmsFileReadStateMachine* frsm)
 {
      /* determine remaining bytes in file */
-     uint32_t bytesLeft = frsm->fileSize - frsm->readPosition;
+     uint32_t fileSize = frsm->fileSize;
+
+#if (CONFIG_MMS_FILE_SERVICE_USE_MMAP == 1)
+     /* the file may have been changed after it has been opened */
+     if ((frsm->mappedFile != NULL) && (frsm->mappedFileSize < fileSize))
+         fileSize = frsm->mappedFileSize;
+#endif
+
+     uint32_t bytesLeft = 0;
+
+     if (frsm->readPosition < fileSize)
+         bytesLeft = fileSize - frsm->readPosition;
 
      uint32_t fileChunkSize = 0;
 
-     uint32_t maxFileChunkSize = CONFIG_MMS_MAXIMUM_PDU_SIZE - 15;
+     uint32_t maxFileChunkSize = CONFIG_MMS_MAXIMUM_PDU_SIZE - FILE_READ_RESPONSE_OVERHEAD;
+
+     /* use the PDU size negotiated with the client */
+     if ((connection->maxPduSize > FILE_READ_RESPONSE_OVERHEAD) && (connection->maxPduSize < CONFIG_MMS_MAXIMUM_PDU_SIZE))
+         maxFileChunkSize = connection->maxPduSize - FILE_READ_RESPONSE_OVERHEAD;
 
      uint32_t fileReadResponseSize = 1; /* for tag */
 
@@ -340,8 +379,6 @@ createFileReadResponse(uint32_t invokeId, ByteBuffer* response,  MmsFileReadStat
      fileReadResponseSize += fileChunkSize;
      fileReadResponseSize += BerEncoder_determineLengthSize(fileChunkSize);
 
-     frsm->readPosition += fileChunkSize;
-
      uint32_t invokeIdSize = BerEncoder_UInt32determineEncodedSize(invokeId) + 2;
 
      uint32_t confirmedResponsePDUSize = invokeIdSize + 2 + BerEncoder_determineLengthSize(fileReadResponseSize)
@@ -360,9 +397,20 @@ createFileReadResponse(uint32_t invokeId, ByteBuffer* response,  MmsFileReadStat
      bufPos = BerEncoder_encodeTL(0x49, fileReadResponseSize, buffer, bufPos);
 
      bufPos = BerEncoder_encodeTL(0x80, fileChunkSize, buffer, bufPos);
+
+#if (CONFIG_MMS_FILE_SERVICE_USE_MMAP == 1)
+     if (frsm->mappedFile != NULL)
+         memcpy(buffer + bufPos, frsm->mappedFile + frsm->readPosition, fileChunkSize);
+     else
+         FileSystem_readFile(frsm->fileHandle, buffer + bufPos, fileChunkSize);
+#else
      FileSystem_readFile(frsm->fileHandle, buffer + bufPos, fileChunkSize);
+#endif
+
      bufPos += fileChunkSize;
 
+     frsm->readPosition += fileChunkSize;
+
      if (!moreFollows)
          bufPos = BerEncoder_encodeBoolean(0x81, false, buffer, bufPos);
 
@@ -384,7 +432,7 @@ mmsServer_handleFileReadRequest(
     MmsFileReadStateMachine* frsm = getFrsm(connection, frsmId);
 
     if (frsm != NULL)
-        createFileReadResponse(invokeId, response, frsm);
+        createFileReadResponse(connection, invokeId, response, frsm);
     else
         mmsServer_createConfirmedErrorPdu(invokeId, response, MMS_ERROR_FILE_OTHER);
 }
@@ -407,13 +455,25 @@ mmsServer_handleFileCloseRequest(
 
     MmsFileReadStateMachine* frsm = getFrsm(connection, frsmId);
 
-    FileSystem_closeFile(frsm->fileHandle);
-    frsm->fileHandle = NULL;
-    frsm->frsmId = 0;
+    if (frsm != NULL) {
+        closeFrsm(frsm);
 
-    createFileCloseResponse(invokeId, response);
+        createFileCloseResponse(invokeId, response);
+    }
+    else
+        mmsServer_createConfirmedErrorPdu(invokeId, response, MMS_ERROR_FILE_OTHER);
 }
 
+void
+mmsServer_closeAllFiles(MmsServerConnection* connection)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_MMS_MAX_NUMBER_OF_OPEN_FILES_PER_CONNECTION; i++) {
+        if (connection->frsms[i].fileHandle != NULL)
+            closeFrsm(&(connection->frsms[i]));
+    }
+}
 
 
 static int //TODO remove redundancy - same as in client code!
@@ -197,9 +197,8 @@ MmsServerConnection_sendInformationReportListOfVariables(
 }
 
 
-void /* send information report for a named variable list */
-MmsServerConnection_sendInformationReportVMDSpecific(MmsServerConnection* self, char* itemId, LinkedList values,
-        bool handlerMode)
+static ByteBuffer*
+createInformationReportVMDSpecific(MmsServerConnection* self, char* itemId, LinkedList values)
 {
 
     uint32_t variableAccessSpecSize = 0;
@@ -268,10 +267,34 @@ MmsServerConnection_sendInformationReportVMDSpecific(MmsServerConnection* self,
 
     reportBuffer->size = bufPos;
 
+    return reportBuffer;
+}
+
+void /* send information report for a named variable list */
+MmsServerConnection_sendInformationReportVMDSpecific(MmsServerConnection* self, char* itemId, LinkedList values,
+        bool handlerMode)
+{
+    ByteBuffer* reportBuffer = createInformationReportVMDSpecific(self, itemId, values);
+
     IsoConnection_sendMessage(self->isoConnection, reportBuffer, false);
 
     ByteBuffer_destroy(reportBuffer);
 }
 
+bool
+MmsServerConnection_enqueueInformationReportVMDSpecific(MmsServerConnection* self, char* itemId, LinkedList values,
+        IsoSendQueuePolicy policy)
+{
+    ByteBuffer* reportBuffer = createInformationReportVMDSpecific(self, itemId, values);
+
+    return IsoConnection_enqueueMessage(self->isoConnection, reportBuffer, policy);
+}
+
+bool
+MmsServerConnection_isSendQueueFull(MmsServerConnection* self)
+{
+    return IsoConnection_isSendQueueFull(self->isoConnection);
+}
+
 
 
@@ -56,6 +56,10 @@ typedef struct {
         uint32_t readPosition;
         uint32_t fileSize;
         FileHandle fileHandle;
+#if (CONFIG_MMS_FILE_SERVICE_USE_MMAP == 1)
+        uint8_t* mappedFile; /* NULL if the file is read with FileSystem_readFile */
+        uint32_t mappedFileSize;
+#endif
 } MmsFileReadStateMachine;
 
 #endif /* (MMS_FILE_SERVICE == 1) */
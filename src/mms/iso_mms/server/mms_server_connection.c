@@ -313,11 +313,7 @@ MmsServerConnection_destroy(MmsServerConnection* self)
 {
 
 #if (MMS_FILE_SERVICE == 1)
-    int frsmIndex = 0;
-
-    for (frsmIndex = 0; frsmIndex < CONFIG_MMS_MAX_NUMBER_OF_OPEN_FILES_PER_CONNECTION; frsmIndex++)
-        if (self->frsms[frsmIndex].fileHandle != NULL)
-            FileSystem_closeFile(self->frsms[frsmIndex].fileHandle);
+    mmsServer_closeAllFiles(self);
 #endif
 
 	LinkedList_destroyDeep(self->namedVariableLists, (LinkedListValueDeleteFunction) MmsNamedVariableList_destroy);
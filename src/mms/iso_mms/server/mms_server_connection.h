@@ -81,6 +81,21 @@ void /* send information report for a VMD specific named variable list */
 MmsServerConnection_sendInformationReportVMDSpecific(MmsServerConnection* self, char* itemId, LinkedList values
         , bool handlerMode);
 
+/** \brief queue an information report for a VMD specific named variable list
+ *
+ *   The report is encoded immediately and transmitted by the send queue of the connection.
+ *
+ *   \param policy the behavior when the send queue of the connection is full
+ *
+ *   \return true if the report has been queued, false if it has been dropped or rejected
+ */
+bool
+MmsServerConnection_enqueueInformationReportVMDSpecific(MmsServerConnection* self, char* itemId, LinkedList values,
+        IsoSendQueuePolicy policy);
+
+bool
+MmsServerConnection_isSendQueueFull(MmsServerConnection* self);
+
 /** \brief send information report for list of variables
  *
  *   \param handlerMode send this message in the context of a stack callback handler
@@ -212,6 +212,9 @@ mmsServer_handleFileCloseRequest(
         uint32_t invokeId,
         ByteBuffer* response);
 
+void
+mmsServer_closeAllFiles(MmsServerConnection* connection);
+
 int
 mmsServer_isIndexAccess(AlternateAccess_t* alternateAccess);
 
@@ -50,6 +50,17 @@
 #define ISO_CON_STATE_RUNNING 1
 #define ISO_CON_STATE_STOPPED 0
 
+#ifndef CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE
+#define CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE 0
+#endif
+
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+typedef struct {
+    ByteBuffer* message;
+    IsoSendQueuePolicy policy;
+} SendQueueEntry;
+#endif
+
 struct sIsoConnection
 {
     uint8_t* receiveBuffer;
@@ -66,10 +77,193 @@ struct sIsoConnection
     Thread thread;
     Semaphore conMutex;
 
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+    SendQueueEntry sendQueue[CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE];
+    int sendQueueHead;
+    int sendQueueLength;
+    int sendQueueBlockedSenders;  /* number of pending sendQueueSpace notifications */
+    int sendQueueWaitingSenders;  /* number of threads waiting for free space */
+    bool sendQueueRunning;
+    Thread sendQueueThread;
+    Semaphore sendQueueMutex;
+    Semaphore sendQueueSignal; /* posted when a message is queued or the queue is stopped */
+    Semaphore sendQueueSpace;  /* posted for blocked senders when a message has been removed */
+#endif
+
+    IsoSendQueueStatistics sendQueueStatistics;
 
     void* securityToken;
 };
 
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+
+static SendQueueEntry*
+getSendQueueEntry(IsoConnection self, int index)
+{
+    return &(self->sendQueue[(self->sendQueueHead + index) % CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE]);
+}
+
+/* remove the entry at index and close the gap - requires sendQueueMutex */
+static void
+removeSendQueueEntry(IsoConnection self, int index)
+{
+    int i;
+
+    for (i = index; i < (self->sendQueueLength - 1); i++)
+        *getSendQueueEntry(self, i) = *getSendQueueEntry(self, i + 1);
+
+    self->sendQueueLength--;
+}
+
+static ByteBuffer*
+dequeueMessage(IsoConnection self)
+{
+    ByteBuffer* message = NULL;
+
+    Semaphore_wait(self->sendQueueMutex);
+
+    if (self->sendQueueLength > 0) {
+        message = getSendQueueEntry(self, 0)->message;
+
+        self->sendQueueHead = (self->sendQueueHead + 1) % CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE;
+        self->sendQueueLength--;
+
+        if (self->sendQueueBlockedSenders > 0) {
+            self->sendQueueBlockedSenders--;
+            Semaphore_post(self->sendQueueSpace);
+        }
+    }
+
+    Semaphore_post(self->sendQueueMutex);
+
+    return message;
+}
+
+static int
+releaseBlockedSenders(IsoConnection self)
+{
+    Semaphore_wait(self->sendQueueMutex);
+
+    while (self->sendQueueBlockedSenders > 0) {
+        self->sendQueueBlockedSenders--;
+        Semaphore_post(self->sendQueueSpace);
+    }
+
+    int waitingSenders = self->sendQueueWaitingSenders;
+
+    Semaphore_post(self->sendQueueMutex);
+
+    return waitingSenders;
+}
+
+#endif /* (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0) */
+
+/* encode the lower layers and send the message - requires conMutex */
+static CotpIndication
+sendMessage(IsoConnection self, ByteBuffer* message)
+{
+    struct sBufferChain payloadBufferStruct;
+    BufferChain payloadBuffer = &payloadBufferStruct;
+    payloadBuffer->length = message->size;
+    payloadBuffer->partLength = message->size;
+    payloadBuffer->partMaxLength = message->size;
+    payloadBuffer->buffer = message->buffer;
+    payloadBuffer->nextPart = NULL;
+
+    struct sBufferChain presentationBufferStruct;
+    BufferChain presentationBuffer = &presentationBufferStruct;
+    presentationBuffer->buffer = self->sendBuffer;
+    presentationBuffer->partMaxLength = SEND_BUF_SIZE;
+
+    IsoPresentation_createUserData(self->presentation,
+            presentationBuffer, payloadBuffer);
+
+    struct sBufferChain sessionBufferStruct;
+    BufferChain sessionBuffer = &sessionBufferStruct;
+    sessionBuffer->buffer = self->sendBuffer + presentationBuffer->partLength;
+
+    IsoSession_createDataSpdu(self->session, sessionBuffer, presentationBuffer);
+
+    return CotpConnection_sendDataMessage(self->cotpConnection, sessionBuffer);
+}
+
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+
+static void
+sendQueueThread(IsoConnection self)
+{
+    if (DEBUG_ISO_SERVER)
+        printf("ISO_SERVER: send queue thread for connection %p started\n", self);
+
+    bool running = true;
+
+    while (running) {
+        Semaphore_wait(self->sendQueueSignal);
+
+        ByteBuffer* message;
+
+        while ((message = dequeueMessage(self)) != NULL) {
+
+            if (self->state == ISO_CON_STATE_RUNNING) {
+                Semaphore_wait(self->conMutex);
+
+                CotpIndication indication = sendMessage(self, message);
+
+                Semaphore_post(self->conMutex);
+
+                if (indication == OK) {
+                    Semaphore_wait(self->sendQueueMutex);
+                    self->sendQueueStatistics.sent++;
+                    Semaphore_post(self->sendQueueMutex);
+                }
+                else if (DEBUG_ISO_SERVER)
+                    printf("ISO_SERVER: send queue: failed to send message!\n");
+            }
+
+            ByteBuffer_destroy(message);
+        }
+
+        Semaphore_wait(self->sendQueueMutex);
+        running = self->sendQueueRunning;
+        Semaphore_post(self->sendQueueMutex);
+    }
+
+    if (DEBUG_ISO_SERVER)
+        printf("ISO_SERVER: send queue thread for connection %p finished\n", self);
+}
+
+static void
+stopSendQueue(IsoConnection self)
+{
+    Semaphore_wait(self->sendQueueMutex);
+    self->sendQueueRunning = false;
+    Semaphore_post(self->sendQueueMutex);
+
+    Semaphore_post(self->sendQueueSignal);
+
+    /* wait until all threads blocked by a full queue have given up */
+    while (releaseBlockedSenders(self) > 0)
+        Thread_sleep(1);
+
+    /* the connection is stopped and queued messages are dropped - unblock a Socket_write to a peer that
+     * doesn't read anymore */
+    if (self->socket != NULL)
+        Socket_shutdown(self->socket);
+
+    Thread_destroy(self->sendQueueThread);
+
+    ByteBuffer* message;
+
+    while ((message = dequeueMessage(self)) != NULL)
+        ByteBuffer_destroy(message);
+
+    Semaphore_destroy(self->sendQueueMutex);
+    Semaphore_destroy(self->sendQueueSignal);
+    Semaphore_destroy(self->sendQueueSpace);
+}
+
+#endif /* (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0) */
+
 static void
 handleTcpConnection(IsoConnection self)
 {
@@ -350,6 +544,10 @@ handleTcpConnection(IsoConnection self)
 
     IsoServer_closeConnection(self->isoServer, self);
 
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+    stopSendQueue(self);
+#endif
+
     if (self->socket != NULL)
         Socket_destroy(self->socket);
 
@@ -393,6 +591,16 @@ IsoConnection_create(Socket socket, IsoServer isoServer)
     self->thread = Thread_create((ThreadExecutionFunction) handleTcpConnection, self, true);
     self->conMutex = Semaphore_create(1);
 
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+    self->sendQueueMutex = Semaphore_create(1);
+    self->sendQueueSignal = Semaphore_create(0);
+    self->sendQueueSpace = Semaphore_create(0);
+    self->sendQueueRunning = true;
+    self->sendQueueThread = Thread_create((ThreadExecutionFunction) sendQueueThread, self, false);
+
+    Thread_start(self->sendQueueThread);
+#endif
+
     Thread_start(self->thread);
 
     if (DEBUG_ISO_SERVER)
@@ -419,31 +627,9 @@ IsoConnection_sendMessage(IsoConnection self, ByteBuffer* message, bool handlerM
     if (!handlerMode)
         Semaphore_wait(self->conMutex);
 
-    struct sBufferChain payloadBufferStruct;
-    BufferChain payloadBuffer = &payloadBufferStruct;
-    payloadBuffer->length = message->size;
-    payloadBuffer->partLength = message->size;
-    payloadBuffer->partMaxLength = message->size;
-    payloadBuffer->buffer = message->buffer;
-    payloadBuffer->nextPart = NULL;
-
-    struct sBufferChain presentationBufferStruct;
-    BufferChain presentationBuffer = &presentationBufferStruct;
-    presentationBuffer->buffer = self->sendBuffer;
-    presentationBuffer->partMaxLength = SEND_BUF_SIZE;
-
-    IsoPresentation_createUserData(self->presentation,
-            presentationBuffer, payloadBuffer);
-
-    struct sBufferChain sessionBufferStruct;
-    BufferChain sessionBuffer = &sessionBufferStruct;
-    sessionBuffer->buffer = self->sendBuffer + presentationBuffer->partLength;
-
-    IsoSession_createDataSpdu(self->session, sessionBuffer, presentationBuffer);
-
     CotpIndication indication;
 
-    indication = CotpConnection_sendDataMessage(self->cotpConnection, sessionBuffer);
+    indication = sendMessage(self, message);
 
     if (DEBUG_ISO_SERVER) {
         if (indication != OK)
@@ -456,6 +642,115 @@ IsoConnection_sendMessage(IsoConnection self, ByteBuffer* message, bool handlerM
         Semaphore_post(self->conMutex);
 }
 
+bool
+IsoConnection_enqueueMessage(IsoConnection self, ByteBuffer* message, IsoSendQueuePolicy policy)
+{
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+    bool queued = false;
+
+    Semaphore_wait(self->sendQueueMutex);
+
+    if (self->sendQueueLength == CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE) {
+
+        if (policy == ISO_SEND_QUEUE_BLOCK) {
+            self->sendQueueStatistics.blocked++;
+            self->sendQueueWaitingSenders++;
+
+            while ((self->sendQueueLength == CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE) && self->sendQueueRunning) {
+                self->sendQueueBlockedSenders++;
+
+                Semaphore_post(self->sendQueueMutex);
+                Semaphore_wait(self->sendQueueSpace);
+                Semaphore_wait(self->sendQueueMutex);
+            }
+
+            self->sendQueueWaitingSenders--;
+        }
+        else if (policy == ISO_SEND_QUEUE_DROP_OLDEST) {
+            int i;
+
+            for (i = 0; i < self->sendQueueLength; i++) {
+                SendQueueEntry* entry = getSendQueueEntry(self, i);
+
+                if (entry->policy == ISO_SEND_QUEUE_DROP_OLDEST) {
+                    ByteBuffer_destroy(entry->message);
+                    removeSendQueueEntry(self, i);
+                    self->sendQueueStatistics.dropped++;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (self->sendQueueRunning && (self->sendQueueLength < CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE)) {
+        SendQueueEntry* entry = getSendQueueEntry(self, self->sendQueueLength);
+
+        entry->message = message;
+        entry->policy = policy;
+
+        self->sendQueueLength++;
+
+        if (self->sendQueueLength > self->sendQueueStatistics.maxLength)
+            self->sendQueueStatistics.maxLength = self->sendQueueLength;
+
+        self->sendQueueStatistics.enqueued++;
+
+        queued = true;
+    }
+    else {
+        if (DEBUG_ISO_SERVER)
+            printf("ISO_SERVER: send queue of connection %p is full -> reject message\n", self);
+
+        self->sendQueueStatistics.rejected++;
+    }
+
+    Semaphore_post(self->sendQueueMutex);
+
+    if (queued)
+        Semaphore_post(self->sendQueueSignal);
+    else
+        ByteBuffer_destroy(message);
+
+    return queued;
+#else
+    IsoConnection_sendMessage(self, message, false);
+
+    ByteBuffer_destroy(message);
+
+    self->sendQueueStatistics.sent++;
+
+    return true;
+#endif /* (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0) */
+}
+
+bool
+IsoConnection_isSendQueueFull(IsoConnection self)
+{
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+    bool isFull;
+
+    Semaphore_wait(self->sendQueueMutex);
+    isFull = (self->sendQueueLength == CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE);
+    Semaphore_post(self->sendQueueMutex);
+
+    return isFull;
+#else
+    return false;
+#endif
+}
+
+void
+IsoConnection_getSendQueueStatistics(IsoConnection self, IsoSendQueueStatistics* statistics)
+{
+#if (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE > 0)
+    Semaphore_wait(self->sendQueueMutex);
+    *statistics = self->sendQueueStatistics;
+    Semaphore_post(self->sendQueueMutex);
+#else
+    *statistics = self->sendQueueStatistics;
+#endif
+}
+
 void
 IsoConnection_close(IsoConnection self)
 {
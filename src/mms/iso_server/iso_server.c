@@ -126,12 +126,8 @@ closeAllOpenClientConnections(IsoServer self)
     int i;
 
     for (i = 0; i < CONFIG_MAXIMUM_TCP_CLIENT_CONNECTIONS; i++) {
-        if (self->openClientConnections[i] != NULL) {
-
+        if (self->openClientConnections[i] != NULL)
             IsoConnection_close(self->openClientConnections[i]);
-
-            break;
-        }
     }
 #endif
 }
@@ -66,6 +66,26 @@ typedef void
 typedef void
 (*MessageReceivedHandler)(void* parameter, ByteBuffer* message, ByteBuffer* response);
 
+/**
+ * \brief Behavior of IsoConnection_enqueueMessage when the send queue of the connection is full
+ */
+typedef enum
+{
+    ISO_SEND_QUEUE_BLOCK,       /* wait until the connection has transmitted a queued message */
+    ISO_SEND_QUEUE_DROP_OLDEST, /* discard the oldest queued message that was enqueued with this policy */
+    ISO_SEND_QUEUE_REJECT       /* don't queue the message - the caller has to keep it and retry later */
+} IsoSendQueuePolicy;
+
+typedef struct
+{
+    uint32_t enqueued;  /* number of messages accepted by the send queue */
+    uint32_t sent;      /* number of queued messages written to the socket */
+    uint32_t dropped;   /* number of messages discarded by the drop-oldest policy */
+    uint32_t rejected;  /* number of messages not queued because the queue was full */
+    uint32_t blocked;   /* number of times a caller had to wait for free space */
+    int maxLength;      /* highest number of messages that were waiting in the queue */
+} IsoSendQueueStatistics;
+
 char*
 IsoConnection_getPeerAddress(IsoConnection self);
 
@@ -88,6 +108,31 @@ IsoConnection_getSecurityToken(IsoConnection self);
 void
 IsoConnection_sendMessage(IsoConnection self, ByteBuffer* message, bool handlerMode);
 
+/**
+ * \brief hand over a message to the send queue of an ISO connection
+ *
+ * The message is transmitted by the sender thread of the connection so that the caller is not
+ * blocked by a slow peer. The connection takes ownership of the message (allocated with
+ * ByteBuffer_create) and releases it after transmission or when it is dropped or rejected.
+ * If the send queue is disabled (CONFIG_ISO_CONNECTION_SEND_QUEUE_SIZE == 0) the message is
+ * sent synchronously.
+ *
+ * \param policy what to do if the send queue is full
+ *
+ * \return true if the message has been queued, false if it has been dropped or rejected
+ */
+bool
+IsoConnection_enqueueMessage(IsoConnection self, ByteBuffer* message, IsoSendQueuePolicy policy);
+
+/**
+ * \brief check if the send queue of the connection is full
+ */
+bool
+IsoConnection_isSendQueueFull(IsoConnection self);
+
+void
+IsoConnection_getSendQueueStatistics(IsoConnection self, IsoSendQueueStatistics* statistics);
+
 IsoServer
 IsoServer_create(void);
 
@@ -21,10 +21,13 @@
  *  See COPYING file for the complete license text.
  */
 
-#include "stack_config.h"
 #include "libiec61850_platform_includes.h"
+#include "stack_config.h"
+#include "sv_publisher.h"
+#include "ethernet.h"
+#include "ber_encoder.h"
 
-#define CONFIG_SV_DEFAULT_DST_ADDRESS CONFIG_GOOSE_DEFAULT_DST_ADDRESS
+#define CONFIG_SV_DEFAULT_DST_ADDRESS { 0x01, 0x0c, 0xcd, 0x04, 0x00, 0x00 }
 
 #define CONFIG_SV_DEFAULT_PRIORITY 4
 #define CONFIG_SV_DEFAULT_VLAN_ID 0
@@ -32,37 +35,60 @@
 
 #define SV_MAX_MESSAGE_SIZE 1518
 
-typedef struct sSampledValuesPublisher* SampledValuesPublisher;
+#ifndef CONFIG_SV_TRANSMIT_QUEUE_SIZE
+#define CONFIG_SV_TRANSMIT_QUEUE_SIZE 16
+#endif
 
-struct sSampledValuesPublisher {
-    uint8_t* buffer;
-    uint16_t appId;
-    EthernetSocket ethernetSocket;
-    int lengthField; /* can probably be removed since packets have fixed size! */
-    int payloadStart;
+/* encoded size of a sample (INT32 value + quality) */
+#define SV_SAMPLE_SIZE 8
 
-    char* id;
-    char* dataSetRef; /* date set reference */
+struct sSVPublisher_ASDU {
+    char* svID;
+    char* datset;
+    int channelCount;
 
-    uint16_t smpCount; /* sample counter - reset by sync */
-    uint32_t confRev; /* Configuration revision according to CB */
-    uint8_t smpSynch; /* Synchronization status */
+    uint16_t smpCnt;
+    uint16_t smpCntWrap;
+    uint32_t confRev;
+    uint8_t smpSynch;
     uint16_t smpRate;
+    uint64_t refrTm;
+
+    bool hasSmpRate; /* optional fields of the ASDU */
+    bool hasRefrTm;
 
-    uint64_t refreshTime; /* local buffer refresh time */
-    MmsValue* refTime;
+    /* positions of the variable parts inside the prepared frame - NULL before setup */
+    uint8_t* smpCntBuf;
+    uint8_t* smpSynchBuf;
+    uint8_t* refrTmBuf;
+    uint8_t* dataBuf;
 
-    bool hasDataSetName; /* optional fields in sv asdu */
-    bool hasRefreshTime;
-    bool hasSampleRate;
+    struct sSVPublisher_ASDU* _next;
 };
 
+struct sSVPublisher {
+    uint8_t* buffer;
+    EthernetSocket ethernetSocket;
+    int lengthField;
+    int payloadStart;
+    int payloadLength;
+
+    int asduCount;
+    SVPublisher_ASDU asduList;
+
+    /* copies of the queued frames - allocated by the first call of SVPublisher_enqueue */
+    uint8_t* queueFrames;
+    uint8_t* queueBuffers[CONFIG_SV_TRANSMIT_QUEUE_SIZE];
+    int queueFrameSizes[CONFIG_SV_TRANSMIT_QUEUE_SIZE];
+    int queuedFrames;
+
+    PcapWriter captureFile;
+    bool captureOnly; /* write the frames to the capture file without sending them */
+};
 
 static void
-preparePacketBuffer(SampledValuesPublisher self, CommParameters* parameters, char* interfaceID)
+preparePacketBuffer(SVPublisher self, CommParameters* parameters, char* interfaceID)
 {
-    //TODO can GOOSE code be reused?
-
     uint8_t srcAddr[6];
 
     if (interfaceID != NULL)
@@ -139,210 +165,431 @@ preparePacketBuffer(SampledValuesPublisher self, CommParameters* parameters, cha
     self->payloadStart = bufPos;
 }
 
+static void
+encodeUInt16FixedSize(uint16_t value, uint8_t* buffer)
+{
+    buffer[0] = (uint8_t) (value >> 8);
+    buffer[1] = (uint8_t) value;
+}
+
+static void
+encodeUInt32FixedSize(uint32_t value, uint8_t* buffer)
+{
+    buffer[0] = (uint8_t) (value >> 24);
+    buffer[1] = (uint8_t) (value >> 16);
+    buffer[2] = (uint8_t) (value >> 8);
+    buffer[3] = (uint8_t) value;
+}
+
+static void
+encodeUtcTime(uint64_t timeInMs, uint8_t* buffer)
+{
+    uint32_t remainder = (timeInMs % 1000LL);
+    uint32_t fractionOfSecond = (remainder) * 16777 + ((remainder * 216) / 1000);
+
+    encodeUInt32FixedSize((uint32_t) (timeInMs / 1000LL), buffer);
+
+    /* encode fraction of second */
+    buffer[4] = ((fractionOfSecond >> 16) & 0xff);
+    buffer[5] = ((fractionOfSecond >> 8) & 0xff);
+    buffer[6] = (fractionOfSecond & 0xff);
+
+    /* encode time quality */
+    buffer[7] = 0x0a; /* 10 bit sub-second time accuracy */
+}
+
+static uint32_t
+determineAsduLength(SVPublisher_ASDU asdu)
+{
+    uint32_t asduLength = 0;
+
+    asduLength += BerEncoder_determineEncodedStringSize(asdu->svID);
+
+    if (asdu->datset != NULL)
+        asduLength += BerEncoder_determineEncodedStringSize(asdu->datset);
+
+    asduLength += 4 + 6 + 3; /* for smpCnt + confRev + smpSynch */
+
+    if (asdu->hasRefrTm)
+        asduLength += 10; /* for refrTm */
+
+    if (asdu->hasSmpRate)
+        asduLength += 4; /* for smpRate */
+
+    uint32_t dataSize = asdu->channelCount * SV_SAMPLE_SIZE;
+
+    asduLength += 1 + BerEncoder_determineLengthSize(dataSize) + dataSize;
+
+    return asduLength;
+}
 
 static int
-encodeUInt16WithTLFixedSize(uint8_t tag, uint16_t value, uint8_t* buffer, int bufPos)
+encodeAsdu(SVPublisher_ASDU asdu, uint32_t asduLength, uint8_t* buffer, int bufPos)
 {
-    uint8_t* valueArray = (uint8_t*) &value;
+    bufPos = BerEncoder_encodeTL(0x30, asduLength, buffer, bufPos);
 
-    buffer[bufPos++] = tag;
-    buffer[bufPos++] = 2;
+    /* Encode svID */
+    bufPos = BerEncoder_encodeStringWithTag(0x80, asdu->svID, buffer, bufPos);
 
-#if (ORDER_LITTLE_ENDIAN == 1)
-    buffer[bufPos++] = valueArray[1];
-    buffer[bufPos++] = valueArray[0];
-#else
-    buffer[bufPos++] = valueArray[0];
-    buffer[bufPos++] = valueArray[1];
-#endif
+    /* Encode datset */
+    if (asdu->datset != NULL)
+        bufPos = BerEncoder_encodeStringWithTag(0x81, asdu->datset, buffer, bufPos);
+
+    /* Encode smpCnt */
+    bufPos = BerEncoder_encodeTL(0x82, 2, buffer, bufPos);
+    asdu->smpCntBuf = buffer + bufPos;
+    encodeUInt16FixedSize(asdu->smpCnt, buffer + bufPos);
+    bufPos += 2;
+
+    /* Encode confRev */
+    bufPos = BerEncoder_encodeTL(0x83, 4, buffer, bufPos);
+    encodeUInt32FixedSize(asdu->confRev, buffer + bufPos);
+    bufPos += 4;
+
+    /* Encode refrTm */
+    if (asdu->hasRefrTm) {
+        bufPos = BerEncoder_encodeTL(0x84, 8, buffer, bufPos);
+        asdu->refrTmBuf = buffer + bufPos;
+        encodeUtcTime(asdu->refrTm, buffer + bufPos);
+        bufPos += 8;
+    }
+
+    /* Encode smpSynch */
+    bufPos = BerEncoder_encodeTL(0x85, 1, buffer, bufPos);
+    asdu->smpSynchBuf = buffer + bufPos;
+    buffer[bufPos++] = asdu->smpSynch;
+
+    /* Encode smpRate */
+    if (asdu->hasSmpRate) {
+        bufPos = BerEncoder_encodeTL(0x86, 2, buffer, bufPos);
+        encodeUInt16FixedSize(asdu->smpRate, buffer + bufPos);
+        bufPos += 2;
+    }
+
+    /* Encode sample data - initialized with 0 */
+    int dataSize = asdu->channelCount * SV_SAMPLE_SIZE;
+
+    bufPos = BerEncoder_encodeTL(0x87, dataSize, buffer, bufPos);
+    asdu->dataBuf = buffer + bufPos;
+    memset(buffer + bufPos, 0, dataSize);
+    bufPos += dataSize;
 
     return bufPos;
 }
 
 static int
-encodeUInt32WithTLFixedSize(uint8_t tag, uint32_t value, uint8_t* buffer, int bufPos)
+createSVPayload(SVPublisher self, uint8_t* buffer, int maxPayloadSize)
 {
-    uint8_t* valueArray = (uint8_t*) &value;
-
-    buffer[bufPos++] = tag;
-    buffer[bufPos++] = 2;
-
-#if (ORDER_LITTLE_ENDIAN == 1)
-    buffer[bufPos++] = valueArray[3];
-    buffer[bufPos++] = valueArray[2];
-    buffer[bufPos++] = valueArray[1];
-    buffer[bufPos++] = valueArray[0];
-#else
-    buffer[bufPos++] = valueArray[0];
-    buffer[bufPos++] = valueArray[1];
-    buffer[bufPos++] = valueArray[2];
-    buffer[bufPos++] = valueArray[3];
-#endif
+    /* Step 1 - calculate length fields */
+    uint32_t sequenceOfAsduLength = 0;
+
+    SVPublisher_ASDU asdu = self->asduList;
+
+    while (asdu != NULL) {
+        uint32_t asduLength = determineAsduLength(asdu);
+
+        sequenceOfAsduLength += 1 + BerEncoder_determineLengthSize(asduLength) + asduLength;
+
+        asdu = asdu->_next;
+    }
+
+    uint32_t svPduLength = 2 + BerEncoder_UInt32determineEncodedSize(self->asduCount);
+
+    svPduLength += 1 + BerEncoder_determineLengthSize(sequenceOfAsduLength) + sequenceOfAsduLength;
+
+    if ((int) (1 + BerEncoder_determineLengthSize(svPduLength) + svPduLength) > maxPayloadSize)
+        return -1;
+
+    /* Step 2 - encode to buffer */
+    int bufPos = 0;
+
+    /* Encode SV PDU */
+    bufPos = BerEncoder_encodeTL(0x60, svPduLength, buffer, bufPos);
+
+    /* Encode noASDU */
+    bufPos = BerEncoder_encodeUInt32WithTL(0x80, self->asduCount, buffer, bufPos);
+
+    /* Encode sequence of ASDUs */
+    bufPos = BerEncoder_encodeTL(0xa2, sequenceOfAsduLength, buffer, bufPos);
+
+    asdu = self->asduList;
+
+    while (asdu != NULL) {
+        bufPos = encodeAsdu(asdu, determineAsduLength(asdu), buffer, bufPos);
+
+        asdu = asdu->_next;
+    }
 
     return bufPos;
 }
 
-static int
-determineEncodedMmsValueSize(MmsValue* value)
+SVPublisher
+SVPublisher_create(CommParameters* parameters, char* interfaceId)
 {
-   switch (MmsValue_getType(value)) {
-   case MMS_ARRAY:
-   case MMS_STRUCTURE: {
-	   int compCount = value->value.structure.size;
-	   int i;
-	   int encodedSize = 0;
-
-	   for (i = 0; i < compCount; i++) {
-		   encodedSize += determineEncodedMmsValueSize(value->value.structure.components[i]);
-	   }
-
-	   return encodedSize;
-   }
-   case MMS_INTEGER:
-       return value->value.integer->maxSize;
-       break;
-   case MMS_UNSIGNED:
-       return value->value.unsignedInteger->maxSize;
-   case MMS_FLOAT:
-       return value->value.floatingPoint.formatWidth / 8;
-   case MMS_BIT_STRING:
-	   return 4;
-   case MMS_UTC_TIME:
-	   return 8;
-   case MMS_BINARY_TIME:
-	   return 6;
-   case MMS_BOOLEAN:
-	   return 1;
-   default:
-	   printf("Data type not supported for sampled values service!\n");
-	   return 0;
-   }
+    SVPublisher self = (SVPublisher) calloc(1, sizeof(struct sSVPublisher));
+
+    preparePacketBuffer(self, parameters, interfaceId);
+
+    self->payloadLength = -1;
+
+    return self;
 }
 
-static int
-encodeMmsValue(MmsValue* value, uint8_t* buffer, int bufPos)
+SVPublisher_ASDU
+SVPublisher_addASDU(SVPublisher self, char* svID, char* datset, uint32_t confRev, int channelCount)
 {
-	switch (MmsValue_getType(value)) {
-	   case MMS_ARRAY:
-	   case MMS_STRUCTURE: {
-		   int compCount = value->value.structure.size;
-		   int i;
-
-		   for (i = 0; i < compCount; i++) {
-			   bufPos = encodeMmsValue(value->value.structure.components[i], buffer, bufPos);
-		   }
-
-		   return bufPos;
-	   }
-	}
+    SVPublisher_ASDU newAsdu = (SVPublisher_ASDU) calloc(1, sizeof(struct sSVPublisher_ASDU));
+
+    newAsdu->svID = copyString(svID);
+
+    if (datset != NULL)
+        newAsdu->datset = copyString(datset);
+
+    newAsdu->confRev = confRev;
+    newAsdu->channelCount = channelCount;
+
+    /* append to the end of the list to keep the order of the ASDUs */
+    if (self->asduList == NULL)
+        self->asduList = newAsdu;
+    else {
+        SVPublisher_ASDU lastAsdu = self->asduList;
+
+        while (lastAsdu->_next != NULL)
+            lastAsdu = lastAsdu->_next;
+
+        lastAsdu->_next = newAsdu;
+    }
+
+    self->asduCount++;
+    self->payloadLength = -1;
+
+    return newAsdu;
 }
 
-static int
-createSVPayload(SampledValuesPublisher self, LinkedList dataSetValues, uint8_t* buffer, int maxPayloadSize) {
+bool
+SVPublisher_setupComplete(SVPublisher self)
+{
+    uint8_t* buffer = self->buffer + self->payloadStart;
 
-    /* Step 1 - calculate length fields */
-    uint32_t asduLength = 0;
+    self->payloadLength = createSVPayload(self, buffer, SV_MAX_MESSAGE_SIZE - self->payloadStart);
 
-    asduLength += BerEncoder_determineEncodedStringSize(self->id);
+    if (self->payloadLength == -1) {
+        if (DEBUG) printf("SV_PUBLISHER: ASDUs too large for a single frame!\n");
+        return false;
+    }
 
-    if (self->hasDataSetName)
-        asduLength += BerEncoder_determineEncodedStringSize(self->dataSetRef);
+    int svLength = self->payloadLength + 8;
 
-    asduLength += 4 + 6 + 3 + 4; /* for smpCnt + confRev + smpSynch + smpMod */
+    self->buffer[self->lengthField] = svLength / 256;
+    self->buffer[self->lengthField + 1] = svLength & 0xff;
 
-    if (self->hasRefreshTime)
-        asduLength += 10; /* for refrTim */
+    return true;
+}
 
-    if (self->hasSampleRate)
-        asduLength += 4; /* for smpRate */
+void
+SVPublisher_setCaptureFile(SVPublisher self, PcapWriter captureFile, bool captureOnly)
+{
+    self->captureFile = captureFile;
+    self->captureOnly = captureOnly;
+}
 
-    uint32_t numberOfDataSetEntries = LinkedList_size(dataSetValues);
+int
+SVPublisher_publish(SVPublisher self)
+{
+    if (self->payloadLength == -1)
+        return -1;
 
-    asduLength += 2 + BerEncoder_UInt32determineEncodedSize(numberOfDataSetEntries);
+    if (self->captureFile != NULL) {
+        PcapWriter_writeFrame(self->captureFile, self->buffer, self->payloadStart + self->payloadLength,
+                Hal_getTimeInNs());
 
-    uint32_t dataSetSize = 0;
+        if (self->captureOnly)
+            return 0;
+    }
 
-    LinkedList element = LinkedList_getNext(dataSetValues);
+    if (self->ethernetSocket == NULL)
+        return -1;
+
+    Ethernet_sendPacket(self->ethernetSocket, self->buffer, self->payloadStart + self->payloadLength);
+
+    return 0;
+}
 
-    while (element != NULL) {
-        MmsValue* dataSetEntry = (MmsValue*) element->data;
+int
+SVPublisher_enqueue(SVPublisher self)
+{
+    if (self->payloadLength == -1)
+        return -1;
 
-        dataSetSize += determineEncodedMmsValueSize(dataSetEntry);
+    /* captured frames get the time stamp of the enqueue call */
+    if (self->captureFile != NULL)
+        return SVPublisher_publish(self);
 
-        element = LinkedList_getNext(element);
+    if (self->ethernetSocket == NULL)
+        return -1;
+
+    if (self->queueFrames == NULL) {
+        self->queueFrames = (uint8_t*) malloc(CONFIG_SV_TRANSMIT_QUEUE_SIZE * SV_MAX_MESSAGE_SIZE);
+
+        int i;
+
+        for (i = 0; i < CONFIG_SV_TRANSMIT_QUEUE_SIZE; i++)
+            self->queueBuffers[i] = self->queueFrames + (i * SV_MAX_MESSAGE_SIZE);
     }
 
-    uint32_t allDataSize = dataSetSize + BerEncoder_determineLengthSize(dataSetSize) + 1;
+    if (self->queuedFrames == CONFIG_SV_TRANSMIT_QUEUE_SIZE)
+        SVPublisher_flush(self);
 
-    asduLength += allDataSize;
+    int frameSize = self->payloadStart + self->payloadLength;
 
-    uint32_t sequenceOfAsduLength = 1 + BerEncoder_DetermineLengthSize(asduLength) + asduLength;
+    memcpy(self->queueBuffers[self->queuedFrames], self->buffer, frameSize);
 
-    uint32_t apduLength = 1 + BerEncoder_DetermineLengthSize(sequenceOfAsduLength) + sequenceOfAsduLength;
+    self->queueFrameSizes[self->queuedFrames] = frameSize;
+    self->queuedFrames++;
 
-    //TODO add length of ASDU header
+    return 0;
+}
 
-    if (apduLength > maxPayloadSize)
+int
+SVPublisher_flush(SVPublisher self)
+{
+    if (self->queuedFrames == 0)
+        return 0;
+
+    if (self->ethernetSocket == NULL)
         return -1;
 
-    /* Step 2 - encode to buffer */
+    int sent = Ethernet_sendPackets(self->ethernetSocket, self->queueBuffers, self->queueFrameSizes,
+            self->queuedFrames);
 
-    int bufPos = 0;
+    self->queuedFrames = 0;
 
-    /* Encode SV PDU */
-    bufPos = BerEncoder_encodeTL(0x60, apduLength, buffer, bufPos);
+    return sent;
+}
 
-    /* Encode No. of ASDUs */
-    bufPos = encodeUInt16WithTLFixedSize(0x80, 1, buffer, bufPos);
-    //bufPos = BerEncoder_encodeUInt32WithTL(0x80, 1, buffer, bufPos);
+void
+SVPublisher_destroy(SVPublisher self)
+{
+    SVPublisher_flush(self);
 
-    /* Encode Sequence of ASDUs */
-    bufPos = BerEncoder_encodeTL(0xa2, sequenceOfAsduLength, buffer, bufPos);
+    if (self->ethernetSocket != NULL)
+        Ethernet_destroySocket(self->ethernetSocket);
 
-    /* Encode ASDU */
-    bufPos = BerEncoder_encodeTL(0x30, asduLength, buffer, bufPos);
+    SVPublisher_ASDU asdu = self->asduList;
 
-    /* Encode svID */
-    bufPos = BerEncoder_encodeStringWithTag(0x80, self->id, buffer, bufPos);
+    while (asdu != NULL) {
+        SVPublisher_ASDU nextAsdu = asdu->_next;
 
-    /* Encode dataSetRef */
-    if (self->hasDataSetName)
-        bufPos = BerEncoder_encodeStringWithTag(0x81, self->dataSetRef, buffer, bufPos);
+        free(asdu->svID);
 
-    /* Encode smpCnt */
-    bufPos = encodeUInt16WithTLFixedSize(0x82, self->smpCount, buffer, bufPos);
+        if (asdu->datset != NULL)
+            free(asdu->datset);
 
-    /* Encode confRev */
-    bufPos = encodeUInt32WithTLFixedSize(0x83, self->confRev, buffer, bufPos);
+        free(asdu);
 
-    /* Encode refreshTime */
-    if (self->hasRefreshTime) {
-    	MmsValue_setUtcTimeMs(self->refTime, self->refreshTime);
-    	bufPos = BerEncoder_encodeOctetString(0x84, self->refTime->value.utcTime, 8, buffer, bufPos);
+        asdu = nextAsdu;
     }
 
-    /* Encode smpSynch */
-    bufPos = BerEncoder_encodeTL(0x85, dataSetSize, buffer, bufPos);
-    buffer[bufPos++] = self->smpSynch;
+    if (self->queueFrames != NULL)
+        free(self->queueFrames);
 
-    /* Encode smpRate */
-    if (self->hasSampleRate) {
-    	bufPos = encodeUInt16WithTLFixedSize(0x86, self->smpRate, buffer, bufPos);
-    }
+    free(self->buffer);
+    free(self);
+}
+
+void
+SVPublisher_ASDU_setSmpRate(SVPublisher_ASDU self, uint16_t smpRate)
+{
+    self->hasSmpRate = true;
+    self->smpRate = smpRate;
+}
+
+void
+SVPublisher_ASDU_enableRefrTm(SVPublisher_ASDU self)
+{
+    self->hasRefrTm = true;
+}
+
+void
+SVPublisher_ASDU_setSmpCnt(SVPublisher_ASDU self, uint16_t smpCnt)
+{
+    self->smpCnt = smpCnt;
+
+    if (self->smpCntBuf != NULL)
+        encodeUInt16FixedSize(smpCnt, self->smpCntBuf);
+}
+
+uint16_t
+SVPublisher_ASDU_getSmpCnt(SVPublisher_ASDU self)
+{
+    return self->smpCnt;
+}
+
+void
+SVPublisher_ASDU_setSmpCntWrap(SVPublisher_ASDU self, uint16_t smpCntWrap)
+{
+    self->smpCntWrap = smpCntWrap;
+}
+
+void
+SVPublisher_ASDU_increaseSmpCnt(SVPublisher_ASDU self)
+{
+    uint16_t smpCnt = self->smpCnt + 1;
 
-    /* Encode sequence of data */
-    bufPos = BerEncoder_encodeTL(0x87, dataSetSize, buffer, bufPos);
+    if ((self->smpCntWrap != 0) && (smpCnt >= self->smpCntWrap))
+        smpCnt = 0;
 
-    /* Encode data set entries */
-    element = LinkedList_getNext(dataSetValues);
+    SVPublisher_ASDU_setSmpCnt(self, smpCnt);
+}
 
-    while (element != NULL) {
-        MmsValue* dataSetEntry = (MmsValue*) element->data;
+void
+SVPublisher_ASDU_setSmpSynch(SVPublisher_ASDU self, uint8_t smpSynch)
+{
+    self->smpSynch = smpSynch;
 
-        bufPos = mmsServer_encodeAccessResult(dataSetEntry, buffer, bufPos, true);
+    if (self->smpSynchBuf != NULL)
+        *(self->smpSynchBuf) = smpSynch;
+}
 
-        element = LinkedList_getNext(element);
+void
+SVPublisher_ASDU_setRefrTm(SVPublisher_ASDU self, uint64_t refrTm)
+{
+    self->refrTm = refrTm;
+
+    if (self->refrTmBuf != NULL)
+        encodeUtcTime(refrTm, self->refrTmBuf);
+}
+
+void
+SVPublisher_ASDU_setSamples(SVPublisher_ASDU self, int32_t* values, uint32_t* qualities)
+{
+    uint8_t* buffer = self->dataBuf;
+
+    if (buffer == NULL)
+        return;
+
+    int i;
+
+    for (i = 0; i < self->channelCount; i++) {
+        encodeUInt32FixedSize((uint32_t) values[i], buffer);
+
+        if (qualities != NULL)
+            encodeUInt32FixedSize(qualities[i], buffer + 4);
+        else
+            memset(buffer + 4, 0, 4);
+
+        buffer += SV_SAMPLE_SIZE;
     }
+}
 
-    return bufPos;
+void
+SVPublisher_ASDU_setSample(SVPublisher_ASDU self, int channel, int32_t value, uint32_t quality)
+{
+    if ((self->dataBuf == NULL) || (channel < 0) || (channel >= self->channelCount))
+        return;
+
+    uint8_t* buffer = self->dataBuf + (channel * SV_SAMPLE_SIZE);
+
+    encodeUInt32FixedSize((uint32_t) value, buffer);
+    encodeUInt32FixedSize(quality, buffer + 4);
 }
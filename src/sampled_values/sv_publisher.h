@@ -0,0 +1,194 @@
+/*
+ *  sv_publisher.h
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SV_PUBLISHER_H_
+#define SV_PUBLISHER_H_
+
+#include "libiec61850_common_api.h"
+#include "goose_publisher.h" /* for CommParameters */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \defgroup sv_publisher_api_group IEC 61850 sampled values (SV) publisher API
+ */
+/**@{*/
+
+typedef struct sSVPublisher* SVPublisher;
+
+typedef struct sSVPublisher_ASDU* SVPublisher_ASDU;
+
+/**
+ * \brief Create a new sampled values publisher.
+ *
+ * The ASDUs have to be added with SVPublisher_addASDU and the frame has to be prepared
+ * with SVPublisher_setupComplete before samples can be published.
+ *
+ * \param parameters destination address, VLAN and APPID or NULL to use the default values
+ * \param interfaceId the ethernet interface to send the messages or NULL to use the default interface
+ */
+SVPublisher
+SVPublisher_create(CommParameters* parameters, char* interfaceId);
+
+/**
+ * \brief Add an ASDU to the messages sent by the publisher.
+ *
+ * Each ASDU carries channelCount samples. Each sample consists of a 32 bit value and a 32 bit
+ * quality (like the data sets of IEC 61850-9-2 LE). Adding multiple ASDUs sends multiple
+ * consecutive sample sets in a single frame (noASDU > 1).
+ *
+ * \param svID the sampled value ID (MsvID)
+ * \param datset the data set reference or NULL if it should not be included in the message
+ * \param confRev the configuration revision
+ * \param channelCount number of samples (value + quality) in the ASDU
+ */
+SVPublisher_ASDU
+SVPublisher_addASDU(SVPublisher self, char* svID, char* datset, uint32_t confRev, int channelCount);
+
+/**
+ * \brief include the optional smpRate field in the ASDU (has to be called before SVPublisher_setupComplete)
+ */
+void
+SVPublisher_ASDU_setSmpRate(SVPublisher_ASDU self, uint16_t smpRate);
+
+/**
+ * \brief include the optional refrTm field in the ASDU (has to be called before SVPublisher_setupComplete)
+ */
+void
+SVPublisher_ASDU_enableRefrTm(SVPublisher_ASDU self);
+
+/**
+ * \brief Encode the message skeleton after all ASDUs have been added.
+ *
+ * The constant parts of the message (header, svID, datset, confRev, length fields) are only
+ * encoded once. Sample counter, synchronization state, refresh time and the samples are written
+ * to fixed positions inside the prepared frame.
+ *
+ * \return true if the message fits into an ethernet frame
+ */
+bool
+SVPublisher_setupComplete(SVPublisher self);
+
+/**
+ * \brief send the prepared frame with the current values of all ASDUs
+ *
+ * \return 0 on success, -1 if the frame is not set up or the ethernet socket could not be opened
+ */
+int
+SVPublisher_publish(SVPublisher self);
+
+/**
+ * \brief copy the prepared frame with the current values of all ASDUs to the transmit queue
+ *
+ * The queued frames are sent with a single system call by SVPublisher_flush. If the queue is
+ * full the queued frames are sent before the frame is added.
+ *
+ * \return 0 on success, -1 if the frame is not set up or the ethernet socket could not be opened
+ */
+int
+SVPublisher_enqueue(SVPublisher self);
+
+/**
+ * \brief send all frames of the transmit queue
+ *
+ * \return the number of frames sent or -1 if the ethernet socket could not be opened
+ */
+int
+SVPublisher_flush(SVPublisher self);
+
+/**
+ * \brief Write all frames of the publisher to a pcap capture file.
+ *
+ * Each frame is written with the current time when it is published. Frames passed to
+ * SVPublisher_enqueue are published directly while a capture file is set. In capture only
+ * mode the frames are not sent, so no privileges are required to create capture files for
+ * replay and benchmarks.
+ *
+ * \param captureFile the capture file or NULL to stop capturing
+ * \param captureOnly write the frames to the file without sending them
+ */
+void
+SVPublisher_setCaptureFile(SVPublisher self, PcapWriter captureFile, bool captureOnly);
+
+void
+SVPublisher_destroy(SVPublisher self);
+
+void
+SVPublisher_ASDU_setSmpCnt(SVPublisher_ASDU self, uint16_t smpCnt);
+
+uint16_t
+SVPublisher_ASDU_getSmpCnt(SVPublisher_ASDU self);
+
+/**
+ * \brief set the value after that the sample counter starts again with 0 (e.g. 4000 for 4000 samples/s)
+ *
+ * The default is 0 (counter wraps at 65536).
+ */
+void
+SVPublisher_ASDU_setSmpCntWrap(SVPublisher_ASDU self, uint16_t smpCntWrap);
+
+/**
+ * \brief increase the sample counter by one (considering the wrap value)
+ */
+void
+SVPublisher_ASDU_increaseSmpCnt(SVPublisher_ASDU self);
+
+void
+SVPublisher_ASDU_setSmpSynch(SVPublisher_ASDU self, uint8_t smpSynch);
+
+/**
+ * \brief set the refresh time (only if enabled by SVPublisher_ASDU_enableRefrTm)
+ *
+ * \param refrTm the time in ms since epoch
+ */
+void
+SVPublisher_ASDU_setRefrTm(SVPublisher_ASDU self, uint64_t refrTm);
+
+/**
+ * \brief write the values of all samples of the ASDU to the prepared frame
+ *
+ * Has no effect before SVPublisher_setupComplete has been called.
+ *
+ * \param values array with channelCount values
+ * \param qualities array with channelCount quality values or NULL if all qualities are 0 (good)
+ */
+void
+SVPublisher_ASDU_setSamples(SVPublisher_ASDU self, int32_t* values, uint32_t* qualities);
+
+/**
+ * \brief write the value of a single sample to the prepared frame
+ *
+ * Has no effect before SVPublisher_setupComplete has been called.
+ */
+void
+SVPublisher_ASDU_setSample(SVPublisher_ASDU self, int channel, int32_t value, uint32_t quality);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SV_PUBLISHER_H_ */
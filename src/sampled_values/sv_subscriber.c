@@ -0,0 +1,519 @@
+/*
+ *  sv_subscriber.c
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#include "libiec61850_platform_includes.h"
+
+#include "stack_config.h"
+#include "sv_subscriber.h"
+#include "ethernet.h"
+#include "thread.h"
+#include "linked_list.h"
+
+#include "ber_decode.h"
+
+#define ETH_P_SV 0x88ba
+
+/* maximum time in ms the receiver thread waits for new frames before checking for a stop request */
+#define SV_RECEIVER_WAIT_TIMEOUT 100
+
+/* encoded size of a sample (INT32 value + quality) */
+#define SV_SAMPLE_SIZE 8
+
+/* The ring buffer indices are shared between the receiver thread (producer) and the
+ * application thread (consumer). The producer publishes a sample by storing the new head
+ * index with release semantics after the sample has been written. */
+#if defined(__GNUC__)
+#define SV_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define SV_STORE_RELEASE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#else
+/* volatile accesses have acquire/release semantics with MSVC */
+#define SV_LOAD_ACQUIRE(ptr) (*(ptr))
+#define SV_STORE_RELEASE(ptr, value) (*(ptr) = (value))
+#endif
+
+struct sSVReceiver {
+    char* interfaceId;
+    bool running;
+    Thread thread;
+    EthernetSocket ethSocket;
+
+    Semaphore subscriberMutex;
+    LinkedList subscriberList;
+};
+
+struct sSVSubscriber {
+    char* svID;
+    int svIDLength;
+    int32_t appId; /* APPID or -1 if APPID should be ignored */
+    int channelCount;
+
+    uint32_t smpCntWrap;
+    uint16_t nextSmpCnt;
+    bool nextSmpCntValid;
+
+    /* ring buffer */
+    uint32_t ringSize; /* power of two */
+    volatile uint32_t head; /* next sample written by the receiver */
+    volatile uint32_t tail; /* next sample read by the application */
+    uint16_t* smpCntRing;
+    uint64_t* timestampRing;
+    int32_t* valueRing;
+    uint32_t* qualityRing;
+
+    SVSubscriberStatistics statistics;
+};
+
+static int32_t
+decodeInt32(uint8_t* buffer)
+{
+    return (int32_t) (((uint32_t) buffer[0] << 24) + ((uint32_t) buffer[1] << 16) +
+            ((uint32_t) buffer[2] << 8) + (uint32_t) buffer[3]);
+}
+
+static void
+storeSample(SVSubscriber self, uint16_t smpCnt, uint8_t* data, int dataLength, uint64_t timestamp)
+{
+    if (dataLength != self->channelCount * SV_SAMPLE_SIZE) {
+        self->statistics.errors++;
+        return;
+    }
+
+    self->statistics.received++;
+
+    /* gap detection */
+    if (self->nextSmpCntValid && (smpCnt != self->nextSmpCnt)) {
+        self->statistics.gaps++;
+        self->statistics.missing += (smpCnt + self->smpCntWrap - self->nextSmpCnt) % self->smpCntWrap;
+    }
+
+    self->nextSmpCnt = (uint16_t) ((smpCnt + 1) % self->smpCntWrap);
+    self->nextSmpCntValid = true;
+
+    uint32_t head = self->head;
+
+    if (head - SV_LOAD_ACQUIRE(&(self->tail)) == self->ringSize) {
+        self->statistics.overflows++;
+        return;
+    }
+
+    uint32_t index = head & (self->ringSize - 1);
+
+    self->smpCntRing[index] = smpCnt;
+    self->timestampRing[index] = timestamp;
+
+    int32_t* values = self->valueRing + (index * self->channelCount);
+    uint32_t* qualities = self->qualityRing + (index * self->channelCount);
+
+    int i;
+
+    for (i = 0; i < self->channelCount; i++) {
+        values[i] = decodeInt32(data);
+        qualities[i] = (uint32_t) decodeInt32(data + 4);
+        data += SV_SAMPLE_SIZE;
+    }
+
+    SV_STORE_RELEASE(&(self->head), head + 1);
+}
+
+/* has to be called with the subscriber mutex locked */
+static SVSubscriber
+findSubscriber(SVReceiver self, uint16_t appId, uint8_t* svID, int svIDLength)
+{
+    LinkedList element = LinkedList_getNext(self->subscriberList);
+
+    while (element != NULL) {
+        SVSubscriber subscriber = (SVSubscriber) element->data;
+
+        if ((subscriber->svIDLength == svIDLength) && ((subscriber->appId < 0) || (subscriber->appId == appId))) {
+            if (memcmp(subscriber->svID, svID, svIDLength) == 0)
+                return subscriber;
+        }
+
+        element = LinkedList_getNext(element);
+    }
+
+    return NULL;
+}
+
+static void
+parseASDU(SVReceiver self, uint16_t appId, uint8_t* buffer, int length, uint64_t timestamp)
+{
+    int bufPos = 0;
+
+    uint8_t* svID = NULL;
+    int svIDLength = 0;
+    uint16_t smpCnt = 0;
+    uint8_t* data = NULL;
+    int dataLength = 0;
+
+    while (bufPos < length) {
+        int elementLength;
+
+        uint8_t tag = buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(buffer, &elementLength, bufPos, length);
+
+        if ((bufPos < 0) || (bufPos + elementLength > length)) {
+            if (DEBUG)
+                printf("SV_SUBSCRIBER: malformed ASDU\n");
+            return;
+        }
+
+        switch (tag) {
+        case 0x80: /* svID */
+            svID = buffer + bufPos;
+            svIDLength = elementLength;
+            break;
+
+        case 0x82: /* smpCnt */
+            if (elementLength == 2)
+                smpCnt = (buffer[bufPos] << 8) + buffer[bufPos + 1];
+            break;
+
+        case 0x87: /* seqData */
+            data = buffer + bufPos;
+            dataLength = elementLength;
+            break;
+
+        default: /* datset, confRev, refrTm, smpSynch, smpRate, smpMod are ignored */
+            break;
+        }
+
+        bufPos += elementLength;
+    }
+
+    if ((svID == NULL) || (data == NULL))
+        return;
+
+    SVSubscriber subscriber = findSubscriber(self, appId, svID, svIDLength);
+
+    if (subscriber != NULL)
+        storeSample(subscriber, smpCnt, data, dataLength, timestamp);
+}
+
+static void
+parseSVPayload(SVReceiver self, uint16_t appId, uint8_t* buffer, int apduLength, uint64_t timestamp)
+{
+    int bufPos = 0;
+    int svPduLength;
+
+    if (buffer[bufPos++] != 0x60)
+        return;
+
+    bufPos = BerDecoder_decodeLength(buffer, &svPduLength, bufPos, apduLength);
+
+    if ((bufPos < 0) || (bufPos + svPduLength > apduLength))
+        return;
+
+    int svPduEnd = bufPos + svPduLength;
+
+    while (bufPos < svPduEnd) {
+        int elementLength;
+
+        uint8_t tag = buffer[bufPos++];
+
+        bufPos = BerDecoder_decodeLength(buffer, &elementLength, bufPos, svPduEnd);
+
+        if ((bufPos < 0) || (bufPos + elementLength > svPduEnd))
+            return;
+
+        if (tag == 0xa2) { /* sequence of ASDUs */
+            int asduPos = bufPos;
+            int asduEnd = bufPos + elementLength;
+
+            while (asduPos < asduEnd) {
+                int asduLength;
+
+                uint8_t asduTag = buffer[asduPos++];
+
+                asduPos = BerDecoder_decodeLength(buffer, &asduLength, asduPos, asduEnd);
+
+                if ((asduPos < 0) || (asduPos + asduLength > asduEnd))
+                    return;
+
+                if (asduTag == 0x30)
+                    parseASDU(self, appId, buffer + asduPos, asduLength, timestamp);
+
+                asduPos += asduLength;
+            }
+        }
+
+        /* noASDU and security are ignored */
+
+        bufPos += elementLength;
+    }
+}
+
+void
+SVReceiver_handleMessage(SVReceiver self, uint8_t* buffer, int length, uint64_t timestamp)
+{
+    if (length < 22)
+        return;
+
+    /* skip ethernet addresses */
+    int bufPos = 12;
+    int headerLength = 14;
+
+    /* check for VLAN tag */
+    if ((buffer[bufPos] == 0x81) && (buffer[bufPos + 1] == 0x00)) {
+        bufPos += 4; /* skip VLAN tag */
+        headerLength += 4;
+    }
+
+    /* check for SV Ethertype */
+    if (buffer[bufPos++] != 0x88)
+        return;
+    if (buffer[bufPos++] != 0xba)
+        return;
+
+    uint16_t appId;
+
+    appId = buffer[bufPos++] * 0x100;
+    appId += buffer[bufPos++];
+
+    uint16_t svLength;
+
+    svLength = buffer[bufPos++] * 0x100;
+    svLength += buffer[bufPos++];
+
+    /* skip reserved fields */
+    bufPos += 4;
+
+    int apduLength = svLength - 8;
+
+    if ((apduLength < 2) || (length < svLength + headerLength)) {
+        if (DEBUG)
+            printf("SV_SUBSCRIBER: Invalid PDU size\n");
+        return;
+    }
+
+    if (timestamp == 0)
+        timestamp = Hal_getTimeInNs();
+
+    Semaphore_wait(self->subscriberMutex);
+
+    parseSVPayload(self, appId, buffer + bufPos, apduLength, timestamp);
+
+    Semaphore_post(self->subscriberMutex);
+}
+
+static void
+handleFrame(void* parameter, uint8_t* buffer, int length, uint64_t timestamp)
+{
+    SVReceiver_handleMessage((SVReceiver) parameter, buffer, length, timestamp);
+}
+
+static void
+svReceiverLoop(void* threadParameter)
+{
+    SVReceiver self = (SVReceiver) threadParameter;
+
+    while (self->running) {
+        if (Ethernet_receivePackets(self->ethSocket, handleFrame, self, SV_RECEIVER_WAIT_TIMEOUT) < 0)
+            Thread_sleep(SV_RECEIVER_WAIT_TIMEOUT);
+    }
+}
+
+SVReceiver
+SVReceiver_create()
+{
+    SVReceiver self = (SVReceiver) calloc(1, sizeof(struct sSVReceiver));
+
+    self->subscriberMutex = Semaphore_create(1);
+    self->subscriberList = LinkedList_create();
+
+    return self;
+}
+
+void
+SVReceiver_setInterfaceId(SVReceiver self, char* interfaceId)
+{
+    if (self->interfaceId != NULL)
+        free(self->interfaceId);
+
+    self->interfaceId = copyString(interfaceId);
+}
+
+void
+SVReceiver_addSubscriber(SVReceiver self, SVSubscriber subscriber)
+{
+    Semaphore_wait(self->subscriberMutex);
+    LinkedList_add(self->subscriberList, subscriber);
+    Semaphore_post(self->subscriberMutex);
+}
+
+void
+SVReceiver_removeSubscriber(SVReceiver self, SVSubscriber subscriber)
+{
+    Semaphore_wait(self->subscriberMutex);
+    LinkedList_remove(self->subscriberList, subscriber);
+    Semaphore_post(self->subscriberMutex);
+}
+
+void
+SVReceiver_start(SVReceiver self)
+{
+    if (self->running == false) {
+
+        if (self->interfaceId == NULL)
+            self->ethSocket = Ethernet_createSocket(CONFIG_ETHERNET_INTERFACE_ID, NULL);
+        else
+            self->ethSocket = Ethernet_createSocket(self->interfaceId, NULL);
+
+        if (self->ethSocket == NULL)
+            return;
+
+        Ethernet_setProtocolFilter(self->ethSocket, ETH_P_SV);
+
+        self->running = true;
+        self->thread = Thread_create((ThreadExecutionFunction) svReceiverLoop, self, false);
+        Thread_start(self->thread);
+    }
+}
+
+void
+SVReceiver_stop(SVReceiver self)
+{
+    if (self->running) {
+        self->running = false;
+        Thread_destroy(self->thread);
+        self->thread = NULL;
+
+        Ethernet_destroySocket(self->ethSocket);
+        self->ethSocket = NULL;
+    }
+}
+
+void
+SVReceiver_destroy(SVReceiver self)
+{
+    SVReceiver_stop(self);
+
+    LinkedList_destroyStatic(self->subscriberList);
+
+    Semaphore_destroy(self->subscriberMutex);
+
+    if (self->interfaceId != NULL)
+        free(self->interfaceId);
+
+    free(self);
+}
+
+SVSubscriber
+SVSubscriber_create(char* svID, int channelCount, int ringBufferSize)
+{
+    SVSubscriber self = (SVSubscriber) calloc(1, sizeof(struct sSVSubscriber));
+
+    self->svID = copyString(svID);
+    self->svIDLength = strlen(svID);
+    self->appId = -1;
+    self->channelCount = channelCount;
+    self->smpCntWrap = 65536;
+
+    uint32_t ringSize = 1;
+
+    while (ringSize < (uint32_t) ringBufferSize)
+        ringSize = ringSize * 2;
+
+    self->ringSize = ringSize;
+    self->smpCntRing = (uint16_t*) calloc(ringSize, sizeof(uint16_t));
+    self->timestampRing = (uint64_t*) calloc(ringSize, sizeof(uint64_t));
+    self->valueRing = (int32_t*) calloc(ringSize * channelCount, sizeof(int32_t));
+    self->qualityRing = (uint32_t*) calloc(ringSize * channelCount, sizeof(uint32_t));
+
+    return self;
+}
+
+void
+SVSubscriber_setAppId(SVSubscriber self, uint16_t appId)
+{
+    self->appId = (int32_t) appId;
+}
+
+void
+SVSubscriber_setSmpCntWrap(SVSubscriber self, uint16_t smpCntWrap)
+{
+    if (smpCntWrap == 0)
+        self->smpCntWrap = 65536;
+    else
+        self->smpCntWrap = smpCntWrap;
+}
+
+void
+SVSubscriber_destroy(SVSubscriber self)
+{
+    free(self->svID);
+    free(self->smpCntRing);
+    free(self->timestampRing);
+    free(self->valueRing);
+    free(self->qualityRing);
+    free(self);
+}
+
+int
+SVSubscriber_getAvailableSamples(SVSubscriber self)
+{
+    return (int) (SV_LOAD_ACQUIRE(&(self->head)) - self->tail);
+}
+
+int
+SVSubscriber_readSamples(SVSubscriber self, int maxSamples, uint16_t* smpCnt, uint64_t* timestamps,
+        int32_t* values, uint32_t* qualities)
+{
+    uint32_t tail = self->tail;
+
+    int available = (int) (SV_LOAD_ACQUIRE(&(self->head)) - tail);
+
+    if (available > maxSamples)
+        available = maxSamples;
+
+    int channelCount = self->channelCount;
+    int i;
+
+    for (i = 0; i < available; i++) {
+        uint32_t index = (tail + i) & (self->ringSize - 1);
+
+        if (smpCnt != NULL)
+            smpCnt[i] = self->smpCntRing[index];
+
+        if (timestamps != NULL)
+            timestamps[i] = self->timestampRing[index];
+
+        memcpy(values + (i * channelCount), self->valueRing + (index * channelCount),
+                channelCount * sizeof(int32_t));
+
+        if (qualities != NULL)
+            memcpy(qualities + (i * channelCount), self->qualityRing + (index * channelCount),
+                    channelCount * sizeof(uint32_t));
+    }
+
+    SV_STORE_RELEASE(&(self->tail), tail + available);
+
+    return available;
+}
+
+void
+SVSubscriber_getStatistics(SVSubscriber self, SVSubscriberStatistics* statistics)
+{
+    *statistics = self->statistics;
+}
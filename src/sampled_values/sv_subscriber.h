@@ -0,0 +1,167 @@
+/*
+ *  sv_subscriber.h
+ *
+ *  Copyright 2013 Michael Zillgith
+ *
+ *  This file is part of libIEC61850.
+ *
+ *  libIEC61850 is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  libIEC61850 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with libIEC61850.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  See COPYING file for the complete license text.
+ */
+
+#ifndef SV_SUBSCRIBER_H_
+#define SV_SUBSCRIBER_H_
+
+#include "libiec61850_common_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \defgroup sv_subscriber_api_group IEC 61850 sampled values (SV) subscriber API
+ */
+/**@{*/
+
+typedef struct sSVReceiver* SVReceiver;
+
+typedef struct sSVSubscriber* SVSubscriber;
+
+typedef struct {
+    uint32_t received;  /* number of samples (ASDUs) received */
+    uint32_t gaps;      /* number of discontinuities of smpCnt */
+    uint32_t missing;   /* number of samples missing according to smpCnt */
+    uint32_t overflows; /* number of samples discarded because the ring buffer was full */
+    uint32_t errors;    /* number of ASDUs that did not match the expected number of channels */
+} SVSubscriberStatistics;
+
+/**
+ * \brief Create a new SV receiver instance.
+ *
+ * A SV receiver uses a single ethernet socket and a single thread to receive the sampled values
+ * messages of an interface and passes the ASDUs to the subscribers of the stream (svID).
+ */
+SVReceiver
+SVReceiver_create(void);
+
+/**
+ * \brief set the ethernet interface that should be used (has to be called before SVReceiver_start)
+ */
+void
+SVReceiver_setInterfaceId(SVReceiver self, char* interfaceId);
+
+void
+SVReceiver_addSubscriber(SVReceiver self, SVSubscriber subscriber);
+
+void
+SVReceiver_removeSubscriber(SVReceiver self, SVSubscriber subscriber);
+
+/**
+ * \brief Start listening to SV messages
+ */
+void
+SVReceiver_start(SVReceiver self);
+
+/**
+ * \brief Stop listening to SV messages
+ */
+void
+SVReceiver_stop(SVReceiver self);
+
+/**
+ * \brief Stop the receiver and release all resources (the subscribers are not destroyed)
+ */
+void
+SVReceiver_destroy(SVReceiver self);
+
+/**
+ * \brief Decode a SV message and pass the samples to the subscribers.
+ *
+ * This function is called by the receiver thread. It can be used to feed messages from other
+ * sources (e.g. a capture file) to the subscribers when the receiver is not started.
+ *
+ * \param buffer a complete ethernet frame (including the ethernet header)
+ * \param length the size of the frame in bytes
+ * \param timestamp the receive time in ns since epoch or 0 to use the current time
+ */
+void
+SVReceiver_handleMessage(SVReceiver self, uint8_t* buffer, int length, uint64_t timestamp);
+
+/**
+ * \brief Create a subscriber for a single SV stream.
+ *
+ * The samples of the stream are stored in a ring buffer. The ring buffer is written by the
+ * receiver thread and can be read by a single other thread without locking.
+ *
+ * \param svID the sampled value ID of the stream (MsvID)
+ * \param channelCount number of samples (value + quality) in an ASDU. ASDUs with a different
+ *        number of samples are counted as errors.
+ * \param ringBufferSize maximum number of samples (ASDUs) stored in the ring buffer. Is
+ *        rounded up to a power of two.
+ */
+SVSubscriber
+SVSubscriber_create(char* svID, int channelCount, int ringBufferSize);
+
+/**
+ * \brief set the APPID used by the subscriber to filter relevant messages.
+ */
+void
+SVSubscriber_setAppId(SVSubscriber self, uint16_t appId);
+
+/**
+ * \brief set the value after that smpCnt starts again with 0 (e.g. 4000 for 4000 samples/s)
+ *
+ * Is required for gap detection when the counter does not wrap at 65536 (default).
+ */
+void
+SVSubscriber_setSmpCntWrap(SVSubscriber self, uint16_t smpCntWrap);
+
+void
+SVSubscriber_destroy(SVSubscriber self);
+
+/**
+ * \brief get the number of samples that can be read from the ring buffer
+ */
+int
+SVSubscriber_getAvailableSamples(SVSubscriber self);
+
+/**
+ * \brief Read a block of samples from the ring buffer.
+ *
+ * Must only be called by a single thread at a time.
+ *
+ * \param maxSamples maximum number of samples (ASDUs) to read
+ * \param smpCnt array for the sample counters (maxSamples elements) or NULL
+ * \param timestamps array for the receive times of the samples in ns since epoch (maxSamples
+ *        elements) or NULL. All ASDUs of a message have the receive time of the message.
+ * \param values array for the values (maxSamples * channelCount elements)
+ * \param qualities array for the qualities (maxSamples * channelCount elements) or NULL
+ *
+ * \return the number of samples read
+ */
+int
+SVSubscriber_readSamples(SVSubscriber self, int maxSamples, uint16_t* smpCnt, uint64_t* timestamps,
+        int32_t* values, uint32_t* qualities);
+
+void
+SVSubscriber_getStatistics(SVSubscriber self, SVSubscriberStatistics* statistics);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SV_SUBSCRIBER_H_ */